@@ -62,7 +62,28 @@
   #define CS_SUB_BLOCK_SIZE 256
 #endif
 
+/// select1 hint spacing: one sampled super-block index every N one-bits.
+#ifndef CS_SELECT_SAMPLE
+  #define CS_SELECT_SAMPLE 4096
+#endif
+
+// ──────────────────────────────────────────────────────────────
+// INTERVAL CACHE PARAMETERS
+// ──────────────────────────────────────────────────────────────
+
+/// Longest pattern suffix stored as an interval-cache key (multiple of 8).
+#ifndef CS_INTERVAL_CACHE_KEY_MAX
+  #define CS_INTERVAL_CACHE_KEY_MAX 64
+#endif
+
+/// Slots per interval-cache bucket (CLOCK eviction runs within a bucket).
+#ifndef CS_INTERVAL_CACHE_WAYS
+  #define CS_INTERVAL_CACHE_WAYS 8
+#endif
+
 static_assert(CS_SUPER_BLOCK_SIZE % CS_SUB_BLOCK_SIZE == 0,
               "Super-block size must be a multiple of sub-block size");
 static_assert(CS_SUB_BLOCK_SIZE % 64 == 0,
               "Sub-block size must be a multiple of 64 (word size)");
+static_assert(CS_INTERVAL_CACHE_KEY_MAX % 8 == 0 && CS_INTERVAL_CACHE_KEY_MAX > 0,
+              "Interval cache key size must be a positive multiple of 8");
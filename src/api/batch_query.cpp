@@ -0,0 +1,183 @@
+/**
+ * batch_query.cpp — Ordered, bounded-window batch query pipeline.
+ */
+
+#include "batch_query.hpp"
+#include <algorithm>
+#include <deque>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace cs {
+
+// ──────────────────────────────────────────────────────────────
+// search_shared_suffixes: Depth-first over the reversed-pattern trie
+// ──────────────────────────────────────────────────────────────
+
+std::vector<SAInterval> search_shared_suffixes(const FMIndex& idx, const std::vector<std::string>& patterns,
+                                               SharedSearchStats* stats) {
+  std::vector<size_t> order(patterns.size());
+  for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+  std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    const auto& x = patterns[a];
+    const auto& y = patterns[b];
+    return std::lexicographical_compare(x.rbegin(), x.rend(), y.rbegin(), y.rend());
+  });
+
+  // path[k] = interval of the previous pattern's length-k suffix; it stops
+  // growing at the first empty interval, since every extension stays empty.
+  std::vector<SAInterval> path{idx.full_interval()};
+  std::vector<SAInterval> out(patterns.size());
+  uint64_t ranks = 0, naive = 0;
+  const std::string* prev = nullptr;
+  for (size_t i : order) {
+    const std::string& p = patterns[i];
+    const size_t m = p.size();
+    size_t shared = 0;
+    if (prev) {
+      const size_t lim = std::min({m, prev->size(), path.size() - 1});
+      while (shared < lim && p[m - 1 - shared] == (*prev)[prev->size() - 1 - shared]) ++shared;
+    }
+    path.resize(shared + 1);
+    while (path.size() <= m && !path.back().empty()) {
+      path.push_back(idx.extend_left(path.back(), static_cast<uint8_t>(p[m - path.size()])));
+      ranks += 2;
+    }
+    // Alone, the search would run until the pattern ends or the interval empties.
+    naive += 2 * (path.size() - 1 < m ? path.size() - 1 : m);
+    out[i] = path.back().empty() ? SAInterval{0, 0, m} : path.back();
+    prev = &p;
+  }
+  if (stats) {
+    stats->rank_calls += ranks;
+    stats->naive_rank_calls += naive;
+  }
+  return out;
+}
+
+// ──────────────────────────────────────────────────────────────
+// run_batch_queries: Ordered, bounded-window pipeline
+// ──────────────────────────────────────────────────────────────
+
+struct ChunkResult {
+  std::string bytes;
+  uint64_t occurrences = 0;
+  SharedSearchStats search;
+};
+
+static ChunkResult run_chunk(const FMIndex& idx, const std::vector<std::string>& patterns,
+                             const BatchQueryOptions& opt) {
+  ChunkResult r;
+  r.bytes.reserve(patterns.size() * (opt.format == BatchFormat::TSV ? 8 : 12));
+  std::vector<SAInterval> intervals;
+  if (opt.shared_suffixes) {
+    intervals = search_shared_suffixes(idx, patterns, &r.search);
+  } else {
+    intervals.reserve(patterns.size());
+    for (const auto& p : patterns) intervals.push_back(idx.interval(p));
+  }
+  for (size_t k = 0; k < patterns.size(); ++k) {
+    const auto& p = patterns[k];
+    // One backward search serves both count and locate.
+    const SAInterval& iv = intervals[k];
+    const uint64_t c = p.empty() ? idx.size() : iv.size();
+    r.occurrences += c;
+    std::vector<uint64_t> pos;
+    if (opt.locate_limit > 0 && c > 0) pos = idx.locate(iv, opt.locate_limit);
+
+    if (opt.format == BatchFormat::TSV) {
+      r.bytes += std::to_string(c);
+      if (opt.locate_limit > 0) {
+        r.bytes += '\t';
+        for (size_t i = 0; i < pos.size(); ++i) {
+          if (i) r.bytes += ',';
+          r.bytes += std::to_string(pos[i]);
+        }
+      }
+      r.bytes += '\n';
+    } else {
+      r.bytes.append(reinterpret_cast<const char*>(&c), sizeof(c));
+      if (opt.locate_limit > 0) {
+        const uint32_t n = static_cast<uint32_t>(pos.size());
+        r.bytes.append(reinterpret_cast<const char*>(&n), sizeof(n));
+        r.bytes.append(reinterpret_cast<const char*>(pos.data()), n * sizeof(uint64_t));
+      }
+    }
+  }
+  return r;
+}
+
+BatchQueryStats run_batch_queries(const FMIndex& idx, std::istream& in, std::ostream& out,
+                                  ThreadPool& pool, const BatchQueryOptions& opt) {
+  const size_t chunk = opt.chunk_patterns ? opt.chunk_patterns : 1;
+  const size_t window = opt.window ? opt.window : 2 * pool.size();
+  BatchQueryStats stats;
+  std::deque<std::future<ChunkResult>> inflight;
+
+  auto retire_front = [&] {
+    ChunkResult r = inflight.front().get();
+    inflight.pop_front();
+    out.write(r.bytes.data(), static_cast<std::streamsize>(r.bytes.size()));
+    stats.occurrences += r.occurrences;
+    stats.rank_calls += r.search.rank_calls;
+    stats.naive_rank_calls += r.search.naive_rank_calls;
+  };
+
+  std::string line;
+  bool eof = false;
+  while (!eof) {
+    auto patterns = std::make_shared<std::vector<std::string>>();
+    patterns->reserve(chunk);
+    while (patterns->size() < chunk) {
+      if (!std::getline(in, line)) {
+        eof = true;
+        break;
+      }
+      if (!line.empty() && line.back() == '\r') line.pop_back();
+      patterns->push_back(std::move(line));
+    }
+    if (patterns->empty()) break;
+    stats.patterns += patterns->size();
+    ++stats.chunks;
+
+    if (inflight.size() >= window) retire_front();
+    inflight.push_back(pool.submit([&idx, &opt, patterns] { return run_chunk(idx, *patterns, opt); }));
+  }
+  while (!inflight.empty()) retire_front();
+  out.flush();
+  return stats;
+}
+
+// ──────────────────────────────────────────────────────────────
+// find_smems_batch: Blocks of reads, per-thread workspace
+// ──────────────────────────────────────────────────────────────
+
+SmemBatch find_smems_batch(const FMIndex& idx, const std::vector<std::string>& reads, size_t min_len,
+                           ThreadPool& pool) {
+  constexpr size_t BLOCK = 256;
+  const size_t blocks = (reads.size() + BLOCK - 1) / BLOCK;
+  std::vector<std::vector<Smem>> block_hits(blocks);
+  std::vector<size_t> counts(reads.size());
+
+  pool.parallel_for(blocks, [&](size_t b) {
+    thread_local SmemWorkspace ws;
+    thread_local std::vector<Smem> one;
+    auto& hits = block_hits[b];
+    for (size_t r = b * BLOCK; r < std::min(reads.size(), (b + 1) * BLOCK); ++r) {
+      idx.smems(reads[r], min_len, ws, one);
+      hits.insert(hits.end(), one.begin(), one.end());
+      counts[r] = one.size();
+    }
+  });
+
+  SmemBatch out;
+  out.offsets.resize(reads.size() + 1, 0);
+  for (size_t r = 0; r < reads.size(); ++r) out.offsets[r + 1] = out.offsets[r] + counts[r];
+  out.hits.reserve(out.offsets.back());
+  for (const auto& h : block_hits) out.hits.insert(out.hits.end(), h.begin(), h.end());
+  return out;
+}
+
+} // namespace cs
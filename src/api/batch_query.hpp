@@ -0,0 +1,85 @@
+#pragma once
+/**
+ * batch_query.hpp — Streams a pattern file through an FMIndex on all cores.
+ *
+ * Patterns (one per line) are read in chunks; each chunk is counted/located
+ * on the thread pool and its output encoded there. Finished chunks are
+ * written strictly in input order, and at most `window` chunks are in flight,
+ * so memory stays bounded no matter how many patterns are streamed.
+ *
+ * Within a chunk, patterns are searched in reversed-string order so suffixes
+ * shared by neighbours are backward-searched once (search_shared_suffixes).
+ *
+ * Output formats (one record per input line, same order):
+ *   TSV     count            (count only)
+ *           count \t p1,p2,… (with locate; up to `locate_limit` positions, ascending)
+ *   BINARY  u64 count                       (count only)
+ *           u64 count, u32 n, u64 pos[n]    (with locate; little-endian)
+ */
+
+#include "fm_index.hpp"
+#include "../util/thread_pool.hpp"
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace cs {
+
+enum class BatchFormat { TSV, BINARY };
+
+struct BatchQueryOptions {
+  size_t chunk_patterns = 4096;   // Patterns per work unit
+  size_t window = 0;              // Chunks in flight (0 = 2 × pool size)
+  size_t locate_limit = 0;        // 0 = count only
+  BatchFormat format = BatchFormat::TSV;
+  bool shared_suffixes = true;    // Search each chunk as a suffix trie
+};
+
+struct BatchQueryStats {
+  uint64_t patterns = 0;
+  uint64_t occurrences = 0;       // Sum of counts
+  uint64_t chunks = 0;
+  uint64_t rank_calls = 0;        // occ() calls of the shared-suffix search
+  uint64_t naive_rank_calls = 0;  // ... had every pattern been searched alone
+};
+
+struct SharedSearchStats {
+  uint64_t rank_calls = 0;
+  uint64_t naive_rank_calls = 0;
+};
+
+/**
+ * search_shared_suffixes(idx, patterns, stats) — idx.interval(p) for every
+ * pattern, in input order. Patterns are visited sorted by reversed string,
+ * which walks the trie of reversed patterns depth-first: a suffix shared with
+ * the previous pattern reuses its interval, so each trie edge costs one
+ * extend_left and searches fan out only where patterns differ. stats (added
+ * to) compares occ() calls against independent backward searches.
+ */
+std::vector<SAInterval> search_shared_suffixes(const FMIndex& idx, const std::vector<std::string>& patterns,
+                                               SharedSearchStats* stats = nullptr);
+
+/**
+ * run_batch_queries(idx, in, out, pool, opt) — Reads patterns from in until
+ * EOF (a trailing '\r' is stripped) and writes one record per pattern to out.
+ */
+BatchQueryStats run_batch_queries(const FMIndex& idx, std::istream& in, std::ostream& out,
+                                  ThreadPool& pool, const BatchQueryOptions& opt = {});
+
+/// SMEMs of many reads, flattened: read r owns hits[offsets[r], offsets[r+1]).
+struct SmemBatch {
+  std::vector<Smem> hits;
+  std::vector<size_t> offsets;
+};
+
+/**
+ * find_smems_batch(idx, reads, min_len, pool) — idx.smems for every read.
+ * Reads are handed out in blocks; each thread keeps one SmemWorkspace and
+ * one output buffer, so nothing is allocated per read once warm.
+ */
+SmemBatch find_smems_batch(const FMIndex& idx, const std::vector<std::string>& reads, size_t min_len,
+                           ThreadPool& pool);
+
+} // namespace cs
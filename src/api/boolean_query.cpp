@@ -0,0 +1,343 @@
+/**
+ * boolean_query.cpp — Boolean query parsing and cost-ordered evaluation.
+ */
+
+#include "boolean_query.hpp"
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace cs {
+
+// ──────────────────────────────────────────────────────────────
+// Construction
+// ──────────────────────────────────────────────────────────────
+
+BoolQuery BoolQuery::term(std::string pattern) {
+  BoolQuery q;
+  q.pattern = std::move(pattern);
+  return q;
+}
+
+BoolQuery BoolQuery::all_of(std::vector<BoolQuery> operands) {
+  if (operands.empty()) throw std::invalid_argument("BoolQuery: AND needs an operand");
+  if (operands.size() == 1) return std::move(operands[0]);
+  BoolQuery q;
+  q.op = Op::AND;
+  q.children = std::move(operands);
+  return q;
+}
+
+BoolQuery BoolQuery::any_of(std::vector<BoolQuery> operands) {
+  if (operands.empty()) throw std::invalid_argument("BoolQuery: OR needs an operand");
+  if (operands.size() == 1) return std::move(operands[0]);
+  BoolQuery q;
+  q.op = Op::OR;
+  q.children = std::move(operands);
+  return q;
+}
+
+BoolQuery BoolQuery::negate(BoolQuery operand) {
+  BoolQuery q;
+  q.op = Op::NOT;
+  q.children.push_back(std::move(operand));
+  return q;
+}
+
+// ──────────────────────────────────────────────────────────────
+// parse: Recursive descent (or → and → unary → primary)
+// ──────────────────────────────────────────────────────────────
+
+namespace {
+
+class Parser {
+public:
+  explicit Parser(std::string_view s) : s_(s) {}
+
+  BoolQuery parse_all() {
+    BoolQuery q = parse_or();
+    skip_space();
+    if (pos_ != s_.size()) fail("unexpected ')'");
+    return q;
+  }
+
+private:
+  BoolQuery parse_or() {
+    std::vector<BoolQuery> ops;
+    ops.push_back(parse_and());
+    while (keyword("OR")) ops.push_back(parse_and());
+    return BoolQuery::any_of(std::move(ops));
+  }
+
+  BoolQuery parse_and() {
+    std::vector<BoolQuery> ops;
+    ops.push_back(parse_unary());
+    for (;;) {
+      if (keyword("AND")) {
+        ops.push_back(parse_unary());
+        continue;
+      }
+      skip_space();
+      if (pos_ == s_.size() || s_[pos_] == ')' || at_keyword("OR")) break;
+      ops.push_back(parse_unary());  // Juxtaposition
+    }
+    return BoolQuery::all_of(std::move(ops));
+  }
+
+  BoolQuery parse_unary() {
+    if (keyword("NOT")) return BoolQuery::negate(parse_unary());
+    return parse_primary();
+  }
+
+  BoolQuery parse_primary() {
+    skip_space();
+    if (pos_ == s_.size()) fail("expected a term");
+    if (s_[pos_] == '(') {
+      ++pos_;
+      BoolQuery q = parse_or();
+      skip_space();
+      if (pos_ == s_.size() || s_[pos_] != ')') fail("missing ')'");
+      ++pos_;
+      return q;
+    }
+    if (s_[pos_] == '"') {
+      std::string t;
+      for (++pos_; pos_ < s_.size() && s_[pos_] != '"'; ++pos_) {
+        if (s_[pos_] == '\\' && pos_ + 1 < s_.size()) ++pos_;
+        t += s_[pos_];
+      }
+      if (pos_ == s_.size()) fail("unterminated quote");
+      ++pos_;
+      if (t.empty()) fail("empty term");
+      return BoolQuery::term(std::move(t));
+    }
+    if (s_[pos_] == ')') fail("expected a term");
+    if (at_keyword("AND") || at_keyword("OR")) fail("expected a term");
+    const size_t start = pos_;
+    while (pos_ < s_.size() && !is_delim(s_[pos_])) ++pos_;
+    return BoolQuery::term(std::string(s_.substr(start, pos_ - start)));
+  }
+
+  static bool is_space(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+  static bool is_delim(char c) { return is_space(c) || c == '(' || c == ')' || c == '"'; }
+
+  void skip_space() {
+    while (pos_ < s_.size() && is_space(s_[pos_])) ++pos_;
+  }
+
+  bool at_keyword(std::string_view kw) {
+    skip_space();
+    return s_.substr(pos_, kw.size()) == kw &&
+           (pos_ + kw.size() == s_.size() || is_delim(s_[pos_ + kw.size()]));
+  }
+
+  bool keyword(std::string_view kw) {
+    if (!at_keyword(kw)) return false;
+    pos_ += kw.size();
+    return true;
+  }
+
+  [[noreturn]] void fail(const char* what) const {
+    throw std::invalid_argument("BoolQuery::parse: " + std::string(what) + " at offset " +
+                                std::to_string(pos_));
+  }
+
+  std::string_view s_;
+  size_t pos_ = 0;
+};
+
+} // namespace
+
+BoolQuery BoolQuery::parse(std::string_view expr) {
+  return Parser(expr).parse_all();
+}
+
+std::string BoolQuery::to_string() const {
+  switch (op) {
+    case Op::TERM: {
+      std::string out = "\"";
+      for (char c : pattern) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+      }
+      return out + '"';
+    }
+    case Op::NOT:
+      return "NOT " + children[0].to_string();
+    default: {
+      std::string out = "(";
+      for (size_t i = 0; i < children.size(); ++i) {
+        if (i) out += op == Op::AND ? " AND " : " OR ";
+        out += children[i].to_string();
+      }
+      return out + ')';
+    }
+  }
+}
+
+// ──────────────────────────────────────────────────────────────
+// search_documents: Cost-ordered evaluation
+// ──────────────────────────────────────────────────────────────
+
+namespace {
+
+using Docs = std::vector<uint32_t>;
+
+class Evaluator {
+public:
+  Evaluator(const FMIndex& idx, BoolQueryStats& stats) : idx_(idx), stats_(stats) {}
+
+  /// Documents matching q, from scratch.
+  Docs evaluate(const BoolQuery& q) {
+    switch (q.op) {
+      case BoolQuery::Op::TERM:
+        ++stats_.lists;
+        return q.pattern.empty() ? Docs() : idx_.list_documents(q.pattern);
+      case BoolQuery::Op::OR: {
+        Docs out;
+        for (const auto& c : q.children) out = set_union(out, evaluate(c));
+        return out;
+      }
+      case BoolQuery::Op::AND: {
+        // Seed with the cheapest positive operand, filter by the rest.
+        const auto order = and_order(q);
+        const BoolQuery& seed = q.children[order[0]];
+        if (seed.op == BoolQuery::Op::NOT) return filter(q, universe());
+        Docs cands = evaluate(seed);
+        return filter_and(q, order, 1, std::move(cands));
+      }
+      case BoolQuery::Op::NOT:
+        return filter(q, universe());
+    }
+    return {};
+  }
+
+  /// The subset of cands (ascending) matching q.
+  Docs filter(const BoolQuery& q, Docs cands) {
+    if (cands.empty()) return cands;
+    switch (q.op) {
+      case BoolQuery::Op::TERM: {
+        if (q.pattern.empty()) return {};
+        // Probe each candidate unless listing the term is cheaper.
+        if (cands.size() <= estimate(q)) {
+          stats_.probes += cands.size();
+          return idx_.filter_documents(q.pattern, cands);
+        }
+        ++stats_.lists;
+        return set_intersection(cands, idx_.list_documents(q.pattern));
+      }
+      case BoolQuery::Op::AND:
+        return filter_and(q, and_order(q), 0, std::move(cands));
+      case BoolQuery::Op::OR: {
+        // Most frequent operand first: it settles the most candidates.
+        std::vector<size_t> order(q.children.size());
+        for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+          return estimate(q.children[a]) > estimate(q.children[b]);
+        });
+        Docs out;
+        for (size_t i : order) {
+          Docs hit = filter(q.children[i], cands);
+          cands = set_difference(cands, hit);
+          out = set_union(out, hit);
+          if (cands.empty()) break;
+        }
+        return out;
+      }
+      case BoolQuery::Op::NOT:
+        return set_difference(cands, filter(q.children[0], cands));
+    }
+    return {};
+  }
+
+private:
+  Docs filter_and(const BoolQuery& q, const std::vector<size_t>& order, size_t from, Docs cands) {
+    for (size_t i = from; i < order.size(); ++i) {
+      if (cands.empty()) {
+        stats_.short_circuit = true;
+        break;
+      }
+      cands = filter(q.children[order[i]], std::move(cands));
+    }
+    return cands;
+  }
+
+  /// AND operands: positives by ascending estimate, then negations.
+  std::vector<size_t> and_order(const BoolQuery& q) {
+    std::vector<size_t> order(q.children.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+      const bool na = q.children[a].op == BoolQuery::Op::NOT;
+      const bool nb = q.children[b].op == BoolQuery::Op::NOT;
+      if (na != nb) return nb;
+      return estimate(q.children[a]) < estimate(q.children[b]);
+    });
+    return order;
+  }
+
+  /// Upper bound on the documents matching q (occurrences for a term).
+  uint64_t estimate(const BoolQuery& q) {
+    switch (q.op) {
+      case BoolQuery::Op::TERM: {
+        if (q.pattern.empty()) return 0;
+        auto it = counts_.find(q.pattern);
+        if (it == counts_.end()) {
+          ++stats_.counts;
+          it = counts_.emplace(q.pattern, idx_.count(q.pattern)).first;
+        }
+        return it->second;
+      }
+      case BoolQuery::Op::AND: {
+        uint64_t best = UINT64_MAX;
+        for (const auto& c : q.children) {
+          if (c.op != BoolQuery::Op::NOT) best = std::min(best, estimate(c));
+        }
+        return best == UINT64_MAX ? idx_.num_documents() : best;
+      }
+      case BoolQuery::Op::OR: {
+        uint64_t sum = 0;
+        for (const auto& c : q.children) sum = std::min<uint64_t>(UINT64_MAX / 2, sum + estimate(c));
+        return sum;
+      }
+      case BoolQuery::Op::NOT:
+        return idx_.num_documents();
+    }
+    return 0;
+  }
+
+  Docs universe() const {
+    Docs all(idx_.num_documents());
+    for (size_t d = 0; d < all.size(); ++d) all[d] = static_cast<uint32_t>(d);
+    return all;
+  }
+
+  static Docs set_union(const Docs& a, const Docs& b) {
+    Docs out;
+    std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(out));
+    return out;
+  }
+  static Docs set_intersection(const Docs& a, const Docs& b) {
+    Docs out;
+    std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(out));
+    return out;
+  }
+  static Docs set_difference(const Docs& a, const Docs& b) {
+    Docs out;
+    std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(out));
+    return out;
+  }
+
+  const FMIndex& idx_;
+  BoolQueryStats& stats_;
+  std::unordered_map<std::string, uint64_t> counts_;
+};
+
+} // namespace
+
+std::vector<uint32_t> search_documents(const FMIndex& idx, const BoolQuery& q, BoolQueryStats* stats) {
+  BoolQueryStats local;
+  return Evaluator(idx, stats ? *stats : local).evaluate(q);
+}
+
+} // namespace cs
@@ -0,0 +1,65 @@
+#pragma once
+/**
+ * boolean_query.hpp — AND/OR/NOT over patterns, answered at document level.
+ *
+ * Planner:
+ *   - count() every term once and order AND operands by selectivity, so the
+ *     rarest operand is listed first and becomes the candidate set
+ *   - remaining operands (and every negation) filter the candidates with
+ *     document-array range ranks; an operand is listed and intersected
+ *     instead only when the candidates outnumber its occurrences
+ *   - nothing is ever located, and an AND stops as soon as its candidate set
+ *     is empty
+ * So the cost of a conjunction follows its rarest term, not its most
+ * frequent one. A query with no positive operand (e.g. NOT x) starts from
+ * every document.
+ *
+ * Text syntax (parse):  cat AND (dog OR "big mouse") AND NOT rat
+ *   - AND binds tighter than OR; juxtaposition means AND
+ *   - NOT/AND/OR are upper-case keywords; quote a term to use them literally
+ *   - inside quotes, \" and \\ escape
+ */
+
+#include "fm_index.hpp"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace cs {
+
+struct BoolQuery {
+  enum class Op : uint8_t { TERM, AND, OR, NOT };
+
+  Op op = Op::TERM;
+  std::string pattern;               // TERM only
+  std::vector<BoolQuery> children;   // AND/OR: ≥1 operand, NOT: exactly 1
+
+  static BoolQuery term(std::string pattern);
+  static BoolQuery all_of(std::vector<BoolQuery> operands);
+  static BoolQuery any_of(std::vector<BoolQuery> operands);
+  static BoolQuery negate(BoolQuery operand);
+
+  /// Parses the text syntax above; throws std::invalid_argument on errors.
+  static BoolQuery parse(std::string_view expr);
+
+  /// Canonical text form (fully parenthesized, terms quoted); parse() round-trips it.
+  std::string to_string() const;
+};
+
+/// Work done by search_documents (accumulated across calls that share it).
+struct BoolQueryStats {
+  uint64_t counts = 0;         // count() calls (one per distinct term)
+  uint64_t lists = 0;          // Terms whose document list was enumerated
+  uint64_t probes = 0;         // Candidate documents checked by range rank
+  bool short_circuit = false;  // An AND emptied before all operands ran
+};
+
+/**
+ * search_documents(idx, q, stats) — Ascending ids of the documents matching q.
+ * The empty pattern matches no document.
+ */
+std::vector<uint32_t> search_documents(const FMIndex& idx, const BoolQuery& q,
+                                       BoolQueryStats* stats = nullptr);
+
+} // namespace cs
@@ -0,0 +1,190 @@
+/**
+ * class_pattern.cpp — Parser and frontier backward search.
+ */
+
+#include "class_pattern.hpp"
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+namespace cs {
+
+// ──────────────────────────────────────────────────────────────
+// CharClass
+// ──────────────────────────────────────────────────────────────
+
+void CharClass::add_range(uint8_t lo, uint8_t hi) {
+  for (unsigned c = lo; c <= hi; ++c) pos_[c >> 6] |= 1ULL << (c & 63);
+  refresh();
+}
+
+void CharClass::refresh() {
+  for (size_t w = 0; w < 4; ++w) {
+    const uint64_t m = pos_[w] | (has_excl_ ? ~excl_[w] : 0);
+    bits_[w] = neg_ ? ~m : m;
+  }
+}
+
+CharClass& CharClass::operator|=(const CharClass& o) {
+  // Both sides as listed bytes plus the complement of an excluded set; a
+  // plain negated class ¬P is the excluded set P with nothing listed.
+  auto split = [](const CharClass& c, Bits& pos, Bits& excl, bool& has) {
+    if (c.neg_ && c.has_excl_) return false;
+    pos = c.neg_ ? Bits{} : c.pos_;
+    excl = c.neg_ ? c.pos_ : c.excl_;
+    has = c.neg_ || c.has_excl_;
+    return true;
+  };
+  Bits p1, e1, p2, e2;
+  bool h1, h2;
+  if (split(*this, p1, e1, h1) && split(o, p2, e2, h2)) {
+    for (size_t w = 0; w < 4; ++w) {
+      pos_[w] = p1[w] | p2[w];
+      excl_[w] = h1 && h2 ? e1[w] & e2[w] : h1 ? e1[w] : e2[w];
+    }
+    has_excl_ = h1 || h2;
+  } else {
+    // [^…\W…] nested once more; keep the members, folding sees them as listed.
+    pos_ = bits_;
+    for (size_t w = 0; w < 4; ++w) pos_[w] |= o.bits_[w];
+    has_excl_ = false;
+  }
+  neg_ = false;
+  refresh();
+  return *this;
+}
+
+size_t CharClass::size() const {
+  size_t n = 0;
+  for (uint64_t w : bits_) n += std::popcount(w);
+  return n;
+}
+
+CharClass CharClass::mapped(const FoldTable& f) const {
+  CharClass out;
+  for (unsigned c = 0; c < 256; ++c) {
+    const uint64_t bit = 1ULL << (f[c] & 63);
+    if ((pos_[c >> 6] >> (c & 63)) & 1) out.pos_[f[c] >> 6] |= bit;
+    if ((excl_[c >> 6] >> (c & 63)) & 1) out.excl_[f[c] >> 6] |= bit;
+  }
+  out.has_excl_ = has_excl_;
+  out.neg_ = neg_;
+  out.refresh();
+  return out;
+}
+
+bool CharClass::any_in(unsigned lo, unsigned hi) const {
+  for (unsigned w = lo / 64; w < 4 && w * 64 < hi; ++w) {
+    const unsigned b = std::max(lo, w * 64) - w * 64, e = std::min(hi, w * 64 + 64) - w * 64;
+    const uint64_t mask = (e - b == 64 ? ~0ULL : ((1ULL << (e - b)) - 1)) << b;
+    if (bits_[w] & mask) return true;
+  }
+  return false;
+}
+
+// ──────────────────────────────────────────────────────────────
+// parse
+// ──────────────────────────────────────────────────────────────
+
+ClassPattern ClassPattern::parse(std::string_view s) {
+  ClassPattern p;
+  for (size_t i = 0; i < s.size(); ++i) {
+    CharClass cc;
+    if (s[i] == '?') {
+      cc.negate();
+    } else if (s[i] == '\\') {
+      if (++i == s.size()) throw std::invalid_argument("class pattern: trailing backslash");
+      cc.add(static_cast<uint8_t>(s[i]));
+    } else if (s[i] == '[') {
+      size_t j = i + 1;
+      const bool neg = j < s.size() && (s[j] == '^' || s[j] == '!');
+      if (neg) ++j;
+      bool first = true;
+      for (; j < s.size() && (s[j] != ']' || first); ++j, first = false) {
+        uint8_t lo = static_cast<uint8_t>(s[j]);
+        if (s[j] == '\\' && j + 1 < s.size()) lo = static_cast<uint8_t>(s[++j]);
+        if (j + 2 < s.size() && s[j + 1] == '-' && s[j + 2] != ']') {
+          j += 2;
+          uint8_t hi = static_cast<uint8_t>(s[j]);
+          if (s[j] == '\\' && j + 1 < s.size()) hi = static_cast<uint8_t>(s[++j]);
+          if (hi < lo) throw std::invalid_argument("class pattern: reversed range in " + std::string(s));
+          cc.add_range(lo, hi);
+        } else {
+          cc.add(lo);
+        }
+      }
+      if (j >= s.size()) throw std::invalid_argument("class pattern: unterminated '[' in " + std::string(s));
+      if (neg) cc.negate();
+      i = j;
+    } else {
+      cc.add(static_cast<uint8_t>(s[i]));
+    }
+    p.positions_.push_back(cc);
+  }
+  return p;
+}
+
+bool ClassPattern::is_literal() const {
+  return std::all_of(positions_.begin(), positions_.end(), [](const CharClass& c) { return c.size() <= 1; });
+}
+
+// ──────────────────────────────────────────────────────────────
+// class_intervals: Right to left, one frontier of disjoint intervals
+// ──────────────────────────────────────────────────────────────
+
+std::vector<SAInterval> class_intervals(const FMIndex& idx, const ClassPattern& p, ClassSearchStats* stats) {
+  ClassSearchStats local;
+  ClassSearchStats& st = stats ? *stats : local;
+  std::vector<SAInterval> frontier{idx.full_interval()}, next;
+
+  for (size_t i = p.size(); i-- > 0 && !frontier.empty();) {
+    const CharClass cc = idx.folded() ? p.at(i).mapped(idx.fold_table()) : p.at(i);
+    next.clear();
+    if (cc.size() == 1) {
+      uint8_t c = 0;
+      while (!cc.contains(c)) ++c;
+      for (const SAInterval& iv : frontier) {
+        ++st.extends;
+        const SAInterval e = idx.extend_left(iv, c);
+        if (!e.empty()) next.push_back(e);
+      }
+    } else if (cc.size() > 1) {
+      auto allow = [&cc](unsigned lo, unsigned hi) { return cc.any_in(lo, hi); };
+      for (const SAInterval& iv : frontier) {
+        ++st.descents;
+        idx.for_each_left_extension(iv, allow, [&](uint8_t, const SAInterval& e) { next.push_back(e); });
+      }
+    }
+    frontier.swap(next);
+    st.peak_frontier = std::max<uint64_t>(st.peak_frontier, frontier.size());
+  }
+
+  std::sort(frontier.begin(), frontier.end(), [](const SAInterval& a, const SAInterval& b) { return a.sp < b.sp; });
+  std::vector<SAInterval> merged;
+  for (const SAInterval& iv : frontier) {
+    if (!merged.empty() && merged.back().ep == iv.sp) merged.back().ep = iv.ep;
+    else merged.push_back(iv);
+  }
+  return merged;
+}
+
+uint64_t count_class(const FMIndex& idx, const ClassPattern& p) {
+  if (p.size() == 0) return idx.size();
+  uint64_t n = 0;
+  for (const SAInterval& iv : class_intervals(idx, p)) n += iv.size();
+  return n;
+}
+
+std::vector<uint64_t> locate_class(const FMIndex& idx, const ClassPattern& p, size_t limit) {
+  std::vector<uint64_t> out;
+  if (p.size() == 0) return out;
+  for (const SAInterval& iv : class_intervals(idx, p)) {
+    if (out.size() >= limit) break;
+    const auto part = idx.locate(iv, limit - out.size());
+    out.insert(out.end(), part.begin(), part.end());
+  }
+  std::sort(out.begin(), out.end());
+  return out;
+}
+
+} // namespace cs
@@ -0,0 +1,88 @@
+#pragma once
+/**
+ * class_pattern.hpp — Patterns with single-byte wildcards and character classes.
+ *
+ * Syntax (one position per element):
+ *   x        the literal byte x
+ *   ?        any byte
+ *   [GT]     any listed byte; ranges such as [a-z0-9]; [^…] or [!…] negates
+ *   \x       x taken literally (for ? [ ] \)
+ * e.g. "AC[GT]T?A" matches ACGTxA and ACTTxA for any byte x.
+ *
+ * Search is backward search over the pattern's positions with a frontier of
+ * SA intervals. A literal position costs one extend_left per interval; a
+ * class position costs one wavelet descent per interval that visits only
+ * subtrees holding both a class member and a symbol present in the range,
+ * so the cost follows the symbols that actually occur rather than the
+ * class size or the number of expanded strings. Distinct strings never share
+ * rows, so the frontier holds disjoint intervals; adjacent ones are merged
+ * before locate.
+ */
+
+#include "fm_index.hpp"
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace cs {
+
+/// A set of byte values. Besides the members it keeps how they were built
+/// (listed bytes, negated shorthands, an outer negation) so that folding
+/// maps the listed bytes first and negates afterwards.
+class CharClass {
+public:
+  void add(uint8_t c) { pos_[c >> 6] |= 1ULL << (c & 63); refresh(); }
+  void add_range(uint8_t lo, uint8_t hi);
+  void negate() { neg_ = !neg_; refresh(); }
+  CharClass& operator|=(const CharClass& o);
+  bool contains(uint8_t c) const { return (bits_[c >> 6] >> (c & 63)) & 1; }
+  size_t size() const;
+  /// The class over folded text: listed bytes c become f[c], then negations
+  /// apply, so [^a] leaves out 'A' as well when 'A' folds to 'a'.
+  CharClass mapped(const FoldTable& f) const;
+  /// True if any byte in [lo, hi) is in the set (for pruned wavelet descents).
+  bool any_in(unsigned lo, unsigned hi) const;
+  bool operator==(const CharClass& o) const { return bits_ == o.bits_; }
+
+private:
+  using Bits = std::array<uint64_t, 4>;
+  void refresh();
+
+  Bits bits_{};             // Members
+  Bits pos_{};              // Listed bytes
+  Bits excl_{};             // Members are pos_ plus all bytes outside excl_ ...
+  bool has_excl_ = false;   // ... when a negated shorthand such as \W was added
+  bool neg_ = false;        // Members complemented once more, as in [^…]
+};
+
+class ClassPattern {
+public:
+  /// Parses the syntax above; throws std::invalid_argument on a malformed class.
+  static ClassPattern parse(std::string_view pattern);
+
+  size_t size() const { return positions_.size(); }
+  const CharClass& at(size_t i) const { return positions_[i]; }
+  /// True if no position has more than one byte.
+  bool is_literal() const;
+
+private:
+  std::vector<CharClass> positions_;
+};
+
+struct ClassSearchStats {
+  uint64_t extends = 0;        // extend_left calls (literal positions)
+  uint64_t descents = 0;       // Pruned wavelet descents (class positions)
+  uint64_t peak_frontier = 0;  // Most intervals alive at once
+};
+
+/// Rows of every string matching p, sorted and with adjacent intervals merged.
+std::vector<SAInterval> class_intervals(const FMIndex& idx, const ClassPattern& p,
+                                        ClassSearchStats* stats = nullptr);
+
+/// Occurrences / positions (ascending, up to limit) of p.
+uint64_t count_class(const FMIndex& idx, const ClassPattern& p);
+std::vector<uint64_t> locate_class(const FMIndex& idx, const ClassPattern& p, size_t limit = 100000);
+
+} // namespace cs
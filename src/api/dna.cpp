@@ -0,0 +1,79 @@
+/**
+ * dna.cpp — Reverse complement, two-strand build, hit mapping.
+ */
+
+#include "dna.hpp"
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+namespace cs {
+
+static const std::array<char, 256> COMPLEMENT = [] {
+  std::array<char, 256> t{};
+  for (int c = 0; c < 256; ++c) t[c] = static_cast<char>(c);
+  const char* from = "ACGTacgt";
+  const char* to = "TGCAtgca";
+  for (int i = 0; i < 8; ++i) t[static_cast<uint8_t>(from[i])] = to[i];
+  return t;
+}();
+
+char complement(char c) { return COMPLEMENT[static_cast<uint8_t>(c)]; }
+
+std::string reverse_complement(std::string_view s) {
+  std::string out(s.size(), '\0');
+  for (size_t i = 0; i < s.size(); ++i) out[s.size() - 1 - i] = complement(s[i]);
+  return out;
+}
+
+// ──────────────────────────────────────────────────────────────
+// build: seqs, then their reverse complements, as documents
+// ──────────────────────────────────────────────────────────────
+
+FMIndex build_both_strands(std::span<const std::string_view> seqs, const BuildParams& p) {
+  if (seqs.empty()) throw std::invalid_argument("build_both_strands: no sequences");
+  std::vector<std::string> minus;
+  minus.reserve(seqs.size());
+  for (const auto& s : seqs) minus.push_back(reverse_complement(s));
+  std::vector<std::string_view> docs(seqs.begin(), seqs.end());
+  docs.insert(docs.end(), minus.begin(), minus.end());
+  return FMIndex::build_from_documents(docs, p);
+}
+
+FMIndex build_both_strands(std::string_view seq, const BuildParams& p) {
+  return build_both_strands(std::span<const std::string_view>(&seq, 1), p);
+}
+
+size_t strand_sequences(const FMIndex& idx) {
+  const size_t docs = idx.num_documents(), k = docs / 2;
+  bool ok = docs % 2 == 0;
+  for (size_t i = 0; ok && i < k; ++i) ok = idx.document_length(i) == idx.document_length(k + i);
+  if (!ok) throw std::invalid_argument("strand_sequences: index was not built with build_both_strands");
+  return k;
+}
+
+// ──────────────────────────────────────────────────────────────
+// locate: minus-strand hit at o in revcomp(seq) is seq[L - o - m, L - o)
+// ──────────────────────────────────────────────────────────────
+
+std::vector<StrandHit> locate_both_strands(const FMIndex& idx, std::string_view pattern, size_t limit) {
+  const size_t k = strand_sequences(idx);
+  std::vector<StrandHit> out;
+  if (pattern.empty()) return out;
+  const uint64_t m = pattern.size();
+  for (const DocHit& h : idx.locate_documents(pattern, limit)) {
+    // A pattern holding the separator can run past its document.
+    const uint64_t len = idx.document_length(h.doc);
+    if (h.offset + m > len) continue;
+    if (h.doc < k) out.push_back({h.doc, h.offset, Strand::PLUS});
+    else out.push_back({static_cast<uint32_t>(h.doc - k), len - h.offset - m, Strand::MINUS});
+  }
+  std::sort(out.begin(), out.end(), [](const StrandHit& a, const StrandHit& b) {
+    if (a.seq != b.seq) return a.seq < b.seq;
+    if (a.offset != b.offset) return a.offset < b.offset;
+    return a.strand < b.strand;
+  });
+  return out;
+}
+
+} // namespace cs
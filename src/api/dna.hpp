@@ -0,0 +1,62 @@
+#pragma once
+/**
+ * dna.hpp — Both-strand search for nucleotide text.
+ *
+ * A read can come from either strand, so it is usually searched twice:
+ * once as given and once as its reverse complement. build_both_strands
+ * indexes every sequence followed by its reverse complement as extra
+ * documents (the FMD-index layout). A pattern then occurs on the minus
+ * strand exactly where it occurs in a reverse-complement document, so one
+ * backward search finds the hits on both strands:
+ *   - count(P) on the index is count(P) + count(revcomp(P)) on the plain text
+ *   - locate_both_strands maps minus-strand hits back to forward coordinates
+ *
+ * The index is twice the size of a one-strand index. Reverse complements
+ * of palindromic patterns (P == revcomp(P)) are the pattern itself, so each
+ * of their sites is reported on both strands, as two searches would report it.
+ */
+
+#include "fm_index.hpp"
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace cs {
+
+/// A↔T, C↔G in either case; N, IUPAC codes and other bytes map to themselves.
+char complement(char c);
+std::string reverse_complement(std::string_view s);
+
+/**
+ * Builds over seqs[0..k) followed by their reverse complements: document
+ * k + i is the minus strand of document i. Throws like build_from_documents.
+ */
+FMIndex build_both_strands(std::span<const std::string_view> seqs, const BuildParams& p);
+FMIndex build_both_strands(std::string_view seq, const BuildParams& p);
+
+enum class Strand : uint8_t { PLUS, MINUS };
+
+/**
+ * One hit in forward coordinates: the pattern (PLUS) or its reverse
+ * complement (MINUS) occurs at seq[offset, offset + |pattern|).
+ */
+struct StrandHit {
+  uint32_t seq = 0;
+  uint64_t offset = 0;
+  Strand strand = Strand::PLUS;
+  bool operator==(const StrandHit&) const = default;
+};
+
+/// Sequences per strand; throws std::invalid_argument unless idx looks like a build_both_strands index.
+size_t strand_sequences(const FMIndex& idx);
+
+/**
+ * Hits on both strands (up to limit) from one backward search, by (seq,
+ * offset, strand). Matches that cross a sequence boundary (only possible
+ * for patterns holding the separator byte) are dropped.
+ */
+std::vector<StrandHit> locate_both_strands(const FMIndex& idx, std::string_view pattern, size_t limit=100000);
+
+} // namespace cs
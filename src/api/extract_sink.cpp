@@ -0,0 +1,124 @@
+/**
+ * extract_sink.cpp — Buffer, stream and writev sinks.
+ */
+
+#include "extract_sink.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace cs {
+
+void BufferSink::write(const char* data, size_t len) {
+  if (len > capacity_ - size_) throw std::out_of_range("BufferSink: capacity exceeded");
+  std::memcpy(out_ + size_, data, len);
+  size_ += len;
+}
+
+char* BufferSink::claim(size_t len) {
+  if (len > capacity_ - size_) throw std::out_of_range("BufferSink: capacity exceeded");
+  size_ += len;
+  return out_ + size_ - len;
+}
+
+void StreamSink::write(const char* data, size_t len) {
+  os_.write(data, static_cast<std::streamsize>(len));
+  if (!os_) throw std::runtime_error("StreamSink: write failed");
+}
+
+void StreamSink::flush() {
+  os_.flush();
+  if (!os_) throw std::runtime_error("StreamSink: flush failed");
+}
+
+// ──────────────────────────────────────────────────────────────
+// FdSink: Copy transient pieces, reference stable ones, writev
+// ──────────────────────────────────────────────────────────────
+
+FdSink::FdSink(int fd, size_t buffer_bytes) : fd_(fd), buf_(std::max<size_t>(buffer_bytes, 1)) {
+  pieces_.reserve(MAX_PIECES);
+}
+
+FdSink::~FdSink() {
+  try {
+    flush();
+  } catch (const std::runtime_error&) {
+    // Destructors must not throw; call flush() to see write errors.
+  }
+}
+
+void FdSink::push(const char* data, size_t len) {
+  if (len == 0) return;
+  if (!pieces_.empty() && pieces_.back().first + pieces_.back().second == data) {
+    pieces_.back().second += len;
+  } else {
+    pieces_.emplace_back(data, len);
+  }
+  if (pieces_.size() == MAX_PIECES) flush();
+}
+
+void FdSink::copy(const char* data, size_t len) {
+  if (len > buf_.size() - used_) flush();
+  std::memcpy(buf_.data() + used_, data, len);
+  used_ += len;
+  push(buf_.data() + used_ - len, len);
+}
+
+void FdSink::write(const char* data, size_t len) {
+  if (len <= buf_.size()) return copy(data, len);
+  // Too big to stage: write it straight from the caller's memory.
+  push(data, len);
+  flush();
+}
+
+void FdSink::write_stable(const char* data, size_t len) {
+  if (len <= COPY_LIMIT && len <= buf_.size()) return copy(data, len);
+  push(data, len);
+}
+
+void FdSink::flush() {
+  size_t first = 0;
+  while (first < pieces_.size()) {
+#ifdef _WIN32
+    auto& [data, len] = pieces_[first];
+    const int chunk = static_cast<int>(std::min<size_t>(len, 1u << 30));
+    const long long w = _write(fd_, data, static_cast<unsigned>(chunk));
+#else
+    iovec iov[MAX_PIECES];
+    const size_t count = pieces_.size() - first;
+    for (size_t i = 0; i < count; ++i) {
+      iov[i].iov_base = const_cast<char*>(pieces_[first + i].first);
+      iov[i].iov_len = pieces_[first + i].second;
+    }
+    const ssize_t w = ::writev(fd_, iov, static_cast<int>(count));
+#endif
+    ++syscalls_;
+    if (w < 0) {
+      if (errno == EINTR) continue;
+      pieces_.clear();
+      used_ = 0;
+      throw std::runtime_error(std::string("FdSink: write failed: ") + std::strerror(errno));
+    }
+    // Drop what was written; a partial write resumes inside a piece.
+    size_t left = static_cast<size_t>(w);
+    written_ += left;
+    while (first < pieces_.size() && left >= pieces_[first].second) left -= pieces_[first++].second;
+    if (left) {
+      pieces_[first].first += left;
+      pieces_[first].second -= left;
+    }
+  }
+  pieces_.clear();
+  used_ = 0;
+}
+
+} // namespace cs
@@ -0,0 +1,102 @@
+#pragma once
+/**
+ * extract_sink.hpp — Destinations for FMIndex::extract_to.
+ *
+ * extract() builds a std::string per call. extract_to hands the bytes to a
+ * sink instead, in pieces of at most EXTRACT_CHUNK bytes, so exporting a
+ * large range needs O(chunk) memory and no copy beyond the destination:
+ *   - a plain index passes slices of its stored text (write_stable)
+ *   - a packed index decodes each chunk into the sink's own memory when it
+ *     offers some (claim), else into one reused buffer (write)
+ *
+ * Sinks:
+ *   BufferSink  caller's char buffer; throws out_of_range when it is full
+ *   StreamSink  std::ostream; throws runtime_error when the stream fails
+ *   FdSink      file descriptor; small pieces are copied into a buffer,
+ *               large stable ones referenced, and all written with one
+ *               writev per batch (a _write loop on Windows)
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+namespace cs {
+
+/// Largest piece extract_to passes to a sink, and the size of its decode buffer.
+constexpr size_t EXTRACT_CHUNK = size_t(1) << 16;
+
+class ExtractSink {
+public:
+  virtual ~ExtractSink() = default;
+  /// data is only valid during the call.
+  virtual void write(const char* data, size_t len) = 0;
+  /// data stays valid until the next flush(), e.g. the index's own text, so it may be kept by pointer.
+  virtual void write_stable(const char* data, size_t len) { write(data, len); }
+  /// Room for the next len bytes, to be filled in place, or nullptr to use write().
+  virtual char* claim(size_t /*len*/) { return nullptr; }
+  virtual void flush() {}
+};
+
+class BufferSink : public ExtractSink {
+public:
+  BufferSink(char* out, size_t capacity) : out_(out), capacity_(capacity) {}
+  void write(const char* data, size_t len) override;
+  char* claim(size_t len) override;
+  size_t size() const { return size_; }
+
+private:
+  char* out_;
+  size_t capacity_;
+  size_t size_ = 0;
+};
+
+class StreamSink : public ExtractSink {
+public:
+  explicit StreamSink(std::ostream& os) : os_(os) {}
+  void write(const char* data, size_t len) override;
+  void flush() override;
+
+private:
+  std::ostream& os_;
+};
+
+/**
+ * FdSink — Gathers pieces and writes them with writev. Transient pieces
+ * and stable ones up to COPY_LIMIT bytes are copied into a buffer of
+ * buffer_bytes; larger stable ones are referenced in place. Flushes when
+ * the buffer or the iovec batch is full, on flush() and (ignoring errors)
+ * on destruction. The fd is not closed.
+ */
+class FdSink : public ExtractSink {
+public:
+  static constexpr size_t MAX_PIECES = 64;
+  static constexpr size_t COPY_LIMIT = 1024;  // Below this a copy is cheaper than an iovec
+
+  explicit FdSink(int fd, size_t buffer_bytes = EXTRACT_CHUNK);
+  ~FdSink() override;
+  FdSink(const FdSink&) = delete;
+  FdSink& operator=(const FdSink&) = delete;
+
+  void write(const char* data, size_t len) override;
+  void write_stable(const char* data, size_t len) override;
+  void flush() override;
+
+  uint64_t bytes_written() const { return written_; }
+  uint64_t syscalls() const { return syscalls_; }
+
+private:
+  void push(const char* data, size_t len);
+  void copy(const char* data, size_t len);
+
+  int fd_;
+  std::vector<char> buf_;
+  size_t used_ = 0;
+  std::vector<std::pair<const char*, size_t>> pieces_;
+  uint64_t written_ = 0;
+  uint64_t syscalls_ = 0;
+};
+
+} // namespace cs
@@ -2,44 +2,83 @@
 #include "../core/sais.hpp"
 #include "../core/bwt.hpp"
 #include "../util/timer.hpp"
+#include "../serialization/serialization.hpp"
 #include <array>
+#include <cstring>
 #include <algorithm>
 #include <stdexcept>
 #include <filesystem>
 
 namespace cs {
 
+// ──────────────────────────────────────────────────────────────
+// Fold tables
+// ──────────────────────────────────────────────────────────────
+
+FoldTable identity_fold() {
+  FoldTable t;
+  for (unsigned c = 0; c < 256; ++c) t[c] = static_cast<uint8_t>(c);
+  return t;
+}
+
+FoldTable ascii_case_fold() {
+  FoldTable t = identity_fold();
+  for (unsigned c = 'A'; c <= 'Z'; ++c) t[c] = static_cast<uint8_t>(c + 32);
+  return t;
+}
+
+FoldTable latin1_case_fold() {
+  FoldTable t = ascii_case_fold();
+  for (unsigned c = 0xC0; c <= 0xDE; ++c)
+    if (c != 0xD7) t[c] = static_cast<uint8_t>(c + 32);
+  return t;
+}
+
 // ──────────────────────────────────────────────────────────────
 // build_from_text: Construct FM-index from input text
 // ──────────────────────────────────────────────────────────────
 
-FMIndex FMIndex::build_from_text(const std::string& text, const BuildParams& p) {
+FMIndex FMIndex::build_from_text(const std::string& original, const BuildParams& p) {
   FMIndex idx;
-  idx.text_ = text;
-  idx.meta_.n = text.size();
+  idx.text_ = original;
+  idx.meta_.n = original.size();
+  if (p.ssa_stride == 0) throw std::invalid_argument("ssa_stride must be positive");
+  if (p.pack_dna) dna_bases(p.fold ? *p.fold : identity_fold());  // Reject a clashing fold up front
+
+  // 0) Folding: every structure below is built over the folded text, and
+  //    text_ keeps the original for extract().
+  std::string folded;
+  if (p.fold) {
+    idx.fold_ = *p.fold;
+    idx.folded_ = true;
+    folded = idx.fold(original);
+  }
+  const std::string& text = p.fold ? folded : original;
 
-  // NOTE: For correct FM-index operation, text should include a unique terminator
-  // (e.g., '$' or '\0') that is lexicographically smaller than all other characters.
-  // This ensures the BWT is well-defined and unambiguous.
+  // NOTE: The BWT is taken over text + a virtual terminator that sorts before
+  // every byte. The terminator occupies row 0 of the SA (the empty suffix) and
+  // is stored as '\0' in the BWT at row meta_.primary; occ() discounts it.
 
-  // 1) Build suffix array (naive O(n^2 log n) for now).
+  // 1) Build suffix array (naive O(n^2 log n) for now), prefixed by the
+  //    empty suffix n.
   ScopeTimer t1("build_sa_naive");
-  idx.sa_ = build_sa_naive(idx.text_);
+  idx.sa_ = build_sa_naive(text);
+  idx.sa_.insert(idx.sa_.begin(), static_cast<uint32_t>(text.size()));
   (void)t1;
 
   // 2) Build BWT from SA.
   ScopeTimer t2("build_bwt");
-  idx.bwt_ = build_bwt_from_sa(text, idx.sa_);
+  idx.bwt_ = build_bwt_with_terminator(text, idx.sa_, idx.meta_.primary);
   (void)t2;
 
-  // 3) Build C array (cumulative character counts).
+  // 3) Build C array (cumulative character counts, offset by the terminator).
   idx.C_.assign(257, 0u);
   std::array<uint32_t, 256> freq{};
   freq.fill(0);
-  for (unsigned char ch : idx.bwt_) {
+  for (unsigned char ch : text) {
     freq[ch]++;
   }
-  uint32_t cum = 0;
+  uint32_t cum = 1;
   for (int c = 0; c < 256; ++c) {
     idx.C_[c] = cum;
     cum += freq[c];
@@ -58,13 +97,76 @@ FMIndex FMIndex::build_from_text(const std::string& text, const BuildParams& p)
   idx.ssa_.stride = p.ssa_stride;
   const size_t num_samples = (idx.sa_.size() + p.ssa_stride - 1) / p.ssa_stride;
   idx.ssa_.samples.resize(num_samples);
+  for (size_t i = 0; i < idx.sa_.size(); i += p.ssa_stride) {
+    idx.ssa_.samples[i / p.ssa_stride] = idx.sa_[i];
+  }
+  // ISA samples at the same stride, for extract_forward / extract_backward.
+  idx.isa_samples_.assign(text.size() / p.ssa_stride + 1, 0);
   for (size_t i = 0; i < idx.sa_.size(); ++i) {
-    if (i % p.ssa_stride == 0) {
-      idx.ssa_.samples[i / p.ssa_stride] = idx.sa_[i];
-    }
+    if (idx.sa_[i] % p.ssa_stride == 0) idx.isa_samples_[idx.sa_[i] / p.ssa_stride] = static_cast<uint32_t>(i);
   }
   (void)t4;
 
+  // 6) Optional reversed-text BWT for bidirectional search. The reversed
+  //    text has the same symbol counts, so C is shared.
+  if (p.bidirectional) {
+    ScopeTimer t5("build_reverse_bwt");
+    const std::string rev(text.rbegin(), text.rend());
+    std::vector<uint32_t> rsa = build_sa_naive(rev);
+    rsa.insert(rsa.begin(), static_cast<uint32_t>(rev.size()));
+    const std::string rbwt = build_bwt_with_terminator(rev, rsa, idx.rev_primary_);
+    idx.rev_wavelet_.build(std::vector<uint8_t>(rbwt.begin(), rbwt.end()));
+    (void)t5;
+  }
+
+  // 7) Optional LCP array, from the SA built in step 1.
+  if (p.lcp) {
+    ScopeTimer t6("build_lcp");
+    idx.lcp_.build(text, idx.sa_, p.lcp_encoding);
+    (void)t6;
+  }
+
+  // 8) Optional 2-bit packing; the byte copies are dropped.
+  if (p.pack_dna) idx.pack();
+
+  return idx;
+}
+
+// ──────────────────────────────────────────────────────────────
+// build_from_documents: Separator-joined collection + start bitvector
+// ──────────────────────────────────────────────────────────────
+
+FMIndex FMIndex::build_from_documents(std::span<const std::string_view> docs, const BuildParams& p) {
+  if (docs.empty()) throw std::invalid_argument("build_from_documents: no documents");
+  for (unsigned c = 0; p.fold && c < 256; ++c) {
+    if (((*p.fold)[c] == p.doc_separator) != (c == p.doc_separator)) {
+      throw std::invalid_argument("build_from_documents: fold table moves bytes to or from the separator");
+    }
+  }
+  std::string text;
+  size_t total = docs.size() - 1;
+  for (const auto& d : docs) total += d.size();
+  text.reserve(total);
+
+  std::vector<uint8_t> starts(total + 1, 0);
+  for (size_t i = 0; i < docs.size(); ++i) {
+    if (docs[i].find(static_cast<char>(p.doc_separator)) != std::string_view::npos) {
+      throw std::invalid_argument("build_from_documents: document " + std::to_string(i) +
+                                  " contains the separator byte");
+    }
+    if (i > 0) text += static_cast<char>(p.doc_separator);
+    starts[text.size()] = 1;
+    text.append(docs[i]);
+  }
+
+  FMIndex idx = build_from_text(text, p);
+  idx.doc_starts_.build(starts);
+  idx.doc_sep_ = p.doc_separator;
+
+  // Document array: DA[i] = document holding suffix SA[i].
+  std::vector<uint32_t> da(idx.sa_.size());
+  for (size_t i = 0; i < da.size(); ++i) da[i] = idx.to_document(idx.sa_[i]).doc;
+  idx.doc_array_.build(da);
   return idx;
 }
 
@@ -73,87 +175,557 @@ FMIndex FMIndex::open_directory(const std::string&) {
 }
 
 // ──────────────────────────────────────────────────────────────
-// count: FM backward search for pattern occurrences
+// save / load: Single-file .csidx persistence
 // ──────────────────────────────────────────────────────────────
 
-uint64_t FMIndex::count(std::string_view pattern) const {
-  if (pattern.empty()) return meta_.n;
-  if (meta_.n == 0) return 0;
+void FMIndex::save(const std::string& path) const {
+  IndexWriter writer(path);
+  writer.write_header(FLAG_NONE, meta_.n);
+  const std::string bwt = packed_ ? packed_bwt_string() : bwt_;
+  writer.write_text(packed_ ? packed_text_.str() : text_);
+  writer.write_bwt(std::vector<uint8_t>(bwt.begin(), bwt.end()));
+  writer.write_c_array(C_);
+  writer.write_ssa(ssa_.samples, ssa_.stride);
+
+  std::vector<uint64_t> bits;
+  std::vector<uint32_t> supers;
+  std::vector<uint16_t> subs;
+  for (int l = 0; l < 8; ++l) {
+    const BitVector& bv = wavelet_.level(l);
+    const size_t words = (bv.size() + 63) / 64;
+    bits.insert(bits.end(), bv.bits().begin(), bv.bits().begin() + words);
+    supers.insert(supers.end(), bv.super_blocks().begin(), bv.super_blocks().end());
+    subs.insert(subs.end(), bv.sub_blocks().begin(), bv.sub_blocks().end());
+  }
+  writer.write_wavelet(bits, supers, subs, 8);
+
+  IndexMetaRecord meta;
+  meta.rows = meta_.n + 1;
+  meta.primary = meta_.primary;
+  writer.write_meta(meta);
+
+  if (doc_starts_.size()) {
+    std::vector<uint64_t> ext = {doc_sep_, num_documents()};
+    for (size_t d = 0; d < num_documents(); ++d) ext.push_back(document_start(d));
+    writer.write_extension(EXT_DOCUMENTS, ext.data(), ext.size() * sizeof(uint64_t));
+
+    std::vector<uint64_t> da = {doc_array_.size(), doc_array_.width()};
+    for (uint32_t l = 0; l < doc_array_.width(); ++l) {
+      const BitVector& bv = doc_array_.level(l);
+      da.insert(da.end(), bv.bits().begin(), bv.bits().begin() + (bv.size() + 63) / 64);
+    }
+    writer.write_extension(EXT_DOC_ARRAY, da.data(), da.size() * sizeof(uint64_t));
+  }
+  if (bidirectional()) {
+    std::vector<uint64_t> rb = {rev_wavelet_.size(), rev_primary_};
+    for (int l = 0; l < 8; ++l) {
+      const BitVector& bv = rev_wavelet_.level(l);
+      rb.insert(rb.end(), bv.bits().begin(), bv.bits().begin() + (bv.size() + 63) / 64);
+    }
+    writer.write_extension(EXT_REVERSE_BWT, rb.data(), rb.size() * sizeof(uint64_t));
+  }
+  if (has_lcp() && lcp_.encoding() == LcpEncoding::PLCP) {
+    const BitVector& bv = lcp_.plcp_bits();
+    const std::vector<uint32_t> minima = lcp_.block_minima();
+    std::vector<uint64_t> pl = {lcp_.size(), bv.size(), minima.size()};
+    pl.insert(pl.end(), bv.bits().begin(), bv.bits().begin() + (bv.size() + 63) / 64);
+    const size_t at = pl.size();
+    pl.resize(at + (minima.size() + 1) / 2, 0);
+    std::memcpy(pl.data() + at, minima.data(), minima.size() * sizeof(uint32_t));
+    writer.write_extension(EXT_PLCP, pl.data(), pl.size() * sizeof(uint64_t));
+  } else if (has_lcp()) {
+    std::vector<uint64_t> lc = {lcp_.size(), lcp_.overflow().size()};
+    for (const auto& [row, v] : lcp_.overflow()) lc.push_back(uint64_t(row) << 32 | v);
+    const size_t at = lc.size();
+    lc.resize(at + (lcp_.size() + 7) / 8, 0);
+    std::memcpy(lc.data() + at, lcp_.bytes().data(), lcp_.size());
+    writer.write_extension(EXT_LCP, lc.data(), lc.size() * sizeof(uint64_t));
+  }
+  if (folded_) writer.write_extension(EXT_FOLD, fold_.data(), fold_.size());
+  if (packed_) {
+    const uint64_t flag = 1;
+    writer.write_extension(EXT_PACKED_DNA, &flag, sizeof(flag));
+  }
+  std::vector<uint32_t> isa = isa_samples_;
+  isa.resize((isa.size() + 1) / 2 * 2, 0);
+  writer.write_extension(EXT_ISA_SAMPLES, isa.data(), isa.size() * sizeof(uint32_t));
+  writer.finalize();
+}
+
+FMIndex FMIndex::load(const std::string& path) {
+  IndexReader reader(path);
+  const IndexMetaRecord* meta = reader.get_meta();
+  if (meta == nullptr) throw std::runtime_error("load: missing meta section: " + path);
+
+  FMIndex idx;
+  idx.meta_.n = reader.header()->text_len;
+  idx.meta_.primary = meta->primary;
+
+  size_t len = 0;
+  const char* text = reader.get_text(&len);
+  if (text == nullptr || len != idx.meta_.n) throw std::runtime_error("load: bad text section");
+  idx.text_.assign(text, len);
+
+  const uint8_t* bwt = reader.get_bwt(&len);
+  if (bwt == nullptr || len != meta->rows) throw std::runtime_error("load: bad BWT section");
+  idx.bwt_.assign(reinterpret_cast<const char*>(bwt), len);
 
-  // FM backward search: start with full BWT range [0, n).
-  uint64_t sp = 0;
-  uint64_t ep = meta_.n;
+  const uint32_t* C = reader.get_c_array(&len);
+  if (C == nullptr || len != 257) throw std::runtime_error("load: bad C array");
+  idx.C_.assign(C, C + len);
 
-  // Process pattern from right to left.
-  for (auto it = pattern.rbegin(); it != pattern.rend(); ++it) {
-    const uint8_t c = static_cast<uint8_t>(*it);
-    
-    // Update range: sp' = C[c] + occ(c, sp), ep' = C[c] + occ(c, ep).
-    sp = C_[c] + occ(c, sp);
-    ep = C_[c] + occ(c, ep);
+  uint32_t stride = 0;
+  const uint32_t* samples = reader.get_ssa(&len, &stride);
+  if (samples == nullptr || stride == 0) throw std::runtime_error("load: bad SSA section");
+  idx.ssa_.stride = stride;
+  idx.ssa_.samples.assign(samples, samples + len);
 
-    // If range becomes empty, pattern doesn't occur.
-    if (sp >= ep) return 0;
+  size_t words = 0, levels = 0;
+  const uint64_t* bits = reader.get_wavelet_bits(&words, &levels);
+  if (bits == nullptr || levels != 8 || words != 8 * ((meta->rows + 63) / 64)) {
+    throw std::runtime_error("load: bad wavelet section");
   }
+  idx.wavelet_.build_from_level_words(bits, meta->rows);
 
-  // Number of occurrences = size of final range.
-  return ep - sp;
+  size_t bytes = 0;
+  if (const uint8_t* ext = reader.get_extension(EXT_DOCUMENTS, &bytes)) {
+    std::vector<uint64_t> words(bytes / sizeof(uint64_t));
+    std::memcpy(words.data(), ext, words.size() * sizeof(uint64_t));
+    if (words.size() < 2 || words.size() != 2 + words[1]) throw std::runtime_error("load: bad documents section");
+    std::vector<uint8_t> starts(idx.meta_.n + 1, 0);
+    for (size_t d = 0; d < words[1]; ++d) {
+      if (words[2 + d] > idx.meta_.n) throw std::runtime_error("load: bad document start");
+      starts[words[2 + d]] = 1;
+    }
+    idx.doc_starts_.build(starts);
+    idx.doc_sep_ = static_cast<uint8_t>(words[0]);
+
+    const uint8_t* da = reader.get_extension(EXT_DOC_ARRAY, &bytes);
+    uint64_t head[2] = {};
+    if (da == nullptr || bytes < sizeof(head)) throw std::runtime_error("load: missing document array");
+    std::memcpy(head, da, sizeof(head));
+    const size_t level_words = (head[0] + 63) / 64;
+    if (head[0] != meta->rows || head[1] == 0 || head[1] > 32 ||
+        bytes != sizeof(head) + head[1] * level_words * sizeof(uint64_t)) {
+      throw std::runtime_error("load: bad document array");
+    }
+    std::vector<uint64_t> level_bits(head[1] * level_words);
+    std::memcpy(level_bits.data(), da + sizeof(head), level_bits.size() * sizeof(uint64_t));
+    idx.doc_array_.build_from_level_words(level_bits.data(), head[0], static_cast<uint32_t>(head[1]));
+  }
+  if (const uint8_t* rb = reader.get_extension(EXT_REVERSE_BWT, &bytes)) {
+    uint64_t head[2] = {};
+    const size_t level_words = (meta->rows + 63) / 64;
+    if (bytes != sizeof(head) + 8 * level_words * sizeof(uint64_t)) throw std::runtime_error("load: bad reverse BWT");
+    std::memcpy(head, rb, sizeof(head));
+    if (head[0] != meta->rows || head[1] >= meta->rows) throw std::runtime_error("load: bad reverse BWT");
+    std::vector<uint64_t> level_bits(8 * level_words);
+    std::memcpy(level_bits.data(), rb + sizeof(head), level_bits.size() * sizeof(uint64_t));
+    idx.rev_wavelet_.build_from_level_words(level_bits.data(), head[0]);
+    idx.rev_primary_ = head[1];
+  }
+  if (const uint8_t* lc = reader.get_extension(EXT_LCP, &bytes)) {
+    uint64_t head[2] = {};
+    if (bytes < sizeof(head)) throw std::runtime_error("load: bad LCP section");
+    std::memcpy(head, lc, sizeof(head));
+    if (head[0] != meta->rows || bytes != sizeof(head) + (head[1] + (head[0] + 7) / 8) * sizeof(uint64_t)) {
+      throw std::runtime_error("load: bad LCP section");
+    }
+    std::vector<std::pair<uint32_t, uint32_t>> overflow(head[1]);
+    for (size_t i = 0; i < head[1]; ++i) {
+      uint64_t w = 0;
+      std::memcpy(&w, lc + sizeof(head) + i * sizeof(uint64_t), sizeof(w));
+      overflow[i] = {static_cast<uint32_t>(w >> 32), static_cast<uint32_t>(w)};
+    }
+    const uint8_t* rows = lc + sizeof(head) + head[1] * sizeof(uint64_t);
+    idx.lcp_.build_from(std::vector<uint8_t>(rows, rows + head[0]), std::move(overflow));
+  }
+  if (const uint8_t* pl = reader.get_extension(EXT_PLCP, &bytes)) {
+    uint64_t head[3] = {};
+    if (bytes < sizeof(head)) throw std::runtime_error("load: bad PLCP section");
+    std::memcpy(head, pl, sizeof(head));
+    const size_t words = (head[1] + 63) / 64;
+    if (head[0] != meta->rows || head[1] != 2 * idx.meta_.n + 1 ||
+        head[2] != (head[0] + LcpArray::BLOCK - 1) / LcpArray::BLOCK ||
+        bytes != sizeof(head) + (words + (head[2] + 1) / 2) * sizeof(uint64_t)) {
+      throw std::runtime_error("load: bad PLCP section");
+    }
+    std::vector<uint64_t> bits(words);
+    std::memcpy(bits.data(), pl + sizeof(head), words * sizeof(uint64_t));
+    std::vector<uint32_t> minima(head[2]);
+    std::memcpy(minima.data(), pl + sizeof(head) + words * sizeof(uint64_t), minima.size() * sizeof(uint32_t));
+    idx.lcp_.build_from_plcp(bits, head[1], head[0], minima);
+  }
+  if (const uint8_t* ft = reader.get_extension(EXT_FOLD, &bytes)) {
+    if (bytes != idx.fold_.size()) throw std::runtime_error("load: bad fold table");
+    std::memcpy(idx.fold_.data(), ft, bytes);
+    idx.folded_ = true;
+  }
+  if (reader.get_extension(EXT_PACKED_DNA, &bytes)) idx.pack();
+  const size_t isa_count = idx.meta_.n / stride + 1;
+  if (const uint8_t* is = reader.get_extension(EXT_ISA_SAMPLES, &bytes)) {
+    if (bytes != (isa_count + 1) / 2 * 2 * sizeof(uint32_t)) throw std::runtime_error("load: bad ISA samples");
+    idx.isa_samples_.resize(isa_count);
+    std::memcpy(idx.isa_samples_.data(), is, isa_count * sizeof(uint32_t));
+  } else {
+    idx.build_isa_samples_by_lf();  // Files written before the ISA samples
+  }
+  return idx;
 }
 
 // ──────────────────────────────────────────────────────────────
-// locate: Find positions of pattern occurrences
+// SA intervals: Incremental backward search
 // ──────────────────────────────────────────────────────────────
 
-std::vector<uint64_t> FMIndex::locate(std::string_view pattern, size_t limit) const {
-  std::vector<uint64_t> positions;
-  if (pattern.empty() || meta_.n == 0) return positions;
+SAInterval FMIndex::extend_left(const SAInterval& iv, uint8_t c) const {
+  if (iv.empty()) return {0, 0, iv.len + 1};
+  c = fold_[c];
+  // sp' = C[c] + occ(c, sp), ep' = C[c] + occ(c, ep).
+  const uint64_t sp = C_[c] + occ(c, iv.sp);
+  const uint64_t ep = C_[c] + occ(c, iv.ep);
+  if (sp >= ep) return {0, 0, iv.len + 1};
+  return {sp, ep, iv.len + 1};
+}
 
-  // 1) FM backward search to find range [sp, ep).
-  uint64_t sp = 0;
-  uint64_t ep = meta_.n;
+SAInterval FMIndex::extend_left(const SAInterval& iv, std::string_view prefix) const {
+  SAInterval out = iv;
+  for (auto it = prefix.rbegin(); it != prefix.rend(); ++it) {
+    if (out.empty()) {
+      out.len += prefix.rend() - it;
+      out.sp = out.ep = 0;
+      break;
+    }
+    out = extend_left(out, static_cast<uint8_t>(*it));
+  }
+  return out;
+}
 
-  for (auto it = pattern.rbegin(); it != pattern.rend(); ++it) {
-    const uint8_t c = static_cast<uint8_t>(*it);
-    sp = C_[c] + occ(c, sp);
-    ep = C_[c] + occ(c, ep);
-    if (sp >= ep) return positions;
+// ──────────────────────────────────────────────────────────────
+// Bidirectional extension
+// ──────────────────────────────────────────────────────────────
+
+/**
+ * Extends bi by c on the side whose BWT is wt (terminator at row primary).
+ * `same` is that side's start, `other` the opposite side's. The terminator
+ * is stored as byte 0 and sorts before every symbol: it is removed from c's
+ * counts when c == 0 and is always one of the "smaller" rows.
+ */
+static BiInterval extend_side(const WaveletTree& wt, uint64_t primary, const std::vector<uint32_t>& C,
+                              uint64_t same, uint64_t other, uint64_t size, uint64_t len, uint8_t c,
+                              bool left) {
+  const uint64_t ep = same + size;
+  RangeRank r = wt.range_rank(c, same, ep);
+  const bool term_in = same <= primary && primary < ep;
+  if (c == 0) {
+    if (primary < same) --r.before;
+    if (term_in) {
+      --r.inside;
+      r.less = 1;
+    }
   }
+  if (r.inside == 0) return {0, 0, 0, len + 1};
+  const uint64_t moved = C[c] + r.before, kept = other + r.less;
+  return left ? BiInterval{moved, kept, r.inside, len + 1} : BiInterval{kept, moved, r.inside, len + 1};
+}
 
-  // 2) For each position in [sp, ep), recover text position via SSA + LF.
-  positions.reserve(std::min<size_t>(ep - sp, limit));
+BiInterval FMIndex::extend_left(const BiInterval& bi, uint8_t c) const {
+  if (!bidirectional()) throw std::logic_error("extend_left(BiInterval): index is not bidirectional");
+  if (bi.empty()) return {0, 0, 0, bi.len + 1};
+  return extend_side(wavelet_, meta_.primary, C_, bi.fwd, bi.rev, bi.size, bi.len, fold_[c], true);
+}
 
-  for (uint64_t i = sp; i < ep && positions.size() < limit; ++i) {
-    uint64_t bwt_pos = i;
-    uint64_t steps = 0;
+BiInterval FMIndex::extend_right(const BiInterval& bi, uint8_t c) const {
+  if (!bidirectional()) throw std::logic_error("extend_right: index is not bidirectional");
+  if (bi.empty()) return {0, 0, 0, bi.len + 1};
+  return extend_side(rev_wavelet_, rev_primary_, C_, bi.rev, bi.fwd, bi.size, bi.len, fold_[c], false);
+}
+
+// ──────────────────────────────────────────────────────────────
+// smems: Forward extension from x, then backward extension of every
+// distinct-interval prefix (Li 2012)
+// ──────────────────────────────────────────────────────────────
+
+size_t FMIndex::smem_at(std::string_view q, size_t x, SmemWorkspace& ws, std::vector<Smem>& out) const {
+  auto& prev = ws.prev;
+  auto& curr = ws.curr;
+  BiInterval ik = extend_right(bi_full_interval(), static_cast<uint8_t>(q[x]));
+  if (ik.empty()) return x + 1;
+  uint32_t end = static_cast<uint32_t>(x + 1);
+
+  // Forward: keep each prefix q[x, i) whose occurrence count drops next.
+  curr.clear();
+  size_t i = x + 1;
+  for (; i < q.size(); ++i) {
+    const BiInterval ok = extend_right(ik, static_cast<uint8_t>(q[i]));
+    if (ok.size != ik.size) curr.push_back({ik, end});
+    if (ok.empty()) break;
+    ik = ok;
+    end = static_cast<uint32_t>(i + 1);
+  }
+  if (i == q.size()) curr.push_back({ik, end});
+  std::reverse(curr.begin(), curr.end());  // Longest match first
+  const size_t next = curr[0].end;
+  std::swap(prev, curr);
 
-    // Walk backwards via LF until we hit a sampled position.
-    while (bwt_pos % ssa_.stride != 0 && steps < meta_.n) {
-      bwt_pos = LF(bwt_pos);
-      ++steps;
+  // Backward: extend all candidates left together; the longest candidate
+  // that cannot be extended at a column is an SMEM unless contained in one
+  // already reported.
+  const size_t first = out.size();
+  for (ptrdiff_t b = static_cast<ptrdiff_t>(x) - 1; b >= -1; --b) {
+    curr.clear();
+    for (const auto& p : prev) {
+      const BiInterval ok = b >= 0 ? extend_left(p.iv, static_cast<uint8_t>(q[b])) : BiInterval{};
+      if (ok.empty()) {
+        const uint32_t begin = static_cast<uint32_t>(b + 1);
+        if (curr.empty() && (out.size() == first || begin < out.back().begin)) {
+          out.push_back({begin, p.end, to_interval(p.iv)});
+        }
+      } else if (curr.empty() || ok.size != curr.back().iv.size) {
+        curr.push_back({ok, p.end});
+      }
     }
+    if (curr.empty()) break;
+    std::swap(prev, curr);
+  }
+  std::reverse(out.begin() + first, out.end());
+  return next;
+}
+
+void FMIndex::smems(std::string_view query, size_t min_len, SmemWorkspace& ws, std::vector<Smem>& out) const {
+  if (!bidirectional()) throw std::logic_error("smems: index is not bidirectional");
+  out.clear();
+  for (size_t x = 0; x < query.size();) x = smem_at(query, x, ws, out);
+  out.erase(std::remove_if(out.begin(), out.end(), [&](const Smem& s) { return s.length() < min_len; }),
+            out.end());
+}
+
+std::vector<Smem> FMIndex::smems(std::string_view query, size_t min_len) const {
+  SmemWorkspace ws;
+  std::vector<Smem> out;
+  smems(query, min_len, ws, out);
+  return out;
+}
 
-    // Safety check.
-    if (steps >= meta_.n) {
-      throw std::runtime_error("locate: LF walk exceeded text length");
+// ──────────────────────────────────────────────────────────────
+// Matching statistics: Backward search that widens to the parent node
+// ──────────────────────────────────────────────────────────────
+
+template <class Fn>
+void FMIndex::matching_pass(std::string_view q, Fn&& fn) const {
+  if (!has_lcp()) throw std::logic_error("matching_statistics: index built without BuildParams::lcp");
+  const uint64_t rows = meta_.n + 1;
+  auto lcp_at = [this](size_t k) { return lcp(k); };
+  SAInterval iv = full_interval();
+  for (size_t i = q.size(); i-- > 0;) {
+    const uint8_t c = static_cast<uint8_t>(q[i]);
+    for (;;) {
+      const SAInterval next = extend_left(iv, c);
+      if (!next.empty()) {
+        iv = next;
+        break;
+      }
+      if (iv.len == 0) break;  // c does not occur at all
+      // Every prefix longer than the enclosing node's depth has the same
+      // rows, so it fails too: drop straight to that depth.
+      const uint32_t depth = std::max(lcp(iv.sp), iv.ep < rows ? lcp(iv.ep) : 0u);
+      if (depth == 0) {
+        iv = full_interval();
+      } else {
+        iv = {lcp_.prev_smaller(iv.sp, depth, lcp_at), lcp_.next_smaller(iv.ep, depth, lcp_at), depth};
+      }
     }
+    fn(i, iv);
+  }
+}
+
+std::vector<uint32_t> FMIndex::matching_statistics(std::string_view query) const {
+  std::vector<uint32_t> ms(query.size());
+  matching_pass(query, [&](size_t i, const SAInterval& iv) { ms[i] = static_cast<uint32_t>(iv.len); });
+  return ms;
+}
+
+CommonSubstring FMIndex::longest_common_substring(std::string_view query) const {
+  CommonSubstring best;
+  matching_pass(query, [&](size_t i, const SAInterval& iv) {
+    if (iv.len > 0 && iv.len >= best.length) best = {static_cast<uint32_t>(i), static_cast<uint32_t>(iv.len), iv};
+  });
+  return best;
+}
 
-    // Now bwt_pos is sampled: SA[bwt_pos] is stored.
-    const uint64_t sample_idx = bwt_pos / ssa_.stride;
-    if (sample_idx >= ssa_.samples.size()) {
-      throw std::runtime_error("locate: SSA sample index out of range: idx=" + 
-                               std::to_string(sample_idx) + ", size=" + 
-                               std::to_string(ssa_.samples.size()));
+// ──────────────────────────────────────────────────────────────
+// count: FM backward search for pattern occurrences
+// ──────────────────────────────────────────────────────────────
+
+uint64_t FMIndex::count(std::string_view pattern) const {
+  if (pattern.empty()) return meta_.n;
+  if (meta_.n == 0) return 0;
+  return interval(pattern).size();
+}
+
+// ──────────────────────────────────────────────────────────────
+// locate: Find positions of pattern occurrences
+// ──────────────────────────────────────────────────────────────
+
+std::vector<uint64_t> FMIndex::locate(std::string_view pattern, size_t limit) const {
+  if (pattern.empty() || meta_.n == 0) return {};
+  return locate(interval(pattern), limit);
+}
+
+std::vector<uint64_t> FMIndex::locate(const SAInterval& iv, size_t limit) const {
+  std::vector<uint64_t> positions;
+  if (iv.empty() || iv.len == 0) return positions;
+
+  // For each row in [sp, ep), recover text position via SSA + LF.
+  positions.reserve(std::min<uint64_t>(iv.size(), limit));
+
+  for (uint64_t i = iv.sp; i < iv.ep && positions.size() < limit; ++i) positions.push_back(sa_at(i));
+  std::sort(positions.begin(), positions.end());
+  return positions;
+}
+
+std::vector<uint64_t> FMIndex::locate_smallest(std::string_view pattern, size_t limit) const {
+  if (pattern.empty() || meta_.n == 0) return {};
+  return locate_smallest(interval(pattern), limit);
+}
+
+std::vector<uint64_t> FMIndex::locate_smallest(const SAInterval& iv, size_t limit) const {
+  if (limit >= iv.size()) return locate(iv, limit);
+  std::vector<uint64_t> positions;
+  if (iv.len == 0 || limit == 0) return positions;
+
+  // Rows are not in text order: locate all of them and keep the smallest
+  // `limit` in a max-heap, so the result is a prefix callers can merge.
+  positions.reserve(limit);
+  for (uint64_t i = iv.sp; i < iv.ep; ++i) {
+    const uint64_t p = sa_at(i);
+    if (positions.size() < limit) {
+      positions.push_back(p);
+      std::push_heap(positions.begin(), positions.end());
+    } else if (p < positions.front()) {
+      std::pop_heap(positions.begin(), positions.end());
+      positions.back() = p;
+      std::push_heap(positions.begin(), positions.end());
     }
-    const uint64_t sa_val = ssa_.samples[sample_idx];
+  }
+  std::sort(positions.begin(), positions.end());
+  return positions;
+}
 
-    // LF-mapping walks backwards in the BWT, which corresponds to prepending characters.
-    // If SA[sampled_pos] = k, and we walked 'steps' backwards via LF,
-    // then we're looking at the suffix starting at position (k + steps) % n.
-    const uint64_t text_pos = (sa_val + steps) % meta_.n;
-    positions.push_back(text_pos);
+uint64_t FMIndex::sa_at(uint64_t row) const {
+  uint64_t bwt_pos = row;
+  uint64_t steps = 0;
+  // Walk backwards via LF until we hit a sampled position.
+  while (bwt_pos % ssa_.stride != 0 && steps <= meta_.n) {
+    bwt_pos = LF(bwt_pos);
+    ++steps;
   }
 
-  return positions;
+  // Safety check.
+  if (steps > meta_.n) {
+    throw std::runtime_error("locate: LF walk exceeded text length");
+  }
+
+  // Now bwt_pos is sampled: SA[bwt_pos] is stored.
+  const uint64_t sample_idx = bwt_pos / ssa_.stride;
+  if (sample_idx >= ssa_.samples.size()) {
+    throw std::runtime_error("locate: SSA sample index out of range: idx=" + 
+                             std::to_string(sample_idx) + ", size=" + 
+                             std::to_string(ssa_.samples.size()));
+  }
+  const uint64_t sa_val = ssa_.samples[sample_idx];
+
+  // LF-mapping walks backwards in the BWT, which corresponds to prepending characters.
+  // If SA[sampled_pos] = k, and we walked 'steps' backwards via LF,
+  // then we're looking at the suffix starting at position (k + steps) mod (n+1).
+  return (sa_val + steps) % (meta_.n + 1);
+}
+
+uint64_t FMIndex::psi(uint64_t row) const {
+  if (row == 0) return meta_.primary;
+  // Row holds a suffix starting with c: find the (row - C[c] + 1)-th c in the
+  // BWT, stepping over the terminator, which the wavelet tree stores as '\0'.
+  const uint8_t c = f_symbol(row);
+  uint64_t k = row - C_[c] + 1;
+  if (c == 0 && k > wavelet_.rank(0, meta_.primary)) ++k;
+  return wavelet_.select(c, k);
+}
+
+// ──────────────────────────────────────────────────────────────
+// Documents: rank/select over the start bitvector
+// ──────────────────────────────────────────────────────────────
+
+uint64_t FMIndex::document_start(size_t d) const {
+  if (!doc_starts_.size()) return 0;
+  return doc_starts_.select1(d + 1);
+}
+
+uint64_t FMIndex::document_length(size_t d) const {
+  const uint64_t start = document_start(d);
+  const uint64_t end = d + 1 < num_documents() ? document_start(d + 1) - 1 : meta_.n;
+  return end - start;
+}
+
+DocHit FMIndex::to_document(uint64_t pos) const {
+  if (!doc_starts_.size()) return {0, pos};
+  const size_t d = doc_starts_.rank1(pos + 1) - 1;
+  return {static_cast<uint32_t>(d), pos - doc_starts_.select1(d + 1)};
+}
+
+std::vector<DocHit> FMIndex::locate_documents(std::string_view pattern, size_t limit) const {
+  const std::vector<uint64_t> positions = locate(pattern, limit);
+  std::vector<DocHit> hits;
+  hits.reserve(positions.size());
+  for (uint64_t pos : positions) hits.push_back(to_document(pos));
+  return hits;
+}
+
+std::vector<uint32_t> FMIndex::list_documents(std::string_view pattern, size_t k) const {
+  std::vector<uint32_t> docs;
+  if (k == 0 || pattern.empty()) return docs;
+  const SAInterval iv = interval(pattern);
+  if (iv.empty()) return docs;
+  if (!doc_starts_.size()) return {0};
+  doc_array_.range_distinct(iv.sp, iv.ep, [&](uint32_t d, size_t) {
+    docs.push_back(d);
+    return docs.size() < k;
+  });
+  return docs;
+}
+
+std::vector<DocFreq> FMIndex::doc_frequency(std::string_view pattern) const {
+  std::vector<DocFreq> out;
+  if (pattern.empty()) return out;
+  const SAInterval iv = interval(pattern);
+  if (iv.empty()) return out;
+  if (!doc_starts_.size()) return {{0, iv.size()}};
+  doc_array_.range_distinct(iv.sp, iv.ep, [&](uint32_t d, size_t f) {
+    out.push_back({d, f});
+    return true;
+  });
+  return out;
+}
+
+std::vector<DocFreq> FMIndex::top_k_documents(std::string_view pattern, size_t k) const {
+  std::vector<DocFreq> out;
+  if (k == 0 || pattern.empty()) return out;
+  const SAInterval iv = interval(pattern);
+  if (iv.empty()) return out;
+  if (!doc_starts_.size()) return {{0, iv.size()}};
+  for (const auto& [d, f] : doc_array_.top_k(iv.sp, iv.ep, k)) out.push_back({d, f});
+  return out;
+}
+
+std::vector<uint32_t> FMIndex::filter_documents(std::string_view pattern,
+                                                std::span<const uint32_t> docs) const {
+  std::vector<uint32_t> out;
+  if (docs.empty() || pattern.empty()) return out;
+  const SAInterval iv = interval(pattern);
+  if (iv.empty()) return out;
+  if (!doc_starts_.size()) return std::vector<uint32_t>(docs.begin(), docs.end());
+  for (uint32_t d : docs) {
+    if (doc_array_.rank(d, iv.ep) > doc_array_.rank(d, iv.sp)) out.push_back(d);
+  }
+  return out;
 }
 
 // ──────────────────────────────────────────────────────────────
@@ -161,9 +733,189 @@ std::vector<uint64_t> FMIndex::locate(std::string_view pattern, size_t limit) co
 // ──────────────────────────────────────────────────────────────
 
 std::string FMIndex::extract(uint64_t p, uint64_t len) const {
+  if (packed_) return packed_text_.extract(p, len);
   if (p >= text_.size()) return {};
   len = std::min<uint64_t>(len, text_.size() - p);
   return text_.substr(p, len);
 }
 
+// ──────────────────────────────────────────────────────────────
+// extract_to: Stored text in place, or packed text chunk by chunk
+// ──────────────────────────────────────────────────────────────
+
+void FMIndex::extract_chunks(uint64_t pos, uint64_t len, ExtractSink& sink, std::vector<char>& buf) const {
+  const uint64_t end = pos + len;
+  for (uint64_t at = pos; at < end; at += EXTRACT_CHUNK) {
+    const size_t piece = static_cast<size_t>(std::min<uint64_t>(EXTRACT_CHUNK, end - at));
+    if (!packed_) {
+      sink.write_stable(text_.data() + at, piece);
+      continue;
+    }
+    if (char* direct = sink.claim(piece)) {
+      packed_text_.extract(at, piece, direct);
+      continue;
+    }
+    if (buf.size() < piece) buf.resize(piece);
+    sink.write(buf.data(), packed_text_.extract(at, piece, buf.data()));
+  }
+}
+
+uint64_t FMIndex::extract_to(uint64_t pos, uint64_t len, ExtractSink& sink) const {
+  if (pos >= meta_.n) return 0;
+  len = std::min<uint64_t>(len, meta_.n - pos);
+  std::vector<char> buf;
+  extract_chunks(pos, len, sink, buf);
+  return len;
+}
+
+std::vector<ExtractPlacement> FMIndex::extract_to(std::span<const ExtractRange> ranges, ExtractSink& sink) const {
+  // (pos, input index), sorted in place: cheaper than sorting indices by an indirect key.
+  std::vector<std::pair<uint64_t, size_t>> order(ranges.size());
+  for (size_t i = 0; i < order.size(); ++i) order[i] = {ranges[i].pos, i};
+  if (!std::is_sorted(order.begin(), order.end())) std::sort(order.begin(), order.end());
+  std::vector<ExtractPlacement> out(ranges.size());
+  std::vector<char> buf;
+  uint64_t offset = 0;
+  for (const auto& [pos, i] : order) {
+    const ExtractRange& r = ranges[i];
+    const uint64_t len = r.pos < meta_.n ? std::min<uint64_t>(r.len, meta_.n - r.pos) : 0;
+    extract_chunks(r.pos, len, sink, buf);
+    out[i] = {offset, len};
+    offset += len;
+  }
+  return out;
+}
+
+// ──────────────────────────────────────────────────────────────
+// extract_forward / extract_backward: psi or LF from an ISA sample
+// ──────────────────────────────────────────────────────────────
+
+uint64_t FMIndex::extract_forward(uint64_t pos, uint64_t len, char* out) const {
+  if (pos >= meta_.n) return 0;
+  len = std::min<uint64_t>(len, meta_.n - pos);
+  const uint32_t stride = ssa_.stride;
+  uint64_t row = isa_samples_[pos / stride];
+  for (uint64_t at = pos / stride * stride; at < pos; ++at) row = psi(row);
+  for (uint64_t i = 0; i < len; ++i) {
+    out[i] = static_cast<char>(f_symbol(row));
+    row = psi(row);
+  }
+  return len;
+}
+
+std::string FMIndex::extract_forward(uint64_t pos, uint64_t len) const {
+  if (pos >= meta_.n) return {};
+  std::string out(std::min<uint64_t>(len, meta_.n - pos), '\0');
+  extract_forward(pos, len, out.data());
+  return out;
+}
+
+std::string FMIndex::extract_backward(uint64_t pos, uint64_t len) const {
+  if (pos >= meta_.n) return {};
+  const uint64_t end = pos + std::min<uint64_t>(len, meta_.n - pos);
+  const uint32_t stride = ssa_.stride;
+  // Suffix at = min(k · stride, n); row 0 is the empty suffix n.
+  const uint64_t k = (end + stride - 1) / stride;
+  uint64_t at = k < isa_samples_.size() ? k * stride : meta_.n;
+  uint64_t row = k < isa_samples_.size() ? isa_samples_[k] : 0;
+  std::string out(end - pos, '\0');
+  for (; at > pos; --at) {
+    // BWT[row] is the symbol before suffix at, i.e. T[at - 1].
+    const uint8_t c = static_cast<uint8_t>(packed_ ? packed_bwt_at(row) : bwt_[row]);
+    row = LF(row);
+    if (at <= end) out[at - 1 - pos] = static_cast<char>(c);
+  }
+  return out;
+}
+
+void FMIndex::build_isa_samples_by_lf() {
+  const uint32_t stride = ssa_.stride;
+  isa_samples_.assign(meta_.n / stride + 1, 0);
+  uint64_t row = 0;  // Suffix n
+  for (uint64_t at = meta_.n;; --at) {
+    if (at % stride == 0) isa_samples_[at / stride] = static_cast<uint32_t>(row);
+    if (at == 0) break;
+    row = LF(row);
+  }
+}
+
+// ──────────────────────────────────────────────────────────────
+// DNA packing: text and BWT to 2-bit form
+// ──────────────────────────────────────────────────────────────
+
+std::array<char, 4> FMIndex::dna_bases(const FoldTable& fold) {
+  std::array<char, 4> bases;
+  std::array<bool, 256> image{};
+  for (unsigned c = 0; c < 256; ++c) image[fold[c]] = true;
+  for (int k = 0; k < 4; ++k) bases[k] = static_cast<char>(fold[static_cast<uint8_t>("ACGT"[k])]);
+  for (int k = 0; k < 4; ++k) {
+    const char base = "ACGT"[k];
+    const bool coded = std::find(bases.begin(), bases.end(), base) != bases.end();
+    if (std::count(bases.begin(), bases.end(), bases[k]) > 1 || (image[static_cast<uint8_t>(base)] && !coded)) {
+      throw std::invalid_argument("pack_dna: fold table must keep A, C, G, T distinct from each other and other bytes");
+    }
+  }
+  return bases;
+}
+
+void FMIndex::pack() {
+  bwt_bases_ = dna_bases(fold_);
+  bwt_code_.fill(-1);
+  for (int k = 0; k < 4; ++k) bwt_code_[static_cast<uint8_t>(bwt_bases_[k])] = static_cast<int8_t>(k);
+  packed_text_.build(text_);
+  if (folded_) {
+    // DnaOcc codes A/C/G/T: rename the folded bases to them first.
+    std::string canon(bwt_);
+    for (auto& b : canon) {
+      const int code = bwt_code_[static_cast<uint8_t>(b)];
+      if (code >= 0) b = "ACGT"[code];
+    }
+    packed_bwt_.build(canon);
+  } else {
+    packed_bwt_.build(bwt_);
+  }
+  packed_ = true;
+  std::string().swap(text_);
+  std::string().swap(bwt_);
+}
+
+std::string FMIndex::packed_bwt_string() const {
+  std::string out(meta_.n + 1, '\0');
+  for (size_t i = 0; i < out.size(); ++i) out[i] = packed_bwt_at(i);
+  return out;
+}
+
+size_t FMIndex::text_and_bwt_bytes() const {
+  return packed_ ? packed_text_.size_in_bytes() + packed_bwt_.size_in_bytes() : text_.size() + bwt_.size();
+}
+
+size_t FMIndex::size_in_bytes() const {
+  auto wavelet = [](const WaveletTree& w) {
+    size_t b = 0;
+    for (int l = 0; l < 8 && w.size(); ++l) b += w.level(l).size_in_bytes();
+    return b;
+  };
+  size_t b = text_and_bwt_bytes() + wavelet(wavelet_) + wavelet(rev_wavelet_);
+  b += (C_.size() + sa_.size() + ssa_.samples.size() + isa_samples_.size()) * sizeof(uint32_t);
+  b += doc_starts_.size_in_bytes() + lcp_.size_in_bytes();
+  for (uint32_t l = 0; l < doc_array_.width(); ++l) b += doc_array_.level(l).size_in_bytes();
+  return b;
+}
+
+std::string FMIndex::fold(std::string_view s) const {
+  std::string out(s);
+  if (folded_) {
+    for (auto& c : out) c = static_cast<char>(fold_[static_cast<uint8_t>(c)]);
+  }
+  return out;
+}
+
+std::vector<uint64_t> FMIndex::locate_exact(std::string_view pattern, size_t limit) const {
+  std::vector<uint64_t> out = locate(pattern, folded_ ? SIZE_MAX : limit);
+  if (!folded_) return out;
+  std::erase_if(out, [&](uint64_t pos) { return extract(pos, pattern.size()) != pattern; });
+  if (out.size() > limit) out.resize(limit);
+  return out;
+}
+
 } // namespace cs
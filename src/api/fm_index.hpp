@@ -1,24 +1,151 @@
 #pragma once
+#include <algorithm>
+#include <array>
+#include <optional>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <cstdint>
+#include <stdexcept>
+#include "../core/bitvector.hpp"
+#include "../core/wavelet_matrix.hpp"
 #include "../core/wavelet.hpp"
 #include "../core/wavelet_learned.hpp"
 #include "../core/ssa.hpp"
+#include "../core/lcp.hpp"
+#include "../core/packed_dna.hpp"
+#include "extract_sink.hpp"
 
 namespace cs {
 
+/// Byte map applied to the text at build time and to every query byte.
+using FoldTable = std::array<uint8_t, 256>;
+
+FoldTable identity_fold();
+FoldTable ascii_case_fold();   // 'A'-'Z' → 'a'-'z'; leaves UTF-8 multi-byte sequences intact
+FoldTable latin1_case_fold();  // ASCII plus Latin-1 À-Þ (but ×) → à-þ; for Latin-1 text only
+
 struct BuildParams {
   uint32_t S = 512, s = 64, ssa_stride = 32;
   double eps = 1.0;
+  uint8_t doc_separator = 0x1E;  // Byte placed between documents (ASCII RS)
+  bool bidirectional = false;    // Also index the reversed text (smems, extend_right)
+  bool lcp = false;              // Also store the LCP array (matching_statistics, SuffixTree)
+  LcpEncoding lcp_encoding = LcpEncoding::BYTES;  // PLCP: ~3 bits per row, slower access
+  std::optional<FoldTable> fold;  // Index fold(text): e.g. case-insensitive search
+  bool pack_dna = false;         // Keep text and BWT 2 bits per base (packed_dna.hpp); see FMIndex::packed_dna
+};
+struct IndexMeta {
+  uint64_t n = 0;          // Text length.
+  uint32_t sigma = 256;
+  uint64_t primary = 0;    // BWT row of the virtual terminator.
+};
+
+/// A text position expressed as (document, offset within that document).
+struct DocHit {
+  uint32_t doc = 0;
+  uint64_t offset = 0;
+  bool operator==(const DocHit&) const = default;
+};
+
+/// Documents containing a pattern, with the pattern's frequency in each.
+struct DocFreq {
+  uint32_t doc = 0;
+  uint64_t freq = 0;
+  bool operator==(const DocFreq&) const = default;
+};
+
+/// Text bytes [pos, pos + len) for FMIndex::extract_to.
+struct ExtractRange {
+  uint64_t pos = 0;
+  uint64_t len = 0;
+};
+
+/// Where extract_to(ranges, sink) wrote one range: output bytes [offset, offset + len).
+struct ExtractPlacement {
+  uint64_t offset = 0;
+  uint64_t len = 0;
+  bool operator==(const ExtractPlacement&) const = default;
+};
+
+/**
+ * SAInterval — Suffix-array rows [sp, ep) prefixed by a pattern of length
+ * len. Obtained from FMIndex::full_interval() / interval() and grown one
+ * symbol at a time with extend_left(); plain values, cheap to cache.
+ * Empty intervals are always {0, 0, len}, so == compares matches.
+ */
+struct SAInterval {
+  uint64_t sp = 0, ep = 0;
+  uint64_t len = 0;          // Length of the matched pattern
+  bool empty() const { return sp >= ep; }
+  uint64_t size() const { return empty() ? 0 : ep - sp; }
+  bool operator==(const SAInterval&) const = default;
+};
+
+/**
+ * BiInterval — A pattern's rows in the forward index [fwd, fwd + size) and,
+ * in the same order of occurrences, in the reversed-text index
+ * [rev, rev + size). Lets a match grow at either end (FMD-style).
+ */
+struct BiInterval {
+  uint64_t fwd = 0, rev = 0, size = 0;
+  uint64_t len = 0;
+  bool empty() const { return size == 0; }
+  bool operator==(const BiInterval&) const = default;
+};
+
+/// Super-maximal exact match: query[begin, end) with its forward SA interval.
+struct Smem {
+  uint32_t begin = 0, end = 0;
+  SAInterval iv;
+  uint32_t length() const { return end - begin; }
+  bool operator==(const Smem&) const = default;
+};
+
+/// Longest query substring found in the text: query[query_pos, +length), rows iv.
+struct CommonSubstring {
+  uint32_t query_pos = 0, length = 0;
+  SAInterval iv;
+  bool operator==(const CommonSubstring&) const = default;
+};
+
+/// Reusable buffers for FMIndex::smems; keep one per thread.
+struct SmemWorkspace {
+  struct Candidate {
+    BiInterval iv;
+    uint32_t end = 0;
+  };
+  std::vector<Candidate> prev, curr;
 };
-struct IndexMeta { uint64_t n = 0; uint32_t sigma = 256; };
 
 class FMIndex {
 public:
+  /**
+   * Builds over text followed by a virtual terminator that sorts before every
+   * byte, so text need not end in a unique '$' (an explicit one is harmless).
+   */
   static FMIndex build_from_text(const std::string& text, const BuildParams& p);
   static FMIndex open_directory(const std::string& dir); // TODO: on-disk format
 
+  /**
+   * Builds over docs joined by p.doc_separator and records each document's
+   * start in a rank/select bitvector. Throws std::invalid_argument if a
+   * document contains the separator. Patterns containing the separator can
+   * match across document boundaries.
+   */
+  static FMIndex build_from_documents(std::span<const std::string_view> docs, const BuildParams& p);
+
+  /**
+   * save(path) / load(path) — Single-file .csidx format (serialization.hpp).
+   * load() restores the wavelet levels from their stored bits.
+   */
+  void save(const std::string& path) const;
+  static FMIndex load(const std::string& path);
+
+  /// Length of the indexed text.
+  uint64_t size() const { return meta_.n; }
+
   /**
    * count(pattern) — Number of occurrences of pattern in the indexed text.
    * Uses FM backward search with wavelet tree rank queries.
@@ -26,43 +153,331 @@ public:
   uint64_t count(std::string_view pattern) const;
 
   /**
-   * locate(pattern, limit) — Positions where pattern occurs (up to limit).
+   * locate(pattern, limit) — Positions where pattern occurs (up to limit),
+   * in ascending text order. With more than `limit` occurrences these come
+   * from the first `limit` SA rows, an arbitrary subset; locate_smallest()
+   * returns the `limit` smallest instead.
    * Uses FM backward search + SSA to recover text positions.
    */
   std::vector<uint64_t> locate(std::string_view pattern, size_t limit=100000) const;
+  std::vector<uint64_t> locate_smallest(std::string_view pattern, size_t limit) const;
+
+  /**
+   * Incremental backward search. full_interval() matches the empty pattern
+   * (all n+1 rows, including the terminator's); extend_left(iv, c) turns the
+   * interval of P into that of cP with two occ() calls. An empty interval
+   * stays empty. count/locate(pattern) are interval(pattern) plus
+   * size()/locate(interval).
+   */
+  SAInterval full_interval() const { return {0, meta_.n + 1, 0}; }
+  SAInterval extend_left(const SAInterval& iv, uint8_t c) const;
+  /// Prepends a whole string (processed right to left).
+  SAInterval extend_left(const SAInterval& iv, std::string_view prefix) const;
+  SAInterval interval(std::string_view pattern) const { return extend_left(full_interval(), pattern); }
+
+  /// Text positions of the interval's first `limit` rows, ascending; one sa_at per returned
+  /// position. An interval of length 0 locates nothing.
+  std::vector<uint64_t> locate(const SAInterval& iv, size_t limit=100000) const;
+
+  /// The `limit` smallest text positions of the interval, ascending. Results of disjoint
+  /// intervals or shards merge into a correct prefix, but this costs one sa_at per row.
+  std::vector<uint64_t> locate_smallest(const SAInterval& iv, size_t limit) const;
+
+  /// SA[row] (row 0 is the empty suffix, n): an LF walk to the nearest SSA sample.
+  uint64_t sa_at(uint64_t row) const;
+
+  /**
+   * psi(row) — Inverse of LF: the row of suffix SA[row] + 1 (row 0 maps to
+   * the row of the whole text). The row's first symbol c is found from C;
+   * psi is then the position of the matching c in the BWT, one
+   * WaveletTree::select.
+   */
+  uint64_t psi(uint64_t row) const;
+
+  /**
+   * Bidirectional search (index built with BuildParams::bidirectional).
+   * Each extension is one range_rank descent on the forward or reversed
+   * BWT; the other side's start moves by the count of smaller symbols.
+   * The extend calls throw std::logic_error on a unidirectional index.
+   */
+  bool bidirectional() const { return rev_wavelet_.size() != 0; }
+  BiInterval bi_full_interval() const { return {0, 0, meta_.n + 1, 0}; }
+  BiInterval extend_left(const BiInterval& bi, uint8_t c) const;   // c·P
+  BiInterval extend_right(const BiInterval& bi, uint8_t c) const;  // P·c
+
+  /**
+   * Every one-symbol extension of a non-empty match, ascending by symbol,
+   * from one range_symbols descent instead of a rank pair per byte value:
+   *   for_each_left_extension(iv, fn)   fn(c, interval of c·P)
+   *   for_each_left_extension(bi, fn)   fn(c, BiInterval of c·P) (bidirectional only)
+   *   for_each_right_extension(bi, fn)  fn(c, BiInterval of P·c) (bidirectional only)
+   * Occurrences at the start (left) or end (right) of the text have no
+   * extension, so the sizes reported can sum to less than the match's.
+   */
+  template <class Fn> void for_each_left_extension(const SAInterval& iv, Fn&& fn) const {
+    for_each_left_extension(iv, [](unsigned, unsigned) { return true; }, fn);
+  }
+  /// Only symbols in subtrees [lo, hi) passing allow(lo, hi) are descended into.
+  template <class Allow, class Fn>
+  void for_each_left_extension(const SAInterval& iv, Allow&& allow, Fn&& fn) const;
+  template <class Fn> void for_each_left_extension(const BiInterval& bi, Fn&& fn) const;
+  template <class Fn> void for_each_right_extension(const BiInterval& bi, Fn&& fn) const;
+
+  SAInterval to_interval(const BiInterval& bi) const {
+    return bi.empty() ? SAInterval{0, 0, bi.len} : SAInterval{bi.fwd, bi.fwd + bi.size, bi.len};
+  }
+
+  /**
+   * smems(query, min_len) — Super-maximal exact matches of at least min_len
+   * bytes, by start: every query[b, e) that occurs in the text, cannot be
+   * extended either way, and is not inside another such match. Uses the
+   * forward/backward extension scheme of BWA-MEM's SMEM finder. The
+   * workspace overload reuses ws and out (no allocation once warm).
+   */
+  std::vector<Smem> smems(std::string_view query, size_t min_len = 1) const;
+  void smems(std::string_view query, size_t min_len, SmemWorkspace& ws, std::vector<Smem>& out) const;
+
+  /**
+   * matching_statistics(query) — ms[i] is the length of the longest prefix
+   * of query[i..] that occurs in the text. One right-to-left pass: when
+   * extend_left fails, the interval widens to its enclosing suffix-tree node
+   * (LCP prev/next smaller values) instead of restarting, so the pass costs
+   * at most 2·|query| backward steps. Needs BuildParams::lcp; throws
+   * std::logic_error otherwise.
+   *
+   * longest_common_substring(query) — The longest ms[i] (leftmost on ties)
+   * with its interval; locate(lcs.iv) gives the text positions.
+   */
+  bool has_lcp() const { return lcp_.size() != 0; }
+  const LcpArray& lcp_array() const { return lcp_; }
+  /// LCP[row]; a PLCP index pays one sa_at per call.
+  uint32_t lcp(uint64_t row) const {
+    return lcp_.encoding() == LcpEncoding::BYTES ? lcp_[row] : lcp_.plcp(sa_at(row));
+  }
+  std::vector<uint32_t> matching_statistics(std::string_view query) const;
+  CommonSubstring longest_common_substring(std::string_view query) const;
 
   /**
    * extract(pos, len) — Extract substring from indexed text.
    */
   std::string extract(uint64_t pos, uint64_t len) const;
 
+  /**
+   * Extraction from the index structures alone (the stored text is not
+   * read), via the ISA samples taken every ssa_stride positions:
+   *   extract_forward   psi steps left to right from the sample at or
+   *                     before pos; each symbol is F[row], read from C
+   *   extract_backward  LF steps right to left from the sample at or after
+   *                     pos + len, filling the output from the end
+   * A folded index returns folded bytes. The buffer form writes up to len
+   * bytes to out and returns how many.
+   */
+  std::string extract_forward(uint64_t pos, uint64_t len) const;
+  uint64_t extract_forward(uint64_t pos, uint64_t len, char* out) const;
+  std::string extract_backward(uint64_t pos, uint64_t len) const;
+
+  /**
+   * extract_to(pos, len, sink) — extract() without building a string: the
+   * bytes go to sink in pieces of at most EXTRACT_CHUNK, so the extra memory
+   * is one chunk whatever len is. Returns the bytes written (len, clipped).
+   *
+   * extract_to(ranges, sink) — Many ranges through one decode buffer. They
+   * are written in order of position, so a packed text is decoded front to
+   * back; result[i] says where ranges[i] landed in the output.
+   */
+  uint64_t extract_to(uint64_t pos, uint64_t len, ExtractSink& sink) const;
+  std::vector<ExtractPlacement> extract_to(std::span<const ExtractRange> ranges, ExtractSink& sink) const;
+
+  /**
+   * DNA packing. With BuildParams::pack_dna the text and the BWT are kept
+   * 2 bits per base instead of as bytes: extract() decodes from the packed
+   * text, and LF and occ() for A/C/G/T read one interleaved counts-and-bases
+   * block instead of descending the 8-level wavelet tree. Other bytes are
+   * exceptions and still go through the wavelet tree.
+   *
+   * With a fold the BWT holds folded bytes, so its 2-bit codes stand for
+   * fold(A), fold(C), fold(G), fold(T) (a, c, g, t under ascii_case_fold).
+   * Building throws std::invalid_argument if those four collide, or if
+   * some other byte folds to one of A/C/G/T that is not among them.
+   *
+   * The wavelet tree is kept in full (psi, range_symbols and bidirectional
+   * search use it), so packing saves the text and BWT bytes only; compare
+   * size_in_bytes() for the whole index.
+   */
+  bool packed_dna() const { return packed_; }
+  /// Bytes held by the text and BWT (packed or not), for comparing layouts.
+  size_t text_and_bwt_bytes() const;
+  /// Bytes held by the whole index, including the full SA a freshly built index keeps.
+  size_t size_in_bytes() const;
+
+  /**
+   * Folding. With BuildParams::fold the index is built over fold(text) and
+   * extend_left/extend_right fold every query byte, so all searches match
+   * under the table (ascii_case_fold: "Error" finds "ERROR" and "error").
+   * extract() still returns the original bytes, which locate_exact uses to
+   * keep only the occurrences that match the pattern exactly.
+   */
+  bool folded() const { return folded_; }
+  const FoldTable& fold_table() const { return fold_; }
+  std::string fold(std::string_view s) const;
+  std::vector<uint64_t> locate_exact(std::string_view pattern, size_t limit=100000) const;
+
+  /**
+   * Document queries. An index built from a single text is one document.
+   * to_document costs one rank and one select on the start bitvector.
+   */
+  size_t num_documents() const { return doc_starts_.size() ? doc_starts_.ones() : 1; }
+  uint64_t document_start(size_t d) const;
+  uint64_t document_length(size_t d) const;
+  DocHit to_document(uint64_t pos) const;
+
+  /// locate() mapped to (doc, offset), ordered by document then offset.
+  std::vector<DocHit> locate_documents(std::string_view pattern, size_t limit=100000) const;
+
+  /**
+   * Document listing over the document array (doc id of every SA row, in a
+   * wavelet matrix): each call costs one backward search plus
+   * O(d · log D) for the d distinct documents reported, independent of the
+   * number of occurrences.
+   *
+   * list_documents — first k documents containing pattern, ascending.
+   * doc_frequency  — every document containing pattern with its count.
+   * top_k_documents — the k documents with the highest count (ties by id).
+   */
+  std::vector<uint32_t> list_documents(std::string_view pattern, size_t k = SIZE_MAX) const;
+  std::vector<DocFreq> doc_frequency(std::string_view pattern) const;
+  std::vector<DocFreq> top_k_documents(std::string_view pattern, size_t k) const;
+
+  /**
+   * filter_documents(pattern, docs) — The subset of docs (ascending) that
+   * contain pattern. One backward search plus one document-array range rank
+   * per candidate, so cheap when docs is small next to the pattern's hits.
+   */
+  std::vector<uint32_t> filter_documents(std::string_view pattern, std::span<const uint32_t> docs) const;
+
 private:
   IndexMeta meta_;
-  std::string text_;                    // Original text (for extract/naive fallback).
-  std::string bwt_;                     // BWT string (for locate via LF).
+  std::string text_;                    // Original text (for extract/naive fallback; empty if packed_).
+  std::string bwt_;                     // BWT of text + terminator ('\0' at meta_.primary; empty if packed_).
+  PackedDna packed_text_;               // text_, 2 bits per base (pack_dna only).
+  DnaOcc packed_bwt_;                   // bwt_ with interleaved A/C/G/T counts (pack_dna only).
+  std::array<char, 4> bwt_bases_{};     // BWT byte of each DnaOcc code: fold of A, C, G, T.
+  std::array<int8_t, 256> bwt_code_{};  // DnaOcc code of a BWT byte, or -1 (pack_dna only).
+  bool packed_ = false;
   std::vector<uint32_t> sa_;            // Full SA (temp, for SSA construction).
-  std::vector<uint32_t> C_;             // Cumulative counts (byte alphabet).
+  std::vector<uint32_t> C_;             // C[c] = 1 + #symbols < c (row 0 is the terminator).
   WaveletTree wavelet_;                 // Binary wavelet tree for BWT.
   SSA ssa_;                             // Sampled suffix array.
+  std::vector<uint32_t> isa_samples_;   // Row of suffix k · ssa_.stride, for k · stride <= n.
+  BitVector doc_starts_;                // Bit p set where a document starts (n+1 bits; empty = one doc).
+  uint8_t doc_sep_ = 0;                 // Separator used by build_from_documents.
+  WaveletMatrix doc_array_;             // Document of SA[i] for every row (documents only).
+  WaveletTree rev_wavelet_;             // BWT of the reversed text (bidirectional only).
+  uint64_t rev_primary_ = 0;            // Terminator row of the reversed BWT.
+  LcpArray lcp_;                        // LCP by SA row (BuildParams::lcp only).
+  FoldTable fold_ = identity_fold();    // Applied to query bytes (identity unless folded_).
+  bool folded_ = false;
   
   // Legacy learned wavelet (kept for compatibility).
   std::vector<WaveletLevel> levels_;
 
   /**
    * occ(c, i) — Occurrences of symbol c in BWT[0..i).
-   * Delegates to wavelet tree.
+   * Delegates to wavelet tree; the terminator is stored as byte 0 and is
+   * discounted so it never matches a real '\0'.
    */
   inline uint64_t occ(uint8_t c, uint64_t i) const {
-    return wavelet_.rank(c, i);
+    if (packed_) {
+      const int code = bwt_code_[c];
+      if (code >= 0) return packed_bwt_.occ(static_cast<unsigned>(code), i);
+    }
+    const uint64_t r = wavelet_.rank(c, i);
+    return (c == 0 && meta_.primary < i) ? r - 1 : r;
+  }
+
+  void pack();
+  /// The four BWT bytes pack() codes as A/C/G/T under fold; throws if they cannot be.
+  static std::array<char, 4> dna_bases(const FoldTable& fold);
+  /// BWT[row] of a packed index.
+  char packed_bwt_at(uint64_t row) const {
+    const char b = packed_bwt_[row];
+    const int code = dna_code(static_cast<uint8_t>(b));
+    return code >= 0 ? bwt_bases_[code] : b;
   }
+  void build_isa_samples_by_lf();
+  /// First symbol of the suffix in row (row > 0): the c with C[c] <= row < C[c + 1].
+  uint8_t f_symbol(uint64_t row) const {
+    return static_cast<uint8_t>(std::upper_bound(C_.begin(), C_.end(), row) - C_.begin() - 1);
+  }
+  std::string packed_bwt_string() const;
+  /// extract_to for an already clipped range; buf is the packed decode buffer.
+  void extract_chunks(uint64_t pos, uint64_t len, ExtractSink& sink, std::vector<char>& buf) const;
+
+  /// Runs the matching-statistics pass; calls fn(i, interval of query[i, i + ms[i])).
+  template <class Fn> void matching_pass(std::string_view query, Fn&& fn) const;
+
+  /// Smems of the matches through query[x]; returns the next x.
+  size_t smem_at(std::string_view query, size_t x, SmemWorkspace& ws, std::vector<Smem>& out) const;
 
   /**
    * LF(i) — Last-to-First mapping: LF(i) = C[BWT[i]] + occ(BWT[i], i).
+   * The terminator row maps to row 0 (the empty suffix).
    */
   inline uint64_t LF(uint64_t i) const {
-    if (i >= bwt_.size()) return 0;
-    const uint8_t c = static_cast<uint8_t>(bwt_[i]);
+    if (i > meta_.n || i == meta_.primary) return 0;
+    const uint8_t c = static_cast<uint8_t>(packed_ ? packed_bwt_at(i) : bwt_[i]);
     return C_[c] + occ(c, i);
   }
 };
+
+// The terminator is stored as byte 0: it is dropped from symbol 0's counts
+// and, on the right, counted among the smaller rows.
+template <class Allow, class Fn>
+void FMIndex::for_each_left_extension(const SAInterval& iv, Allow&& allow, Fn&& fn) const {
+  if (iv.empty()) return;
+  wavelet_.range_symbols(iv.sp, iv.ep, allow, [&](uint8_t c, size_t before, size_t inside) {
+    if (c == 0) {
+      if (meta_.primary < iv.sp) --before;
+      if (iv.sp <= meta_.primary && meta_.primary < iv.ep) --inside;
+    }
+    if (inside > 0) fn(c, SAInterval{C_[c] + before, C_[c] + before + inside, iv.len + 1});
+  });
+}
+
+template <class Fn>
+void FMIndex::for_each_left_extension(const BiInterval& bi, Fn&& fn) const {
+  if (!bidirectional()) throw std::logic_error("for_each_left_extension(BiInterval): index is not bidirectional");
+  if (bi.empty()) return;
+  uint64_t less = 0;
+  wavelet_.range_symbols(bi.fwd, bi.fwd + bi.size, [&](uint8_t c, size_t before, size_t inside) {
+    if (c == 0) {
+      if (meta_.primary < bi.fwd) --before;
+      if (bi.fwd <= meta_.primary && meta_.primary < bi.fwd + bi.size) {
+        --inside;
+        less = 1;
+      }
+    }
+    if (inside > 0) fn(c, BiInterval{C_[c] + before, bi.rev + less, inside, bi.len + 1});
+    less += inside;
+  });
+}
+
+template <class Fn>
+void FMIndex::for_each_right_extension(const BiInterval& bi, Fn&& fn) const {
+  if (!bidirectional()) throw std::logic_error("for_each_right_extension: index is not bidirectional");
+  if (bi.empty()) return;
+  uint64_t less = 0;
+  rev_wavelet_.range_symbols(bi.rev, bi.rev + bi.size, [&](uint8_t c, size_t before, size_t inside) {
+    if (c == 0) {
+      if (rev_primary_ < bi.rev) --before;
+      if (bi.rev <= rev_primary_ && rev_primary_ < bi.rev + bi.size) {
+        --inside;
+        less = 1;
+      }
+    }
+    if (inside > 0) fn(c, BiInterval{bi.fwd + less, C_[c] + before, inside, bi.len + 1});
+    less += inside;
+  });
+}
+
 } // namespace cs
@@ -0,0 +1,130 @@
+/**
+ * int_fm_index.cpp — SA over ids, BWT in a wavelet matrix, samples.
+ */
+
+#include "int_fm_index.hpp"
+#include "../util/timer.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace cs {
+
+// ──────────────────────────────────────────────────────────────
+// build
+// ──────────────────────────────────────────────────────────────
+
+void IntFMIndex::build(const std::vector<uint32_t>& T, uint32_t sigma, uint32_t stride) {
+  if (stride == 0) throw std::invalid_argument("sample_stride must be positive");
+  if (T.size() >= UINT32_MAX) throw std::invalid_argument("IntFMIndex: sequence too large");
+  n_ = T.size();
+  stride_ = stride;
+
+  // SA prefixed by the empty suffix (as build_sa_naive).
+  ScopeTimer t1("int_build_sa");
+  std::vector<uint32_t> sa(n_ + 1);
+  for (uint32_t i = 0; i <= n_; ++i) sa[i] = i;
+  std::sort(sa.begin(), sa.end(), [&](uint32_t a, uint32_t b) {
+    return std::lexicographical_compare(T.begin() + a, T.end(), T.begin() + b, T.end());
+  });
+  (void)t1;
+
+  std::vector<uint32_t> bwt(n_ + 1);
+  std::vector<uint64_t> freq(size_t(sigma) + 2, 0);
+  for (uint32_t v : T) {
+    if (v == 0 || v > sigma) throw std::invalid_argument("IntFMIndex: id outside [1, sigma]");
+    ++freq[v];
+  }
+  for (size_t i = 0; i <= n_; ++i) bwt[i] = sa[i] ? T[sa[i] - 1] : 0;
+  C_.assign(size_t(sigma) + 2, 0);
+  uint64_t cum = 1;
+  for (size_t v = 1; v < C_.size(); ++v) {
+    C_[v] = cum;
+    cum += freq[v];
+  }
+  bwt_.build(bwt);
+
+  // SA by row; ISA by position, position n included.
+  sa_samples_.clear();
+  isa_samples_.clear();
+  for (size_t i = 0; i <= n_; i += stride_) sa_samples_.push_back(sa[i]);
+  std::vector<uint32_t> isa(n_ + 1);
+  for (size_t i = 0; i <= n_; ++i) isa[sa[i]] = static_cast<uint32_t>(i);
+  for (uint64_t k = 0;; k += stride_) {
+    isa_samples_.push_back(isa[std::min(k, n_)]);
+    if (k >= n_) break;
+  }
+}
+
+// ──────────────────────────────────────────────────────────────
+// Search
+// ──────────────────────────────────────────────────────────────
+
+SAInterval IntFMIndex::extend_left(const SAInterval& iv, uint32_t v) const {
+  if (iv.empty() || v == 0 || v >= C_.size()) return {0, 0, iv.len + 1};
+  const uint64_t sp = C_[v] + bwt_.rank(v, iv.sp), ep = C_[v] + bwt_.rank(v, iv.ep);
+  if (sp >= ep) return {0, 0, iv.len + 1};
+  return {sp, ep, iv.len + 1};
+}
+
+SAInterval IntFMIndex::interval(std::span<const uint32_t> ids) const {
+  SAInterval iv = full_interval();
+  for (size_t i = ids.size(); i-- > 0;) {
+    iv = extend_left(iv, ids[i]);
+    if (iv.empty()) return {0, 0, ids.size()};
+  }
+  return iv;
+}
+
+std::vector<uint64_t> IntFMIndex::locate(const SAInterval& iv, size_t limit) const {
+  std::vector<uint64_t> out;
+  if (iv.empty() || iv.len == 0) return out;
+  out.reserve(std::min<uint64_t>(iv.size(), limit));
+  for (uint64_t r = iv.sp; r < iv.ep && out.size() < limit; ++r) out.push_back(sa_at(r));
+  std::sort(out.begin(), out.end());
+  return out;
+}
+
+/// LF with the symbol it crosses; the terminator row maps to row 0.
+uint64_t IntFMIndex::lf(uint64_t row, uint32_t& v) const {
+  size_t r = 0;
+  v = bwt_.access_rank(row, r);
+  return v ? C_[v] + r : 0;
+}
+
+uint64_t IntFMIndex::sa_at(uint64_t row) const {
+  uint64_t steps = 0;
+  uint32_t v = 0;
+  while (row % stride_ != 0) {
+    row = lf(row, v);
+    ++steps;
+  }
+  return (sa_samples_[row / stride_] + steps) % (n_ + 1);
+}
+
+// ──────────────────────────────────────────────────────────────
+// extract: LF backwards from the next ISA sample
+// ──────────────────────────────────────────────────────────────
+
+std::vector<uint32_t> IntFMIndex::extract(uint64_t pos, uint64_t len) const {
+  if (pos >= n_) return {};
+  len = std::min(len, n_ - pos);  // Clip before adding: pos + len may wrap
+  const uint64_t end = pos + len;
+  const uint64_t k = (end + stride_ - 1) / stride_;
+  uint64_t at = std::min<uint64_t>(k * stride_, n_);
+  uint64_t row = isa_samples_[k];
+  std::vector<uint32_t> out(end - pos);
+  uint32_t v = 0;
+  for (; at > pos; --at) {
+    row = lf(row, v);  // v = T[at - 1]
+    if (at <= end) out[at - 1 - pos] = v;
+  }
+  return out;
+}
+
+size_t IntFMIndex::size_in_bytes() const {
+  size_t b = C_.size() * 8 + (sa_samples_.size() + isa_samples_.size()) * 4;
+  for (uint32_t l = 0; l < bwt_.width(); ++l) b += bitvector_bytes(bwt_.level(l));
+  return b;
+}
+
+} // namespace cs
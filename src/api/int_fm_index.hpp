@@ -0,0 +1,57 @@
+#pragma once
+/**
+ * int_fm_index.hpp — FM-index over an integer alphabet.
+ *
+ * Symbols are ids 1..σ (0 is the terminator). The BWT is kept in a
+ * WaveletMatrix of ceil(log2(σ + 1)) levels; SA and ISA are sampled every
+ * `stride` rows / positions for locate and extract. Shared by the
+ * token-level (WordIndex) and code-point (Utf8Index) front ends, which own
+ * the mapping between their symbols and ids.
+ */
+
+#include "fm_index.hpp"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace cs {
+
+class IntFMIndex {
+public:
+  /// T holds ids in [1, sigma]. Throws std::invalid_argument otherwise.
+  void build(const std::vector<uint32_t>& T, uint32_t sigma, uint32_t stride);
+
+  uint64_t size() const { return n_; }
+  uint32_t sigma() const { return static_cast<uint32_t>(C_.size()) - 2; }
+
+  SAInterval full_interval() const { return {0, n_ + 1, 0}; }
+  SAInterval extend_left(const SAInterval& iv, uint32_t v) const;
+  /// Backward search; any id outside [1, sigma] gives an empty interval.
+  SAInterval interval(std::span<const uint32_t> ids) const;
+
+  /// Positions of the interval's first `limit` rows, ascending. Like FMIndex::locate this is
+  /// an arbitrary subset when limit < iv.size(); there is no smallest-positions variant here.
+  std::vector<uint64_t> locate(const SAInterval& iv, size_t limit=100000) const;
+  /// Ids [pos, pos + len), clipped to the sequence.
+  std::vector<uint32_t> extract(uint64_t pos, uint64_t len) const;
+
+  size_t size_in_bytes() const;
+
+private:
+  uint64_t lf(uint64_t row, uint32_t& v) const;
+  uint64_t sa_at(uint64_t row) const;
+
+  uint64_t n_ = 0;
+  std::vector<uint64_t> C_{0, 1};       // C[v] = rows of suffixes starting below v
+  WaveletMatrix bwt_;                   // BWT of ids + terminator (id 0)
+  uint32_t stride_ = 32;
+  std::vector<uint32_t> sa_samples_;    // SA[i] for i % stride == 0
+  std::vector<uint32_t> isa_samples_;   // Row of suffix min(k · stride, n)
+};
+
+/// Bytes of a BitVector with its rank directories (for size accounting).
+inline size_t bitvector_bytes(const BitVector& bv) {
+  return bv.bits().size() * 8 + bv.super_blocks().size() * 4 + bv.sub_blocks().size() * 2;
+}
+
+} // namespace cs
@@ -0,0 +1,257 @@
+/**
+ * interval_cache.cpp — Seqlock slots, per-bucket CLOCK, suffix resumption.
+ */
+
+#include "interval_cache.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace cs {
+
+constexpr size_t KEY_WORDS = IntervalCache::KEY_MAX / 8;
+
+/**
+ * One cached (key, interval). Every field is atomic so lock-free readers
+ * never race with the writer; seq is odd while a write is in progress and
+ * readers discard anything read across a change of seq.
+ */
+struct alignas(64) IntervalCache::Slot {
+  std::atomic<uint32_t> seq{0};
+  std::atomic<uint32_t> len{0};           // Key length + 1 (0 = empty slot)
+  std::atomic<uint8_t> ref{0};            // CLOCK reference bit
+  std::atomic<uint64_t> hash{0};
+  std::atomic<uint64_t> sp{0}, ep{0};
+  std::atomic<uint64_t> key[KEY_WORDS];   // Key bytes, zero-padded
+};
+
+struct IntervalCache::Shard {
+  std::unique_ptr<Slot[]> slots;
+  std::vector<uint8_t> hands;             // CLOCK hand per bucket (under mu)
+  std::mutex mu;
+  alignas(64) std::atomic<uint64_t> hits{0};
+  std::atomic<uint64_t> partial_hits{0};
+  std::atomic<uint64_t> misses{0};
+  std::atomic<uint64_t> inserts{0};
+  std::atomic<uint64_t> evictions{0};
+};
+
+static void pack_key(std::string_view key, uint64_t (&words)[KEY_WORDS]) {
+  std::memset(words, 0, sizeof(words));
+  std::memcpy(words, key.data(), key.size());
+}
+
+static uint64_t mix64(uint64_t x) {
+  x ^= x >> 30; x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27; x *= 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+/// Checkpoints: the capped full length, plus powers of two from 4.
+static bool is_checkpoint(size_t j, size_t top, bool suffixes) {
+  return j == top || (suffixes && j >= 4 && (j & (j - 1)) == 0);
+}
+
+// ──────────────────────────────────────────────────────────────
+// Construction
+// ──────────────────────────────────────────────────────────────
+
+IntervalCache::IntervalCache(const FMIndex& idx, const IntervalCacheConfig& cfg)
+  : idx_(idx), cfg_(cfg) {
+  const size_t slots = cfg_.memory_bytes / sizeof(Slot);
+  if (slots < WAYS) {
+    throw std::invalid_argument("interval cache: memory_bytes below one bucket (" +
+                                std::to_string(WAYS * sizeof(Slot)) + " bytes)");
+  }
+  // Fewer shards rather than going over the cap: each needs one bucket.
+  cfg_.shards = std::clamp<size_t>(cfg_.shards, 1, slots / WAYS);
+  buckets_ = slots / (cfg_.shards * WAYS);
+  shards_ = std::make_unique<Shard[]>(cfg_.shards);
+  for (size_t i = 0; i < cfg_.shards; ++i) {
+    shards_[i].slots = std::make_unique<Slot[]>(buckets_ * WAYS);
+    shards_[i].hands.assign(buckets_, 0);
+  }
+}
+
+IntervalCache::~IntervalCache() = default;
+
+IntervalCache::Shard& IntervalCache::shard_of(uint64_t hash) const {
+  return shards_[hash % cfg_.shards];
+}
+
+IntervalCache::Slot* IntervalCache::bucket_of(const Shard& s, uint64_t hash) const {
+  return &s.slots[((hash / cfg_.shards) % buckets_) * WAYS];
+}
+
+// ──────────────────────────────────────────────────────────────
+// lookup: Lock-free; a slot being rewritten reads as a miss
+// ──────────────────────────────────────────────────────────────
+
+bool IntervalCache::lookup(uint64_t hash, std::string_view key, SAInterval& iv) {
+  uint64_t want[KEY_WORDS];
+  pack_key(key, want);
+  const size_t words = (key.size() + 7) / 8;
+  Slot* bucket = bucket_of(shard_of(hash), hash);
+
+  for (size_t w = 0; w < WAYS; ++w) {
+    Slot& s = bucket[w];
+    const uint32_t seq = s.seq.load(std::memory_order_acquire);
+    if (seq & 1) continue;
+    if (s.hash.load(std::memory_order_relaxed) != hash) continue;
+    if (s.len.load(std::memory_order_relaxed) != key.size() + 1) continue;
+    bool same = true;
+    for (size_t i = 0; i < words && same; ++i) same = s.key[i].load(std::memory_order_relaxed) == want[i];
+    const uint64_t sp = s.sp.load(std::memory_order_relaxed);
+    const uint64_t ep = s.ep.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (!same || s.seq.load(std::memory_order_relaxed) != seq) continue;
+
+    if (!s.ref.load(std::memory_order_relaxed)) s.ref.store(1, std::memory_order_relaxed);
+    iv = {sp, ep, key.size()};
+    return true;
+  }
+  return false;
+}
+
+// ──────────────────────────────────────────────────────────────
+// insert: Under the shard lock; replace, fill, or CLOCK-evict
+// ──────────────────────────────────────────────────────────────
+
+void IntervalCache::insert(uint64_t hash, std::string_view key, const SAInterval& iv) {
+  uint64_t words[KEY_WORDS];
+  pack_key(key, words);
+  Shard& sh = shard_of(hash);
+  Slot* bucket = bucket_of(sh, hash);
+  const size_t b = (hash / cfg_.shards) % buckets_;
+
+  std::lock_guard<std::mutex> lock(sh.mu);
+  Slot* victim = nullptr;
+  for (size_t w = 0; w < WAYS && !victim; ++w) {
+    Slot& s = bucket[w];
+    const uint32_t len = s.len.load(std::memory_order_relaxed);
+    if (len == 0) {
+      victim = &s;
+    } else if (len == key.size() + 1 && s.hash.load(std::memory_order_relaxed) == hash) {
+      bool same = true;
+      for (size_t i = 0; i < KEY_WORDS && same; ++i) same = s.key[i].load(std::memory_order_relaxed) == words[i];
+      if (same) return;  // Another thread got here first
+    }
+  }
+  if (!victim) {
+    uint8_t& hand = sh.hands[b];
+    while (bucket[hand].ref.load(std::memory_order_relaxed)) {
+      bucket[hand].ref.store(0, std::memory_order_relaxed);
+      hand = static_cast<uint8_t>((hand + 1) % WAYS);
+    }
+    victim = &bucket[hand];
+    hand = static_cast<uint8_t>((hand + 1) % WAYS);
+    sh.evictions.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  const uint32_t seq = victim->seq.load(std::memory_order_relaxed);
+  victim->seq.store(seq + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  victim->hash.store(hash, std::memory_order_relaxed);
+  victim->len.store(static_cast<uint32_t>(key.size() + 1), std::memory_order_relaxed);
+  victim->sp.store(iv.sp, std::memory_order_relaxed);
+  victim->ep.store(iv.ep, std::memory_order_relaxed);
+  for (size_t i = 0; i < KEY_WORDS; ++i) victim->key[i].store(words[i], std::memory_order_relaxed);
+  victim->ref.store(0, std::memory_order_relaxed);
+  victim->seq.store(seq + 2, std::memory_order_release);
+  sh.inserts.fetch_add(1, std::memory_order_relaxed);
+}
+
+// ──────────────────────────────────────────────────────────────
+// interval: Probe checkpoints longest first, resume from the hit
+// ──────────────────────────────────────────────────────────────
+
+SAInterval IntervalCache::interval(std::string_view pattern) {
+  const size_t m = pattern.size();
+  if (m == 0) return idx_.full_interval();
+  const size_t top = std::min(m, KEY_MAX);
+
+  // hashes[j] identifies the suffix of length j (built right to left).
+  uint64_t hashes[KEY_MAX + 1];
+  uint64_t raw = 0xcbf29ce484222325ULL;
+  for (size_t j = 1; j <= top; ++j) {
+    raw = (raw ^ static_cast<uint8_t>(pattern[m - j])) * 0x100000001b3ULL;
+    hashes[j] = mix64(raw + j);
+  }
+  auto suffix = [&](size_t j) { return pattern.substr(m - j); };
+
+  SAInterval iv = idx_.full_interval();
+  size_t done = 0;
+  for (size_t j = top; j > 0; --j) {
+    if (!is_checkpoint(j, top, cfg_.cache_suffixes)) continue;
+    if (lookup(hashes[j], suffix(j), iv)) {
+      done = j;
+      break;
+    }
+  }
+  Shard& stats = shard_of(hashes[top]);
+  if (done == m) {
+    stats.hits.fetch_add(1, std::memory_order_relaxed);
+    return iv;
+  }
+  (done ? stats.partial_hits : stats.misses).fetch_add(1, std::memory_order_relaxed);
+
+  while (done < m && !iv.empty()) {
+    iv = idx_.extend_left(iv, static_cast<uint8_t>(pattern[m - 1 - done]));
+    ++done;
+    if (done <= top && is_checkpoint(done, top, cfg_.cache_suffixes)) insert(hashes[done], suffix(done), iv);
+  }
+  if (iv.empty()) {
+    // Every longer suffix is absent too; remember the capped one.
+    if (done < top) insert(hashes[top], suffix(top), {0, 0, top});
+    return {0, 0, m};
+  }
+  return iv;
+}
+
+uint64_t IntervalCache::count(std::string_view pattern) {
+  if (pattern.empty()) return idx_.size();
+  return interval(pattern).size();
+}
+
+std::vector<uint64_t> IntervalCache::locate(std::string_view pattern, size_t limit) {
+  if (pattern.empty()) return {};
+  return idx_.locate(interval(pattern), limit);
+}
+
+// ──────────────────────────────────────────────────────────────
+// stats / clear
+// ──────────────────────────────────────────────────────────────
+
+IntervalCacheStats IntervalCache::stats() const {
+  IntervalCacheStats st;
+  for (size_t i = 0; i < cfg_.shards; ++i) {
+    const Shard& s = shards_[i];
+    st.hits += s.hits.load(std::memory_order_relaxed);
+    st.partial_hits += s.partial_hits.load(std::memory_order_relaxed);
+    st.misses += s.misses.load(std::memory_order_relaxed);
+    st.inserts += s.inserts.load(std::memory_order_relaxed);
+    st.evictions += s.evictions.load(std::memory_order_relaxed);
+  }
+  st.capacity = cfg_.shards * buckets_ * WAYS;
+  st.memory_bytes = st.capacity * sizeof(Slot);
+  return st;
+}
+
+void IntervalCache::clear() {
+  for (size_t i = 0; i < cfg_.shards; ++i) {
+    Shard& sh = shards_[i];
+    std::lock_guard<std::mutex> lock(sh.mu);
+    for (size_t k = 0; k < buckets_ * WAYS; ++k) {
+      Slot& s = sh.slots[k];
+      if (s.len.load(std::memory_order_relaxed) == 0) continue;
+      const uint32_t seq = s.seq.load(std::memory_order_relaxed);
+      s.seq.store(seq + 1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+      s.len.store(0, std::memory_order_relaxed);
+      s.seq.store(seq + 2, std::memory_order_release);
+    }
+  }
+}
+
+} // namespace cs
@@ -0,0 +1,93 @@
+#pragma once
+/**
+ * interval_cache.hpp — Concurrent pattern-suffix → SA-interval cache.
+ *
+ * Sits in front of FMIndex backward search for skewed traffic:
+ *   - a full hit returns the cached SAInterval with no rank work
+ *   - otherwise the longest cached suffix of the pattern is resumed with
+ *     extend_left, and checkpoint suffixes are inserted on the way (lengths
+ *     4, 8, 16, … and the full pattern, capped at KEY_MAX bytes)
+ *   - empty intervals are cached too, so absent patterns hit as well
+ *
+ * Layout:
+ *   - shards × buckets × WAYS fixed slots, sized from a memory cap; shards
+ *     are reduced until one bucket each fits under it
+ *   - reads are lock-free (per-slot sequence counter, retried as a miss);
+ *     inserts take the shard's mutex
+ *   - eviction is CLOCK within a bucket: hits set a reference bit, the hand
+ *     clears bits until it finds a slot that was not referenced
+ *
+ * The cache is bound to one index and is safe to share between threads.
+ */
+
+#include "fm_index.hpp"
+#include "../../include/cs/config.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+namespace cs {
+
+struct IntervalCacheConfig {
+  size_t memory_bytes = 64u << 20;  // Cap on slot storage
+  size_t shards = 16;               // Independent write locks
+  bool cache_suffixes = true;       // Also insert checkpoint suffixes
+};
+
+struct IntervalCacheStats {
+  uint64_t hits = 0;          // Whole pattern found
+  uint64_t partial_hits = 0;  // Resumed from a cached suffix
+  uint64_t misses = 0;        // Searched from scratch
+  uint64_t inserts = 0;
+  uint64_t evictions = 0;
+  size_t capacity = 0;        // Slots
+  size_t memory_bytes = 0;    // Bytes of slot storage
+};
+
+class IntervalCache {
+public:
+  static constexpr size_t KEY_MAX = CS_INTERVAL_CACHE_KEY_MAX;
+  static constexpr size_t WAYS = CS_INTERVAL_CACHE_WAYS;
+
+  /// idx is borrowed and must outlive the cache. Throws std::invalid_argument
+  /// if cfg.memory_bytes cannot hold one bucket of WAYS slots.
+  explicit IntervalCache(const FMIndex& idx, const IntervalCacheConfig& cfg = {});
+  ~IntervalCache();
+
+  IntervalCache(const IntervalCache&) = delete;
+  IntervalCache& operator=(const IntervalCache&) = delete;
+
+  /// Same result as idx.interval(pattern).
+  SAInterval interval(std::string_view pattern);
+
+  /// Same results as idx.count / idx.locate, through the cache.
+  uint64_t count(std::string_view pattern);
+  std::vector<uint64_t> locate(std::string_view pattern, size_t limit=100000);
+
+  /// Counters are summed over shards; they are not a consistent snapshot.
+  IntervalCacheStats stats() const;
+
+  /// Drops every entry (counters are kept).
+  void clear();
+
+  const FMIndex& index() const { return idx_; }
+
+private:
+  struct Slot;
+  struct Shard;
+
+  bool lookup(uint64_t hash, std::string_view key, SAInterval& iv);
+  void insert(uint64_t hash, std::string_view key, const SAInterval& iv);
+  Shard& shard_of(uint64_t hash) const;
+  Slot* bucket_of(const Shard& s, uint64_t hash) const;
+
+  const FMIndex& idx_;
+  IntervalCacheConfig cfg_;
+  size_t buckets_ = 0;                     // Per shard
+  std::unique_ptr<Shard[]> shards_;
+};
+
+} // namespace cs
@@ -0,0 +1,240 @@
+/**
+ * kmers.cpp — Serial top-level split, parallel depth-first branches.
+ */
+
+#include "kmers.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+namespace cs {
+
+namespace {
+
+/// Grows k-mers to the right (lexicographic) on a bidirectional index.
+struct RightWalk {
+  using Node = BiInterval;
+  const FMIndex& idx;
+  Node root() const { return idx.bi_full_interval(); }
+  static uint64_t count(const Node& v) { return v.size; }
+  template <class Fn> void children(const Node& v, Fn&& fn) const { idx.for_each_right_extension(v, fn); }
+  static size_t slot(size_t depth, size_t) { return depth; }
+};
+
+/// Grows k-mers to the left (colexicographic) with plain backward search.
+struct LeftWalk {
+  using Node = SAInterval;
+  const FMIndex& idx;
+  Node root() const { return idx.full_interval(); }
+  static uint64_t count(const Node& v) { return v.size(); }
+  template <class Fn> void children(const Node& v, Fn&& fn) const { idx.for_each_left_extension(v, fn); }
+  static size_t slot(size_t depth, size_t k) { return k - 1 - depth; }
+};
+
+template <class Walk>
+struct Branch {
+  typename Walk::Node node;
+  std::string kmer;  // k bytes; the first `depth` symbols placed
+  size_t depth = 0;
+};
+
+/// Resumable depth-first walk of one branch; the stack holds at most σ nodes per level.
+template <class Walk>
+struct BranchWalk {
+  struct Frame {
+    typename Walk::Node node;
+    size_t depth;
+    uint8_t c;
+  };
+
+  Walk w;
+  Branch<Walk> b;
+  size_t k;
+  uint64_t min_count;
+  std::vector<Frame> stack{};
+  bool started = false;
+  bool done = false;
+
+  void push_children(const typename Walk::Node& v, size_t depth, uint64_t& nodes) {
+    const size_t mark = stack.size();
+    w.children(v, [&](uint8_t c, const typename Walk::Node& ch) {
+      ++nodes;
+      if (Walk::count(ch) >= min_count) stack.push_back({ch, depth + 1, c});
+    });
+    std::reverse(stack.begin() + mark, stack.end());  // Smallest symbol on top
+  }
+
+  /// Appends up to cap k-mers to out, resuming where the last call stopped.
+  void step(KmerBlock& out, size_t cap, uint64_t& nodes) {
+    if (!started) {
+      started = true;
+      if (b.depth == k) {
+        out.kmers += b.kmer;
+        out.counts.push_back(Walk::count(b.node));
+        done = true;
+        return;
+      }
+      push_children(b.node, b.depth, nodes);
+    }
+    while (!stack.empty() && out.size() < cap) {
+      const Frame f = stack.back();
+      stack.pop_back();
+      b.kmer[Walk::slot(f.depth - 1, k)] = static_cast<char>(f.c);
+      if (f.depth == k) {
+        out.kmers += b.kmer;
+        out.counts.push_back(Walk::count(f.node));
+      } else {
+        push_children(f.node, f.depth, nodes);
+      }
+    }
+    done = stack.empty();
+  }
+};
+
+/// Blocks a branch may produce ahead of the consumer.
+constexpr size_t LANE_AHEAD = 2;
+
+/**
+ * One branch in flight. A pool task runs one step() and queues the block;
+ * it resubmits itself while fewer than LANE_AHEAD blocks wait, otherwise the
+ * consumer restarts it after taking one. Shared with the tasks, so a lane
+ * outlives the last task that touches it.
+ */
+template <class Walk>
+struct Lane {
+  explicit Lane(BranchWalk<Walk> bw) : walk(std::move(bw)) {}
+
+  BranchWalk<Walk> walk;                // Touched only by the task that runs it
+  std::mutex mu;
+  std::condition_variable cv;
+  std::deque<KmerBlock> ready;
+  uint64_t nodes = 0;
+  bool running = false;
+  bool finished = false;
+  bool cancelled = false;
+  std::exception_ptr error;
+};
+
+template <class Walk>
+void run_lane(const std::shared_ptr<Lane<Walk>>& lane, ThreadPool& pool, size_t cap) {
+  pool.submit([lane, &pool, cap] {
+    KmerBlock block;
+    block.k = lane->walk.k;
+    uint64_t nodes = 0;
+    std::exception_ptr error;
+    try {
+      lane->walk.step(block, cap, nodes);
+    } catch (...) {
+      error = std::current_exception();
+    }
+    std::lock_guard<std::mutex> lock(lane->mu);
+    lane->nodes += nodes;
+    if (block.size() > 0) lane->ready.push_back(std::move(block));
+    if (error) lane->error = error;
+    lane->finished = lane->walk.done || error != nullptr;
+    if (!lane->finished && !lane->cancelled && lane->ready.size() < LANE_AHEAD) {
+      run_lane(lane, pool, cap);
+    } else {
+      lane->running = false;
+    }
+    lane->cv.notify_all();
+  });
+}
+
+template <class Walk>
+KmerStats run(const Walk& w, size_t k, uint64_t min_count, const std::function<void(const KmerBlock&)>& callback,
+              ThreadPool& pool, const KmerOptions& opt) {
+  KmerStats stats;
+  const size_t want = opt.min_branches ? opt.min_branches : 16 * pool.size();
+  const size_t window = opt.window ? opt.window : 4 * pool.size();
+  const size_t cap = opt.block_kmers ? opt.block_kmers : 4096;
+
+  // Expand whole levels, in order, until there are enough branches.
+  std::vector<Branch<Walk>> branches;
+  if (Walk::count(w.root()) >= min_count) branches.push_back({w.root(), std::string(k, '\0'), 0});
+  while (!branches.empty() && branches.front().depth < k && branches.size() < want) {
+    std::vector<Branch<Walk>> next;
+    for (const auto& b : branches) {
+      w.children(b.node, [&](uint8_t c, const typename Walk::Node& ch) {
+        ++stats.nodes;
+        if (Walk::count(ch) < min_count) return;
+        Branch<Walk> nb{ch, b.kmer, b.depth + 1};
+        nb.kmer[Walk::slot(b.depth, k)] = static_cast<char>(c);
+        next.push_back(std::move(nb));
+      });
+    }
+    branches.swap(next);
+  }
+
+  // Up to `window` branches run at once; blocks are taken from the oldest.
+  std::deque<std::shared_ptr<Lane<Walk>>> inflight;
+  size_t started = 0;
+  auto start_next = [&] {
+    auto lane = std::make_shared<Lane<Walk>>(
+        BranchWalk<Walk>{w, std::move(branches[started++]), k, min_count});
+    lane->running = true;
+    inflight.push_back(lane);
+    run_lane(lane, pool, cap);
+  };
+  // Tasks read the index, so none may outlive this call on an exception.
+  auto cancel_all = [&] {
+    for (auto& lane : inflight) {
+      std::unique_lock<std::mutex> lock(lane->mu);
+      lane->cancelled = true;
+      lane->cv.wait(lock, [&] { return !lane->running; });
+    }
+  };
+
+  try {
+    while (started < branches.size() && inflight.size() < window) start_next();
+    while (!inflight.empty()) {
+      Lane<Walk>& lane = *inflight.front();
+      KmerBlock block;
+      {
+        std::unique_lock<std::mutex> lock(lane.mu);
+        lane.cv.wait(lock, [&] { return !lane.ready.empty() || !lane.running; });
+        if (lane.error) std::rethrow_exception(lane.error);
+        if (lane.ready.empty()) {
+          stats.nodes += lane.nodes;
+          lock.unlock();
+          inflight.pop_front();
+          if (started < branches.size()) start_next();
+          continue;
+        }
+        block = std::move(lane.ready.front());
+        lane.ready.pop_front();
+        if (!lane.running && !lane.finished) {
+          lane.running = true;
+          run_lane(inflight.front(), pool, cap);
+        }
+      }
+      ++stats.blocks;
+      stats.kmers += block.size();
+      for (uint64_t c : block.counts) stats.occurrences += c;
+      callback(block);
+    }
+  } catch (...) {
+    cancel_all();
+    throw;
+  }
+  return stats;
+}
+
+} // namespace
+
+KmerStats enumerate_kmers(const FMIndex& idx, size_t k, uint64_t min_count,
+                          const std::function<void(const KmerBlock&)>& callback, ThreadPool& pool,
+                          const KmerOptions& opt) {
+  if (k == 0) throw std::invalid_argument("enumerate_kmers: k must be positive");
+  if (min_count == 0) min_count = 1;
+  KmerStats stats = idx.bidirectional() ? run(RightWalk{idx}, k, min_count, callback, pool, opt)
+                                        : run(LeftWalk{idx}, k, min_count, callback, pool, opt);
+  stats.lexicographic = idx.bidirectional();
+  return stats;
+}
+
+} // namespace cs
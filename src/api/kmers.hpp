@@ -0,0 +1,65 @@
+#pragma once
+/**
+ * kmers.hpp — All distinct k-mers of an indexed text with their counts.
+ *
+ * A depth-first walk of the implicit suffix tree, one symbol per level, with
+ * every child of a node taken from one wavelet descent
+ * (for_each_left/right_extension). Subtrees below min_count are pruned.
+ *
+ *   - the top levels are expanded serially until there are enough
+ *     branches for the pool; each branch is then walked on a worker with an
+ *     explicit stack of at most k·σ nodes
+ *   - a branch yields KmerBlocks of at most block_kmers k-mers; its walk
+ *     pauses once two blocks wait and resumes when the consumer takes one,
+ *     so memory is O(window × block_kmers × k) however large the output
+ *   - blocks reach the callback in order, on the calling thread
+ *
+ * Order: lexicographic on a bidirectional index (k-mers grow to the right
+ * through the reversed BWT); otherwise k-mers grow to the left and come out
+ * ordered by their reversed string (colexicographic).
+ * K-mers containing the document separator are reported like any other.
+ */
+
+#include "fm_index.hpp"
+#include "../util/thread_pool.hpp"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace cs {
+
+/// Consecutive k-mers in output order, packed k bytes apart.
+struct KmerBlock {
+  size_t k = 0;
+  std::string kmers;
+  std::vector<uint64_t> counts;
+  size_t size() const { return counts.size(); }
+  std::string_view kmer(size_t i) const { return std::string_view(kmers).substr(i * k, k); }
+};
+
+struct KmerOptions {
+  size_t min_branches = 0;  // Branches to split into (0 = 16 × pool size)
+  size_t window = 0;        // Branches in flight (0 = 4 × pool size)
+  size_t block_kmers = 0;   // Max k-mers per block (0 = 4096)
+};
+
+struct KmerStats {
+  uint64_t kmers = 0;        // Distinct k-mers reported
+  uint64_t occurrences = 0;  // Sum of their counts
+  uint64_t blocks = 0;
+  uint64_t nodes = 0;        // Suffix-tree nodes visited (extensions)
+  bool lexicographic = false;
+};
+
+/**
+ * enumerate_kmers(idx, k, min_count, callback, pool) — Every k-mer occurring
+ * at least min_count times, in blocks passed to callback in the order above.
+ * Throws std::invalid_argument if k == 0.
+ */
+KmerStats enumerate_kmers(const FMIndex& idx, size_t k, uint64_t min_count,
+                          const std::function<void(const KmerBlock&)>& callback, ThreadPool& pool,
+                          const KmerOptions& opt = {});
+
+} // namespace cs
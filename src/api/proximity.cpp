@@ -0,0 +1,104 @@
+/**
+ * proximity.cpp — Plan choice, window scans, and the sorted merge join.
+ */
+
+#include "proximity.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace cs {
+
+// Scanning this many text bytes costs about as much as locating one row
+// (an SA-sample walk of stride / 2 LF steps on average).
+constexpr uint64_t LOCATE_BYTES = 64;
+
+/// min(a * b, cap) without wrapping.
+static uint64_t capped_product(uint64_t a, uint64_t b, uint64_t cap) {
+  return b != 0 && a > cap / b ? cap : std::min(a * b, cap);
+}
+
+/**
+ * Occurrences of p starting in the union of the windows [lo, hi), ascending
+ * and without repeats. Windows arrive sorted by lo.
+ */
+static std::vector<uint64_t> scan_windows(const FMIndex& idx, std::string_view p,
+                                          const std::vector<std::pair<uint64_t, uint64_t>>& windows,
+                                          uint64_t& scanned) {
+  std::vector<uint64_t> out;
+  const uint64_t n = idx.size();
+  for (size_t w = 0; w < windows.size();) {
+    uint64_t lo = windows[w].first, hi = windows[w].second;
+    for (++w; w < windows.size() && windows[w].first <= hi; ++w) hi = std::max(hi, windows[w].second);
+    hi = std::min(hi, n);
+    if (hi < lo + p.size()) continue;
+    const std::string text = idx.fold(idx.extract(lo, hi - lo));
+    scanned += text.size();
+    for (size_t at = text.find(p); at != std::string::npos; at = text.find(p, at + 1)) out.push_back(lo + at);
+  }
+  return out;
+}
+
+std::vector<ProximityMatch> find_near(const FMIndex& idx, std::string_view raw1, std::string_view raw2,
+                                      const ProximityOptions& opt, ProximityStats* stats) {
+  const std::string p1 = idx.fold(raw1), p2 = idx.fold(raw2);  // Scans compare folded text
+  if (opt.min_gap > opt.max_gap) throw std::invalid_argument("find_near: min_gap > max_gap");
+  ProximityStats local;
+  ProximityStats& st = stats ? *stats : local;
+  st = {};
+  std::vector<ProximityMatch> out;
+  if (p1.empty() || p2.empty() || opt.limit == 0) return out;
+
+  const SAInterval iv1 = idx.interval(p1), iv2 = idx.interval(p2);
+  st.first_count = iv1.size();
+  st.second_count = iv2.size();
+  if (iv1.empty() || iv2.empty()) return out;
+
+  // No gap exceeds the text, so clamping both bounds to n keeps the answer
+  // and keeps every position sum below 3n.
+  const uint64_t n = idx.size(), min_gap = std::min(opt.min_gap, n), span = std::min(opt.max_gap, n);
+
+  // Cost of each plan in scanned-byte units.
+  const uint64_t scan_after = iv1.size() * LOCATE_BYTES + capped_product(iv1.size(), span + p2.size(), n);
+  const uint64_t scan_before = iv2.size() * LOCATE_BYTES + capped_product(iv2.size(), span + p1.size(), n);
+  const uint64_t join = (iv1.size() + iv2.size()) * LOCATE_BYTES;
+  st.plan = opt.plan;
+  if (st.plan == ProximityPlan::AUTO) {
+    st.plan = join < std::min(scan_after, scan_before) ? ProximityPlan::JOIN
+            : scan_after <= scan_before ? ProximityPlan::SCAN_AFTER_FIRST : ProximityPlan::SCAN_BEFORE_SECOND;
+  }
+
+  std::vector<uint64_t> a, b;
+  std::vector<std::pair<uint64_t, uint64_t>> windows;
+  if (st.plan != ProximityPlan::SCAN_BEFORE_SECOND) {
+    a = idx.locate(iv1, SIZE_MAX);
+    st.located += a.size();
+  }
+  if (st.plan != ProximityPlan::SCAN_AFTER_FIRST) {
+    b = idx.locate(iv2, SIZE_MAX);
+    st.located += b.size();
+  }
+  if (st.plan == ProximityPlan::SCAN_AFTER_FIRST) {
+    for (uint64_t i : a) windows.emplace_back(i + p1.size() + min_gap, i + p1.size() + span + p2.size());
+    b = scan_windows(idx, p2, windows, st.scanned_bytes);
+  } else if (st.plan == ProximityPlan::SCAN_BEFORE_SECOND) {
+    for (uint64_t j : b) {
+      const uint64_t reach = span + p1.size();
+      if (j >= p1.size() + min_gap) windows.emplace_back(j > reach ? j - reach : 0, j - min_gap);
+    }
+    a = scan_windows(idx, p1, windows, st.scanned_bytes);
+  }
+
+  // Merge join: for ascending i, the partners j lie in [i + |P1| + min, i + |P1| + max].
+  size_t lo = 0;
+  for (uint64_t i : a) {
+    const uint64_t from = i + p1.size() + min_gap, to = i + p1.size() + span;
+    while (lo < b.size() && b[lo] < from) ++lo;
+    for (size_t k = lo; k < b.size() && b[k] <= to; ++k) {
+      out.push_back({i, b[k]});
+      if (out.size() == opt.limit) return out;
+    }
+  }
+  return out;
+}
+
+} // namespace cs
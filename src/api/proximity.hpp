@@ -0,0 +1,57 @@
+#pragma once
+/**
+ * proximity.hpp — Bounded-gap proximity search ("P1 .{min,max} P2").
+ *
+ * A match is a pair (i, j) where P1 occurs at i, P2 occurs at j, and the
+ * gap j - (i + |P1|) lies in [min_gap, max_gap]; P2 never overlaps P1.
+ *
+ * Both sides are counted first (two backward searches), then the cheapest
+ * plan is picked:
+ *   - SCAN_AFTER_FIRST: locate P1 only, and find P2 by scanning the text
+ *     just after each occurrence (overlapping windows are merged, so each
+ *     byte is scanned once)
+ *   - SCAN_BEFORE_SECOND: the same from the P2 side
+ *   - JOIN: locate both and merge the two sorted position lists
+ * Locating costs an SA-sample walk per row, so a scan plan wins while the
+ * rare side's windows are short; when both sides are frequent, or the gap is
+ * wide, the merge join touches each position once instead. Every plan ends
+ * in the same linear merge of two sorted lists.
+ */
+
+#include "fm_index.hpp"
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace cs {
+
+struct ProximityMatch {
+  uint64_t first = 0;   // Position of P1
+  uint64_t second = 0;  // Position of P2
+  bool operator==(const ProximityMatch&) const = default;
+};
+
+enum class ProximityPlan { AUTO, SCAN_AFTER_FIRST, SCAN_BEFORE_SECOND, JOIN };
+
+struct ProximityOptions {
+  uint64_t min_gap = 0;
+  uint64_t max_gap = 0;
+  size_t limit = 100000;                   // Matches returned
+  ProximityPlan plan = ProximityPlan::AUTO;
+};
+
+struct ProximityStats {
+  ProximityPlan plan = ProximityPlan::AUTO;  // Plan actually run
+  uint64_t first_count = 0, second_count = 0;
+  uint64_t located = 0;        // Rows passed to locate
+  uint64_t scanned_bytes = 0;  // Text bytes scanned for the other side
+};
+
+/**
+ * find_near(idx, p1, p2, opt) — Matches ordered by first, then second, up to
+ * opt.limit. Throws std::invalid_argument if min_gap > max_gap.
+ */
+std::vector<ProximityMatch> find_near(const FMIndex& idx, std::string_view p1, std::string_view p2,
+                                      const ProximityOptions& opt = {}, ProximityStats* stats = nullptr);
+
+} // namespace cs
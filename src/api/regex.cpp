@@ -0,0 +1,641 @@
+/**
+ * regex.cpp — Parser, required literals, Thompson NFA, and both plans.
+ */
+
+#include "regex.hpp"
+#include <algorithm>
+#include <cctype>
+#include <memory>
+#include <stdexcept>
+
+namespace cs {
+
+namespace {
+
+constexpr uint32_t INF = UINT32_MAX;
+constexpr uint32_t MAX_REPEAT = 1000;
+
+struct Node {
+  enum Kind { EMPTY, BYTES, CONCAT, ALT, REPEAT } kind = EMPTY;
+  CharClass cc;                             // BYTES
+  std::vector<std::unique_ptr<Node>> kids;  // CONCAT, ALT, REPEAT (one)
+  uint32_t min = 0, max = 0;                // REPEAT (max = INF: unbounded)
+};
+
+using NodePtr = std::unique_ptr<Node>;
+
+NodePtr make(Node::Kind k) {
+  auto n = std::make_unique<Node>();
+  n->kind = k;
+  return n;
+}
+
+// ──────────────────────────────────────────────────────────────
+// Parser: alt := concat ('|' concat)*, concat := repeat*,
+//         repeat := atom quantifier*
+// ──────────────────────────────────────────────────────────────
+
+class Parser {
+public:
+  explicit Parser(std::string_view s) : s_(s) {}
+
+  NodePtr parse() {
+    NodePtr n = alt();
+    if (i_ < s_.size()) fail("unmatched ')'");
+    return n;
+  }
+
+private:
+  [[noreturn]] void fail(const std::string& what) const {
+    throw std::invalid_argument("regex: " + what + " at " + std::to_string(i_) + " in " + std::string(s_));
+  }
+  bool more() const { return i_ < s_.size(); }
+  char peek() const { return s_[i_]; }
+
+  NodePtr alt() {
+    NodePtr first = concat();
+    if (!more() || peek() != '|') return first;
+    NodePtr n = make(Node::ALT);
+    n->kids.push_back(std::move(first));
+    while (more() && peek() == '|') {
+      ++i_;
+      n->kids.push_back(concat());
+    }
+    return n;
+  }
+
+  NodePtr concat() {
+    NodePtr n = make(Node::CONCAT);
+    while (more() && peek() != '|' && peek() != ')') n->kids.push_back(repeat());
+    if (n->kids.size() == 1) return std::move(n->kids[0]);
+    return n;
+  }
+
+  NodePtr repeat() {
+    NodePtr n = atom();
+    while (more()) {
+      uint32_t lo, hi;
+      const char q = peek();
+      if (q == '*') lo = 0, hi = INF;
+      else if (q == '+') lo = 1, hi = INF;
+      else if (q == '?') lo = 0, hi = 1;
+      else if (q == '{') counted(lo, hi);
+      else break;
+      if (q != '{') ++i_;
+      NodePtr r = make(Node::REPEAT);
+      r->min = lo;
+      r->max = hi;
+      r->kids.push_back(std::move(n));
+      n = std::move(r);
+    }
+    return n;
+  }
+
+  // {m}, {m,}, {m,n}; leaves i_ after the '}'.
+  void counted(uint32_t& lo, uint32_t& hi) {
+    ++i_;
+    lo = number();
+    hi = lo;
+    if (more() && peek() == ',') {
+      ++i_;
+      hi = more() && peek() == '}' ? INF : number();
+    }
+    if (!more() || peek() != '}') fail("bad {m,n}");
+    ++i_;
+    if (hi < lo) fail("{m,n} with n < m");
+  }
+
+  uint32_t number() {
+    if (!more() || !std::isdigit(static_cast<unsigned char>(peek()))) fail("expected a number");
+    uint32_t v = 0;
+    while (more() && std::isdigit(static_cast<unsigned char>(peek()))) {
+      v = v * 10 + static_cast<uint32_t>(peek() - '0');
+      if (v > MAX_REPEAT) fail("repeat count above " + std::to_string(MAX_REPEAT));
+      ++i_;
+    }
+    return v;
+  }
+
+  NodePtr atom() {
+    const char c = peek();
+    if (c == '(') {
+      ++i_;
+      NodePtr n = alt();
+      if (!more() || peek() != ')') fail("unmatched '('");
+      ++i_;
+      return n;
+    }
+    if (c == '*' || c == '+' || c == '?' || c == '{') fail("nothing to repeat");
+    if (c == '^' || c == '$') fail("anchors are not supported");
+    NodePtr n = make(Node::BYTES);
+    if (c == '.') {
+      n->cc.add('\n');
+      n->cc.negate();
+      ++i_;
+    } else if (c == '[') {
+      n->cc = bracket();
+    } else if (c == '\\') {
+      n->cc = escape();
+    } else {
+      n->cc.add(static_cast<uint8_t>(c));
+      ++i_;
+    }
+    return n;
+  }
+
+  // After a '\': a shorthand class or one literal byte.
+  CharClass escape() {
+    ++i_;
+    if (!more()) fail("trailing backslash");
+    const char e = s_[i_++];
+    CharClass cc;
+    switch (e) {
+      case 'd': case 'D': cc.add_range('0', '9'); break;
+      case 'w': case 'W': cc.add_range('a', 'z'); cc.add_range('A', 'Z'); cc.add_range('0', '9'); cc.add('_'); break;
+      case 's': case 'S': for (char w : {' ', '\t', '\n', '\r', '\f', '\v'}) cc.add(static_cast<uint8_t>(w)); break;
+      case 'n': cc.add('\n'); break;
+      case 't': cc.add('\t'); break;
+      case 'r': cc.add('\r'); break;
+      case 'x': {
+        if (i_ + 2 > s_.size() || !std::isxdigit(static_cast<unsigned char>(s_[i_])) ||
+            !std::isxdigit(static_cast<unsigned char>(s_[i_ + 1])))
+          fail("bad \\xHH");
+        cc.add(static_cast<uint8_t>(std::stoi(std::string(s_.substr(i_, 2)), nullptr, 16)));
+        i_ += 2;
+        break;
+      }
+      default: cc.add(static_cast<uint8_t>(e));
+    }
+    if (e == 'D' || e == 'W' || e == 'S') cc.negate();
+    return cc;
+  }
+
+  CharClass bracket() {
+    ++i_;
+    const bool neg = more() && peek() == '^';
+    if (neg) ++i_;
+    CharClass cc;
+    for (bool first = true; more() && (peek() != ']' || first); first = false) {
+      if (peek() == '\\' && i_ + 1 < s_.size() && std::string_view("dDwWsS").find(s_[i_ + 1]) != std::string_view::npos) {
+        cc |= escape();
+        continue;
+      }
+      const uint8_t lo = single();
+      if (i_ + 1 < s_.size() && peek() == '-' && s_[i_ + 1] != ']') {
+        ++i_;
+        const uint8_t hi = single();
+        if (hi < lo) fail("reversed range");
+        cc.add_range(lo, hi);
+      } else {
+        cc.add(lo);
+      }
+    }
+    if (!more()) fail("unterminated '['");
+    ++i_;
+    if (neg) cc.negate();
+    return cc;
+  }
+
+  // One byte inside brackets, possibly escaped.
+  uint8_t single() {
+    if (peek() != '\\') return static_cast<uint8_t>(s_[i_++]);
+    const CharClass e = escape();
+    if (e.size() != 1) fail("class shorthand in a range");
+    uint8_t b = 0;
+    while (!e.contains(b)) ++b;
+    return b;
+  }
+
+  std::string_view s_;
+  size_t i_ = 0;
+};
+
+// ──────────────────────────────────────────────────────────────
+// Required literal: exact strings, plus the longest substring,
+// prefix and suffix common to every match
+// ──────────────────────────────────────────────────────────────
+
+struct LitInfo {
+  bool exact = false;  // Every match is `str`
+  std::string str, best, prefix, suffix;
+};
+
+const std::string& longer(const std::string& a, const std::string& b) { return b.size() > a.size() ? b : a; }
+
+LitInfo exact(std::string s) {
+  LitInfo li;
+  li.exact = true;
+  li.best = li.prefix = li.suffix = s;
+  li.str = std::move(s);
+  return li;
+}
+
+LitInfo concat_info(const LitInfo& a, const LitInfo& b) {
+  if (a.exact && b.exact) return exact(a.str + b.str);
+  LitInfo li;
+  li.best = longer(longer(a.best, b.best), a.suffix + b.prefix);
+  li.prefix = a.exact ? a.str + b.prefix : a.prefix;
+  li.suffix = b.exact ? a.suffix + b.str : b.suffix;
+  return li;
+}
+
+LitInfo literal_info(const Node& n) {
+  switch (n.kind) {
+    case Node::EMPTY: return exact("");
+    case Node::BYTES: {
+      if (n.cc.size() != 1) return {};
+      uint8_t b = 0;
+      while (!n.cc.contains(b)) ++b;
+      return exact(std::string(1, static_cast<char>(b)));
+    }
+    case Node::CONCAT: {
+      LitInfo li = exact("");
+      for (const auto& k : n.kids) li = concat_info(li, literal_info(*k));
+      return li;
+    }
+    case Node::ALT: {
+      LitInfo first = literal_info(*n.kids[0]);
+      for (size_t i = 1; i < n.kids.size(); ++i) {
+        const LitInfo k = literal_info(*n.kids[i]);
+        if (!first.exact || !k.exact || k.str != first.str) return {};
+      }
+      return first;
+    }
+    case Node::REPEAT: {
+      if (n.min == 0) return {};
+      const LitInfo k = literal_info(*n.kids[0]);
+      if (k.exact && n.min == n.max) {
+        std::string s;
+        for (uint32_t i = 0; i < n.min; ++i) s += k.str;
+        return exact(s);
+      }
+      LitInfo li = k;
+      li.exact = false;
+      if (k.exact) li.best = k.str;
+      if (k.exact && n.min > 1) {
+        for (uint32_t i = 1; i < n.min && li.best.size() < 64; ++i) li.best += k.str;
+        li.prefix = li.suffix = li.best;
+      }
+      return li;
+    }
+  }
+  return {};
+}
+
+} // namespace
+
+// ──────────────────────────────────────────────────────────────
+// NFA construction: compile(node, next) returns a state that
+// matches node and continues at next
+// ──────────────────────────────────────────────────────────────
+
+class RegexSearch {
+public:
+  using Set = std::vector<uint64_t>;
+
+  static uint32_t compile(Regex& re, const Node& n, uint32_t next) {
+    if (re.states_.size() > Regex::MAX_STATES) throw std::invalid_argument("regex: too many NFA states");
+    switch (n.kind) {
+      case Node::EMPTY: return next;
+      case Node::BYTES: {
+        Regex::State s;
+        s.byte = true;
+        s.cc = n.cc;
+        s.next = next;
+        re.states_.push_back(s);
+        return static_cast<uint32_t>(re.states_.size() - 1);
+      }
+      case Node::CONCAT:
+        for (size_t i = n.kids.size(); i-- > 0;) next = compile(re, *n.kids[i], next);
+        return next;
+      case Node::ALT: {
+        std::vector<uint32_t> eps;
+        for (const auto& k : n.kids) eps.push_back(compile(re, *k, next));
+        return split(re, std::move(eps));
+      }
+      case Node::REPEAT: {
+        const Node& body = *n.kids[0];
+        uint32_t at = next;
+        if (n.max == INF) {
+          const uint32_t loop = split(re, {});
+          const uint32_t b = compile(re, body, loop);
+          re.states_[loop].eps = {b, next};
+          at = loop;
+        } else {
+          for (uint32_t i = n.min; i < n.max; ++i) {
+            const uint32_t b = compile(re, body, at);
+            at = split(re, {b, at});
+          }
+        }
+        for (uint32_t i = 0; i < n.min; ++i) at = compile(re, body, at);
+        return at;
+      }
+    }
+    return next;
+  }
+
+  static uint32_t split(Regex& re, std::vector<uint32_t> eps) {
+    Regex::State s;
+    s.eps = std::move(eps);
+    re.states_.push_back(std::move(s));
+    return static_cast<uint32_t>(re.states_.size() - 1);
+  }
+
+  static bool test(const Set& s, uint32_t q) { return (s[q >> 6] >> (q & 63)) & 1; }
+  static bool set(Set& s, uint32_t q) {
+    if (test(s, q)) return false;
+    s[q >> 6] |= 1ULL << (q & 63);
+    return true;
+  }
+  static bool empty(const Set& s) {
+    return std::all_of(s.begin(), s.end(), [](uint64_t w) { return w == 0; });
+  }
+
+  // ── Forward simulation (VERIFY) ──
+
+  static void forward_closure(const Regex& re, Set& s, std::vector<uint32_t>& work) {
+    work.clear();
+    for (uint32_t q = 0; q < re.states_.size(); ++q)
+      if (test(s, q)) work.push_back(q);
+    while (!work.empty()) {
+      const uint32_t q = work.back();
+      work.pop_back();
+      for (uint32_t e : re.states_[q].eps)
+        if (set(s, e)) work.push_back(e);
+    }
+  }
+
+  /// Forward runs sharing the start closure and the scratch sets.
+  struct Forward {
+    const Regex& re;
+    Set init, cur, nxt;
+    CharClass first;  // Bytes some run can start with
+    std::vector<uint32_t> work;
+
+    explicit Forward(const Regex& r) : re(r), init((r.states_.size() + 63) / 64, 0) {
+      set(init, re.start_);
+      forward_closure(re, init, work);
+      for (uint32_t q = 0; q < re.states_.size(); ++q)
+        if (re.states_[q].byte && test(init, q)) first |= re.states_[q].cc;
+      cur = nxt = init;
+    }
+
+    /// Calls fn(len) for every len in [1, max_len] where s[0, len) matches.
+    template <class Fn>
+    void run(std::string_view s, size_t max_len, Fn&& fn) {
+      if (s.empty() || !first.contains(static_cast<uint8_t>(s[0]))) return;
+      cur = init;
+      match_steps(re, s, max_len, cur, nxt, work, fn);
+    }
+  };
+
+  template <class Fn>
+  static void match_steps(const Regex& re, std::string_view s, size_t max_len, Set& cur, Set& nxt,
+                          std::vector<uint32_t>& work, Fn&& fn) {
+    for (size_t i = 0; i < s.size() && i < max_len; ++i) {
+      std::fill(nxt.begin(), nxt.end(), 0);
+      const uint8_t c = static_cast<uint8_t>(s[i]);
+      bool live = false;
+      for (uint32_t q = 0; q < re.states_.size(); ++q) {
+        const Regex::State& st = re.states_[q];
+        if (st.byte && test(cur, q) && st.cc.contains(c)) {
+          set(nxt, st.next);
+          live = true;
+        }
+      }
+      if (!live) return;
+      forward_closure(re, nxt, work);
+      cur.swap(nxt);
+      if (test(cur, 0)) fn(i + 1);
+    }
+  }
+
+  // ── Backward simulation (TRAVERSE) ──
+
+  struct Backward {
+    const Regex& re;
+    std::vector<std::vector<uint32_t>> eps_into;   // q -> splits with an eps edge to q
+    std::vector<std::vector<uint32_t>> byte_into;  // q -> byte states with next == q
+
+    explicit Backward(const Regex& r) : re(r), eps_into(r.states_.size()), byte_into(r.states_.size()) {
+      for (uint32_t p = 0; p < r.states_.size(); ++p) {
+        const Regex::State& st = r.states_[p];
+        if (st.byte) byte_into[st.next].push_back(p);
+        for (uint32_t e : st.eps) eps_into[e].push_back(p);
+      }
+    }
+
+    /// Adds every state that reaches s by epsilon moves.
+    void closure(Set& s, std::vector<uint32_t>& work) const {
+      work.clear();
+      for (uint32_t q = 0; q < re.states_.size(); ++q)
+        if (test(s, q)) work.push_back(q);
+      while (!work.empty()) {
+        const uint32_t q = work.back();
+        work.pop_back();
+        for (uint32_t p : eps_into[q])
+          if (set(s, p)) work.push_back(p);
+      }
+    }
+
+    /// Byte states whose successor is in s: the moves available on a prepend.
+    void entries(const Set& s, std::vector<uint32_t>& out) const {
+      out.clear();
+      for (uint32_t q = 0; q < re.states_.size(); ++q)
+        if (test(s, q)) out.insert(out.end(), byte_into[q].begin(), byte_into[q].end());
+    }
+  };
+
+  static std::vector<SAInterval> traverse(const FMIndex& idx, const Regex& re, const RegexOptions& opt,
+                                          RegexStats& st) {
+    std::vector<SAInterval> out;
+    const Backward bw(re);
+    const size_t words = (re.states_.size() + 63) / 64;
+    struct Frame {
+      SAInterval iv;
+      Set states;
+    };
+    std::vector<Frame> stack;
+    std::vector<uint32_t> work, moves;
+    Frame root{idx.full_interval(), Set(words, 0)};
+    set(root.states, 0);
+    bw.closure(root.states, work);
+    stack.push_back(std::move(root));
+
+    while (!stack.empty()) {
+      Frame f = std::move(stack.back());
+      stack.pop_back();
+      if (f.iv.len > 0 && test(f.states, re.start_)) {
+        out.push_back(f.iv);
+        ++st.intervals;
+      }
+      if (f.iv.len >= opt.max_length) continue;
+      bw.entries(f.states, moves);
+      if (moves.empty()) continue;
+      ++st.nodes;
+      CharClass allowed;
+      for (uint32_t p : moves) allowed |= re.states_[p].cc;
+      idx.for_each_left_extension(
+          f.iv, [&](unsigned lo, unsigned hi) { return allowed.any_in(lo, hi); },
+          [&](uint8_t c, const SAInterval& e) {
+            Frame ch{e, Set(words, 0)};
+            for (uint32_t p : moves)
+              if (re.states_[p].cc.contains(c)) set(ch.states, p);
+            bw.closure(ch.states, work);
+            stack.push_back(std::move(ch));
+          });
+    }
+    return out;
+  }
+
+  // ── VERIFY: forward runs from every start within reach of a literal ──
+
+  template <class Fn>
+  static void verify(const FMIndex& idx, const Regex& re, const SAInterval& lit, const RegexOptions& opt,
+                     RegexStats& st, Fn&& fn) {
+    const uint64_t n = idx.size(), m = re.literal_.size();
+    const uint64_t reach = opt.max_length > m ? opt.max_length - m : 0;
+    const std::vector<uint64_t> at = idx.locate(lit, SIZE_MAX);
+    Forward fw(re);
+    // Starts [p - reach, p] per occurrence, merged; each run reads max_length bytes.
+    for (size_t w = 0; w < at.size();) {
+      const uint64_t lo = at[w] > reach ? at[w] - reach : 0;
+      uint64_t hi = at[w] + 1;
+      for (++w; w < at.size() && (at[w] > reach ? at[w] - reach : 0) <= hi; ++w) hi = at[w] + 1;
+      const std::string text = idx.fold(idx.extract(lo, std::min<uint64_t>(n, hi - 1 + opt.max_length) - lo));
+      st.scanned_bytes += text.size();
+      for (uint64_t s = lo; s < hi; ++s)
+        fw.run(std::string_view(text).substr(s - lo), opt.max_length,
+               [&](size_t len) { fn(RegexMatch{s, static_cast<uint32_t>(len)}); });
+    }
+  }
+
+  /// Picks the plan; counts the literal. Returns false when nothing can match.
+  /// opt.max_length is at most idx.size() (see bounded()).
+  static bool plan(const FMIndex& idx, const Regex& re, const RegexOptions& opt, RegexStats& st, SAInterval& lit) {
+    st = {};
+    st.plan = opt.plan;
+    if (opt.max_length == 0 || idx.size() == 0) return false;
+    lit = idx.interval(re.literal_);
+    st.literal_count = re.literal_.empty() ? idx.size() : lit.size();
+    if (st.literal_count == 0) return false;
+    if (st.plan == RegexPlan::VERIFY && re.literal_.empty())
+      throw std::invalid_argument("regex: VERIFY needs a required literal");
+    if (st.plan == RegexPlan::AUTO) {
+      // A literal suffix is matched first by the traversal and keeps it
+      // narrow. Otherwise its first steps branch on a class, so verify while
+      // the candidate starts stay well below the text.
+      const uint64_t per = opt.max_length > re.literal_.size() ? opt.max_length - re.literal_.size() + 1 : 1;
+      st.plan = re.suffix_.empty() && !re.literal_.empty() && per <= idx.size() / 4 / st.literal_count
+                    ? RegexPlan::VERIFY : RegexPlan::TRAVERSE;
+    }
+    return true;
+  }
+};
+
+// ──────────────────────────────────────────────────────────────
+// Regex
+// ──────────────────────────────────────────────────────────────
+
+Regex Regex::compile(std::string_view pattern) {
+  const NodePtr ast = Parser(pattern).parse();
+  Regex re;
+  re.states_.emplace_back();  // 0: accept
+  re.start_ = RegexSearch::compile(re, *ast, 0);
+  const LitInfo li = literal_info(*ast);
+  re.literal_ = li.exact ? li.str : li.best;
+  re.suffix_ = li.exact ? li.str : li.suffix;
+  return re;
+}
+
+bool Regex::matches(std::string_view s) const {
+  RegexSearch::Forward fw(*this);
+  if (s.empty()) return RegexSearch::test(fw.init, 0);
+  bool full = false;
+  fw.run(s, s.size(), [&](size_t len) { full |= len == s.size(); });
+  return full;
+}
+
+Regex Regex::folded(const FoldTable& f) const {
+  Regex re = *this;
+  for (State& s : re.states_)
+    if (s.byte) s.cc = s.cc.mapped(f);
+  for (auto* lit : {&re.literal_, &re.suffix_})
+    for (auto& c : *lit) c = static_cast<char>(f[static_cast<uint8_t>(c)]);
+  return re;
+}
+
+// ──────────────────────────────────────────────────────────────
+// Searches
+// ──────────────────────────────────────────────────────────────
+
+/// re itself, or its folded copy (kept in tmp) on a folded index.
+static const Regex& for_index(const FMIndex& idx, const Regex& re, Regex& tmp) {
+  if (!idx.folded()) return re;
+  tmp = re.folded(idx.fold_table());
+  return tmp;
+}
+
+/// opt with max_length clamped to the text: no match is longer, and the plans add and multiply it.
+static RegexOptions bounded(const FMIndex& idx, const RegexOptions& opt) {
+  RegexOptions o = opt;
+  o.max_length = static_cast<size_t>(std::min<uint64_t>(o.max_length, idx.size()));
+  return o;
+}
+
+std::vector<SAInterval> regex_intervals(const FMIndex& idx, const Regex& pattern, const RegexOptions& opt,
+                                        RegexStats* stats) {
+  Regex tmp;
+  const Regex& re = for_index(idx, pattern, tmp);
+  RegexStats local;
+  RegexStats& st = stats ? *stats : local;
+  RegexOptions o = bounded(idx, opt);
+  o.plan = RegexPlan::TRAVERSE;
+  SAInterval lit;
+  if (!RegexSearch::plan(idx, re, o, st, lit)) return {};
+  return RegexSearch::traverse(idx, re, o, st);
+}
+
+uint64_t count_regex(const FMIndex& idx, const Regex& pattern, const RegexOptions& opt, RegexStats* stats) {
+  Regex tmp;
+  const RegexOptions o = bounded(idx, opt);
+  const Regex& re = for_index(idx, pattern, tmp);
+  RegexStats local;
+  RegexStats& st = stats ? *stats : local;
+  SAInterval lit;
+  if (!RegexSearch::plan(idx, re, o, st, lit)) return 0;
+  uint64_t n = 0;
+  if (st.plan == RegexPlan::VERIFY) {
+    RegexSearch::verify(idx, re, lit, o, st, [&](const RegexMatch&) { ++n; });
+  } else {
+    for (const SAInterval& iv : RegexSearch::traverse(idx, re, o, st)) n += iv.size();
+  }
+  return n;
+}
+
+std::vector<RegexMatch> find_regex(const FMIndex& idx, const Regex& pattern, const RegexOptions& opt, RegexStats* stats) {
+  Regex tmp;
+  const RegexOptions o = bounded(idx, opt);
+  const Regex& re = for_index(idx, pattern, tmp);
+  RegexStats local;
+  RegexStats& st = stats ? *stats : local;
+  std::vector<RegexMatch> out;
+  SAInterval lit;
+  if (o.limit == 0 || !RegexSearch::plan(idx, re, o, st, lit)) return out;
+  if (st.plan == RegexPlan::VERIFY) {
+    RegexSearch::verify(idx, re, lit, o, st, [&](const RegexMatch& m) {
+      if (out.size() < o.limit) out.push_back(m);
+    });
+  } else {
+    for (const SAInterval& iv : RegexSearch::traverse(idx, re, o, st)) {
+      if (out.size() >= o.limit) break;
+      for (uint64_t pos : idx.locate(iv, o.limit - out.size()))
+        out.push_back({pos, static_cast<uint32_t>(iv.len)});
+    }
+  }
+  std::sort(out.begin(), out.end(),
+            [](const RegexMatch& a, const RegexMatch& b) { return a.pos != b.pos ? a.pos < b.pos : a.length < b.length; });
+  return out;
+}
+
+} // namespace cs
@@ -0,0 +1,109 @@
+#pragma once
+/**
+ * regex.hpp — Regular-expression search over an FM-index.
+ *
+ * Syntax (bytes, POSIX-like):
+ *   x  .  [a-z]  [^…]  \d \w \s \D \W \S  \n \t \r \xHH  \x (literal x)
+ *   ( … )  a|b  a*  a+  a?  a{m}  a{m,}  a{m,n}
+ * '.' matches any byte but '\n'. Anchors (^, $) are not supported.
+ *
+ * A match is a (pos, length) pair with 1 <= length <= max_length such that
+ * text[pos, pos + length) is in the language; one position can match at
+ * several lengths. Two plans:
+ *   - TRAVERSE: the pattern is compiled to a Thompson NFA and run backwards
+ *     (last byte first) alongside backward search. Each node is an SA
+ *     interval plus the set of NFA states that can still finish the match;
+ *     one pruned wavelet descent lists the extensions some state accepts,
+ *     and a node dies when its interval or state set empties. Every
+ *     interval reached with the start state live is a distinct matching
+ *     string, so the cost follows the viable strings that occur in the
+ *     text, not its length.
+ *   - VERIFY: every match contains the pattern's required literal (the
+ *     longest string all matches share, e.g. "ERROR" in "ERROR [0-9]+").
+ *     Its occurrences are located and the NFA is run forwards from each
+ *     start that could reach them, over the extracted neighbourhood.
+ * AUTO traverses when every match ends in a known literal (the traversal
+ * begins with it and stays narrow), and verifies otherwise while the
+ * literal's candidate starts are a small part of the text.
+ * The literal is counted first in both plans; no occurrence means no match.
+ * On a folded index (BuildParams::fold) the pattern is folded the same way.
+ */
+
+#include "class_pattern.hpp"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace cs {
+
+class Regex {
+public:
+  /// Throws std::invalid_argument on a syntax error or a pattern whose NFA
+  /// exceeds MAX_STATES (large counted repeats).
+  static Regex compile(std::string_view pattern);
+
+  static constexpr size_t MAX_STATES = 1 << 16;
+
+  /// Longest string contained in every match ("" if none is known).
+  const std::string& required_literal() const { return literal_; }
+  size_t states() const { return states_.size(); }
+
+  /// Full-match test (reference semantics for the searches).
+  bool matches(std::string_view s) const;
+
+  /// The same pattern over folded bytes; searches on a folded index use it.
+  Regex folded(const FoldTable& f) const;
+
+private:
+  friend class RegexSearch;
+
+  struct State {
+    CharClass cc;                // Consumed by a byte state
+    bool byte = false;           // Byte state (cc, next) or split (eps)
+    uint32_t next = 0;
+    std::vector<uint32_t> eps;
+  };
+
+  std::vector<State> states_;  // State 0 accepts
+  uint32_t start_ = 0;
+  std::string literal_;
+  std::string suffix_;         // Ends every match
+};
+
+enum class RegexPlan { AUTO, TRAVERSE, VERIFY };
+
+struct RegexOptions {
+  size_t max_length = 256;  // Longest match reported
+  size_t limit = 100000;    // Matches returned by find_regex
+  RegexPlan plan = RegexPlan::AUTO;
+};
+
+struct RegexMatch {
+  uint64_t pos = 0;
+  uint32_t length = 0;
+  bool operator==(const RegexMatch&) const = default;
+};
+
+struct RegexStats {
+  RegexPlan plan = RegexPlan::AUTO;  // Plan actually run
+  uint64_t literal_count = 0;        // Occurrences of the required literal
+  uint64_t nodes = 0;                // TRAVERSE: (interval, state set) nodes expanded
+  uint64_t intervals = 0;            // TRAVERSE: matching intervals
+  uint64_t scanned_bytes = 0;        // VERIFY: bytes fed to the NFA
+};
+
+/// Number of matches.
+uint64_t count_regex(const FMIndex& idx, const Regex& re, const RegexOptions& opt = {},
+                     RegexStats* stats = nullptr);
+
+/// Matches ordered by position, then length. With more than opt.limit
+/// matches, which ones are returned depends on the plan.
+std::vector<RegexMatch> find_regex(const FMIndex& idx, const Regex& re, const RegexOptions& opt = {},
+                                   RegexStats* stats = nullptr);
+
+/// TRAVERSE only: every matching string's interval (len = match length).
+std::vector<SAInterval> regex_intervals(const FMIndex& idx, const Regex& re, const RegexOptions& opt = {},
+                                        RegexStats* stats = nullptr);
+
+} // namespace cs
@@ -0,0 +1,130 @@
+/**
+ * repeats.cpp — Weiner-link traversal of right-maximal strings.
+ */
+
+#include "repeats.hpp"
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+
+namespace cs {
+
+namespace {
+
+/// Distinct symbols after P (end of text included) and whether each occurs once.
+struct RightContext {
+  size_t distinct = 0;
+  bool all_once = true;
+};
+
+RightContext right_context(const FMIndex& idx, const BiInterval& v) {
+  RightContext r;
+  uint64_t total = 0;
+  idx.for_each_right_extension(v, [&](uint8_t, const BiInterval& e) {
+    ++r.distinct;
+    total += e.size;
+    r.all_once &= e.size == 1;
+  });
+  if (total < v.size) ++r.distinct;  // An occurrence ends the text
+  r.all_once &= v.size - total <= 1;
+  return r;
+}
+
+class Walker {
+public:
+  Walker(const FMIndex& idx, const RepeatOptions& opt, uint64_t min_count,
+         const std::function<void(std::span<const MaximalRepeat>)>& callback, std::mutex& mu, RepeatStats& stats)
+    : idx_(idx), opt_(opt), min_count_(min_count), callback_(callback), mu_(mu), stats_(stats) {}
+
+  /// Reports v if it qualifies and appends its right-maximal children to out.
+  void visit(const BiInterval& v, std::vector<BiInterval>& out) {
+    ++nodes_;
+    size_t left_distinct = 0;
+    uint64_t left_total = 0;
+    bool left_once = true;
+    idx_.for_each_left_extension(v, [&](uint8_t, const BiInterval& ch) {
+      ++left_distinct;
+      left_total += ch.size;
+      left_once &= ch.size == 1;
+      if (ch.size >= min_count_ && right_context(idx_, ch).distinct >= 2) out.push_back(ch);
+    });
+    if (left_total < v.size) ++left_distinct;  // An occurrence starts the text
+    left_once &= v.size - left_total <= 1;
+
+    if (v.len == 0 || v.len < opt_.min_length || v.size < min_count_ || left_distinct < 2) return;
+    if (opt_.supermaximal && !(left_once && right_context(idx_, v).all_once)) return;
+    MaximalRepeat r;
+    r.iv = idx_.to_interval(v);
+    if (opt_.locate_limit) r.positions = idx_.locate(r.iv, opt_.locate_limit);
+    batch_.push_back(std::move(r));
+    if (batch_.size() >= std::max<size_t>(1, opt_.batch)) flush();
+  }
+
+  /// Depth-first over the subtree below v.
+  void walk(const BiInterval& v) {
+    std::vector<BiInterval> stack{v};
+    while (!stack.empty()) {
+      const BiInterval top = stack.back();
+      stack.pop_back();
+      visit(top, stack);
+    }
+  }
+
+  /// Hands the pending batch to the callback. Called explicitly, never from a
+  /// destructor, so a throwing callback propagates instead of terminating.
+  void flush() {
+    std::lock_guard<std::mutex> lock(mu_);
+    stats_.nodes += nodes_;
+    nodes_ = 0;
+    if (batch_.empty()) return;
+    stats_.repeats += batch_.size();
+    ++stats_.batches;
+    callback_(batch_);
+    batch_.clear();
+  }
+
+private:
+  const FMIndex& idx_;
+  const RepeatOptions& opt_;
+  const uint64_t min_count_;
+  const std::function<void(std::span<const MaximalRepeat>)>& callback_;
+  std::mutex& mu_;
+  RepeatStats& stats_;
+  std::vector<MaximalRepeat> batch_;
+  uint64_t nodes_ = 0;
+};
+
+} // namespace
+
+RepeatStats find_maximal_repeats(const FMIndex& idx, const RepeatOptions& opt,
+                                 const std::function<void(std::span<const MaximalRepeat>)>& callback,
+                                 ThreadPool& pool) {
+  if (!idx.bidirectional()) throw std::logic_error("find_maximal_repeats: index is not bidirectional");
+  const uint64_t min_count = std::max<uint64_t>(2, opt.min_count);
+  const size_t want = opt.min_branches ? opt.min_branches : 16 * pool.size();
+  RepeatStats stats;
+  std::mutex mu;
+
+  // Serial breadth-first expansion from the root until there is enough work.
+  std::vector<BiInterval> frontier;
+  {
+    Walker top(idx, opt, min_count, callback, mu, stats);
+    const BiInterval root = idx.bi_full_interval();
+    if (right_context(idx, root).distinct >= 2) frontier.push_back(root);
+    while (!frontier.empty() && frontier.size() < want) {
+      std::vector<BiInterval> next;
+      for (const BiInterval& v : frontier) top.visit(v, next);
+      frontier.swap(next);
+    }
+    top.flush();
+  }
+
+  pool.parallel_for(frontier.size(), [&](size_t i) {
+    Walker w(idx, opt, min_count, callback, mu, stats);
+    w.walk(frontier[i]);
+    w.flush();
+  });
+  return stats;
+}
+
+} // namespace cs
@@ -0,0 +1,68 @@
+#pragma once
+/**
+ * repeats.hpp — Maximal and supermaximal repeats of an indexed text.
+ *
+ * A repeat P (two or more occurrences) is maximal when it cannot be extended
+ * on either side without losing an occurrence: its occurrences are preceded
+ * by at least two different symbols and followed by at least two different
+ * symbols (the start or end of the text counts as a symbol of its own).
+ * It is supermaximal when it is not inside another maximal repeat: every
+ * occurrence has a different left symbol and a different right symbol.
+ *
+ * Needs a bidirectional index. Right-maximal strings are the suffix-tree's
+ * internal nodes and are closed under taking suffixes, so they are all
+ * reached from the root by left extensions (Weiner links) that stay
+ * right-maximal:
+ *   - for_each_left_extension lists a node's left symbols in one wavelet
+ *     descent, which is also the left-diversity check
+ *   - for_each_right_extension on each child checks its right diversity
+ *   - children rarer than min_count are pruned
+ *
+ * The top of the tree is expanded serially, then subtrees run on the pool.
+ * Results are streamed in batches to the callback, which is called from the
+ * workers one at a time (batch order unspecified). Memory is bounded by the
+ * batch size and the per-worker stacks, whatever the number of repeats.
+ */
+
+#include "fm_index.hpp"
+#include "../util/thread_pool.hpp"
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+namespace cs {
+
+struct MaximalRepeat {
+  SAInterval iv;                    // Forward rows; iv.len is the repeat's length
+  std::vector<uint64_t> positions;  // Up to RepeatOptions::locate_limit, ascending
+  uint64_t length() const { return iv.len; }
+  uint64_t count() const { return iv.size(); }
+};
+
+struct RepeatOptions {
+  uint64_t min_length = 1;
+  uint64_t min_count = 2;       // Values below 2 are raised to 2
+  bool supermaximal = false;    // Report only supermaximal repeats
+  size_t locate_limit = 0;      // Positions per repeat (0 = none)
+  size_t batch = 1024;          // Repeats per callback
+  size_t min_branches = 0;      // Subtrees to split into (0 = 16 × pool size)
+};
+
+struct RepeatStats {
+  uint64_t repeats = 0;
+  uint64_t nodes = 0;     // Right-maximal strings visited
+  uint64_t batches = 0;
+};
+
+/**
+ * find_maximal_repeats(idx, opt, callback, pool) — Every maximal (or
+ * supermaximal) repeat of at least min_length bytes and min_count
+ * occurrences. Throws std::logic_error if idx is not bidirectional. An
+ * exception from the callback propagates; undelivered batches are dropped.
+ */
+RepeatStats find_maximal_repeats(const FMIndex& idx, const RepeatOptions& opt,
+                                 const std::function<void(std::span<const MaximalRepeat>)>& callback,
+                                 ThreadPool& pool);
+
+} // namespace cs
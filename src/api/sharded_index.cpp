@@ -0,0 +1,235 @@
+/**
+ * sharded_index.cpp — Parallel shard build and scatter-gather queries.
+ */
+
+#include "sharded_index.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace cs {
+
+uint64_t scan_count(std::string_view s, std::string_view pattern) {
+  uint64_t c = 0;
+  for (size_t at = s.find(pattern); at != std::string_view::npos; at = s.find(pattern, at + 1)) ++c;
+  return c;
+}
+
+// ──────────────────────────────────────────────────────────────
+// build: Choose cuts, then build every shard in parallel
+// ──────────────────────────────────────────────────────────────
+
+static std::vector<uint64_t> choose_cuts(const std::string& text, const ShardParams& p) {
+  const uint64_t n = text.size();
+  std::vector<uint64_t> cuts;
+  if (!p.boundaries.empty()) {
+    cuts = p.boundaries;
+    if (cuts.front() != 0) throw std::invalid_argument("shard boundaries must start at 0");
+    for (size_t i = 1; i < cuts.size(); ++i) {
+      if (cuts[i] <= cuts[i - 1] || cuts[i] > n) {
+        throw std::invalid_argument("shard boundaries must be increasing and within the text");
+      }
+    }
+    return cuts;
+  }
+  const size_t k = std::max<size_t>(1, std::min<uint64_t>(p.num_shards, std::max<uint64_t>(n, 1)));
+  cuts.push_back(0);
+  for (size_t i = 1; i < k; ++i) {
+    uint64_t c = n * i / k;
+    if (p.boundary_char >= 0) {
+      // Move the cut to just after the next boundary byte, e.g. a newline.
+      const size_t at = text.find(static_cast<char>(p.boundary_char), c);
+      c = at == std::string::npos ? n : at + 1;
+    }
+    if (c > cuts.back() && c < n) cuts.push_back(c);
+  }
+  return cuts;
+}
+
+ShardedIndex ShardedIndex::build(const std::string& text, const ShardParams& p, ThreadPool& pool) {
+  if (p.max_pattern_len == 0) throw std::invalid_argument("max_pattern_len must be positive");
+  ShardedIndex si;
+  si.n_ = text.size();
+  si.max_pattern_len_ = p.max_pattern_len;
+
+  const std::vector<uint64_t> cuts = choose_cuts(text, p);
+  const uint64_t overlap = p.max_pattern_len - 1;
+  si.shards_.resize(cuts.size());
+  pool.parallel_for(cuts.size(), [&](size_t i) {
+    Shard& s = si.shards_[i];
+    s.start = cuts[i];
+    const uint64_t end = i + 1 < cuts.size() ? cuts[i + 1] : si.n_;
+    s.owned = end - s.start;
+    s.tail = text.substr(end, std::min<uint64_t>(overlap, si.n_ - end));
+    s.index = FMIndex::build_from_text(text.substr(s.start, s.owned) + s.tail, p.build);
+  });
+  return si;
+}
+
+// ──────────────────────────────────────────────────────────────
+// Queries: fan out, subtract tail hits, merge
+// ──────────────────────────────────────────────────────────────
+
+void ShardedIndex::check_pattern(std::string_view pattern) const {
+  if (pattern.size() > max_pattern_len_) {
+    throw std::invalid_argument("pattern longer than shard max_pattern_len (" +
+                                std::to_string(max_pattern_len_) + ")");
+  }
+}
+
+uint64_t ShardedIndex::shard_count(const Shard& s, std::string_view pattern) const {
+  const uint64_t c = s.index.count(pattern);
+  return c ? c - scan_count(s.index.fold(s.tail), s.index.fold(pattern)) : 0;
+}
+
+uint64_t ShardedIndex::count(std::string_view pattern, ThreadPool& pool) const {
+  if (pattern.empty()) return n_;
+  check_pattern(pattern);
+  std::vector<uint64_t> partial(shards_.size());
+  pool.parallel_for(shards_.size(), [&](size_t i) { partial[i] = shard_count(shards_[i], pattern); });
+  uint64_t total = 0;
+  for (uint64_t c : partial) total += c;
+  return total;
+}
+
+std::vector<uint64_t> ShardedIndex::count_batch(const std::vector<std::string>& patterns,
+                                                ThreadPool& pool) const {
+  for (const auto& p : patterns) check_pattern(p);
+  std::vector<std::vector<uint64_t>> partial(shards_.size());
+  pool.parallel_for(shards_.size(), [&](size_t i) {
+    partial[i].resize(patterns.size());
+    for (size_t k = 0; k < patterns.size(); ++k) {
+      partial[i][k] = patterns[k].empty() ? 0 : shard_count(shards_[i], patterns[k]);
+    }
+  });
+  std::vector<uint64_t> total(patterns.size(), 0);
+  for (size_t k = 0; k < patterns.size(); ++k) {
+    if (patterns[k].empty()) { total[k] = n_; continue; }
+    for (const auto& part : partial) total[k] += part[k];
+  }
+  return total;
+}
+
+std::vector<uint64_t> ShardedIndex::locate(std::string_view pattern, ThreadPool& pool,
+                                           size_t limit) const {
+  if (pattern.empty()) return {};
+  check_pattern(pattern);
+  std::vector<std::vector<uint64_t>> partial(shards_.size());
+  pool.parallel_for(shards_.size(), [&](size_t i) {
+    const Shard& s = shards_[i];
+    auto& out = partial[i];
+    for (uint64_t p : s.index.locate_smallest(pattern, limit)) {
+      if (p < s.owned) out.push_back(s.start + p);
+    }
+  });
+
+  std::vector<uint64_t> merged;
+  for (auto& part : partial) merged.insert(merged.end(), part.begin(), part.end());
+  std::sort(merged.begin(), merged.end());
+  if (merged.size() > limit) merged.resize(limit);
+  return merged;
+}
+
+std::string ShardedIndex::extract(uint64_t pos, uint64_t len) const {
+  std::string out;
+  if (pos >= n_) return out;
+  len = std::min<uint64_t>(len, n_ - pos);
+  // Last shard whose start is <= pos.
+  auto it = std::upper_bound(shards_.begin(), shards_.end(), pos,
+                             [](uint64_t p, const Shard& s) { return p < s.start; });
+  for (--it; len > 0 && it != shards_.end(); ++it) {
+    const uint64_t local = pos - it->start;
+    const uint64_t take = std::min<uint64_t>(len, it->owned - local);
+    out += it->index.extract(local, take);
+    pos += take;
+    len -= take;
+  }
+  return out;
+}
+
+// ──────────────────────────────────────────────────────────────
+// Persistence: manifest + one .csidx per shard
+// ──────────────────────────────────────────────────────────────
+
+void ShardManifest::write(const std::string& path) const {
+  std::ofstream out(path, std::ios::trunc);
+  if (!out) throw std::runtime_error("cannot write manifest: " + path);
+  out << "cs-shards 1\n";
+  out << "n " << n << "\n";
+  out << "max_pattern_len " << max_pattern_len << "\n";
+  for (const auto& s : shards) {
+    out << "shard " << s.start << " " << s.owned << " " << s.tail_len << " " << s.file << "\n";
+  }
+  if (!out) throw std::runtime_error("error writing manifest: " + path);
+}
+
+ShardManifest ShardManifest::read(const std::string& path) {
+  std::ifstream in(path);
+  if (!in) throw std::runtime_error("cannot open manifest: " + path);
+  ShardManifest m;
+  std::string line, key;
+  if (!std::getline(in, line) || line != "cs-shards 1") {
+    throw std::runtime_error("not a shard manifest: " + path);
+  }
+  while (std::getline(in, line)) {
+    if (line.empty()) continue;
+    std::istringstream ls(line);
+    ls >> key;
+    if (key == "n") {
+      ls >> m.n;
+    } else if (key == "max_pattern_len") {
+      ls >> m.max_pattern_len;
+    } else if (key == "shard") {
+      ShardInfo s;
+      ls >> s.start >> s.owned >> s.tail_len >> s.file;
+      m.shards.push_back(s);
+    } else {
+      throw std::runtime_error("manifest: unknown key '" + key + "' in " + path);
+    }
+    if (!ls) throw std::runtime_error("manifest: malformed line '" + line + "' in " + path);
+  }
+  if (m.shards.empty() || m.max_pattern_len == 0) throw std::runtime_error("manifest: no shards in " + path);
+  return m;
+}
+
+ShardManifest ShardedIndex::manifest() const {
+  ShardManifest m;
+  m.n = n_;
+  m.max_pattern_len = max_pattern_len_;
+  for (size_t i = 0; i < shards_.size(); ++i) {
+    const Shard& s = shards_[i];
+    m.shards.push_back({s.start, s.owned, s.tail.size(), "shard-" + std::to_string(i) + ".csidx"});
+  }
+  return m;
+}
+
+void ShardedIndex::save(const std::string& dir) const {
+  std::filesystem::create_directories(dir);
+  const ShardManifest m = manifest();
+  for (size_t i = 0; i < shards_.size(); ++i) shards_[i].index.save(dir + "/" + m.shards[i].file);
+  m.write(dir + "/shards.manifest");
+}
+
+ShardedIndex ShardedIndex::load(const std::string& dir, ThreadPool& pool) {
+  const ShardManifest m = ShardManifest::read(dir + "/shards.manifest");
+  ShardedIndex si;
+  si.n_ = m.n;
+  si.max_pattern_len_ = m.max_pattern_len;
+  si.shards_.resize(m.shards.size());
+  pool.parallel_for(m.shards.size(), [&](size_t i) {
+    const ShardInfo& info = m.shards[i];
+    Shard& s = si.shards_[i];
+    s.index = FMIndex::load(dir + "/" + info.file);
+    if (s.index.size() != info.owned + info.tail_len) {
+      throw std::runtime_error("shard size does not match manifest: " + info.file);
+    }
+    s.start = info.start;
+    s.owned = info.owned;
+    s.tail = s.index.extract(info.owned, info.tail_len);
+  });
+  return si;
+}
+
+} // namespace cs
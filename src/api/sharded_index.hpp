@@ -0,0 +1,104 @@
+#pragma once
+/**
+ * sharded_index.hpp — Text split into independently built FMIndex shards.
+ *
+ * Shard i owns text positions [start_i, start_{i+1}) and additionally indexes
+ * the first `overlap = max_pattern_len - 1` bytes of the next shard (its tail),
+ * so any occurrence of a pattern up to max_pattern_len long that starts in the
+ * owned range is fully inside the shard. Occurrences starting in the tail
+ * belong to the next shard and are subtracted (count) or filtered (locate).
+ *
+ * Shards are built in parallel; count/locate fan out to every shard on a
+ * ThreadPool and merge with global position offsets.
+ *
+ * save(dir) writes one .csidx per shard plus a text manifest, which is also
+ * what a multi-process Coordinator (src/server/coordinator.hpp) reads:
+ *   cs-shards 1
+ *   n <text_len>
+ *   max_pattern_len <L>
+ *   shard <start> <owned> <tail_len> <file>     (one line per shard)
+ */
+
+#include "fm_index.hpp"
+#include "../util/thread_pool.hpp"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace cs {
+
+struct ShardParams {
+  size_t num_shards = 4;              // Ignored when boundaries is non-empty
+  std::vector<uint64_t> boundaries;   // Explicit shard starts (first must be 0)
+  int boundary_char = -1;             // Snap even cuts to just after this byte (-1 = off)
+  size_t max_pattern_len = 256;       // Longest pattern guaranteed across cuts
+  BuildParams build;
+};
+
+struct ShardInfo {
+  uint64_t start = 0;     // Global offset of the first owned byte
+  uint64_t owned = 0;     // Owned byte count
+  uint64_t tail_len = 0;  // Overlap bytes indexed after the owned range
+  std::string file;       // Shard .csidx, relative to the manifest directory
+};
+
+struct ShardManifest {
+  uint64_t n = 0;
+  size_t max_pattern_len = 0;
+  std::vector<ShardInfo> shards;
+
+  void write(const std::string& path) const;
+  /// Throws std::runtime_error on a missing or malformed manifest.
+  static ShardManifest read(const std::string& path);
+};
+
+/// Occurrences of pattern in s by direct scan (used on short shard tails).
+uint64_t scan_count(std::string_view s, std::string_view pattern);
+
+class ShardedIndex {
+public:
+  static ShardedIndex build(const std::string& text, const ShardParams& p, ThreadPool& pool);
+
+  /// Throws std::invalid_argument if pattern is longer than max_pattern_len.
+  uint64_t count(std::string_view pattern, ThreadPool& pool) const;
+
+  /// Per-pattern counts; each shard task handles the whole batch.
+  std::vector<uint64_t> count_batch(const std::vector<std::string>& patterns,
+                                    ThreadPool& pool) const;
+
+  /// The `limit` smallest global positions, ascending (shards use FMIndex::locate_smallest).
+  std::vector<uint64_t> locate(std::string_view pattern, ThreadPool& pool,
+                               size_t limit = 100000) const;
+
+  std::string extract(uint64_t pos, uint64_t len) const;
+
+  /// Writes dir/shards.manifest and dir/shard-<i>.csidx (dir is created).
+  void save(const std::string& dir) const;
+  static ShardedIndex load(const std::string& dir, ThreadPool& pool);
+  ShardManifest manifest() const;
+
+  uint64_t size() const { return n_; }
+  size_t num_shards() const { return shards_.size(); }
+  size_t max_pattern_len() const { return max_pattern_len_; }
+  const FMIndex& shard(size_t i) const { return shards_[i].index; }
+  uint64_t shard_start(size_t i) const { return shards_[i].start; }
+  uint64_t shard_owned(size_t i) const { return shards_[i].owned; }
+
+private:
+  struct Shard {
+    FMIndex index;          // Over owned bytes + tail
+    uint64_t start = 0;     // Global offset of the first owned byte
+    uint64_t owned = 0;     // Owned byte count
+    std::string tail;       // Overlap copied from the next shard
+  };
+
+  uint64_t shard_count(const Shard& s, std::string_view pattern) const;
+  void check_pattern(std::string_view pattern) const;
+
+  uint64_t n_ = 0;
+  size_t max_pattern_len_ = 0;
+  std::vector<Shard> shards_;
+};
+
+} // namespace cs
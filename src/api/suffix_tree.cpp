@@ -0,0 +1,100 @@
+/**
+ * suffix_tree.cpp — Node operations from LCP smaller-value queries and psi.
+ */
+
+#include "suffix_tree.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace cs {
+
+SuffixTree::SuffixTree(const FMIndex& idx) : idx_(idx) {
+  if (!idx_.has_lcp()) throw std::logic_error("SuffixTree: index built without BuildParams::lcp");
+}
+
+SAInterval SuffixTree::widen(uint64_t sp, uint64_t ep, uint64_t d) const {
+  if (d == 0) return root();
+  const LcpArray& lcp = idx_.lcp_array();
+  auto get = [this](size_t k) { return idx_.lcp(k); };
+  const uint32_t depth = static_cast<uint32_t>(d);
+  return {lcp.prev_smaller(sp, depth, get), lcp.next_smaller(ep, depth, get), d};
+}
+
+uint64_t SuffixTree::child_end(uint64_t k, uint64_t ep, uint64_t d) const {
+  auto get = [this](size_t r) { return idx_.lcp(r); };
+  return std::min<uint64_t>(ep, idx_.lcp_array().next_smaller(k + 1, static_cast<uint32_t>(d + 1), get));
+}
+
+// ──────────────────────────────────────────────────────────────
+// node / string_depth / label_at
+// ──────────────────────────────────────────────────────────────
+
+SAInterval SuffixTree::node(const SAInterval& iv) const {
+  if (iv.empty()) return {0, 0, iv.len};
+  return {iv.sp, iv.ep, string_depth(iv)};
+}
+
+uint64_t SuffixTree::string_depth(const SAInterval& v) const {
+  if (v.empty()) return 0;
+  if (is_leaf(v)) return idx_.size() - idx_.sa_at(v.sp);
+  auto get = [this](size_t k) { return idx_.lcp(k); };
+  return idx_.lcp_array().range_min(v.sp + 1, v.ep, get);
+}
+
+uint8_t SuffixTree::label_at(const SAInterval& v, uint64_t d) const {
+  return symbol_at(idx_.sa_at(v.sp) + d);
+}
+
+// ──────────────────────────────────────────────────────────────
+// parent / children / child
+// ──────────────────────────────────────────────────────────────
+
+SAInterval SuffixTree::parent(const SAInterval& v) const {
+  if (v.empty() || is_root(v)) return root();
+  const uint64_t rows = idx_.full_interval().ep;
+  const uint64_t d = std::max(idx_.lcp(v.sp), v.ep < rows ? idx_.lcp(v.ep) : 0u);
+  return widen(v.sp, v.ep, d);
+}
+
+std::vector<SAInterval> SuffixTree::children(const SAInterval& v) const {
+  std::vector<SAInterval> out;
+  if (v.empty() || is_leaf(v)) return out;
+  const uint64_t d = v.len;
+  for (uint64_t k = v.sp; k < v.ep;) {
+    const uint64_t e = child_end(k, v.ep, d);
+    out.push_back(node({k, e, 0}));
+    k = e;
+  }
+  return out;
+}
+
+SAInterval SuffixTree::child(const SAInterval& v, uint8_t c) const {
+  if (v.empty() || is_leaf(v)) return {0, 0, v.len + 1};
+  c = idx_.fold_table()[c];
+  const uint64_t d = v.len;
+  for (uint64_t k = v.sp; k < v.ep;) {
+    const uint64_t e = child_end(k, v.ep, d);
+    const uint64_t pos = idx_.sa_at(k) + d;
+    if (pos < idx_.size()) {  // Skip the leaf that ends at the terminator
+      const uint8_t first = symbol_at(pos);
+      if (first == c) return node({k, e, 0});
+      if (first > c) break;  // Children are in symbol order
+    }
+    k = e;
+  }
+  return {0, 0, v.len + 1};
+}
+
+// ──────────────────────────────────────────────────────────────
+// suffix_link: Rows of aX map through psi to rows of X
+// ──────────────────────────────────────────────────────────────
+
+SAInterval SuffixTree::suffix_link(const SAInterval& v) const {
+  if (v.empty() || v.len == 0) return root();
+  const uint64_t lo = idx_.psi(v.sp);
+  if (is_leaf(v)) return {lo, lo + 1, v.len - 1};
+  const uint64_t hi = idx_.psi(v.ep - 1);
+  return widen(lo, hi + 1, v.len - 1);
+}
+
+} // namespace cs
@@ -0,0 +1,70 @@
+#pragma once
+/**
+ * suffix_tree.hpp — Compressed suffix tree navigation over an FMIndex.
+ *
+ * A node is the SAInterval of its subtree's rows with len = string depth,
+ * so any backward-search result can be turned into a node with node().
+ * Built from the index's LCP array (BuildParams::lcp), no extra storage:
+ *   - string_depth: range minimum of LCP inside the interval; a leaf's is
+ *     its suffix length (the virtual terminator is not counted)
+ *   - parent: widen to max(LCP[sp], LCP[ep]) via prev/next smaller values
+ *   - child / children: split at rows whose LCP equals the node's depth;
+ *     the edge symbol comes from one sa_at per child
+ *   - suffix_link: psi() of the first and last row, widened to depth - 1
+ *
+ * With a PLCP index every LCP read is an SA lookup, so operations are
+ * slower by about the SSA stride. The tree borrows the index.
+ */
+
+#include "fm_index.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace cs {
+
+class SuffixTree {
+public:
+  /// Throws std::logic_error if idx was built without BuildParams::lcp.
+  explicit SuffixTree(const FMIndex& idx);
+
+  SAInterval root() const { return idx_.full_interval(); }
+  bool is_root(const SAInterval& v) const { return v.sp == 0 && v.ep == idx_.full_interval().ep; }
+  bool is_leaf(const SAInterval& v) const { return v.size() == 1; }
+
+  /// The node with exactly iv's rows (e.g. idx.interval(P) is the locus of P).
+  SAInterval node(const SAInterval& iv) const;
+
+  /// String depth of the node spanning rows [sp, ep).
+  uint64_t string_depth(const SAInterval& v) const;
+
+  /// Parent node; the root is its own parent.
+  SAInterval parent(const SAInterval& v) const;
+
+  /// Child whose edge starts with c (folded on a folded index); empty interval if none (or v is a leaf).
+  SAInterval child(const SAInterval& v, uint8_t c) const;
+
+  /// All children in row order. The empty suffix's leaf (below the root) is included.
+  std::vector<SAInterval> children(const SAInterval& v) const;
+
+  /// Node for the label of v without its first symbol; the root links to itself.
+  SAInterval suffix_link(const SAInterval& v) const;
+
+  /// Symbol at offset d of v's label (d < string depth); folded on a folded index.
+  uint8_t label_at(const SAInterval& v, uint64_t d) const;
+
+  const FMIndex& index() const { return idx_; }
+
+private:
+  /// Smallest node around [sp, ep) with string depth >= d.
+  SAInterval widen(uint64_t sp, uint64_t ep, uint64_t d) const;
+  /// End of the child of a depth-d node that starts at row k.
+  uint64_t child_end(uint64_t k, uint64_t ep, uint64_t d) const;
+  /// Text symbol at pos as the index orders it: extract() returns the original byte.
+  uint8_t symbol_at(uint64_t pos) const {
+    return idx_.fold_table()[static_cast<uint8_t>(idx_.extract(pos, 1)[0])];
+  }
+
+  const FMIndex& idx_;
+};
+
+} // namespace cs
@@ -0,0 +1,146 @@
+/**
+ * utf8_index.cpp — Decode, number the code points, build over the ids.
+ */
+
+#include "utf8_index.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace cs {
+
+// ──────────────────────────────────────────────────────────────
+// UTF-8 (RFC 3629: shortest form, no surrogates, at most U+10FFFF)
+// ──────────────────────────────────────────────────────────────
+
+uint32_t decode_utf8(std::string_view s, size_t& i) {
+  const uint8_t b0 = static_cast<uint8_t>(s[i]);
+  if (b0 < 0x80) {
+    ++i;
+    return b0;
+  }
+  size_t len = 0;
+  uint32_t cp = 0, min = 0;
+  if ((b0 & 0xE0) == 0xC0) len = 2, cp = b0 & 0x1F, min = 0x80;
+  else if ((b0 & 0xF0) == 0xE0) len = 3, cp = b0 & 0x0F, min = 0x800;
+  else if ((b0 & 0xF8) == 0xF0) len = 4, cp = b0 & 0x07, min = 0x10000;
+  bool ok = len != 0 && i + len <= s.size();
+  for (size_t k = 1; ok && k < len; ++k) {
+    const uint8_t b = static_cast<uint8_t>(s[i + k]);
+    ok = (b & 0xC0) == 0x80;
+    cp = cp << 6 | (b & 0x3F);
+  }
+  if (!ok || cp < min || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) {
+    ++i;
+    return INVALID_BASE + b0;
+  }
+  i += len;
+  return cp;
+}
+
+void append_utf8(std::string& out, uint32_t cp) {
+  if (cp < 0x80) {
+    out += static_cast<char>(cp);
+  } else if (cp >= INVALID_BASE) {
+    out += static_cast<char>(cp - INVALID_BASE);
+  } else if (cp < 0x800) {
+    out += static_cast<char>(0xC0 | cp >> 6);
+    out += static_cast<char>(0x80 | (cp & 0x3F));
+  } else if (cp < 0x10000) {
+    out += static_cast<char>(0xE0 | cp >> 12);
+    out += static_cast<char>(0x80 | (cp >> 6 & 0x3F));
+    out += static_cast<char>(0x80 | (cp & 0x3F));
+  } else {
+    out += static_cast<char>(0xF0 | cp >> 18);
+    out += static_cast<char>(0x80 | (cp >> 12 & 0x3F));
+    out += static_cast<char>(0x80 | (cp >> 6 & 0x3F));
+    out += static_cast<char>(0x80 | (cp & 0x3F));
+  }
+}
+
+// ──────────────────────────────────────────────────────────────
+// build: Decode, dense ids in code point order, FM-index over ids
+// ──────────────────────────────────────────────────────────────
+
+Utf8Index Utf8Index::build(std::string_view text, const Utf8IndexParams& p) {
+  Utf8Index u;
+  u.bytes_ = text.size();
+  std::vector<uint32_t> T;
+  T.reserve(text.size());
+  std::vector<uint8_t> starts(p.byte_offsets ? text.size() + 1 : 0, 0);
+  for (size_t i = 0; i < text.size();) {
+    if (p.byte_offsets) starts[i] = 1;
+    T.push_back(decode_utf8(text, i));
+  }
+  if (p.byte_offsets) {
+    starts[text.size()] = 1;
+    u.starts_.build(starts);
+  }
+
+  u.cps_ = T;
+  std::sort(u.cps_.begin(), u.cps_.end());
+  u.cps_.erase(std::unique(u.cps_.begin(), u.cps_.end()), u.cps_.end());
+  for (size_t k = 0; k < u.cps_.size() && u.cps_[k] < 128; ++k) u.ascii_[u.cps_[k]] = static_cast<uint32_t>(k + 1);
+  for (auto& v : T) v = u.id(v);
+
+  u.fm_.build(T, static_cast<uint32_t>(u.cps_.size()), p.sample_stride);
+  return u;
+}
+
+uint32_t Utf8Index::id(uint32_t cp) const {
+  if (cp < 128) return ascii_[cp];
+  const auto it = std::lower_bound(cps_.begin(), cps_.end(), cp);
+  return it != cps_.end() && *it == cp ? static_cast<uint32_t>(it - cps_.begin() + 1) : 0;
+}
+
+std::vector<uint32_t> Utf8Index::ids(std::string_view pattern) const {
+  std::vector<uint32_t> out;
+  out.reserve(pattern.size());
+  for (size_t i = 0; i < pattern.size();) out.push_back(id(decode_utf8(pattern, i)));
+  return out;
+}
+
+// ──────────────────────────────────────────────────────────────
+// Search
+// ──────────────────────────────────────────────────────────────
+
+SAInterval Utf8Index::interval(std::string_view pattern) const { return fm_.interval(ids(pattern)); }
+
+uint64_t Utf8Index::count(std::string_view pattern) const {
+  if (pattern.empty()) return size();
+  return interval(pattern).size();
+}
+
+std::vector<uint64_t> Utf8Index::locate(std::string_view pattern, size_t limit) const {
+  if (pattern.empty()) return {};
+  return fm_.locate(interval(pattern), limit);
+}
+
+std::vector<uint64_t> Utf8Index::locate_bytes(std::string_view pattern, size_t limit) const {
+  auto hits = locate(pattern, limit);
+  for (auto& h : hits) h = byte_offset(h);
+  return hits;
+}
+
+std::string Utf8Index::extract(uint64_t pos, uint64_t len) const {
+  std::string out;
+  for (uint32_t v : fm_.extract(pos, len)) append_utf8(out, cps_[v - 1]);
+  return out;
+}
+
+uint64_t Utf8Index::byte_offset(uint64_t pos) const {
+  if (!starts_.size()) throw std::logic_error("byte_offset: index built without byte_offsets");
+  if (pos > size()) throw std::out_of_range("byte_offset: character position out of range");
+  return starts_.select1(pos + 1);
+}
+
+uint64_t Utf8Index::char_at_byte(uint64_t b) const {
+  if (!starts_.size()) throw std::logic_error("char_at_byte: index built without byte_offsets");
+  if (b >= bytes_) throw std::out_of_range("char_at_byte: byte offset out of range");
+  return starts_.rank1(b + 1) - 1;
+}
+
+size_t Utf8Index::size_in_bytes() const {
+  return cps_.size() * 4 + sizeof(ascii_) + fm_.size_in_bytes() + bitvector_bytes(starts_);
+}
+
+} // namespace cs
@@ -0,0 +1,88 @@
+#pragma once
+/**
+ * utf8_index.hpp — FM-index over the code points of UTF-8 text.
+ *
+ * The byte-level FMIndex takes two to four steps per non-ASCII character and
+ * can match a pattern that starts or ends inside a multi-byte sequence (a
+ * pattern made of continuation bytes, or one cut mid-character). Here the
+ * text is decoded once and the distinct code points are numbered 1..σ in code
+ * point order (which is also UTF-8 byte order), so:
+ *   - backward search takes one step per character, whatever its length
+ *   - every hit starts and ends on a character boundary
+ *   - the BWT's wavelet matrix has ceil(log2(σ + 1)) levels, not 8
+ *
+ * Malformed input is kept, not rejected: each byte that does not start a
+ * well-formed sequence (stray continuation bytes, overlong forms,
+ * surrogates, truncated sequences, values above U+10FFFF) decodes on its own
+ * as INVALID_BASE + byte, so extract() gives the original bytes back and
+ * such bytes only match the same bytes in a pattern.
+ *
+ * A bitvector of character starts over the text bytes maps code point
+ * positions to byte offsets and back.
+ */
+
+#include "int_fm_index.hpp"
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace cs {
+
+/// Code points INVALID_BASE + 0x80 … + 0xFF stand for undecodable bytes.
+constexpr uint32_t INVALID_BASE = 0x110000;
+
+/// Decodes the character at s[i] and advances i past it (see INVALID_BASE).
+uint32_t decode_utf8(std::string_view s, size_t& i);
+/// Appends cp as UTF-8 (an INVALID_BASE code point as its raw byte).
+void append_utf8(std::string& out, uint32_t cp);
+
+struct Utf8IndexParams {
+  uint32_t sample_stride = 32;  // SA and ISA sampling (characters)
+  bool byte_offsets = true;     // Keep character starts for byte_offset()
+};
+
+class Utf8Index {
+public:
+  static Utf8Index build(std::string_view text, const Utf8IndexParams& p = {});
+
+  /// Characters in the text / distinct characters / bytes of the text.
+  uint64_t size() const { return fm_.size(); }
+  size_t alphabet() const { return cps_.size(); }
+  uint64_t bytes() const { return bytes_; }
+
+  /// Id of code point cp, or 0 if it never occurs.
+  uint32_t id(uint32_t cp) const;
+  uint32_t code_point(uint32_t id) const { return id && id <= cps_.size() ? cps_[id - 1] : 0; }
+  /// Ids of the pattern's characters (0 for characters not in the text).
+  std::vector<uint32_t> ids(std::string_view pattern) const;
+
+  /// Backward search, one step per character (len counts characters).
+  SAInterval interval(std::string_view pattern) const;
+
+  /// Same meaning as FMIndex::count/locate; positions are in characters.
+  uint64_t count(std::string_view pattern) const;
+  std::vector<uint64_t> locate(std::string_view pattern, size_t limit=100000) const;
+  /// Hits as byte offsets into the text (needs byte_offsets).
+  std::vector<uint64_t> locate_bytes(std::string_view pattern, size_t limit=100000) const;
+
+  /// Characters [pos, pos + len) as UTF-8 (original bytes for malformed input).
+  std::string extract(uint64_t pos, uint64_t len) const;
+
+  /// Byte offset of character pos (pos == size() gives bytes()), and the
+  /// character containing byte b. Both need byte_offsets.
+  uint64_t byte_offset(uint64_t pos) const;
+  uint64_t char_at_byte(uint64_t b) const;
+
+  size_t size_in_bytes() const;
+
+private:
+  uint64_t bytes_ = 0;
+  std::vector<uint32_t> cps_;           // Id - 1 → code point, ascending
+  std::array<uint32_t, 128> ascii_{};   // ASCII code point → id (0 = absent)
+  IntFMIndex fm_;                       // Over character ids
+  BitVector starts_;                    // Character start bits over the text bytes, plus the end
+};
+
+} // namespace cs
@@ -0,0 +1,120 @@
+/**
+ * word_index.cpp — Tokenize, build the id sequence's FM-index, search.
+ */
+
+#include "word_index.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace cs {
+
+// ──────────────────────────────────────────────────────────────
+// build: Tokens, dictionary, FM-index over ids
+// ──────────────────────────────────────────────────────────────
+
+WordIndex WordIndex::build(std::string_view text, const WordIndexParams& p) {
+  WordIndex w;
+  w.tokenizer_ = p.tokenizer;
+
+  // 1) Tokens, folded, with their starts.
+  std::vector<std::string> tokens;
+  std::vector<uint8_t> starts(p.byte_offsets ? text.size() + 1 : 0, 0);
+  tokenize(text, p.tokenizer, [&](std::string_view t, size_t at) {
+    tokens.emplace_back(t);
+    if (p.tokenizer.fold)
+      for (auto& c : tokens.back()) c = static_cast<char>((*p.tokenizer.fold)[static_cast<uint8_t>(c)]);
+    if (p.byte_offsets) starts[at] = 1;
+  });
+  if (p.byte_offsets) w.starts_.build(starts);
+  w.n_ = tokens.size();
+
+  // 2) Dictionary in byte order, so ids compare like their tokens.
+  std::vector<std::string_view> dict(tokens.begin(), tokens.end());
+  std::sort(dict.begin(), dict.end());
+  dict.erase(std::unique(dict.begin(), dict.end()), dict.end());
+  std::unordered_map<std::string_view, uint32_t> ids;
+  for (const auto& t : dict) {
+    w.dict_ += t;
+    w.dict_offsets_.push_back(static_cast<uint32_t>(w.dict_.size()));
+  }
+  for (size_t i = 0; i < dict.size(); ++i) ids.emplace(w.token(static_cast<uint32_t>(i + 1)), static_cast<uint32_t>(i + 1));
+  std::vector<uint32_t> T(w.n_);
+  for (size_t i = 0; i < w.n_; ++i) T[i] = ids.at(tokens[i]);
+  tokens.clear();
+
+  // 3) FM-index over the ids.
+  w.fm_.build(T, static_cast<uint32_t>(dict.size()), p.sample_stride);
+  return w;
+}
+
+// ──────────────────────────────────────────────────────────────
+// Dictionary
+// ──────────────────────────────────────────────────────────────
+
+std::string_view WordIndex::token(uint32_t id) const {
+  if (id == 0 || id > vocabulary()) return {};
+  return std::string_view(dict_).substr(dict_offsets_[id - 1], dict_offsets_[id] - dict_offsets_[id - 1]);
+}
+
+uint32_t WordIndex::id(std::string_view t) const {
+  std::string folded(t);
+  if (tokenizer_.fold)
+    for (auto& c : folded) c = static_cast<char>((*tokenizer_.fold)[static_cast<uint8_t>(c)]);
+  uint32_t lo = 1, hi = static_cast<uint32_t>(vocabulary()) + 1;
+  while (lo < hi) {
+    const uint32_t mid = lo + (hi - lo) / 2;
+    if (token(mid) < folded) lo = mid + 1;
+    else hi = mid;
+  }
+  return lo <= vocabulary() && token(lo) == folded ? lo : 0;
+}
+
+std::vector<uint32_t> WordIndex::ids(std::string_view phrase) const {
+  std::vector<uint32_t> out;
+  tokenize(phrase, tokenizer_, [&](std::string_view t, size_t) { out.push_back(id(t)); });
+  return out;
+}
+
+// ──────────────────────────────────────────────────────────────
+// Search
+// ──────────────────────────────────────────────────────────────
+
+SAInterval WordIndex::interval(std::span<const uint32_t> q) const { return fm_.interval(q); }
+
+uint64_t WordIndex::count(std::string_view phrase) const {
+  const auto q = ids(phrase);
+  if (q.empty()) return n_;
+  return interval(q).size();
+}
+
+std::vector<uint64_t> WordIndex::locate(std::string_view phrase, size_t limit) const {
+  const auto q = ids(phrase);
+  if (q.empty()) return {};
+  return locate(interval(q), limit);
+}
+
+std::vector<uint64_t> WordIndex::locate(const SAInterval& iv, size_t limit) const { return fm_.locate(iv, limit); }
+
+std::vector<uint32_t> WordIndex::extract_ids(uint64_t pos, uint64_t len) const { return fm_.extract(pos, len); }
+
+std::string WordIndex::extract(uint64_t pos, uint64_t len) const {
+  std::string out;
+  for (uint32_t v : extract_ids(pos, len)) {
+    if (!out.empty()) out += ' ';
+    out += token(v);
+  }
+  return out;
+}
+
+uint64_t WordIndex::byte_offset(uint64_t pos) const {
+  if (!starts_.size()) throw std::logic_error("byte_offset: index built without byte_offsets");
+  if (pos >= n_) throw std::out_of_range("byte_offset: token position out of range");
+  return starts_.select1(pos + 1);
+}
+
+size_t WordIndex::size_in_bytes() const {
+  return dict_.size() + dict_offsets_.size() * 4 + fm_.size_in_bytes() + bitvector_bytes(starts_);
+}
+
+} // namespace cs
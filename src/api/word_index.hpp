@@ -0,0 +1,104 @@
+#pragma once
+/**
+ * word_index.hpp — Word-level FM-index: tokens are the symbols.
+ *
+ * The text is split into tokens (words, and optionally single punctuation
+ * bytes; whitespace separates), the distinct tokens are sorted into a
+ * dictionary with ids 1..σ, and an IntFMIndex is built over the id sequence
+ * (BWT in a WaveletMatrix with ceil(log2(σ + 1)) levels, sampled SA and
+ * ISA). Optionally a bitvector of token starts gives byte offsets.
+ * A phrase is one symbol per word, so backward search takes one step per
+ * word instead of per byte, and the BWT holds one symbol per token.
+ *
+ * Positions are token positions (0 = first token) unless stated otherwise.
+ */
+
+#include "int_fm_index.hpp"
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace cs {
+
+struct TokenizerParams {
+  std::optional<FoldTable> fold;  // Applied to every token (e.g. ascii_case_fold)
+  bool punctuation = true;        // Keep other non-space bytes as one-byte tokens
+};
+
+/**
+ * tokenize(text, p, fn) — fn(token, byte offset) for every token. Words are
+ * maximal runs of letters, digits, '_' and bytes >= 0x80 (so UTF-8 words stay
+ * whole). Tokens are passed unfolded.
+ */
+template <class Fn>
+void tokenize(std::string_view text, const TokenizerParams& p, Fn&& fn) {
+  auto word = [](uint8_t c) { return c >= 0x80 || c == '_' || unsigned((c | 32) - 'a') < 26 || unsigned(c - '0') < 10; };
+  auto space = [](uint8_t c) { return c == ' ' || (c >= '\t' && c <= '\r'); };
+  for (size_t i = 0; i < text.size();) {
+    const uint8_t c = static_cast<uint8_t>(text[i]);
+    if (space(c)) {
+      ++i;
+    } else if (word(c)) {
+      size_t e = i + 1;
+      while (e < text.size() && word(static_cast<uint8_t>(text[e]))) ++e;
+      fn(text.substr(i, e - i), i);
+      i = e;
+    } else {
+      if (p.punctuation) fn(text.substr(i, 1), i);
+      ++i;
+    }
+  }
+}
+
+struct WordIndexParams {
+  TokenizerParams tokenizer;
+  uint32_t sample_stride = 32;  // SA and ISA sampling (tokens)
+  bool byte_offsets = true;     // Keep token starts for byte_offset()
+};
+
+class WordIndex {
+public:
+  static WordIndex build(std::string_view text, const WordIndexParams& p = {});
+
+  /// Number of tokens in the text / distinct tokens.
+  uint64_t size() const { return n_; }
+  size_t vocabulary() const { return dict_offsets_.size() - 1; }
+
+  /// Id of token (folded as at build time), or 0 if it never occurs.
+  uint32_t id(std::string_view token) const;
+  std::string_view token(uint32_t id) const;
+  /// Ids of the phrase's tokens (0 for unknown tokens).
+  std::vector<uint32_t> ids(std::string_view phrase) const;
+
+  /// Backward search over ids (len counts tokens). Any 0 id gives an empty interval.
+  SAInterval interval(std::span<const uint32_t> ids) const;
+
+  /// Same meaning as FMIndex::count/locate, over tokens.
+  uint64_t count(std::string_view phrase) const;
+  std::vector<uint64_t> locate(std::string_view phrase, size_t limit=100000) const;
+  std::vector<uint64_t> locate(const SAInterval& iv, size_t limit=100000) const;
+
+  /// Token ids [pos, pos + len), or their tokens joined by single spaces.
+  std::vector<uint32_t> extract_ids(uint64_t pos, uint64_t len) const;
+  std::string extract(uint64_t pos, uint64_t len) const;
+
+  /// Byte offset of token pos in the original text. Throws std::logic_error
+  /// when built without byte_offsets.
+  uint64_t byte_offset(uint64_t pos) const;
+
+  /// Bytes held by the index structures (dictionary included).
+  size_t size_in_bytes() const;
+
+private:
+  uint64_t n_ = 0;                      // Tokens
+  TokenizerParams tokenizer_;
+  std::string dict_;                    // Sorted distinct tokens, concatenated
+  std::vector<uint32_t> dict_offsets_{0};  // Token id - 1 → start in dict_ (plus end)
+  IntFMIndex fm_;                       // Over token ids
+  BitVector starts_;                    // Token start bits over the text bytes
+};
+
+} // namespace cs
@@ -13,10 +13,12 @@ namespace cs {
 
 void BitVector::build(const std::vector<uint8_t>& bits) {
   nbits_ = bits.size();
+  ones_ = 0;
+  super_.clear();
+  blocks_.clear();
+  select_hints_.clear();
   if (nbits_ == 0) {
     bits_.clear();
-    super_.clear();
-    blocks_.clear();
     return;
   }
 
@@ -62,7 +64,6 @@ void BitVector::build(const std::vector<uint8_t>& bits) {
       blocks_.push_back(static_cast<uint16_t>(local_rank));
 
       const size_t sub_end_bit = std::min(sub_start_bit + SUB, super_end_bit);
-      const size_t sub_len = sub_end_bit - sub_start_bit;
 
       // Popcount this sub-block: iterate over its 64-bit words.
       const size_t word_start = sub_start_bit / 64;
@@ -89,6 +90,8 @@ void BitVector::build(const std::vector<uint8_t>& bits) {
       }
     }
   }
+  ones_ = running_rank;
+  build_select_hints();
 }
 
 // ──────────────────────────────────────────────────────────────
@@ -98,6 +101,9 @@ void BitVector::build(const std::vector<uint8_t>& bits) {
 void BitVector::build_from_words(const std::vector<uint64_t>& words, size_t nbits) {
   nbits_ = nbits;
   bits_ = words;
+  ones_ = 0;
+  super_.clear();
+  blocks_.clear();
 
   // Ensure bits_ has enough words.
   const size_t required_words = (nbits_ + 63) / 64;
@@ -156,6 +162,8 @@ void BitVector::build_from_words(const std::vector<uint64_t>& words, size_t nbit
       }
     }
   }
+  ones_ = running_rank;
+  build_select_hints();
 }
 
 // ──────────────────────────────────────────────────────────────
@@ -166,7 +174,7 @@ size_t BitVector::rank1(size_t i) const {
   if (i == 0) return 0;
   if (i >= nbits_) {
     // For i >= nbits_, return the total count.
-    return count_ones();
+    return ones_;
   }
 
   constexpr size_t SUPER = CS_SUPER_BLOCK_SIZE;
@@ -229,6 +237,101 @@ size_t BitVector::rank1(size_t i) const {
   return rank;
 }
 
+// ──────────────────────────────────────────────────────────────
+// select1(k): position of the k-th 1-bit
+// ──────────────────────────────────────────────────────────────
+
+void BitVector::build_select_hints() {
+  select_hints_.clear();
+  size_t next = 1;  // Rank (1-indexed) of the next one-bit to sample
+  for (size_t j = 0; j < super_.size() && next <= ones_; ++j) {
+    const size_t end = j + 1 < super_.size() ? super_[j + 1] : ones_;
+    while (next <= end) {
+      select_hints_.push_back(static_cast<uint32_t>(j));
+      next += CS_SELECT_SAMPLE;
+    }
+  }
+  select0_hints_.clear();
+  const size_t zeros = nbits_ - ones_;
+  next = 1;
+  for (size_t j = 0; j < super_.size() && next <= zeros; ++j) {
+    const size_t end = j + 1 < super_.size() ? (j + 1) * CS_SUPER_BLOCK_SIZE - super_[j + 1] : zeros;
+    while (next <= end) {
+      select0_hints_.push_back(static_cast<uint32_t>(j));
+      next += CS_SELECT_SAMPLE;
+    }
+  }
+}
+
+size_t BitVector::select1(size_t k) const {
+  if (k == 0 || k > ones_) return nbits_;
+
+  constexpr size_t SUPER = CS_SUPER_BLOCK_SIZE;
+  constexpr size_t SUB   = CS_SUB_BLOCK_SIZE;
+  constexpr size_t SUBS_PER_SUPER = SUPER / SUB;
+
+  // 1) Last super-block with super_[j] < k, searched between two hints.
+  const size_t h = (k - 1) / CS_SELECT_SAMPLE;
+  size_t lo = select_hints_[h];
+  size_t hi = h + 1 < select_hints_.size() ? select_hints_[h + 1] + 1 : super_.size();
+  while (hi - lo > 1) {
+    const size_t mid = lo + (hi - lo) / 2;
+    if (super_[mid] < k) lo = mid; else hi = mid;
+  }
+  size_t rest = k - super_[lo];
+
+  // 2) Last sub-block within it whose relative rank is < rest.
+  const size_t base = lo * SUBS_PER_SUPER;
+  size_t sub = 0;
+  while (sub + 1 < SUBS_PER_SUPER && base + sub + 1 < blocks_.size() && blocks_[base + sub + 1] < rest) ++sub;
+  rest -= blocks_[base + sub];
+
+  // 3) Word scan, then the bit inside the word.
+  for (size_t w = (lo * SUPER + sub * SUB) / 64; w < bits_.size(); ++w) {
+    const size_t pop = popcount64(bits_[w]);
+    if (rest <= pop) return w * 64 + select64(bits_[w], static_cast<uint32_t>(rest - 1));
+    rest -= pop;
+  }
+  return nbits_;
+}
+
+size_t BitVector::select0(size_t k) const {
+  if (k == 0 || k > nbits_ - ones_) return nbits_;
+
+  constexpr size_t SUPER = CS_SUPER_BLOCK_SIZE;
+  constexpr size_t SUB   = CS_SUB_BLOCK_SIZE;
+  constexpr size_t SUBS_PER_SUPER = SUPER / SUB;
+  auto zeros_before = [&](size_t j) { return j * SUPER - super_[j]; };
+
+  // 1) Last super-block with fewer than k zeros before it.
+  const size_t h = (k - 1) / CS_SELECT_SAMPLE;
+  size_t lo = select0_hints_[h];
+  size_t hi = h + 1 < select0_hints_.size() ? select0_hints_[h + 1] + 1 : super_.size();
+  while (hi - lo > 1) {
+    const size_t mid = lo + (hi - lo) / 2;
+    if (zeros_before(mid) < k) lo = mid; else hi = mid;
+  }
+  size_t rest = k - zeros_before(lo);
+
+  // 2) Last sub-block within it with fewer than rest zeros before it.
+  const size_t base = lo * SUBS_PER_SUPER;
+  size_t sub = 0;
+  while (sub + 1 < SUBS_PER_SUPER && base + sub + 1 < blocks_.size() &&
+         (sub + 1) * SUB - blocks_[base + sub + 1] < rest) {
+    ++sub;
+  }
+  rest -= sub * SUB - blocks_[base + sub];
+
+  // 3) Word scan over the complement (rest <= zeros left, so padding is never reached).
+  for (size_t w = (lo * SUPER + sub * SUB) / 64; w < bits_.size(); ++w) {
+    const uint64_t inv = ~bits_[w];
+    const size_t pop = popcount64(inv);
+    if (rest <= pop) return w * 64 + select64(inv, static_cast<uint32_t>(rest - 1));
+    rest -= pop;
+  }
+  return nbits_;
+}
+
 // ──────────────────────────────────────────────────────────────
 // count_ones: for debugging/testing
 // ──────────────────────────────────────────────────────────────
@@ -75,14 +75,23 @@ public:
   }
 
   /**
-   * (Optional) select1(k) = position of the k-th 1-bit (1-indexed k).
-   * Not implemented in STEP 1; left for future extension.
+   * select1(k) = position of the k-th 1-bit (1-indexed k).
+   *
+   * A hint every CS_SELECT_SAMPLE ones narrows the super-block binary search;
+   * the sub-block and word are then found by scanning, and the bit by select64.
+   * Returns size() if k == 0 or k > ones().
    */
-  // size_t select1(size_t k) const;
+  size_t select1(size_t k) const;
+
+  /// select0(k) = position of the k-th 0-bit (1-indexed k), same scheme; size() if out of range.
+  size_t select0(size_t k) const;
 
   /// For debugging: count all 1s (should equal rank1(size())).
   size_t count_ones() const;
 
+  /// Cached total number of 1-bits (computed once at build time).
+  inline size_t ones() const { return ones_; }
+
   // ─────────────────────────────────────────────────────────
   // Public accessors for internal data (for vEB layout)
   // ─────────────────────────────────────────────────────────
@@ -91,11 +100,22 @@ public:
   const std::vector<uint32_t>& super_blocks() const { return super_; }
   const std::vector<uint16_t>& sub_blocks() const { return blocks_; }
 
+  /// Heap bytes of the bits, rank directory and select hints.
+  size_t size_in_bytes() const {
+    return bits_.size() * 8 + super_.size() * 4 + blocks_.size() * 2 +
+           (select_hints_.size() + select0_hints_.size()) * 4;
+  }
+
 private:
   size_t nbits_ = 0;                  ///< Logical bit count.
+  size_t ones_ = 0;                   ///< Total 1-bits, so rank1(size()) is O(1).
   std::vector<uint64_t> bits_;        ///< Packed bitvector (64-bit words).
   std::vector<uint32_t> super_;       ///< Absolute rank1 every SUPER_BLOCK_SIZE bits.
   std::vector<uint16_t> blocks_;      ///< Relative rank1 every SUB_BLOCK_SIZE within super-block.
+  std::vector<uint32_t> select_hints_; ///< Super-block holding the (j*CS_SELECT_SAMPLE+1)-th one.
+  std::vector<uint32_t> select0_hints_; ///< Super-block holding the (j*CS_SELECT_SAMPLE+1)-th zero.
+
+  void build_select_hints();
 };
 
 } // namespace cs
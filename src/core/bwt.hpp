@@ -13,4 +13,20 @@ inline std::string build_bwt_from_sa(const std::string& T, const std::vector<uin
   }
   return BWT;
 }
+
+// BWT of T$ where $ is a virtual terminator smaller than every byte.
+// sa must have n+1 entries with sa[0] == n (the empty suffix). The terminator
+// is written as '\0' and its row is returned through primary.
+inline std::string build_bwt_with_terminator(const std::string& T, const std::vector<uint32_t>& sa,
+                                             uint64_t& primary){
+  const size_t rows = sa.size();
+  std::string BWT; BWT.resize(rows);
+  primary = 0;
+  for(size_t i=0;i<rows;++i){
+    uint32_t idx = sa[i];
+    if (idx==0) { BWT[i] = '\0'; primary = i; }
+    else BWT[i] = T[idx-1];
+  }
+  return BWT;
+}
 } // namespace cs
@@ -0,0 +1,122 @@
+/**
+ * lcp.cpp — Kasai construction, both encodings, and the block-minimum tree.
+ */
+
+#include "lcp.hpp"
+
+namespace cs {
+
+// ──────────────────────────────────────────────────────────────
+// build: Kasai et al. over text positions, stored by row or by position
+// ──────────────────────────────────────────────────────────────
+
+void LcpArray::build(const std::string& text, const std::vector<uint32_t>& sa, LcpEncoding enc) {
+  const size_t n = text.size();
+  std::vector<uint32_t> rank(sa.size());
+  for (size_t i = 0; i < sa.size(); ++i) rank[sa[i]] = static_cast<uint32_t>(i);
+
+  // by_row is LCP in row order; PLCP[p] + 2p sets one bit per text position
+  // (position n, the empty suffix, has PLCP 0).
+  std::vector<uint32_t> by_row(sa.size(), 0);
+  std::vector<uint64_t> words(enc == LcpEncoding::PLCP ? (2 * n + 1 + 63) / 64 : 0, 0);
+  size_t h = 0;
+  for (size_t p = 0; p < n; ++p) {
+    const size_t r = rank[p];  // Never 0: row 0 is the empty suffix
+    const size_t q = sa[r - 1];
+    while (p + h < n && q + h < n && text[p + h] == text[q + h]) ++h;
+    by_row[r] = static_cast<uint32_t>(h);
+    if (!words.empty()) words[(h + 2 * p) / 64] |= 1ULL << ((h + 2 * p) % 64);
+    if (h > 0) --h;
+  }
+
+  std::vector<uint32_t> minima((by_row.size() + BLOCK - 1) / BLOCK, UINT32_MAX);
+  for (size_t i = 0; i < by_row.size(); ++i) minima[i / BLOCK] = std::min(minima[i / BLOCK], by_row[i]);
+
+  if (enc == LcpEncoding::PLCP) {
+    words[(2 * n) / 64] |= 1ULL << ((2 * n) % 64);
+    build_from_plcp(words, 2 * n + 1, sa.size(), minima);
+    return;
+  }
+  std::vector<uint8_t> bytes(by_row.size());
+  std::vector<std::pair<uint32_t, uint32_t>> overflow;
+  for (size_t i = 0; i < by_row.size(); ++i) {
+    bytes[i] = static_cast<uint8_t>(std::min<uint32_t>(by_row[i], 0xFF));
+    if (by_row[i] >= 0xFF) overflow.emplace_back(static_cast<uint32_t>(i), by_row[i]);
+  }
+  build_from(std::move(bytes), std::move(overflow));
+}
+
+void LcpArray::build_from(std::vector<uint8_t> bytes, std::vector<std::pair<uint32_t, uint32_t>> overflow) {
+  enc_ = LcpEncoding::BYTES;
+  rows_ = bytes.size();
+  bytes_ = std::move(bytes);
+  overflow_ = std::move(overflow);
+  plcp_ = BitVector();
+  std::vector<uint32_t> minima((rows_ + BLOCK - 1) / BLOCK, UINT32_MAX);
+  for (size_t i = 0; i < rows_; ++i) minima[i / BLOCK] = std::min(minima[i / BLOCK], (*this)[i]);
+  build_tree(minima);
+}
+
+void LcpArray::build_from_plcp(const std::vector<uint64_t>& words, size_t nbits, size_t rows,
+                               const std::vector<uint32_t>& minima) {
+  enc_ = LcpEncoding::PLCP;
+  rows_ = rows;
+  bytes_.clear();
+  overflow_.clear();
+  plcp_.build_from_words(words, nbits);
+  build_tree(minima);
+}
+
+void LcpArray::build_tree(const std::vector<uint32_t>& minima) {
+  leaves_ = 1;
+  while (leaves_ < minima.size()) leaves_ <<= 1;
+  tree_.assign(2 * leaves_, UINT32_MAX);
+  std::copy(minima.begin(), minima.end(), tree_.begin() + leaves_);
+  for (size_t v = leaves_ - 1; v > 0; --v) tree_[v] = std::min(tree_[2 * v], tree_[2 * v + 1]);
+}
+
+std::vector<uint32_t> LcpArray::block_minima() const {
+  return std::vector<uint32_t>(tree_.begin() + leaves_, tree_.begin() + leaves_ + (rows_ + BLOCK - 1) / BLOCK);
+}
+
+size_t LcpArray::size_in_bytes() const {
+  const size_t plcp_bytes = (plcp_.size() + 7) / 8 + plcp_.super_blocks().size() * sizeof(uint32_t) +
+                            plcp_.sub_blocks().size() * sizeof(uint16_t);
+  return bytes_.size() + overflow_.size() * sizeof(overflow_[0]) + plcp_bytes + tree_.size() * sizeof(uint32_t);
+}
+
+uint32_t LcpArray::overflow_value(size_t i) const {
+  auto it = std::lower_bound(overflow_.begin(), overflow_.end(), std::make_pair(static_cast<uint32_t>(i), 0u));
+  return it != overflow_.end() && it->first == i ? it->second : 0xFF;
+}
+
+// ──────────────────────────────────────────────────────────────
+// Min tree: Nearest block below d on either side, range minimum
+// ──────────────────────────────────────────────────────────────
+
+size_t LcpArray::block_before(size_t b, uint32_t d) const {
+  size_t v = leaves_ + b;
+  while (v > 1 && !((v & 1) && tree_[v - 1] < d)) v >>= 1;
+  if (v == 1) return npos;
+  for (--v; v < leaves_;) v = tree_[2 * v + 1] < d ? 2 * v + 1 : 2 * v;
+  return v - leaves_;
+}
+
+size_t LcpArray::block_after(size_t b, uint32_t d) const {
+  size_t v = leaves_ + b;
+  while (v > 1 && !(!(v & 1) && tree_[v + 1] < d)) v >>= 1;
+  if (v == 1) return npos;
+  for (++v; v < leaves_;) v = tree_[2 * v] < d ? 2 * v : 2 * v + 1;
+  return v - leaves_;
+}
+
+uint32_t LcpArray::blocks_min(size_t lo, size_t hi) const {
+  uint32_t m = UINT32_MAX;
+  for (lo += leaves_, hi += leaves_; lo < hi; lo >>= 1, hi >>= 1) {
+    if (lo & 1) m = std::min(m, tree_[lo++]);
+    if (hi & 1) m = std::min(m, tree_[--hi]);
+  }
+  return m;
+}
+
+} // namespace cs
@@ -0,0 +1,153 @@
+#pragma once
+/**
+ * lcp.hpp — Longest-common-prefix array over suffix-array rows.
+ *
+ * LCP[0] = 0 and LCP[i] = lcp(suffix SA[i-1], suffix SA[i]), for the n+1
+ * rows of an FM-index (row 0 is the empty suffix).
+ *
+ * Encodings:
+ *   - BYTES: one byte per row; values ≥ 255 go to a (row, value) overflow
+ *     table searched by binary search. LCP[i] needs no SA access.
+ *   - PLCP: Sadakane's 2n-bit bitvector over text positions, PLCP[p] =
+ *     select1(p + 1) - 2p. LCP[i] = PLCP[SA[i]], so the caller supplies the
+ *     SA lookup (the get() accessors below).
+ *
+ * Both keep a min tree over blocks of 64 rows, so prev_smaller /
+ * next_smaller (the bounds of an enclosing suffix-tree node) and range_min
+ * read at most two blocks of values plus O(log n) tree nodes.
+ *
+ * Built with Kasai's algorithm from the text and its suffix array.
+ */
+
+#include "bitvector.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace cs {
+
+enum class LcpEncoding : uint8_t {
+  BYTES = 0,  // ~8 bits per row, direct access
+  PLCP = 1,   // ~3 bits per row, one SA lookup per access
+};
+
+class LcpArray {
+public:
+  static constexpr size_t npos = SIZE_MAX;
+  static constexpr size_t BLOCK = 64;
+
+  /// Accessor over BYTES storage.
+  struct ByRow {
+    const LcpArray* lcp;
+    uint32_t operator()(size_t k) const { return (*lcp)[k]; }
+  };
+
+  LcpArray() = default;
+
+  /// sa holds the n+1 rows, with sa[0] = n (the empty suffix).
+  void build(const std::string& text, const std::vector<uint32_t>& sa, LcpEncoding enc = LcpEncoding::BYTES);
+
+  LcpEncoding encoding() const { return enc_; }
+  size_t size() const { return rows_; }
+
+  /// LCP[i] (BYTES only).
+  uint32_t operator[](size_t i) const {
+    return bytes_[i] != 0xFF ? bytes_[i] : overflow_value(i);
+  }
+
+  /// PLCP[pos]: LCP of the row whose suffix starts at text position pos (PLCP only).
+  uint32_t plcp(size_t pos) const {
+    return static_cast<uint32_t>(plcp_.select1(pos + 1) - 2 * pos);
+  }
+
+  /**
+   * Largest k <= i with LCP[k] < d, or npos. get(k) returns LCP[k]; the
+   * two-argument form reads BYTES storage directly.
+   */
+  template <class Get>
+  size_t prev_smaller(size_t i, uint32_t d, Get&& get) const {
+    if (rows_ == 0 || d == 0) return npos;
+    i = std::min(i, rows_ - 1);
+    const size_t b = i / BLOCK;
+    for (size_t k = i + 1; k-- > b * BLOCK;) {
+      if (get(k) < d) return k;
+    }
+    const size_t blk = block_before(b, d);
+    if (blk == npos) return npos;
+    for (size_t k = std::min(rows_, (blk + 1) * BLOCK); k-- > blk * BLOCK;) {
+      if (get(k) < d) return k;
+    }
+    return npos;
+  }
+
+  /// Smallest k >= i with LCP[k] < d, or size() if none.
+  template <class Get>
+  size_t next_smaller(size_t i, uint32_t d, Get&& get) const {
+    if (i >= rows_ || d == 0) return rows_;
+    const size_t b = i / BLOCK;
+    for (size_t k = i; k < std::min(rows_, (b + 1) * BLOCK); ++k) {
+      if (get(k) < d) return k;
+    }
+    const size_t blk = block_after(b, d);
+    if (blk == npos) return rows_;
+    for (size_t k = blk * BLOCK; k < std::min(rows_, (blk + 1) * BLOCK); ++k) {
+      if (get(k) < d) return k;
+    }
+    return rows_;
+  }
+
+  /// Minimum of LCP[i, j), or UINT32_MAX if the range is empty.
+  template <class Get>
+  uint32_t range_min(size_t i, size_t j, Get&& get) const {
+    uint32_t m = UINT32_MAX;
+    j = std::min(j, rows_);
+    if (i >= j) return m;
+    const size_t bi = i / BLOCK, bj = (j - 1) / BLOCK;
+    if (bi == bj) {
+      for (size_t k = i; k < j; ++k) m = std::min(m, get(k));
+      return m;
+    }
+    for (size_t k = i; k < (bi + 1) * BLOCK; ++k) m = std::min(m, get(k));
+    for (size_t k = bj * BLOCK; k < j; ++k) m = std::min(m, get(k));
+    return std::min(m, blocks_min(bi + 1, bj));
+  }
+
+  size_t prev_smaller(size_t i, uint32_t d) const { return prev_smaller(i, d, ByRow{this}); }
+  size_t next_smaller(size_t i, uint32_t d) const { return next_smaller(i, d, ByRow{this}); }
+  uint32_t range_min(size_t i, size_t j) const { return range_min(i, j, ByRow{this}); }
+
+  /**
+   * Exposed for serialization. build_from rebuilds BYTES storage and its min
+   * tree; build_from_plcp takes the stored block minima, since recomputing
+   * them would need an SA lookup per row.
+   */
+  const std::vector<uint8_t>& bytes() const { return bytes_; }
+  const std::vector<std::pair<uint32_t, uint32_t>>& overflow() const { return overflow_; }
+  const BitVector& plcp_bits() const { return plcp_; }
+  std::vector<uint32_t> block_minima() const;
+  void build_from(std::vector<uint8_t> bytes, std::vector<std::pair<uint32_t, uint32_t>> overflow);
+  void build_from_plcp(const std::vector<uint64_t>& words, size_t nbits, size_t rows,
+                       const std::vector<uint32_t>& minima);
+
+  size_t size_in_bytes() const;
+
+private:
+  uint32_t overflow_value(size_t i) const;
+  void build_tree(const std::vector<uint32_t>& minima);
+  size_t block_before(size_t b, uint32_t d) const;
+  size_t block_after(size_t b, uint32_t d) const;
+  uint32_t blocks_min(size_t lo, size_t hi) const;
+
+  LcpEncoding enc_ = LcpEncoding::BYTES;
+  size_t rows_ = 0;
+  std::vector<uint8_t> bytes_;                           ///< min(LCP[i], 255) (BYTES)
+  std::vector<std::pair<uint32_t, uint32_t>> overflow_;  ///< (row, LCP) where LCP ≥ 255, by row (BYTES)
+  BitVector plcp_;                                       ///< Bit PLCP[p] + 2p set for p in [0, n] (PLCP)
+  std::vector<uint32_t> tree_;                           ///< Block minima; leaves at [leaves_, 2·leaves_)
+  size_t leaves_ = 0;
+};
+
+} // namespace cs
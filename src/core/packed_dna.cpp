@@ -0,0 +1,218 @@
+/**
+ * packed_dna.cpp — Packing, SIMD decode, interleaved occ.
+ */
+
+#include "packed_dna.hpp"
+#include "../util/bitops.hpp"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <stdexcept>
+#if defined(CS_AVX2)
+  #include <immintrin.h>
+#endif
+
+namespace cs {
+
+static constexpr char BASES[4] = {'A', 'C', 'G', 'T'};
+
+int dna_code(uint8_t c) {
+  switch (c) {
+    case 'A': return 0;
+    case 'C': return 1;
+    case 'G': return 2;
+    case 'T': return 3;
+    default: return -1;
+  }
+}
+
+void DnaExceptions::add(uint64_t p, char c) {
+  if (runs() && end(runs() - 1) == p && bytes.back() == c && len.back() < UINT32_MAX) {
+    ++len.back();
+    return;
+  }
+  start.push_back(p);
+  len.push_back(1);
+  bytes += c;
+}
+
+std::vector<uint32_t> DnaExceptions::first_per_block(size_t block, size_t blocks) const {
+  std::vector<uint32_t> first(blocks + 1);
+  size_t k = 0;
+  for (size_t b = 0; b <= blocks; ++b) {
+    while (k < runs() && end(k) <= b * block) ++k;
+    first[b] = static_cast<uint32_t>(k);
+  }
+  return first;
+}
+
+/// Run holding i among runs k, k + 1, … (by start), or SIZE_MAX if i is a base.
+static inline size_t exception_run(const DnaExceptions& exc, size_t i, size_t k) {
+  for (; k < exc.runs() && exc.start[k] <= i; ++k) {
+    if (i < exc.end(k)) return k;
+  }
+  return SIZE_MAX;
+}
+
+/// Packs s into 2-bit words (exceptions as code 0) and lists the exceptions.
+static void pack(std::string_view s, std::vector<uint64_t>& words, DnaExceptions& exc) {
+  if (s.size() >= UINT32_MAX) throw std::invalid_argument("PackedDna: sequence too large");
+  words.assign((s.size() + 31) / 32, 0);
+  exc = {};
+  for (size_t i = 0; i < s.size(); ++i) {
+    const int code = dna_code(static_cast<uint8_t>(s[i]));
+    if (code < 0) {
+      exc.add(i, s[i]);
+    } else {
+      words[i / 32] |= uint64_t(code) << (2 * (i % 32));
+    }
+  }
+}
+
+// ──────────────────────────────────────────────────────────────
+// Decoding 32 bases (one word) at a time
+// ──────────────────────────────────────────────────────────────
+
+#if defined(CS_AVX2)
+/// Each output byte j takes byte j / 4 of the word, shifted by 2·(j mod 4),
+/// masked to a code and mapped to its letter with a byte shuffle.
+static inline void decode_word(uint64_t w, char* out) {
+  const __m256i x = _mm256_shuffle_epi8(_mm256_set1_epi64x(static_cast<long long>(w)),
+                                        _mm256_setr_epi8(0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3,
+                                                         4, 4, 4, 4, 5, 5, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7));
+  const __m256i lane = _mm256_set1_epi32(0xFF);
+  __m256i v = _mm256_and_si256(x, lane);
+  v = _mm256_or_si256(v, _mm256_and_si256(_mm256_srli_epi16(x, 2), _mm256_slli_epi32(lane, 8)));
+  v = _mm256_or_si256(v, _mm256_and_si256(_mm256_srli_epi32(x, 4), _mm256_slli_epi32(lane, 16)));
+  v = _mm256_or_si256(v, _mm256_and_si256(_mm256_srli_epi32(x, 6), _mm256_slli_epi32(lane, 24)));
+  v = _mm256_and_si256(v, _mm256_set1_epi8(3));
+  const __m256i letters = _mm256_setr_epi8('A', 'C', 'G', 'T', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                                           'A', 'C', 'G', 'T', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_shuffle_epi8(letters, v));
+}
+#else
+/// Four letters per packed byte.
+static const std::array<uint32_t, 256> QUADS = [] {
+  std::array<uint32_t, 256> t{};
+  for (unsigned b = 0; b < 256; ++b) {
+    char q[4];
+    for (unsigned k = 0; k < 4; ++k) q[k] = BASES[(b >> (2 * k)) & 3];
+    std::memcpy(&t[b], q, 4);
+  }
+  return t;
+}();
+
+static inline void decode_word(uint64_t w, char* out) {
+  for (unsigned k = 0; k < 8; ++k, w >>= 8) std::memcpy(out + 4 * k, &QUADS[w & 0xFF], 4);
+}
+#endif
+
+/// Bases [pos, pos + len) of words into out, exceptions not yet patched.
+static void decode(const std::vector<uint64_t>& words, size_t pos, size_t len, char* out) {
+  size_t i = pos;
+  const size_t end = pos + len;
+  for (; i < end && i % 32; ++i) *out++ = BASES[(words[i / 32] >> (2 * (i % 32))) & 3];
+  for (; i + 32 <= end; i += 32, out += 32) decode_word(words[i / 32], out);
+  for (; i < end; ++i) *out++ = BASES[(words[i / 32] >> (2 * (i % 32))) & 3];
+}
+
+// ──────────────────────────────────────────────────────────────
+// PackedDna
+// ──────────────────────────────────────────────────────────────
+
+void PackedDna::build(std::string_view s) {
+  n_ = s.size();
+  pack(s, words_, exc_);
+  exc_first_ = exc_.first_per_block(BLOCK, (n_ + BLOCK - 1) / BLOCK);
+}
+
+char PackedDna::operator[](size_t i) const {
+  const uint32_t k = exc_first_[i / BLOCK];
+  if (k < exc_.runs() && exc_.start[k] <= i) {
+    if (const size_t r = exception_run(exc_, i, k); r != SIZE_MAX) return exc_.bytes[r];
+  }
+  return BASES[(words_[i / 32] >> (2 * (i % 32))) & 3];
+}
+
+size_t PackedDna::extract(size_t pos, size_t len, char* out) const {
+  if (pos >= n_) return 0;
+  len = std::min(len, n_ - pos);
+  decode(words_, pos, len, out);
+  const size_t end = pos + len;
+  for (size_t k = exc_first_[pos / BLOCK]; k < exc_.runs() && exc_.start[k] < end; ++k) {
+    const size_t lo = std::max<size_t>(pos, exc_.start[k]), hi = std::min<size_t>(end, exc_.end(k));
+    if (lo < hi) std::memset(out + (lo - pos), exc_.bytes[k], hi - lo);
+  }
+  return len;
+}
+
+std::string PackedDna::extract(size_t pos, size_t len) const {
+  if (pos >= n_) return {};
+  std::string out(std::min(len, n_ - pos), '\0');
+  extract(pos, len, out.data());
+  return out;
+}
+
+size_t PackedDna::size_in_bytes() const {
+  return words_.size() * 8 + exc_first_.size() * 4 + exc_.size_in_bytes();
+}
+
+// ──────────────────────────────────────────────────────────────
+// DnaOcc: counts and bases interleaved per block
+// ──────────────────────────────────────────────────────────────
+
+void DnaOcc::build(std::string_view bwt) {
+  n_ = bwt.size();
+  std::vector<uint64_t> words;
+  pack(bwt, words, exc_);
+  const size_t blocks = (n_ + BLOCK - 1) / BLOCK;
+  const std::vector<uint32_t> first = exc_.first_per_block(BLOCK, blocks);
+  blocks_.assign(blocks + 1, Block{});
+  uint32_t counts[4] = {};
+  for (size_t b = 0; b <= blocks; ++b) {
+    Block& blk = blocks_[b];
+    std::memcpy(blk.counts, counts, sizeof(counts));
+    blk.exc_first = first[b];
+    for (size_t w = 0; w < BLOCK / 32 && b * (BLOCK / 32) + w < words.size(); ++w) {
+      blk.bases[w] = words[b * (BLOCK / 32) + w];
+    }
+    for (size_t i = b * BLOCK; i < std::min(n_, (b + 1) * BLOCK); ++i) {
+      const int code = dna_code(static_cast<uint8_t>(bwt[i]));
+      if (code >= 0) ++counts[code];
+    }
+  }
+}
+
+char DnaOcc::operator[](size_t i) const {
+  const Block& blk = blocks_[i / BLOCK];
+  const uint32_t k = blk.exc_first;
+  if (k < exc_.runs() && exc_.start[k] <= i) {
+    if (const size_t r = exception_run(exc_, i, k); r != SIZE_MAX) return exc_.bytes[r];
+  }
+  return BASES[(blk.bases[(i % BLOCK) / 32] >> (2 * (i % 32))) & 3];
+}
+
+uint64_t DnaOcc::occ(unsigned code, size_t i) const {
+  const Block& blk = blocks_[i / BLOCK];
+  const size_t off = i % BLOCK;
+  // Bit 2k of eq is set where base k of the word equals code.
+  const uint64_t pattern = 0x5555555555555555ULL * code;
+  uint64_t r = blk.counts[code];
+  for (size_t w = 0; w * 32 < off; ++w) {
+    const uint64_t x = blk.bases[w] ^ pattern;
+    uint64_t eq = ~(x | x >> 1) & 0x5555555555555555ULL;
+    const size_t take = std::min<size_t>(32, off - w * 32);
+    if (take < 32) eq &= (uint64_t(1) << (2 * take)) - 1;
+    r += popcount64(eq);
+  }
+  // Exceptions are stored as code 0: take them back out of A's count.
+  if (code == 0 && off) {
+    const size_t from = i - off;
+    for (size_t k = blk.exc_first; k < exc_.runs() && exc_.start[k] < i; ++k) {
+      r -= std::min<uint64_t>(i, exc_.end(k)) - std::max<uint64_t>(from, exc_.start[k]);
+    }
+  }
+  return r;
+}
+
+} // namespace cs
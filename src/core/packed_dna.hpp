@@ -0,0 +1,104 @@
+#pragma once
+/**
+ * packed_dna.hpp — 2-bit nucleotide storage with an exception list.
+ *
+ * A, C, G, T are stored as codes 0..3, 32 bases per 64-bit word (base i at
+ * bits 2·(i mod 32) of word i / 32). Every other byte (N, lowercase, IUPAC
+ * codes, separators, the BWT terminator) is an exception: its slot holds
+ * code 0 and it goes to a sorted list of runs (start, length, byte), so an
+ * assembly gap of a million Ns is one entry. Each 128-base block records
+ * its first overlapping run, so a lookup only scans the runs inside the
+ * block, and a block without any costs nothing extra.
+ *
+ *   PackedDna  the text: ~2.25 bits per base; extract() decodes 32 bases per
+ *              step (an AVX2 byte shuffle under CS_AVX2, a 4-base table
+ *              otherwise) and then patches the exceptions in the range
+ *   DnaOcc     the BWT, BWA-style: each 64-byte block holds the A/C/G/T
+ *              counts before it next to its 128 packed bases, so
+ *              occ(c, i) reads one cache line plus the block's exceptions
+ *
+ * Both are meant for text that is mostly ACGT; each exception run costs 13 bytes.
+ */
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace cs {
+
+/// 2-bit code of an A/C/G/T byte, or -1 for an exception byte.
+int dna_code(uint8_t c);
+
+/// Runs of equal non-ACGT bytes of a sequence, by start.
+struct DnaExceptions {
+  std::vector<uint64_t> start;
+  std::vector<uint32_t> len;
+  std::string bytes;
+
+  size_t runs() const { return start.size(); }
+  uint64_t end(size_t k) const { return start[k] + len[k]; }
+  /// Appends byte c at position p (after every earlier one).
+  void add(uint64_t p, char c);
+  /// first[b] = first run ending after b · block, for b in [0, blocks].
+  std::vector<uint32_t> first_per_block(size_t block, size_t blocks) const;
+  size_t size_in_bytes() const { return runs() * 13; }
+};
+
+class PackedDna {
+public:
+  static constexpr size_t BLOCK = 128;  // Bases per exception-count entry
+
+  void build(std::string_view s);
+
+  size_t size() const { return n_; }
+  size_t exception_runs() const { return exc_.runs(); }
+
+  /// Byte at position i.
+  char operator[](size_t i) const;
+  /// Bytes [pos, pos + len) (clipped) into out, which has room for len bytes.
+  size_t extract(size_t pos, size_t len, char* out) const;
+  std::string extract(size_t pos, size_t len) const;
+  std::string str() const { return extract(0, n_); }
+
+  size_t size_in_bytes() const;
+
+private:
+  size_t n_ = 0;
+  std::vector<uint64_t> words_;          // 32 bases per word
+  std::vector<uint32_t> exc_first_;      // First run ending after block b's start (plus the run count)
+  DnaExceptions exc_;
+};
+
+class DnaOcc {
+public:
+  static constexpr size_t BLOCK = 128;  // Bases per interleaved block
+
+  /// One cache line: counts of A/C/G/T before the block, then its bases.
+  struct alignas(64) Block {
+    uint32_t counts[4];
+    uint32_t exc_first;                  // First exception run ending after the block's start
+    uint32_t pad[3];
+    uint64_t bases[BLOCK / 32];
+  };
+
+  void build(std::string_view bwt);
+
+  size_t size() const { return n_; }
+  size_t exception_runs() const { return exc_.runs(); }
+
+  /// Byte at position i.
+  char operator[](size_t i) const;
+  /// Occurrences of base code (0..3 = A, C, G, T) in [0, i).
+  uint64_t occ(unsigned code, size_t i) const;
+
+  size_t size_in_bytes() const { return blocks_.size() * sizeof(Block) + exc_.size_in_bytes(); }
+
+private:
+  size_t n_ = 0;
+  std::vector<Block> blocks_;            // ceil(n / BLOCK) + 1 (the last holds the totals)
+  DnaExceptions exc_;
+};
+
+} // namespace cs
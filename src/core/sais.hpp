@@ -2,15 +2,20 @@
 #include <vector>
 #include <cstdint>
 #include <string>
+#include <string_view>
 #include <algorithm>
 
 namespace cs {
+// Sorts the suffixes of T by direct comparison. A suffix that is a prefix of
+// another sorts first, i.e. T behaves as if followed by a unique smallest
+// terminator. string_view comparison avoids copying suffixes.
 inline std::vector<uint32_t> build_sa_naive(const std::string& T){
   uint32_t n = (uint32_t)T.size();
   std::vector<uint32_t> sa(n);
   for(uint32_t i=0;i<n;++i) sa[i]=i;
+  const std::string_view v(T);
   std::sort(sa.begin(), sa.end(), [&](uint32_t a, uint32_t b){
-    return T.substr(a) < T.substr(b);
+    return v.substr(a) < v.substr(b);
   });
   return sa;
 }
@@ -13,6 +13,7 @@ namespace cs {
 
 void WaveletTree::build(const std::vector<uint8_t>& bwt) {
   n_ = bwt.size();
+  zeros_.fill(0);
   if (n_ == 0) return;
 
   // Build levels from MSB (bit 7) to LSB (bit 0).
@@ -43,6 +44,7 @@ void WaveletTree::build(const std::vector<uint8_t>& bwt) {
 
     // Build BitVector for this level.
     levels_[level].build(bitvec);
+    zeros_[level] = n_ - levels_[level].ones();
 
     // For next level, concatenate left and right partitions.
     if (bit > 0) {  // Not the last level.
@@ -50,6 +52,24 @@ void WaveletTree::build(const std::vector<uint8_t>& bwt) {
       current.insert(current.end(), right.begin(), right.end());
     }
   }
+  build_nodes();
+}
+
+// ──────────────────────────────────────────────────────────────
+// build_from_level_words: Restore levels from serialized bits
+// ──────────────────────────────────────────────────────────────
+
+void WaveletTree::build_from_level_words(const uint64_t* words, size_t n) {
+  n_ = n;
+  zeros_.fill(0);
+  const size_t words_per_level = (n + 63) / 64;
+  for (int level = 0; level < 8; ++level) {
+    const uint64_t* begin = words + level * words_per_level;
+    levels_[level].build_from_words(
+        std::vector<uint64_t>(begin, begin + words_per_level), n);
+    zeros_[level] = n_ - levels_[level].ones();
+  }
+  build_nodes();
 }
 
 // ──────────────────────────────────────────────────────────────
@@ -57,7 +77,7 @@ void WaveletTree::build(const std::vector<uint8_t>& bwt) {
 // ──────────────────────────────────────────────────────────────
 
 size_t WaveletTree::rank(uint8_t c, size_t i) const {
-  if (i == 0 || i > n_) return 0;
+  if (i == 0) return 0;
   if (i > n_) i = n_;
 
   size_t start = 0;  // Start of current range.
@@ -82,9 +102,8 @@ size_t WaveletTree::rank(uint8_t c, size_t i) const {
       const size_t rank1_end = bv.rank1(end);
       
       // Right partition starts after all 0s in this level.
-      const size_t zeros_total = bv.size() - bv.rank1(bv.size());
-      start = zeros_total + rank1_start;
-      end = zeros_total + rank1_end;
+      start = zeros_[level] + rank1_start;
+      end = zeros_[level] + rank1_end;
     }
 
     // If range becomes empty, symbol c doesn't appear in [0, i).
@@ -95,6 +114,70 @@ size_t WaveletTree::rank(uint8_t c, size_t i) const {
   return end - start;
 }
 
+// ──────────────────────────────────────────────────────────────
+// select(c, k): Down to c's leaf, then back up through each level
+// ──────────────────────────────────────────────────────────────
+
+size_t WaveletTree::select(uint8_t c, size_t k) const {
+  if (k == 0 || k > counts_[c]) return n_;
+  // p = offset of the occurrence within c's node, from the leaf upwards.
+  size_t p = k - 1;
+  for (int level = 7; level >= 0; --level) {
+    const size_t node = (size_t(1) << level) - 1 + (c >> (8 - level));
+    const size_t s = node_start_[node], ones = node_ones_[node];
+    const BitVector& bv = levels_[level];
+    p = ((c >> (7 - level)) & 1 ? bv.select1(ones + p + 1) : bv.select0(s - ones + p + 1)) - s;
+  }
+  return p;
+}
+
+/// Node starts per level and prefix (the transitions rank() takes), and symbol counts.
+void WaveletTree::build_nodes() {
+  node_start_.assign(255, 0);
+  node_ones_.assign(255, 0);
+  for (int level = 0; level < 8; ++level) {
+    const BitVector& bv = levels_[level];
+    for (size_t p = 0; p < (size_t(1) << level); ++p) {
+      const size_t node = (size_t(1) << level) - 1 + p;
+      const size_t s = node_start_[node], ones = node_ones_[node] = bv.rank1(s);
+      if (level == 7) continue;
+      node_start_[2 * node + 1] = s - ones;              // Prefix p·0
+      node_start_[2 * node + 2] = zeros_[level] + ones;  // Prefix p·1
+    }
+  }
+  for (unsigned c = 0; c < 256; ++c) counts_[c] = rank(static_cast<uint8_t>(c), n_);
+}
+
+// ──────────────────────────────────────────────────────────────
+// range_rank(c, sp, ep): Rank before/inside a range plus smaller symbols
+// ──────────────────────────────────────────────────────────────
+
+RangeRank WaveletTree::range_rank(uint8_t c, size_t sp, size_t ep) const {
+  RangeRank r;
+  if (ep > n_) ep = n_;
+  if (sp > ep) sp = ep;
+  size_t node = 0;  // Start of c's node at the current level.
+
+  for (int level = 0; level < 8; ++level) {
+    const BitVector& bv = levels_[level];
+    const size_t o_node = bv.rank1(node), o_sp = bv.rank1(sp), o_ep = bv.rank1(ep);
+    if ((c >> (7 - level)) & 1) {
+      // Zeros inside the range are smaller symbols.
+      r.less += (ep - sp) - (o_ep - o_sp);
+      node = zeros_[level] + o_node;
+      sp = zeros_[level] + o_sp;
+      ep = zeros_[level] + o_ep;
+    } else {
+      node -= o_node;
+      sp -= o_sp;
+      ep -= o_ep;
+    }
+  }
+  r.before = sp - node;
+  r.inside = ep - sp;
+  return r;
+}
+
 // ──────────────────────────────────────────────────────────────
 // access(i): Retrieve symbol at position i
 // ──────────────────────────────────────────────────────────────
@@ -119,8 +202,7 @@ uint8_t WaveletTree::access(size_t i) const {
       pos = pos - bv.rank1(pos);
     } else {
       // Go right: position among 1s.
-      const size_t zeros_total = bv.size() - bv.rank1(bv.size());
-      pos = zeros_total + bv.rank1(pos);
+      pos = zeros_[level] + bv.rank1(pos);
     }
   }
 
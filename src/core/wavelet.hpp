@@ -10,6 +10,9 @@
  * API:
  *   - rank(c, i): Count of symbol c in BWT[0..i)
  *   - access(i): Return BWT[i]
+ *   - select(c, k): Position of the k-th c (inverse of rank)
+ *   - range_rank(c, sp, ep): c before / inside [sp, ep), and symbols < c inside
+ *   - range_symbols(sp, ep, fn): every distinct symbol in [sp, ep), ascending
  *
  * Construction:
  *   Given BWT string, build all 8 levels by partitioning on each bit.
@@ -23,6 +26,13 @@
 
 namespace cs {
 
+/// Counts for one symbol c around a range [sp, ep).
+struct RangeRank {
+  size_t before = 0;  ///< Occurrences of c in [0, sp).
+  size_t inside = 0;  ///< Occurrences of c in [sp, ep).
+  size_t less = 0;    ///< Symbols smaller than c in [sp, ep).
+};
+
 class WaveletTree {
 public:
   WaveletTree() = default;
@@ -49,12 +59,76 @@ public:
    */
   uint8_t access(size_t i) const;
 
+  /**
+   * select(c, k) = position of the k-th occurrence of c (1-indexed k), or
+   * size() if there are fewer. Node starts depend only on c's prefix and
+   * are precomputed at build, so this is one select1/select0 per level,
+   * from the leaf up.
+   */
+  size_t select(uint8_t c, size_t k) const;
+
+  /**
+   * range_rank(c, sp, ep) — One descent tracking the node start, sp and ep
+   * (3 rank1 per level). Serves bidirectional extension, which needs the
+   * count of smaller symbols in the range as well as rank(c, ·).
+   */
+  RangeRank range_rank(uint8_t c, size_t sp, size_t ep) const;
+
+  /**
+   * range_symbols(sp, ep, fn) — fn(c, before, inside) for each distinct
+   * symbol c in [sp, ep), ascending, with rank(c, sp) and its count inside.
+   * Descends only into non-empty nodes: O(d · 8) rank1 for d symbols.
+   */
+  template <class Fn>
+  void range_symbols(size_t sp, size_t ep, Fn&& fn) const {
+    range_symbols(sp, ep, [](unsigned, unsigned) { return true; }, fn);
+  }
+
+  /// As above, skipping every subtree whose symbols [lo, hi) fail allow(lo, hi).
+  template <class Allow, class Fn>
+  void range_symbols(size_t sp, size_t ep, Allow&& allow, Fn&& fn) const {
+    if (ep > n_) ep = n_;
+    if (sp < ep) symbols_rec(0, 0, sp, ep, 0, allow, fn);
+  }
+
   /// Number of symbols in the BWT.
   size_t size() const { return n_; }
 
+  /// Level bitvector (0 = MSB). Exposed for serialization.
+  const BitVector& level(int l) const { return levels_[l]; }
+
+  /**
+   * Rebuild from serialized level bits: 8 consecutive runs of
+   * ceil(n/64) words each, MSB level first. Rank directories are recomputed.
+   */
+  void build_from_level_words(const uint64_t* words, size_t n);
+
 private:
+  template <class Allow, class Fn>
+  void symbols_rec(int level, size_t node, size_t sp, size_t ep, uint32_t prefix, Allow& allow, Fn& fn) const {
+    const unsigned width = 1u << (8 - level);
+    if (!allow(prefix * width, (prefix + 1) * width)) return;
+    if (level == 8) {
+      fn(static_cast<uint8_t>(prefix), sp - node, ep - sp);
+      return;
+    }
+    const BitVector& bv = levels_[level];
+    const size_t o_node = bv.rank1(node), o_sp = bv.rank1(sp), o_ep = bv.rank1(ep);
+    if (sp - o_sp < ep - o_ep) symbols_rec(level + 1, node - o_node, sp - o_sp, ep - o_ep, prefix << 1, allow, fn);
+    if (o_sp < o_ep) {
+      const size_t z = zeros_[level];
+      symbols_rec(level + 1, z + o_node, z + o_sp, z + o_ep, (prefix << 1) | 1, allow, fn);
+    }
+  }
+
+  void build_nodes();
+
   size_t n_ = 0;                          ///< Length of BWT.
   std::array<BitVector, 8> levels_;       ///< One BitVector per bit (MSB to LSB).
+  std::array<size_t, 8> zeros_{};         ///< Zeros per level (start of right partition).
+  std::vector<size_t> node_start_;        ///< Node start of level l, prefix p at (1 << l) - 1 + p.
+  std::vector<size_t> node_ones_;         ///< rank1 of the level at that start.
+  std::array<size_t, 256> counts_{};      ///< Occurrences of each symbol.
 };
 
 } // namespace cs
@@ -0,0 +1,147 @@
+/**
+ * wavelet_matrix.cpp — Wavelet matrix implementation.
+ */
+
+#include "wavelet_matrix.hpp"
+#include <algorithm>
+#include <bit>
+#include <queue>
+#include <tuple>
+
+namespace cs {
+
+// ──────────────────────────────────────────────────────────────
+// build: Stable partition on each bit, MSB first
+// ──────────────────────────────────────────────────────────────
+
+void WaveletMatrix::build(const std::vector<uint32_t>& values) {
+  n_ = values.size();
+  uint32_t max_v = 0;
+  for (uint32_t v : values) max_v = std::max(max_v, v);
+  width_ = std::max<uint32_t>(1, static_cast<uint32_t>(std::bit_width(max_v)));
+  levels_.assign(width_, BitVector());
+  zeros_.assign(width_, 0);
+
+  std::vector<uint32_t> current = values, next(n_);
+  std::vector<uint8_t> bits(n_);
+  for (uint32_t l = 0; l < width_; ++l) {
+    const uint32_t shift = width_ - 1 - l;
+    size_t z = 0;
+    for (size_t i = 0; i < n_; ++i) {
+      bits[i] = (current[i] >> shift) & 1;
+      z += bits[i] == 0;
+    }
+    levels_[l].build(bits);
+    zeros_[l] = z;
+
+    size_t zi = 0, oi = z;
+    for (size_t i = 0; i < n_; ++i) next[bits[i] ? oi++ : zi++] = current[i];
+    current.swap(next);
+  }
+}
+
+void WaveletMatrix::build_from_level_words(const uint64_t* words, size_t n, uint32_t width) {
+  n_ = n;
+  width_ = width;
+  levels_.assign(width_, BitVector());
+  zeros_.assign(width_, 0);
+  const size_t words_per_level = (n + 63) / 64;
+  for (uint32_t l = 0; l < width_; ++l) {
+    const uint64_t* begin = words + l * words_per_level;
+    levels_[l].build_from_words(std::vector<uint64_t>(begin, begin + words_per_level), n);
+    zeros_[l] = n_ - levels_[l].ones();
+  }
+}
+
+// ──────────────────────────────────────────────────────────────
+// access / rank
+// ──────────────────────────────────────────────────────────────
+
+uint32_t WaveletMatrix::access(size_t i) const {
+  uint32_t v = 0;
+  for (uint32_t l = 0; l < width_; ++l) {
+    const BitVector& bv = levels_[l];
+    const uint32_t b = bv.get(i);
+    v = (v << 1) | b;
+    i = b ? zeros_[l] + bv.rank1(i) : i - bv.rank1(i);
+  }
+  return v;
+}
+
+size_t WaveletMatrix::rank(uint32_t v, size_t i) const {
+  if (i > n_) i = n_;
+  if (width_ < 32 && (v >> width_) != 0) return 0;
+  size_t sp = 0, ep = i;
+  for (uint32_t l = 0; l < width_ && sp < ep; ++l) {
+    const BitVector& bv = levels_[l];
+    if ((v >> (width_ - 1 - l)) & 1) {
+      sp = zeros_[l] + bv.rank1(sp);
+      ep = zeros_[l] + bv.rank1(ep);
+    } else {
+      sp = sp - bv.rank1(sp);
+      ep = ep - bv.rank1(ep);
+    }
+  }
+  return ep > sp ? ep - sp : 0;
+}
+
+// Follows i and the start of its node down together; at the leaf the
+// distance between them is the rank.
+uint32_t WaveletMatrix::access_rank(size_t i, size_t& r) const {
+  uint32_t v = 0;
+  size_t sp = 0;
+  for (uint32_t l = 0; l < width_; ++l) {
+    const BitVector& bv = levels_[l];
+    const uint32_t b = bv.get(i);
+    v = (v << 1) | b;
+    if (b) {
+      sp = zeros_[l] + bv.rank1(sp);
+      i = zeros_[l] + bv.rank1(i);
+    } else {
+      sp = sp - bv.rank1(sp);
+      i = i - bv.rank1(i);
+    }
+  }
+  r = i - sp;
+  return v;
+}
+
+// ──────────────────────────────────────────────────────────────
+// top_k: Expand the largest node first; leaves pop in count order
+// ──────────────────────────────────────────────────────────────
+
+std::vector<std::pair<uint32_t, size_t>> WaveletMatrix::top_k(size_t sp, size_t ep, size_t k) const {
+  std::vector<std::pair<uint32_t, size_t>> out;
+  if (ep > n_) ep = n_;
+  if (sp >= ep || k == 0) return out;
+
+  // Node = (size, first value it can hold, level, prefix, sp). Larger ranges
+  // pop first; equal sizes pop by first value, so count ties come out with
+  // ascending values.
+  using Node = std::tuple<size_t, uint64_t, uint32_t, uint32_t, size_t>;
+  auto cmp = [](const Node& a, const Node& b) {
+    if (std::get<0>(a) != std::get<0>(b)) return std::get<0>(a) < std::get<0>(b);
+    return std::get<1>(a) > std::get<1>(b);
+  };
+  std::priority_queue<Node, std::vector<Node>, decltype(cmp)> heap(cmp);
+  heap.emplace(ep - sp, 0, 0u, 0u, sp);
+
+  while (!heap.empty() && out.size() < k) {
+    const auto [size, first, l, prefix, lo] = heap.top();
+    heap.pop();
+    if (l == width_) {
+      out.emplace_back(prefix, size);
+      continue;
+    }
+    const BitVector& bv = levels_[l];
+    const size_t hi = lo + size;
+    const size_t o_sp = bv.rank1(lo), o_ep = bv.rank1(hi);
+    const size_t zeros = (hi - lo) - (o_ep - o_sp);
+    const uint64_t one_first = first | (uint64_t(1) << (width_ - 1 - l));
+    if (zeros > 0) heap.emplace(zeros, first, l + 1, prefix << 1, lo - o_sp);
+    if (o_ep > o_sp) heap.emplace(o_ep - o_sp, one_first, l + 1, (prefix << 1) | 1, zeros_[l] + o_sp);
+  }
+  return out;
+}
+
+} // namespace cs
@@ -0,0 +1,86 @@
+#pragma once
+/**
+ * wavelet_matrix.hpp — Wavelet matrix over an integer alphabet [0, 2^width).
+ *
+ * Structure:
+ *   - `width` levels, level 0 = MSB; each level is a BitVector
+ *   - Values are stably partitioned on the level bit (zeros first) before the
+ *     next level, so every node's range stays contiguous
+ *
+ * API:
+ *   - access(i), rank(v, i), access_rank(i, r) (both in one descent, for LF)
+ *   - range_distinct(sp, ep, fn): fn(value, count) for every distinct value in
+ *     [sp, ep), ascending; O(d · width) for d distinct values reported
+ *   - top_k(sp, ep, k): k most frequent values in [sp, ep), greedy by node size
+ *
+ * Used for the document array (doc id per suffix-array row) and for
+ * integer-alphabet BWTs.
+ */
+
+#include "bitvector.hpp"
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace cs {
+
+class WaveletMatrix {
+public:
+  WaveletMatrix() = default;
+
+  /// Builds over values; width = bits of the largest value (at least 1).
+  void build(const std::vector<uint32_t>& values);
+
+  size_t size() const { return n_; }
+  uint32_t width() const { return width_; }
+
+  uint32_t access(size_t i) const;
+
+  /// Occurrences of v in [0, i).
+  size_t rank(uint32_t v, size_t i) const;
+
+  /// v = access(i), with r = rank(v, i), in one descent.
+  uint32_t access_rank(size_t i, size_t& r) const;
+
+  /**
+   * Calls fn(value, count) for each distinct value in [sp, ep), ascending.
+   * fn returns false to stop early.
+   */
+  template <class Fn>
+  void range_distinct(size_t sp, size_t ep, Fn&& fn) const {
+    if (ep > n_) ep = n_;
+    if (sp < ep) distinct_rec(0, sp, ep, 0, fn);
+  }
+
+  /// Up to k (value, count) pairs from [sp, ep) by count desc, then value asc.
+  std::vector<std::pair<uint32_t, size_t>> top_k(size_t sp, size_t ep, size_t k) const;
+
+  /// Level bitvector (0 = MSB). Exposed for serialization.
+  const BitVector& level(uint32_t l) const { return levels_[l]; }
+
+  /**
+   * Rebuild from serialized level bits: `width` consecutive runs of
+   * ceil(n/64) words each, MSB level first.
+   */
+  void build_from_level_words(const uint64_t* words, size_t n, uint32_t width);
+
+private:
+  template <class Fn>
+  bool distinct_rec(uint32_t l, size_t sp, size_t ep, uint32_t prefix, Fn& fn) const {
+    if (l == width_) return fn(prefix, ep - sp);
+    const BitVector& bv = levels_[l];
+    const size_t o_sp = bv.rank1(sp), o_ep = bv.rank1(ep);
+    const size_t z_sp = sp - o_sp, z_ep = ep - o_ep;
+    if (z_sp < z_ep && !distinct_rec(l + 1, z_sp, z_ep, prefix << 1, fn)) return false;
+    if (o_sp < o_ep) return distinct_rec(l + 1, zeros_[l] + o_sp, zeros_[l] + o_ep, (prefix << 1) | 1, fn);
+    return true;
+  }
+
+  size_t n_ = 0;
+  uint32_t width_ = 0;
+  std::vector<BitVector> levels_;   ///< One BitVector per bit (MSB to LSB).
+  std::vector<size_t> zeros_;       ///< Zeros per level (start of the ones partition).
+};
+
+} // namespace cs
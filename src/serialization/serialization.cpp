@@ -49,6 +49,7 @@ void IndexWriter::align_to(size_t alignment) {
     for (size_t written = 0; written < padding; ) {
       const size_t chunk = (padding - written) < sizeof(zeros) ? (padding - written) : sizeof(zeros);
       write_raw(zeros, chunk);
+      written += chunk;
     }
   }
 }
@@ -131,6 +132,22 @@ void IndexWriter::write_veb_layout(const uint8_t* veb_data, size_t veb_size) {
   write_raw(veb_data, veb_size);
 }
 
+void IndexWriter::write_meta(const IndexMetaRecord& meta) {
+  align_to(8);
+  header_.offsets[SECTION_META] = current_offset_;
+  write_raw(&meta, sizeof(IndexMetaRecord));
+}
+
+void IndexWriter::write_extension(uint32_t tag, const void* data, size_t bytes) {
+  align_to(8);
+  if (header_.offsets[SECTION_EXT] == 0) header_.offsets[SECTION_EXT] = current_offset_;
+  const uint32_t head[2] = {tag, 0};
+  const uint64_t len = bytes;
+  write_raw(head, sizeof(head));
+  write_raw(&len, sizeof(len));
+  if (bytes > 0) write_raw(data, bytes);
+}
+
 void IndexWriter::finalize() {
   align_to(8);
   header_.offsets[SECTION_FOOTER] = current_offset_;
@@ -323,13 +340,61 @@ const uint8_t* IndexReader::get_wavelet(size_t* out_size) const {
   
   const uint8_t* base = static_cast<const uint8_t*>(mmap_ptr_);
   if (out_size) {
-    // Calculate size from section start to next section or end
-    const size_t next_offset = header_->offsets[SECTION_VEB_LAYOUT];
-    *out_size = (next_offset > offset) ? (next_offset - offset) : 0;
+    // Calculate size from section start to the next section or end of file.
+    *out_size = section_end(offset) - offset;
   }
   return base + offset;
 }
 
+const uint64_t* IndexReader::get_wavelet_bits(size_t* out_words, size_t* out_levels) const {
+  const size_t offset = header_->offsets[SECTION_WAVELET];
+  if (offset == 0 || offset + 16 > mmap_size_) {
+    if (out_words) *out_words = 0;
+    if (out_levels) *out_levels = 0;
+    return nullptr;
+  }
+  const uint8_t* base = static_cast<const uint8_t*>(mmap_ptr_);
+  if (out_levels) *out_levels = *reinterpret_cast<const uint64_t*>(base + offset);
+  // [num_levels][bits count][bits...] — bits array follows the level count.
+  return read_array_at<uint64_t>(offset + 8, out_words);
+}
+
+const IndexMetaRecord* IndexReader::get_meta() const {
+  const size_t offset = header_->offsets[SECTION_META];
+  if (offset == 0 || offset + sizeof(IndexMetaRecord) > mmap_size_) return nullptr;
+  const uint8_t* base = static_cast<const uint8_t*>(mmap_ptr_);
+  return reinterpret_cast<const IndexMetaRecord*>(base + offset);
+}
+
+const uint8_t* IndexReader::get_extension(uint32_t tag, size_t* out_bytes) const {
+  const size_t offset = header_->offsets[SECTION_EXT];
+  if (offset == 0) return nullptr;
+  const uint8_t* base = static_cast<const uint8_t*>(mmap_ptr_);
+  const size_t end = section_end(offset);
+  for (size_t at = offset; at + 16 <= end; ) {
+    uint32_t chunk_tag;
+    uint64_t bytes;
+    std::memcpy(&chunk_tag, base + at, sizeof(chunk_tag));
+    std::memcpy(&bytes, base + at + 8, sizeof(bytes));
+    if (bytes > end - at - 16) break;  // Truncated chunk
+    if (chunk_tag == tag) {
+      if (out_bytes) *out_bytes = bytes;
+      return base + at + 16;
+    }
+    at += 16 + ((bytes + 7) & ~uint64_t(7));
+  }
+  return nullptr;
+}
+
+size_t IndexReader::section_end(size_t offset) const {
+  size_t end = mmap_size_;
+  for (size_t s = 0; s < NUM_SECTIONS; ++s) {
+    const size_t o = header_->offsets[s];
+    if (o > offset && o < end) end = o;
+  }
+  return end;
+}
+
 const uint8_t* IndexReader::get_veb_layout(size_t* out_size) const {
   return read_array_at<uint8_t>(header_->offsets[SECTION_VEB_LAYOUT], out_size);
 }
@@ -2,18 +2,23 @@
  * serialization.hpp — Binary serialization for FM-index with mmap support.
  * 
  * File Format:
- *   [Header] [Text] [BWT] [C-array] [SSA] [Wavelet] [vEB Layout] [Footer]
+ *   [Header] [Text] [BWT] [C-array] [SSA] [Wavelet] [vEB Layout] [Meta] [Ext] [Footer]
  * 
  * Header:
  *   - Magic number: "CSIDX" (5 bytes)
- *   - Version: uint16_t (current: 1)
+ *   - Version: uint16_t (current: 3)
  *   - Flags: uint32_t (feature flags)
- *   - Offsets: uint64_t[8] (section byte offsets)
+ *   - Offsets: uint64_t[NUM_SECTIONS] (section byte offsets)
  * 
  * Zero-Copy Design:
  *   - All data 8-byte aligned
  *   - Arrays serialized as [count (8 bytes)] [data]
  *   - Can be directly mmap'd and cast to structs
+ *
+ * Extension section:
+ *   Optional per-feature payloads as consecutive tagged chunks
+ *   { u32 tag, u32 0, u64 bytes, data[bytes], pad to 8 }, so new features add
+ *   a tag rather than a header slot. Readers ignore unknown tags.
  */
 
 #ifndef CS_SERIALIZATION_HPP
@@ -21,6 +26,7 @@
 
 #include <cstdint>
 #include <cstddef>
+#include <cstring>
 #include <vector>
 #include <string>
 #include <fstream>
@@ -33,7 +39,7 @@ namespace cs {
 // ──────────────────────────────────────────────────────────────
 
 constexpr char INDEX_MAGIC[6] = "CSIDX";  // 5 bytes + null terminator
-constexpr uint16_t INDEX_VERSION = 1;
+constexpr uint16_t INDEX_VERSION = 3;
 
 // Feature flags (bitfield)
 enum IndexFlags : uint32_t {
@@ -54,11 +60,37 @@ enum SectionType : uint8_t {
   SECTION_WAVELET = 5,
   SECTION_VEB_LAYOUT = 6,
   SECTION_FOOTER = 7,
-  NUM_SECTIONS = 8
+  SECTION_META = 8,
+  SECTION_EXT = 9,
+  NUM_SECTIONS = 10
 };
 
+// Extension chunk tags (SECTION_EXT)
+enum ExtensionTag : uint32_t {
+  EXT_DOCUMENTS = 1,   // u64 separator, u64 count, u64 doc_start[count]
+  EXT_DOC_ARRAY = 2,   // u64 rows, u64 width, width × ceil(rows/64) level words
+  EXT_REVERSE_BWT = 3, // u64 rows, u64 primary, 8 × ceil(rows/64) wavelet level words
+  EXT_LCP = 4,         // u64 rows, u64 count, u64 (row << 32 | lcp)[count], rows bytes (padded to 8)
+  EXT_PLCP = 5,        // u64 rows, u64 bits, u64 blocks, PLCP bit words, u32 block minima (padded to 8)
+  EXT_FOLD = 6,        // 256-byte fold table applied to the text and to query bytes
+  EXT_PACKED_DNA = 7,  // u64 flag: keep text and BWT 2-bit packed after load (sections stay plain)
+  EXT_ISA_SAMPLES = 8, // u32 row of suffix k · ssa stride, for k · stride <= n (padded to 8)
+};
+
+// ──────────────────────────────────────────────────────────────
+// Meta record: FM-index scalars that do not fit in the header
+// ──────────────────────────────────────────────────────────────
+
+struct IndexMetaRecord {
+  uint64_t rows = 0;                // BWT length (text_len + 1 virtual terminator)
+  uint64_t primary = 0;             // BWT row holding the virtual terminator
+  uint64_t reserved[6] = {};        // Zero; room for later fields
+};
+
+static_assert(sizeof(IndexMetaRecord) == 64, "IndexMetaRecord should be 64 bytes");
+
 // ──────────────────────────────────────────────────────────────
-// Index Header (64 bytes, cache-line aligned)
+// Index Header (24 bytes + one offset per section)
 // ──────────────────────────────────────────────────────────────
 
 struct IndexHeader {
@@ -80,7 +112,8 @@ struct IndexHeader {
   }
 };
 
-static_assert(sizeof(IndexHeader) == 88, "IndexHeader should be 88 bytes");
+static_assert(sizeof(IndexHeader) == 24 + 8 * NUM_SECTIONS,
+              "IndexHeader should be 24 bytes plus the offset table");
 
 // ──────────────────────────────────────────────────────────────
 // Serialization Writer
@@ -102,6 +135,9 @@ public:
                      const std::vector<uint16_t>& sub_data,
                      size_t num_levels);
   void write_veb_layout(const uint8_t* veb_data, size_t veb_size);
+  void write_meta(const IndexMetaRecord& meta);
+  /// Appends a tagged chunk; all extensions must be written back to back.
+  void write_extension(uint32_t tag, const void* data, size_t bytes);
   void finalize();
 
 private:
@@ -142,6 +178,14 @@ public:
   const uint32_t* get_ssa(size_t* out_len = nullptr, uint32_t* out_stride = nullptr) const;
   const uint8_t* get_wavelet(size_t* out_size = nullptr) const;
   const uint8_t* get_veb_layout(size_t* out_size = nullptr) const;
+  const IndexMetaRecord* get_meta() const;
+
+  /// Payload of the extension chunk with this tag (nullptr if absent).
+  const uint8_t* get_extension(uint32_t tag, size_t* out_bytes = nullptr) const;
+
+  /// Concatenated level bits written by write_wavelet (nullptr if absent).
+  const uint64_t* get_wavelet_bits(size_t* out_words = nullptr,
+                                   size_t* out_levels = nullptr) const;
 
 private:
   void* mmap_ptr_;
@@ -157,6 +201,7 @@ private:
 
   void open_mmap(const std::string& filepath);
   void close_mmap();
+  size_t section_end(size_t offset) const;
   
   template<typename T>
   const T* read_array_at(size_t offset, size_t* out_count = nullptr) const {
@@ -0,0 +1,314 @@
+/**
+ * client.cpp — Blocking socket client for the batch protocol.
+ */
+
+#include "client.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace cs {
+
+static void throw_errno(const std::string& what) {
+  throw std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+using Clock = std::chrono::steady_clock;
+
+// Milliseconds left until deadline for poll(); -1 (no deadline) stays -1.
+static int poll_ms(bool bounded, Clock::time_point deadline) {
+  if (!bounded) return -1;
+  const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count();
+  return left > 0 ? static_cast<int>(left) : 0;
+}
+
+// ──────────────────────────────────────────────────────────────
+// Connection management
+// ──────────────────────────────────────────────────────────────
+
+// Non-blocking connect, then poll for completion; the fd is closed on failure.
+static void connect_within(int fd, const sockaddr* addr, socklen_t len, int timeout_ms, const std::string& what) {
+  const int flags = fcntl(fd, F_GETFL, 0);
+  fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+  const Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(std::max(timeout_ms, 0));
+  int rc = connect(fd, addr, len);
+  if (rc < 0 && errno == EINPROGRESS) {
+    for (;;) {
+      pollfd pfd{fd, POLLOUT, 0};
+      const int pr = ::poll(&pfd, 1, poll_ms(timeout_ms >= 0, deadline));
+      if (pr < 0 && errno == EINTR) continue;
+      if (pr <= 0) {
+        const int saved = pr == 0 ? ETIMEDOUT : errno;
+        ::close(fd);
+        errno = saved;
+        throw_errno("connect " + what);
+      }
+      break;
+    }
+    int err = 0;
+    socklen_t err_len = sizeof(err);
+    getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &err_len);
+    errno = err;
+    rc = err ? -1 : 0;
+  }
+  if (rc < 0) {
+    const int saved = errno;
+    ::close(fd);
+    errno = saved;
+    throw_errno("connect " + what);
+  }
+  fcntl(fd, F_SETFL, flags);
+}
+
+QueryClient QueryClient::connect_unix(const std::string& path, int timeout_ms) {
+  sockaddr_un addr{};
+  if (path.size() >= sizeof(addr.sun_path)) throw std::runtime_error("unix socket path too long: " + path);
+  const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) throw_errno("socket(AF_UNIX)");
+  addr.sun_family = AF_UNIX;
+  std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+  connect_within(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr), timeout_ms, path);
+  return QueryClient(fd);
+}
+
+QueryClient QueryClient::connect_tcp(const std::string& host, uint16_t port, int timeout_ms) {
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  if (inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1) {
+    throw std::runtime_error("bad IPv4 address: " + host);
+  }
+  const int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) throw_errno("socket(AF_INET)");
+  connect_within(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr), timeout_ms,
+                 host + ":" + std::to_string(port));
+  const int one = 1;
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+  return QueryClient(fd);
+}
+
+QueryClient::QueryClient(QueryClient&& other) noexcept
+  : fd_(other.fd_), next_id_(other.next_id_), send_timeout_ms_(other.send_timeout_ms_),
+    in_(std::move(other.in_)) {
+  other.fd_ = -1;
+}
+
+QueryClient& QueryClient::operator=(QueryClient&& other) noexcept {
+  if (this != &other) {
+    if (fd_ >= 0) ::close(fd_);
+    fd_ = other.fd_;
+    next_id_ = other.next_id_;
+    send_timeout_ms_ = other.send_timeout_ms_;
+    in_ = std::move(other.in_);
+    other.fd_ = -1;
+  }
+  return *this;
+}
+
+QueryClient::~QueryClient() {
+  if (fd_ >= 0) ::close(fd_);
+}
+
+// ──────────────────────────────────────────────────────────────
+// Sending
+// ──────────────────────────────────────────────────────────────
+
+void QueryClient::write_all(const char* data, size_t size) {
+  const Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(std::max(send_timeout_ms_, 0));
+  while (size > 0) {
+    const ssize_t w = ::send(fd_, data, size, MSG_NOSIGNAL | MSG_DONTWAIT);
+    if (w < 0) {
+      if (errno == EINTR) continue;
+      if (errno != EAGAIN && errno != EWOULDBLOCK) throw_errno("send");
+      pollfd pfd{fd_, POLLOUT, 0};
+      const int pr = ::poll(&pfd, 1, poll_ms(send_timeout_ms_ >= 0, deadline));
+      if (pr < 0 && errno != EINTR) throw_errno("poll");
+      if (pr == 0) throw std::runtime_error("send: timed out");
+      continue;
+    }
+    data += w;
+    size -= static_cast<size_t>(w);
+  }
+}
+
+uint64_t QueryClient::send_frame(FrameHeader hdr, std::string& frame, size_t at) {
+  hdr.request_id = next_id_++;
+  finish_frame(frame, at, hdr);
+  write_all(frame.data(), frame.size());
+  return hdr.request_id;
+}
+
+uint64_t QueryClient::send_ping(uint16_t index) {
+  std::string frame;
+  const size_t at = begin_frame(frame);
+  FrameHeader hdr;
+  hdr.op = OP_PING;
+  hdr.index = index;
+  return send_frame(hdr, frame, at);
+}
+
+uint64_t QueryClient::send_info(uint16_t index) {
+  std::string frame;
+  const size_t at = begin_frame(frame);
+  FrameHeader hdr;
+  hdr.op = OP_INFO;
+  hdr.index = index;
+  return send_frame(hdr, frame, at);
+}
+
+uint64_t QueryClient::send_count(const std::vector<std::string>& patterns, uint16_t index) {
+  std::string frame;
+  const size_t at = begin_frame(frame);
+  WireWriter w(frame);
+  for (const auto& p : patterns) w.bytes(p);
+  FrameHeader hdr;
+  hdr.op = OP_COUNT;
+  hdr.index = index;
+  hdr.count = static_cast<uint32_t>(patterns.size());
+  return send_frame(hdr, frame, at);
+}
+
+uint64_t QueryClient::send_locate(const std::vector<std::string>& patterns, uint32_t limit,
+                                  uint16_t index, bool smallest) {
+  std::string frame;
+  const size_t at = begin_frame(frame);
+  WireWriter w(frame);
+  w.u32(limit);
+  for (const auto& p : patterns) w.bytes(p);
+  FrameHeader hdr;
+  hdr.op = OP_LOCATE;
+  hdr.index = index;
+  hdr.flags = smallest ? LOCATE_SMALLEST : 0;
+  hdr.count = static_cast<uint32_t>(patterns.size());
+  return send_frame(hdr, frame, at);
+}
+
+uint64_t QueryClient::send_extract(const std::vector<std::pair<uint64_t, uint64_t>>& ranges,
+                                   uint16_t index) {
+  std::string frame;
+  const size_t at = begin_frame(frame);
+  WireWriter w(frame);
+  for (const auto& [pos, len] : ranges) {
+    w.u64(pos);
+    w.u64(len);
+  }
+  FrameHeader hdr;
+  hdr.op = OP_EXTRACT;
+  hdr.index = index;
+  hdr.count = static_cast<uint32_t>(ranges.size());
+  return send_frame(hdr, frame, at);
+}
+
+// ──────────────────────────────────────────────────────────────
+// Receiving
+// ──────────────────────────────────────────────────────────────
+
+bool QueryClient::recv(WireResponse& out, int timeout_ms) {
+  // One deadline for the whole frame, however many pieces it arrives in.
+  const Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(std::max(timeout_ms, 0));
+  for (;;) {
+    FrameHeader hdr;
+    if (peek_frame(in_.data(), in_.size(), hdr) &&
+        in_.size() >= sizeof(FrameHeader) + hdr.payload) {
+      out.header = hdr;
+      out.payload.assign(in_, sizeof(FrameHeader), hdr.payload);
+      in_.erase(0, sizeof(FrameHeader) + hdr.payload);
+      return true;
+    }
+    pollfd pfd{fd_, POLLIN, 0};
+    const int pr = ::poll(&pfd, 1, poll_ms(timeout_ms >= 0, deadline));
+    if (pr < 0) {
+      if (errno == EINTR) continue;
+      throw_errno("poll");
+    }
+    if (pr == 0) return false;
+    char buf[64 * 1024];
+    const ssize_t r = ::read(fd_, buf, sizeof(buf));
+    if (r < 0) {
+      if (errno == EINTR) continue;
+      throw_errno("read");
+    }
+    if (r == 0) throw std::runtime_error("server closed connection");
+    in_.append(buf, static_cast<size_t>(r));
+  }
+}
+
+WireResponse QueryClient::wait_for(uint64_t request_id) {
+  WireResponse r;
+  do {
+    recv(r);
+  } while (r.header.request_id != request_id);
+  return r;
+}
+
+static void check_status(const WireResponse& r) {
+  if (r.header.status != STATUS_OK) {
+    throw std::runtime_error("server error " + std::to_string(r.header.status) + ": " + r.payload);
+  }
+}
+
+std::vector<uint64_t> QueryClient::decode_counts(const WireResponse& r) {
+  check_status(r);
+  WireReader in(r.payload.data(), r.payload.size());
+  std::vector<uint64_t> counts(r.header.count);
+  for (auto& c : counts) c = in.u64();
+  return counts;
+}
+
+std::vector<LocateReply> QueryClient::decode_locates(const WireResponse& r) {
+  check_status(r);
+  WireReader in(r.payload.data(), r.payload.size());
+  std::vector<LocateReply> out(r.header.count);
+  for (auto& rep : out) {
+    rep.total = in.u64();
+    rep.positions.resize(in.u32());
+    if (!rep.positions.empty()) in.raw(rep.positions.data(), rep.positions.size() * sizeof(uint64_t));
+  }
+  return out;
+}
+
+std::vector<std::string> QueryClient::decode_extracts(const WireResponse& r) {
+  check_status(r);
+  WireReader in(r.payload.data(), r.payload.size());
+  std::vector<std::string> out(r.header.count);
+  for (auto& s : out) s = std::string(in.bytes());
+  return out;
+}
+
+IndexInfo QueryClient::decode_info(const WireResponse& r) {
+  check_status(r);
+  WireReader in(r.payload.data(), r.payload.size());
+  IndexInfo info;
+  info.size = in.u64();
+  const std::string_view fold = in.bytes();
+  if (fold.size() != info.fold.size()) throw std::runtime_error("bad fold table in info reply");
+  std::memcpy(info.fold.data(), fold.data(), fold.size());
+  return info;
+}
+
+std::vector<uint64_t> QueryClient::count(const std::vector<std::string>& patterns, uint16_t index) {
+  return decode_counts(wait_for(send_count(patterns, index)));
+}
+
+std::vector<LocateReply> QueryClient::locate(const std::vector<std::string>& patterns,
+                                             uint32_t limit, uint16_t index) {
+  return decode_locates(wait_for(send_locate(patterns, limit, index)));
+}
+
+std::vector<std::string> QueryClient::extract(
+    const std::vector<std::pair<uint64_t, uint64_t>>& ranges, uint16_t index) {
+  return decode_extracts(wait_for(send_extract(ranges, index)));
+}
+
+} // namespace cs
@@ -0,0 +1,95 @@
+#pragma once
+/**
+ * client.hpp — Blocking client for the cs_serverd batch protocol.
+ *
+ * send_*() only writes a frame and returns its request id, so callers can
+ * pipeline many batches before collecting replies with recv(). The
+ * count()/locate()/extract() helpers do a single round trip.
+ *
+ * connect_*() and sends block unless given a timeout; on timeout they throw
+ * std::runtime_error (a timed-out send leaves the stream unusable).
+ */
+
+#include "protocol.hpp"
+#include <array>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace cs {
+
+struct WireResponse {
+  FrameHeader header;
+  std::string payload;
+};
+
+struct IndexInfo {
+  uint64_t size = 0;                  // Text length
+  std::array<uint8_t, 256> fold{};    // Byte map applied to text and patterns (see OP_INFO)
+};
+
+struct LocateReply {
+  uint64_t total = 0;               // Occurrences in the index
+  std::vector<uint64_t> positions;  // Up to `limit` of them, ascending
+};
+
+class QueryClient {
+public:
+  /// timeout_ms bounds the connect (-1 waits as long as the kernel does).
+  static QueryClient connect_unix(const std::string& path, int timeout_ms = -1);
+  static QueryClient connect_tcp(const std::string& host, uint16_t port, int timeout_ms = -1);
+
+  QueryClient(QueryClient&& other) noexcept;
+  QueryClient& operator=(QueryClient&& other) noexcept;
+  QueryClient(const QueryClient&) = delete;
+  QueryClient& operator=(const QueryClient&) = delete;
+  ~QueryClient();
+
+  uint64_t send_ping(uint16_t index = 0);
+  uint64_t send_info(uint16_t index = 0);
+  uint64_t send_count(const std::vector<std::string>& patterns, uint16_t index = 0);
+  /// smallest = true asks for the `limit` smallest positions (LOCATE_SMALLEST).
+  uint64_t send_locate(const std::vector<std::string>& patterns, uint32_t limit,
+                       uint16_t index = 0, bool smallest = false);
+  uint64_t send_extract(const std::vector<std::pair<uint64_t, uint64_t>>& ranges,
+                        uint16_t index = 0);
+
+  /**
+   * recv(out, timeout_ms) — Next response frame. Returns false if none
+   * arrived in full within timeout_ms of the call (-1 waits forever); throws
+   * if the server closed.
+   */
+  bool recv(WireResponse& out, int timeout_ms = -1);
+
+  /// Waits for the response to request_id (replies to other ids are dropped).
+  WireResponse wait_for(uint64_t request_id);
+
+  std::vector<uint64_t> count(const std::vector<std::string>& patterns, uint16_t index = 0);
+  std::vector<LocateReply> locate(const std::vector<std::string>& patterns, uint32_t limit,
+                                  uint16_t index = 0);
+  std::vector<std::string> extract(const std::vector<std::pair<uint64_t, uint64_t>>& ranges,
+                                   uint16_t index = 0);
+
+  /// Response decoders; throw std::runtime_error carrying the server message on error status.
+  static std::vector<uint64_t> decode_counts(const WireResponse& r);
+  static std::vector<LocateReply> decode_locates(const WireResponse& r);
+  static std::vector<std::string> decode_extracts(const WireResponse& r);
+  static IndexInfo decode_info(const WireResponse& r);
+
+  int fd() const { return fd_; }
+  /// Bounds each send_*() call (-1 = block until the frame is written).
+  void set_send_timeout(int timeout_ms) { send_timeout_ms_ = timeout_ms; }
+
+private:
+  explicit QueryClient(int fd) : fd_(fd) {}
+  uint64_t send_frame(FrameHeader hdr, std::string& frame, size_t at);
+  void write_all(const char* data, size_t size);
+
+  int fd_ = -1;
+  uint64_t next_id_ = 1;
+  int send_timeout_ms_ = -1;
+  std::string in_;
+};
+
+} // namespace cs
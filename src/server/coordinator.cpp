@@ -0,0 +1,218 @@
+/**
+ * coordinator.cpp — Scatter requests to shard workers, gather with a deadline.
+ */
+
+#include "coordinator.hpp"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <stdexcept>
+
+namespace cs {
+
+using Clock = std::chrono::steady_clock;
+
+static int remaining_ms(Clock::time_point deadline) {
+  const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count();
+  return left > 0 ? static_cast<int>(left) : 0;
+}
+
+struct Coordinator::Worker {
+  ShardEndpoint ep;
+  std::unique_ptr<QueryClient> client;  // Null until connected
+  FoldTable fold = identity_fold();     // The shard index's fold (from OP_INFO)
+  std::string tail;                     // Overlap bytes after the owned range, folded
+  bool tail_known = false;              // tail and fold fetched on the current connection
+
+  /// Tail hits of pattern as the shard counts them: both sides folded.
+  uint64_t tail_hits(std::string_view pattern) const {
+    std::string p(pattern);
+    for (auto& c : p) c = static_cast<char>(fold[static_cast<uint8_t>(c)]);
+    return scan_count(tail, p);
+  }
+};
+
+static QueryClient connect_to(const std::string& address, int timeout_ms) {
+  if (address.rfind("unix:", 0) == 0) return QueryClient::connect_unix(address.substr(5), timeout_ms);
+  const auto colon = address.rfind(':');
+  if (colon == std::string::npos) throw std::invalid_argument("expected unix:PATH or HOST:PORT, got " + address);
+  return QueryClient::connect_tcp(address.substr(0, colon),
+                                  static_cast<uint16_t>(std::stoul(address.substr(colon + 1))), timeout_ms);
+}
+
+// Reads replies until every nonzero id in ids has one (stored in out at the
+// same index), in whichever order the server finished them. Replies to other
+// ids are dropped. False if the deadline passes first.
+static bool await_replies(QueryClient& c, const std::vector<uint64_t>& ids,
+                          Clock::time_point deadline, std::vector<WireResponse>& out) {
+  out.assign(ids.size(), WireResponse{});
+  size_t pending = 0;
+  for (uint64_t id : ids) pending += id != 0;
+  while (pending > 0) {
+    WireResponse next;
+    if (!c.recv(next, remaining_ms(deadline))) return false;
+    for (size_t k = 0; k < ids.size(); ++k) {
+      if (ids[k] != 0 && next.header.request_id == ids[k]) {
+        out[k] = std::move(next);
+        --pending;
+        break;
+      }
+    }
+  }
+  return true;
+}
+
+Coordinator::Coordinator(std::vector<ShardEndpoint> shards, const CoordinatorConfig& cfg)
+  : cfg_(cfg) {
+  if (shards.empty()) throw std::invalid_argument("coordinator needs at least one shard");
+  for (auto& ep : shards) {
+    workers_.push_back(std::make_unique<Worker>());
+    workers_.back()->ep = std::move(ep);
+  }
+}
+
+Coordinator::~Coordinator() = default;
+
+std::vector<ShardEndpoint> Coordinator::endpoints(const ShardManifest& m,
+                                                  const std::vector<std::string>& addresses) {
+  if (addresses.size() != m.shards.size()) {
+    throw std::invalid_argument("manifest has " + std::to_string(m.shards.size()) +
+                                " shards but " + std::to_string(addresses.size()) + " workers given");
+  }
+  std::vector<ShardEndpoint> eps;
+  for (size_t i = 0; i < addresses.size(); ++i) {
+    const ShardInfo& s = m.shards[i];
+    eps.push_back({addresses[i], 0, s.start, s.owned, s.tail_len});
+  }
+  return eps;
+}
+
+void Coordinator::check_patterns(const std::vector<std::string>& patterns) const {
+  if (cfg_.max_pattern_len == 0) return;
+  for (const auto& p : patterns) {
+    if (p.size() > cfg_.max_pattern_len) {
+      throw std::invalid_argument("pattern longer than shard max_pattern_len (" +
+                                  std::to_string(cfg_.max_pattern_len) + ")");
+    }
+  }
+}
+
+// ──────────────────────────────────────────────────────────────
+// fan_out: connect lazily, send to all, then gather until the deadline
+// ──────────────────────────────────────────────────────────────
+
+template <class Send, class Merge>
+std::vector<size_t> Coordinator::fan_out(Send send, Merge merge) {
+  const Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(cfg_.timeout_ms);
+  std::vector<uint64_t> tail_ids(workers_.size(), 0);  // Tail fetch on a fresh connection
+  std::vector<uint64_t> info_ids(workers_.size(), 0);  // Fold table, same connection
+  std::vector<uint64_t> ids(workers_.size(), 0);       // 0 = shard not queried
+  std::vector<size_t> missing;
+
+  // Everything is sent before anything is awaited, so one slow shard only
+  // delays the gather, never the other shards' work. Connects and sends are
+  // bounded by the same deadline, so a blackholed node or a full socket
+  // buffer marks the shard missing instead of stalling the fan-out.
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    Worker& w = *workers_[i];
+    try {
+      if (!w.client) {
+        w.tail_known = false;
+        w.client = std::make_unique<QueryClient>(connect_to(w.ep.address, remaining_ms(deadline)));
+        w.client->set_send_timeout(remaining_ms(deadline));
+        tail_ids[i] = w.client->send_extract({{w.ep.owned, w.ep.tail_len}}, w.ep.slot);
+        info_ids[i] = w.client->send_info(w.ep.slot);
+      }
+      w.client->set_send_timeout(remaining_ms(deadline));
+      ids[i] = send(*w.client, w);
+    } catch (const std::exception&) {
+      w.client.reset();
+      missing.push_back(i);
+    }
+  }
+
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    if (ids[i] == 0) continue;
+    Worker& w = *workers_[i];
+    try {
+      std::vector<WireResponse> r;
+      if (!await_replies(*w.client, {tail_ids[i], info_ids[i], ids[i]}, deadline, r)) {
+        throw std::runtime_error("timed out");
+      }
+      if (tail_ids[i] != 0) {
+        w.fold = QueryClient::decode_info(r[1]).fold;
+        w.tail = QueryClient::decode_extracts(r[0]).at(0);
+        if (w.tail.size() != w.ep.tail_len) throw std::runtime_error("shard tail shorter than manifest");
+        for (auto& c : w.tail) c = static_cast<char>(w.fold[static_cast<uint8_t>(c)]);
+        w.tail_known = true;
+      }
+      merge(w, r[2]);
+    } catch (const std::exception&) {
+      // Abandon the connection so a late reply cannot be mistaken for a
+      // newer request; the next fan-out reconnects and refetches the tail.
+      w.client.reset();
+      missing.push_back(i);
+    }
+  }
+  std::sort(missing.begin(), missing.end());
+  return missing;
+}
+
+// ──────────────────────────────────────────────────────────────
+// Queries
+// ──────────────────────────────────────────────────────────────
+
+CoordinatorCounts Coordinator::count(const std::vector<std::string>& patterns) {
+  check_patterns(patterns);
+  CoordinatorCounts out;
+  out.counts.assign(patterns.size(), 0);
+  out.missing = fan_out(
+      [&](QueryClient& c, const Worker& w) { return c.send_count(patterns, w.ep.slot); },
+      [&](const Worker& w, const WireResponse& r) {
+        const auto counts = QueryClient::decode_counts(r);
+        if (counts.size() != patterns.size()) throw std::runtime_error("short count reply");
+        for (size_t k = 0; k < patterns.size(); ++k) {
+          if (patterns[k].empty()) {
+            out.counts[k] += w.ep.owned;
+          } else if (counts[k] > 0) {
+            out.counts[k] += counts[k] - w.tail_hits(patterns[k]);
+          }
+        }
+      });
+  return out;
+}
+
+CoordinatorLocates Coordinator::locate(const std::vector<std::string>& patterns, uint32_t limit) {
+  check_patterns(patterns);
+  CoordinatorLocates out;
+  out.replies.resize(patterns.size());
+  out.missing = fan_out(
+      [&](QueryClient& c, const Worker& w) {
+        // Smallest positions, so the per-shard lists merge into a correct
+        // prefix; tail hits sort after owned ones and never displace them.
+        return c.send_locate(patterns, limit, w.ep.slot, true);
+      },
+      [&](const Worker& w, const WireResponse& r) {
+        const auto replies = QueryClient::decode_locates(r);
+        if (replies.size() != patterns.size()) throw std::runtime_error("short locate reply");
+        for (size_t k = 0; k < patterns.size(); ++k) {
+          LocateReply& dst = out.replies[k];
+          if (patterns[k].empty()) {
+            dst.total += w.ep.owned;
+            continue;
+          }
+          if (replies[k].total == 0) continue;
+          dst.total += replies[k].total - w.tail_hits(patterns[k]);
+          for (uint64_t p : replies[k].positions) {
+            if (p < w.ep.owned) dst.positions.push_back(w.ep.start + p);
+          }
+        }
+      });
+  for (auto& rep : out.replies) {
+    std::sort(rep.positions.begin(), rep.positions.end());
+    if (rep.positions.size() > limit) rep.positions.resize(limit);
+  }
+  return out;
+}
+
+} // namespace cs
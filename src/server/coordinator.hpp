@@ -0,0 +1,83 @@
+#pragma once
+/**
+ * coordinator.hpp — Routes batched queries to shard workers and merges them.
+ *
+ * Each shard of a ShardedIndex (see api/sharded_index.hpp) is served by a
+ * worker speaking the cs_serverd protocol, typically one cs_serverd process
+ * per node. A request is sent to every shard before any reply is awaited, so
+ * shards work concurrently; replies are then collected against a single
+ * deadline. Shards that miss the deadline or whose connection fails are
+ * reported in `missing` and the result covers only the shards that answered.
+ *
+ * Overlap handling matches ShardedIndex: the coordinator fetches each shard's
+ * tail and fold table (OP_INFO) once per connection and subtracts/filters hits
+ * that start there, folding tail and patterns the way a folded shard does.
+ * A connection that fails or times out is dropped and re-established on the
+ * next request. A Coordinator is not thread-safe; use one per client thread.
+ */
+
+#include "client.hpp"
+#include "../api/sharded_index.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace cs {
+
+struct ShardEndpoint {
+  std::string address;    // "unix:/path/to.sock" or "HOST:PORT" (IPv4)
+  uint16_t slot = 0;      // Index slot on that worker
+  uint64_t start = 0;     // From the shard manifest
+  uint64_t owned = 0;
+  uint64_t tail_len = 0;
+};
+
+struct CoordinatorConfig {
+  int timeout_ms = 1000;        // Deadline for one fan-out (connect + send + reply)
+  size_t max_pattern_len = 0;   // Manifest value; 0 = patterns unchecked
+};
+
+struct CoordinatorCounts {
+  std::vector<uint64_t> counts;    // One per pattern
+  std::vector<size_t> missing;     // Shards that timed out or failed
+  bool partial() const { return !missing.empty(); }
+};
+
+struct CoordinatorLocates {
+  std::vector<LocateReply> replies;  // Global positions, ascending
+  std::vector<size_t> missing;
+  bool partial() const { return !missing.empty(); }
+};
+
+class Coordinator {
+public:
+  explicit Coordinator(std::vector<ShardEndpoint> shards, const CoordinatorConfig& cfg = {});
+  ~Coordinator();
+
+  Coordinator(const Coordinator&) = delete;
+  Coordinator& operator=(const Coordinator&) = delete;
+
+  /// Pairs manifest shard i with addresses[i] (slot 0 on each worker).
+  static std::vector<ShardEndpoint> endpoints(const ShardManifest& m,
+                                              const std::vector<std::string>& addresses);
+
+  /// Throws std::invalid_argument if a pattern exceeds max_pattern_len.
+  CoordinatorCounts count(const std::vector<std::string>& patterns);
+  CoordinatorLocates locate(const std::vector<std::string>& patterns, uint32_t limit);
+
+  size_t num_shards() const { return workers_.size(); }
+  void set_timeout(int timeout_ms) { cfg_.timeout_ms = timeout_ms; }
+
+private:
+  struct Worker;
+
+  void check_patterns(const std::vector<std::string>& patterns) const;
+  template <class Send, class Merge>
+  std::vector<size_t> fan_out(Send send, Merge merge);
+
+  CoordinatorConfig cfg_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+};
+
+} // namespace cs
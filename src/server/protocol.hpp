@@ -0,0 +1,185 @@
+#pragma once
+/**
+ * protocol.hpp — Compact binary batch protocol spoken by cs_serverd.
+ *
+ * Every message is a 32-byte FrameHeader followed by `payload` bytes. A frame
+ * carries a batch of `count` items of one operation; clients may pipeline any
+ * number of frames per connection. Responses echo request_id and may arrive
+ * out of order (frames are executed on a worker pool).
+ *
+ * Request payloads (integers little-endian):
+ *   OP_PING     —
+ *   OP_INFO     —
+ *   OP_COUNT    count × { u32 len, bytes[len] }
+ *   OP_LOCATE   u32 limit, then count × { u32 len, bytes[len] }; header flag
+ *               LOCATE_SMALLEST selects which positions a limit keeps
+ *   OP_EXTRACT  count × { u64 pos, u64 len }
+ *
+ * Response payloads (status == STATUS_OK):
+ *   OP_PING     —
+ *   OP_INFO     u64 text_len, u32 256, bytes[256] fold table (byte b of the
+ *               text and of patterns is searched as table[b]; identity
+ *               unless the index was built with BuildParams::fold)
+ *   OP_COUNT    count × u64
+ *   OP_LOCATE   count × { u64 total, u32 n, u64 pos[n] }, n = min(total, limit)
+ *               positions, ascending: those of the first n SA rows, or with
+ *               LOCATE_SMALLEST the n smallest (costs a walk of every row)
+ *   OP_EXTRACT  count × { u32 len, bytes[len] }
+ * Any other status carries an error message as payload and count == 0.
+ *
+ * Both directions are capped at FRAME_MAX_PAYLOAD. A request whose response
+ * would exceed it (e.g. many large EXTRACT ranges, or LOCATE limit × count
+ * positions) fails as a whole with STATUS_BAD_REQUEST; split the batch.
+ */
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <stdexcept>
+
+namespace cs {
+
+// ──────────────────────────────────────────────────────────────
+// Constants
+// ──────────────────────────────────────────────────────────────
+
+constexpr uint32_t FRAME_MAGIC = 0x31515343;          // "CSQ1"
+constexpr uint32_t FRAME_MAX_PAYLOAD = 64u << 20;     // 64 MiB
+
+enum WireOp : uint16_t {
+  OP_PING    = 0,
+  OP_INFO    = 1,
+  OP_COUNT   = 2,
+  OP_LOCATE  = 3,
+  OP_EXTRACT = 4,
+};
+
+// Request flags (FrameHeader::flags)
+enum WireFlags : uint16_t {
+  LOCATE_SMALLEST = 1,     // OP_LOCATE: keep the `limit` smallest positions (mergeable)
+};
+
+enum WireStatus : uint16_t {
+  STATUS_OK          = 0,
+  STATUS_BAD_REQUEST = 1,  // Malformed payload or unknown op
+  STATUS_NO_INDEX    = 2,  // Index slot out of range
+  STATUS_INTERNAL    = 3,  // Exception while executing
+  STATUS_TIMEOUT     = 4,  // Used by coordinators for missing shard replies
+};
+
+// ──────────────────────────────────────────────────────────────
+// Frame header (32 bytes)
+// ──────────────────────────────────────────────────────────────
+
+struct FrameHeader {
+  uint32_t magic = FRAME_MAGIC;
+  uint32_t payload = 0;       // Bytes following the header
+  uint64_t request_id = 0;    // Echoed in the response
+  uint16_t op = OP_PING;      // WireOp
+  uint16_t index = 0;         // Index slot on the server
+  uint16_t status = STATUS_OK;
+  uint16_t flags = 0;         // WireFlags
+  uint32_t count = 0;         // Items in the batch
+  uint32_t reserved2 = 0;
+};
+
+static_assert(sizeof(FrameHeader) == 32, "FrameHeader should be 32 bytes");
+
+/// Thrown for malformed frames or payloads.
+struct WireError : std::runtime_error {
+  using std::runtime_error::runtime_error;
+};
+
+// ──────────────────────────────────────────────────────────────
+// WireWriter: append-only encoder into a std::string buffer
+// ──────────────────────────────────────────────────────────────
+
+class WireWriter {
+public:
+  explicit WireWriter(std::string& out) : out_(out) {}
+
+  void u32(uint32_t v) { raw(&v, sizeof(v)); }
+  void u64(uint64_t v) { raw(&v, sizeof(v)); }
+  void bytes(std::string_view s) {
+    u32(static_cast<uint32_t>(s.size()));
+    out_.append(s.data(), s.size());
+  }
+  void raw(const void* p, size_t n) { out_.append(static_cast<const char*>(p), n); }
+
+private:
+  std::string& out_;
+};
+
+// ──────────────────────────────────────────────────────────────
+// WireReader: bounds-checked decoder (throws on truncation)
+// ──────────────────────────────────────────────────────────────
+
+class WireReader {
+public:
+  WireReader(const char* data, size_t size) : p_(data), end_(data + size) {}
+
+  uint32_t u32() { uint32_t v; raw(&v, sizeof(v)); return v; }
+  uint64_t u64() { uint64_t v; raw(&v, sizeof(v)); return v; }
+  std::string_view bytes() {
+    const uint32_t len = u32();
+    need(len);
+    std::string_view s(p_, len);
+    p_ += len;
+    return s;
+  }
+  void raw(void* dst, size_t n) {
+    need(n);
+    std::memcpy(dst, p_, n);
+    p_ += n;
+  }
+  bool done() const { return p_ == end_; }
+
+private:
+  void need(size_t n) const {
+    if (static_cast<size_t>(end_ - p_) < n) throw WireError("wire: truncated payload");
+  }
+  const char* p_;
+  const char* end_;
+};
+
+// ──────────────────────────────────────────────────────────────
+// Frame helpers
+// ──────────────────────────────────────────────────────────────
+
+/// Reserves header space at the end of out; call finish_frame once the payload is written.
+inline size_t begin_frame(std::string& out) {
+  const size_t at = out.size();
+  out.resize(at + sizeof(FrameHeader));
+  return at;
+}
+
+inline void finish_frame(std::string& out, size_t at, FrameHeader hdr) {
+  const size_t payload = out.size() - at - sizeof(FrameHeader);
+  if (payload > FRAME_MAX_PAYLOAD) throw WireError("wire: frame too large");
+  hdr.payload = static_cast<uint32_t>(payload);
+  std::memcpy(&out[at], &hdr, sizeof(FrameHeader));
+}
+
+/// Appends an error response for request `req` to out.
+inline void append_error(std::string& out, const FrameHeader& req, WireStatus status,
+                         std::string_view message) {
+  const size_t at = begin_frame(out);
+  out.append(message.data(), message.size());
+  FrameHeader hdr = req;
+  hdr.status = status;
+  hdr.count = 0;
+  finish_frame(out, at, hdr);
+}
+
+/// Parses a header from buf; returns false if fewer than 32 bytes are available.
+inline bool peek_frame(const char* buf, size_t size, FrameHeader& hdr) {
+  if (size < sizeof(FrameHeader)) return false;
+  std::memcpy(&hdr, buf, sizeof(FrameHeader));
+  if (hdr.magic != FRAME_MAGIC) throw WireError("wire: bad frame magic");
+  if (hdr.payload > FRAME_MAX_PAYLOAD) throw WireError("wire: frame too large");
+  return true;
+}
+
+} // namespace cs
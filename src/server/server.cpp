@@ -0,0 +1,427 @@
+/**
+ * server.cpp — epoll event loop + worker pool for cs_serverd.
+ */
+
+#include "server.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace cs {
+
+// epoll user data: 0 = wake eventfd, [1, CONN_ID_BASE) = listeners, else connection id.
+constexpr uint64_t WAKE_ID = 0;
+constexpr uint64_t CONN_ID_BASE = 64;
+
+static void throw_errno(const std::string& what) {
+  throw std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+// ──────────────────────────────────────────────────────────────
+// execute_frame: Decode one batch, run it, encode the response
+// ──────────────────────────────────────────────────────────────
+
+void execute_frame(const FrameHeader& req, const char* payload, const FMIndex& idx,
+                   std::string& out, IntervalCache* cache) {
+  const size_t at = begin_frame(out);
+  FrameHeader hdr = req;
+  hdr.status = STATUS_OK;
+  // Fails the frame before an item would push the response past the cap.
+  auto reserve = [&](uint64_t bytes) {
+    if (bytes > FRAME_MAX_PAYLOAD - (out.size() - at - sizeof(FrameHeader))) {
+      throw std::invalid_argument("response exceeds FRAME_MAX_PAYLOAD; split the batch");
+    }
+  };
+  try {
+    WireReader in(payload, req.payload);
+    WireWriter w(out);
+    switch (req.op) {
+      case OP_PING:
+        hdr.count = 0;
+        break;
+      case OP_INFO: {
+        const FoldTable& fold = idx.fold_table();
+        w.u64(idx.size());
+        w.bytes(std::string_view(reinterpret_cast<const char*>(fold.data()), fold.size()));
+        hdr.count = 1;
+        break;
+      }
+      case OP_COUNT:
+        for (uint32_t i = 0; i < req.count; ++i) {
+          const std::string_view pattern = in.bytes();
+          reserve(8);
+          w.u64(cache ? cache->count(pattern) : idx.count(pattern));
+        }
+        break;
+      case OP_LOCATE: {
+        const uint32_t limit = in.u32();
+        for (uint32_t i = 0; i < req.count; ++i) {
+          const std::string_view pattern = in.bytes();
+          const SAInterval iv = cache ? cache->interval(pattern) : idx.interval(pattern);
+          const uint64_t total = pattern.empty() ? idx.size() : iv.size();
+          reserve(12 + 8 * std::min<uint64_t>(limit, iv.size()));
+          const auto pos = (req.flags & LOCATE_SMALLEST) ? idx.locate_smallest(iv, limit)
+                                                         : idx.locate(iv, limit);
+          w.u64(total);
+          w.u32(static_cast<uint32_t>(pos.size()));
+          if (!pos.empty()) w.raw(pos.data(), pos.size() * sizeof(uint64_t));
+        }
+        break;
+      }
+      case OP_EXTRACT:
+        for (uint32_t i = 0; i < req.count; ++i) {
+          const uint64_t pos = in.u64();
+          const uint64_t want = in.u64();
+          const uint64_t len = pos < idx.size() ? std::min<uint64_t>(want, idx.size() - pos) : 0;
+          reserve(4 + len);
+          w.bytes(idx.extract(pos, len));
+        }
+        break;
+      default:
+        throw std::invalid_argument("unknown op " + std::to_string(req.op));
+    }
+    if (!in.done()) throw std::invalid_argument("trailing bytes in payload");
+    finish_frame(out, at, hdr);
+  } catch (const WireError& e) {
+    out.resize(at);
+    append_error(out, req, STATUS_BAD_REQUEST, e.what());
+  } catch (const std::invalid_argument& e) {
+    out.resize(at);
+    append_error(out, req, STATUS_BAD_REQUEST, e.what());
+  } catch (const std::exception& e) {
+    out.resize(at);
+    append_error(out, req, STATUS_INTERNAL, e.what());
+  }
+}
+
+// ──────────────────────────────────────────────────────────────
+// Construction / listeners
+// ──────────────────────────────────────────────────────────────
+
+QueryServer::QueryServer(std::vector<const FMIndex*> indexes, const ServerConfig& cfg)
+  : indexes_(std::move(indexes)), cfg_(cfg), next_id_(CONN_ID_BASE), pool_(cfg.threads) {
+  epfd_ = epoll_create1(EPOLL_CLOEXEC);
+  if (epfd_ < 0) throw_errno("epoll_create1");
+  wakefd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (wakefd_ < 0) throw_errno("eventfd");
+  epoll_event ev{};
+  ev.events = EPOLLIN;
+  ev.data.u64 = WAKE_ID;
+  if (epoll_ctl(epfd_, EPOLL_CTL_ADD, wakefd_, &ev) < 0) throw_errno("epoll_ctl(wake)");
+  if (cfg_.cache_bytes > 0 && !indexes_.empty()) {
+    IntervalCacheConfig cc;
+    cc.memory_bytes = cfg_.cache_bytes / indexes_.size();
+    for (const FMIndex* idx : indexes_) caches_.push_back(std::make_unique<IntervalCache>(*idx, cc));
+  }
+}
+
+QueryServer::~QueryServer() {
+  // In-flight tasks write to done_ and wakefd_; let them finish first.
+  pool_.join();
+  for (auto& kv : conns_) ::close(kv.second.fd);
+  for (int fd : listeners_) ::close(fd);
+  for (const auto& p : unix_paths_) ::unlink(p.c_str());
+  if (wakefd_ >= 0) ::close(wakefd_);
+  if (epfd_ >= 0) ::close(epfd_);
+}
+
+void QueryServer::add_listener(int fd) {
+  if (listen(fd, SOMAXCONN) < 0) { ::close(fd); throw_errno("listen"); }
+  if (1 + listeners_.size() >= CONN_ID_BASE) { ::close(fd); throw std::runtime_error("too many listeners"); }
+  epoll_event ev{};
+  ev.events = EPOLLIN;
+  ev.data.u64 = 1 + listeners_.size();
+  if (epoll_ctl(epfd_, EPOLL_CTL_ADD, fd, &ev) < 0) { ::close(fd); throw_errno("epoll_ctl(listen)"); }
+  listeners_.push_back(fd);
+}
+
+void QueryServer::listen_unix(const std::string& path) {
+  sockaddr_un addr{};
+  if (path.size() >= sizeof(addr.sun_path)) throw std::runtime_error("unix socket path too long: " + path);
+  const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (fd < 0) throw_errno("socket(AF_UNIX)");
+  addr.sun_family = AF_UNIX;
+  std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+  ::unlink(path.c_str());
+  if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+    ::close(fd);
+    throw_errno("bind " + path);
+  }
+  add_listener(fd);
+  unix_paths_.push_back(path);
+}
+
+uint16_t QueryServer::listen_tcp(const std::string& host, uint16_t port) {
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  if (inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1) {
+    throw std::runtime_error("bad IPv4 address: " + host);
+  }
+  const int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (fd < 0) throw_errno("socket(AF_INET)");
+  const int one = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+    ::close(fd);
+    throw_errno("bind " + host + ":" + std::to_string(port));
+  }
+  socklen_t len = sizeof(addr);
+  getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len);
+  add_listener(fd);
+  return ntohs(addr.sin_port);
+}
+
+// ──────────────────────────────────────────────────────────────
+// Event loop
+// ──────────────────────────────────────────────────────────────
+
+void QueryServer::stop() {
+  stopping_.store(true);
+  const uint64_t one = 1;
+  ssize_t r = ::write(wakefd_, &one, sizeof(one));
+  (void)r;
+}
+
+void QueryServer::run() {
+  constexpr int MAX_EVENTS = 128;
+  epoll_event events[MAX_EVENTS];
+  while (!stopping_.load()) {
+    const int n = epoll_wait(epfd_, events, MAX_EVENTS, -1);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      throw_errno("epoll_wait");
+    }
+    for (int e = 0; e < n; ++e) {
+      const uint64_t id = events[e].data.u64;
+      if (id == WAKE_ID) {
+        uint64_t v;
+        while (::read(wakefd_, &v, sizeof(v)) > 0) {}
+        drain_completions();
+      } else if (id < CONN_ID_BASE) {
+        accept_all(listeners_[id - 1]);
+      } else {
+        if (events[e].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) on_readable(id, events[e].events);
+        auto it = conns_.find(id);
+        // Sends pending output, then runs frames held back by a full buffer.
+        if (it != conns_.end() && (events[e].events & EPOLLOUT)) parse_frames(id, it->second);
+      }
+    }
+  }
+}
+
+void QueryServer::accept_all(int lfd) {
+  for (;;) {
+    const int fd = accept4(lfd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) return;
+      if (errno == EMFILE || errno == ENFILE) return;  // Retry on the next wakeup
+      throw_errno("accept4");
+    }
+    const int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));  // Fails harmlessly on AF_UNIX
+    const uint64_t id = next_id_++;
+    epoll_event ev{};
+    ev.events = EPOLLIN | EPOLLRDHUP;
+    ev.data.u64 = id;
+    if (epoll_ctl(epfd_, EPOLL_CTL_ADD, fd, &ev) < 0) { ::close(fd); continue; }
+    Connection& c = conns_[id];
+    c.fd = fd;
+    c.events = ev.events;
+  }
+}
+
+void QueryServer::on_readable(uint64_t id, uint32_t events) {
+  auto it = conns_.find(id);
+  if (it == conns_.end()) return;
+  Connection& c = it->second;
+  if (c.eof) return;
+  if (!reading(c)) {
+    // Input is paused; HUP/ERR stay level-triggered, and the peer is gone anyway.
+    if (events & (EPOLLHUP | EPOLLERR)) close_conn(id);
+    return;
+  }
+  char buf[64 * 1024];
+  // Bounded read-ahead: what is left stays in the socket until the next wakeup.
+  // A frame larger than max_buffered is still read in full once its header is
+  // in, or it could never be parsed and EPOLLIN would fire forever.
+  for (;;) {
+    size_t limit = cfg_.max_buffered;
+    try {
+      FrameHeader hdr;
+      if (peek_frame(c.in.data(), c.in.size(), hdr)) {
+        limit = std::max(limit, sizeof(FrameHeader) + hdr.payload);
+      }
+    } catch (const std::exception&) {
+      close_conn(id);  // Framing is lost; nothing sensible to reply to
+      return;
+    }
+    if (c.in.size() >= limit) break;
+    const ssize_t r = ::read(c.fd, buf, sizeof(buf));
+    if (r > 0) {
+      c.in.append(buf, static_cast<size_t>(r));
+      continue;
+    }
+    if (r == 0) {
+      // Peer half-closed: answer what was already sent, then close.
+      c.eof = true;
+      break;
+    }
+    if (errno == EINTR) continue;
+    if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+    close_conn(id);  // Hard error
+    return;
+  }
+  parse_frames(id, c);
+}
+
+bool QueryServer::runs_inline(const FrameHeader& req) const {
+  switch (req.op) {
+    case OP_PING:
+    case OP_INFO:
+      return true;
+    case OP_COUNT:
+      return req.count <= cfg_.inline_items;
+    default:
+      return false;  // LOCATE/EXTRACT cost scales with occurrences or bytes
+  }
+}
+
+bool QueryServer::reading(const Connection& c) const {
+  return !c.eof && c.inflight < cfg_.max_inflight &&
+         c.out.size() - c.out_off < cfg_.max_buffered;
+}
+
+void QueryServer::parse_frames(uint64_t id, Connection& c) {
+  for (;;) {
+    const bool was_full = c.out.size() - c.out_off >= cfg_.max_buffered;
+    size_t off = 0;
+    std::string inline_out;
+    try {
+      FrameHeader req;
+      while (c.inflight < cfg_.max_inflight &&
+             c.out.size() - c.out_off + inline_out.size() < cfg_.max_buffered &&
+             peek_frame(c.in.data() + off, c.in.size() - off, req)) {
+        const size_t total = sizeof(FrameHeader) + req.payload;
+        if (c.in.size() - off < total) break;
+        const char* payload = c.in.data() + off + sizeof(FrameHeader);
+        if (runs_inline(req)) {
+          handle(req, payload, inline_out);
+        } else {
+          ++c.inflight;
+          pool_.submit([this, id, req, body = std::string(payload, req.payload)] {
+            std::string out;
+            handle(req, body.data(), out);
+            {
+              std::lock_guard<std::mutex> lock(done_mu_);
+              done_.emplace_back(id, std::move(out));
+            }
+            const uint64_t one = 1;
+            ssize_t r = ::write(wakefd_, &one, sizeof(one));
+            (void)r;
+          });
+        }
+        off += total;
+      }
+    } catch (const std::exception&) {
+      close_conn(id);  // Framing is lost; nothing sensible to reply to
+      return;
+    }
+    c.in.erase(0, off);
+    c.out += inline_out;
+    if (!flush(id, c)) return;
+    // Frames held back by a full output buffer may fit now that some was sent;
+    // otherwise an idle round means only a partial frame is left.
+    if (c.in.empty() || c.inflight >= cfg_.max_inflight ||
+        c.out.size() - c.out_off >= cfg_.max_buffered || (off == 0 && !was_full)) {
+      break;
+    }
+  }
+  rearm(id, c);
+}
+
+void QueryServer::handle(const FrameHeader& req, const char* payload, std::string& out) const {
+  if (req.index >= indexes_.size()) {
+    append_error(out, req, STATUS_NO_INDEX, "no index in slot " + std::to_string(req.index));
+    return;
+  }
+  execute_frame(req, payload, *indexes_[req.index], out,
+                caches_.empty() ? nullptr : caches_[req.index].get());
+}
+
+bool QueryServer::flush(uint64_t id, Connection& c) {
+  while (c.out_off < c.out.size()) {
+    const ssize_t w = ::send(c.fd, c.out.data() + c.out_off, c.out.size() - c.out_off, MSG_NOSIGNAL);
+    if (w > 0) { c.out_off += static_cast<size_t>(w); continue; }
+    if (w < 0 && errno == EINTR) continue;
+    if (w < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+    close_conn(id);
+    return false;
+  }
+  if (c.out_off == c.out.size()) {
+    c.out.clear();
+    c.out_off = 0;
+  }
+  return true;
+}
+
+void QueryServer::rearm(uint64_t id, Connection& c) {
+  if (c.eof && c.inflight == 0 && c.out.empty()) {
+    close_conn(id);
+    return;
+  }
+  // Stop polling for input after EOF (it would stay readable forever) and
+  // while the connection is over its inflight or output budget.
+  const uint32_t want = (reading(c) ? uint32_t(EPOLLIN | EPOLLRDHUP) : 0u) |
+                        (c.out.empty() ? 0u : uint32_t(EPOLLOUT));
+  if (want != c.events) {
+    epoll_event ev{};
+    ev.events = want;
+    ev.data.u64 = id;
+    epoll_ctl(epfd_, EPOLL_CTL_MOD, c.fd, &ev);
+    c.events = want;
+  }
+}
+
+void QueryServer::drain_completions() {
+  std::vector<std::pair<uint64_t, std::string>> done;
+  {
+    std::lock_guard<std::mutex> lock(done_mu_);
+    done.swap(done_);
+  }
+  for (auto& [id, bytes] : done) {
+    auto it = conns_.find(id);
+    if (it == conns_.end()) continue;  // Client went away; drop the reply
+    Connection& c = it->second;
+    --c.inflight;
+    c.out += bytes;
+  }
+  for (auto& [id, bytes] : done) {
+    auto it = conns_.find(id);
+    if (it == conns_.end()) continue;
+    // parse_frames resumes frames held back by max_inflight, flushes, and
+    // re-enables reads once the connection is back under budget.
+    parse_frames(id, it->second);
+  }
+}
+
+void QueryServer::close_conn(uint64_t id) {
+  auto it = conns_.find(id);
+  if (it == conns_.end()) return;
+  epoll_ctl(epfd_, EPOLL_CTL_DEL, it->second.fd, nullptr);
+  ::close(it->second.fd);
+  conns_.erase(it);
+}
+
+} // namespace cs
@@ -0,0 +1,118 @@
+#pragma once
+/**
+ * server.hpp — Persistent query server over Unix-domain or TCP sockets.
+ *
+ * One epoll event loop owns every socket; complete frames are handed to a
+ * worker pool and finished responses come back through an eventfd, so a slow
+ * locate never stalls other connections. Only PING/INFO and small COUNT
+ * batches (<= inline_items) run directly on the loop thread to skip the
+ * handoff; LOCATE and EXTRACT cost depends on the data and always go to the
+ * pool.
+ *
+ * Backpressure: a connection stops being read while max_inflight of its
+ * frames are on the workers or max_buffered response bytes wait for the
+ * peer, and resumes once either drains.
+ *
+ * Linux only (epoll + eventfd). See protocol.hpp for the wire format.
+ */
+
+#include "protocol.hpp"
+#include "../api/fm_index.hpp"
+#include "../api/interval_cache.hpp"
+#include "../util/thread_pool.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace cs {
+
+struct ServerConfig {
+  size_t threads = 0;           // Worker threads (0 = hardware concurrency)
+  size_t inline_items = 4;      // COUNT batches this small run on the event loop
+  size_t max_inflight = 256;    // Per-connection frames queued on workers
+  size_t max_buffered = 8u << 20;  // Per-connection input read ahead / unsent output
+  size_t cache_bytes = 0;       // Interval cache, split across slots (0 = off)
+};
+
+/**
+ * execute_frame(req, payload, idx, out, cache) — Runs one request frame
+ * against idx and appends the response frame to out. COUNT/LOCATE go through
+ * cache when one is given (it must be bound to idx). Malformed payloads
+ * produce an error response rather than throwing.
+ */
+void execute_frame(const FrameHeader& req, const char* payload, const FMIndex& idx,
+                   std::string& out, IntervalCache* cache = nullptr);
+
+class QueryServer {
+public:
+  /// Indexes are borrowed and must outlive the server; slot i = indexes[i].
+  explicit QueryServer(std::vector<const FMIndex*> indexes, const ServerConfig& cfg = {});
+  ~QueryServer();
+
+  QueryServer(const QueryServer&) = delete;
+  QueryServer& operator=(const QueryServer&) = delete;
+
+  /// Binds a Unix-domain stream socket (an existing socket file is replaced).
+  void listen_unix(const std::string& path);
+
+  /// Binds a TCP socket; port 0 picks a free port. Returns the bound port.
+  uint16_t listen_tcp(const std::string& host, uint16_t port);
+
+  /// Runs the event loop until stop() is called.
+  void run();
+
+  /// Thread-safe and async-signal-safe: wakes the loop and makes run() return.
+  void stop();
+
+  /// Interval cache of slot i, or nullptr when caching is off.
+  const IntervalCache* cache(size_t slot) const {
+    return slot < caches_.size() ? caches_[slot].get() : nullptr;
+  }
+
+private:
+  struct Connection {
+    int fd = -1;
+    std::string in;               // Unparsed bytes
+    std::string out;              // Pending response bytes
+    size_t out_off = 0;           // Bytes of out already sent
+    size_t inflight = 0;          // Frames queued on workers
+    uint32_t events = 0;          // Currently registered epoll events
+    bool eof = false;             // Peer finished sending
+  };
+
+  void add_listener(int fd);
+  void accept_all(int lfd);
+  void on_readable(uint64_t id, uint32_t events);
+  void parse_frames(uint64_t id, Connection& c);
+  bool runs_inline(const FrameHeader& req) const;
+  bool reading(const Connection& c) const;
+  bool flush(uint64_t id, Connection& c);
+  void rearm(uint64_t id, Connection& c);
+  void drain_completions();
+  void close_conn(uint64_t id);
+  void handle(const FrameHeader& req, const char* payload, std::string& out) const;
+
+  std::vector<const FMIndex*> indexes_;
+  std::vector<std::unique_ptr<IntervalCache>> caches_;  // Per slot (empty = off)
+  ServerConfig cfg_;
+  int epfd_ = -1;
+  int wakefd_ = -1;
+  std::vector<int> listeners_;
+  std::vector<std::string> unix_paths_;
+  std::unordered_map<uint64_t, Connection> conns_;
+  uint64_t next_id_ = 0;
+  std::atomic<bool> stopping_{false};
+
+  std::mutex done_mu_;
+  std::vector<std::pair<uint64_t, std::string>> done_;  // (conn id, response bytes)
+
+  // Last, so it is destroyed first: workers use done_mu_, done_ and wakefd_.
+  ThreadPool pool_;
+};
+
+} // namespace cs
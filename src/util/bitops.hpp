@@ -2,7 +2,7 @@
 #include <cstdint>
 #include <cstddef>
 #include <bit>
-#if defined(CS_AVX2) || defined(__SSE4_2__) || defined(__POPCNT__)
+#if defined(CS_AVX2) || defined(__SSE4_2__) || defined(__POPCNT__) || defined(__BMI2__)
   #include <immintrin.h>
 #endif
 #if defined(_MSC_VER)
@@ -25,4 +25,14 @@ inline uint32_t popcount64(uint64_t x) {
   return static_cast<uint32_t>(std::popcount(x));
 #endif
 }
+
+/// Position of the (k+1)-th set bit of x (k < popcount(x)).
+inline uint32_t select64(uint64_t x, uint32_t k) {
+#if defined(__BMI2__)
+  return static_cast<uint32_t>(std::countr_zero(_pdep_u64(1ULL << k, x)));
+#else
+  for (; k > 0; --k) x &= x - 1;
+  return static_cast<uint32_t>(std::countr_zero(x));
+#endif
+}
 } // namespace cs
@@ -0,0 +1,116 @@
+#pragma once
+/**
+ * thread_pool.hpp — Fixed-size worker pool shared by the tools and APIs.
+ *
+ *   submit(fn)            enqueue a task, returns std::future of its result
+ *   parallel_for(n, fn)   run fn(i) for i in [0, n) across all workers and wait
+ *   join()                run every queued task, then stop the workers (idempotent)
+ *
+ * Tasks must not block on other tasks of the same pool.
+ */
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <exception>
+
+namespace cs {
+
+class ThreadPool {
+public:
+  /// threads == 0 picks std::thread::hardware_concurrency().
+  explicit ThreadPool(size_t threads = 0) {
+    if (threads == 0) threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    workers_.reserve(threads);
+    for (size_t t = 0; t < threads; ++t) {
+      workers_.emplace_back([this] { worker_loop(); });
+    }
+  }
+
+  ~ThreadPool() { join(); }
+
+  /// Drains the queue and joins the workers; no task may be submitted afterwards.
+  void join() {
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      stopping_ = true;
+    }
+    cv_.notify_all();
+    for (auto& w : workers_) {
+      if (w.joinable()) w.join();
+    }
+  }
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  size_t size() const { return workers_.size(); }
+
+  template <typename F>
+  auto submit(F&& fn) -> std::future<decltype(fn())> {
+    using R = decltype(fn());
+    auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(fn));
+    std::future<R> fut = task->get_future();
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      tasks_.emplace([task] { (*task)(); });
+    }
+    cv_.notify_one();
+    return fut;
+  }
+
+  /**
+   * parallel_for(n, fn) — fn(i) for every i in [0, n). Indices are handed out
+   * dynamically so uneven work balances; the first exception is rethrown.
+   */
+  template <typename F>
+  void parallel_for(size_t n, F&& fn) {
+    if (n == 0) return;
+    auto next = std::make_shared<std::atomic<size_t>>(0);
+    const size_t lanes = std::min(n, workers_.size());
+    std::vector<std::future<void>> done;
+    done.reserve(lanes);
+    for (size_t l = 0; l < lanes; ++l) {
+      done.push_back(submit([next, n, &fn] {
+        for (size_t i = next->fetch_add(1); i < n; i = next->fetch_add(1)) fn(i);
+      }));
+    }
+    // Wait for every lane before rethrowing: lanes reference fn.
+    std::exception_ptr first;
+    for (auto& f : done) {
+      try { f.get(); } catch (...) { if (!first) first = std::current_exception(); }
+    }
+    if (first) std::rethrow_exception(first);
+  }
+
+private:
+  void worker_loop() {
+    for (;;) {
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> lock(mu_);
+        cv_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+        if (tasks_.empty()) return;  // stopping_ and drained
+        task = std::move(tasks_.front());
+        tasks_.pop();
+      }
+      task();
+    }
+  }
+
+  std::vector<std::thread> workers_;
+  std::queue<std::function<void()>> tasks_;
+  std::mutex mu_;
+  std::condition_variable cv_;
+  bool stopping_ = false;
+};
+
+} // namespace cs
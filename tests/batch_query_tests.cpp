@@ -0,0 +1,149 @@
+/**
+ * batch_query_tests.cpp — Tests for the streaming batch query pipeline.
+ *
+ * Tests:
+ *   1) TSV count output preserves input order across many small chunks.
+ *   2) TSV with locate positions, CRLF input.
+ *   3) Binary format decodes to the same results.
+ *   4) Shared-suffix search matches per-pattern search and saves rank calls.
+ */
+
+#include "../src/api/batch_query.hpp"
+#include <iostream>
+#include <cassert>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace cs;
+
+static std::string make_text() {
+  std::string text;
+  for (int i = 0; i < 200; ++i) text += "alpha beta gamma " + std::to_string(i) + " delta\n";
+  return text;
+}
+
+static std::vector<std::string> make_patterns() {
+  std::vector<std::string> patterns;
+  for (int i = 0; i < 1000; ++i) {
+    switch (i % 5) {
+      case 0: patterns.push_back("alpha"); break;
+      case 1: patterns.push_back(std::to_string(i % 250)); break;
+      case 2: patterns.push_back("gamma " + std::to_string(i % 13)); break;
+      case 3: patterns.push_back("nope"); break;
+      default: patterns.push_back("a"); break;
+    }
+  }
+  return patterns;
+}
+
+static void test_tsv_order() {
+  std::cout << "[batch_query_tests] Test 1: TSV order across chunks\n";
+  FMIndex idx = FMIndex::build_from_text(make_text(), BuildParams());
+  auto patterns = make_patterns();
+  std::string input;
+  for (const auto& p : patterns) input += p + "\n";
+
+  ThreadPool pool(4);
+  BatchQueryOptions opt;
+  opt.chunk_patterns = 7;  // Many chunks, small reorder window
+  opt.window = 3;
+  std::istringstream in(input);
+  std::ostringstream out;
+  [[maybe_unused]] BatchQueryStats stats = run_batch_queries(idx, in, out, pool, opt);
+  assert(stats.patterns == patterns.size());
+  assert(stats.chunks == (patterns.size() + 6) / 7);
+
+  std::istringstream lines(out.str());
+  std::string line;
+  uint64_t total = 0;
+  for (const auto& p : patterns) {
+    assert(std::getline(lines, line));
+    assert(std::stoull(line) == idx.count(p));
+    total += idx.count(p);
+  }
+  assert(!std::getline(lines, line));
+  assert(stats.occurrences == total);
+  std::cout << "  ✓ TSV order passed\n";
+}
+
+static void test_tsv_locate() {
+  std::cout << "[batch_query_tests] Test 2: TSV with locate\n";
+  FMIndex idx = FMIndex::build_from_text("abracadabra", BuildParams());
+  ThreadPool pool(2);
+  BatchQueryOptions opt;
+  opt.locate_limit = 2;
+  opt.chunk_patterns = 1;
+  std::istringstream in("abra\r\nzz\r\na\n");
+  std::ostringstream out;
+  run_batch_queries(idx, in, out, pool, opt);
+  // Limited locate reports the first rows of the SA range, sorted by position.
+  auto pos_a = idx.locate("a", 2);
+  const std::string expect_a = std::to_string(pos_a[0]) + "," + std::to_string(pos_a[1]);
+  assert(out.str() == "2\t0,7\n0\t\n5\t" + expect_a + "\n");
+  std::cout << "  ✓ TSV with locate passed\n";
+}
+
+static void test_binary() {
+  std::cout << "[batch_query_tests] Test 3: Binary format\n";
+  FMIndex idx = FMIndex::build_from_text(make_text(), BuildParams());
+  auto patterns = make_patterns();
+  std::string input;
+  for (const auto& p : patterns) input += p + "\n";
+
+  ThreadPool pool(3);
+  BatchQueryOptions opt;
+  opt.format = BatchFormat::BINARY;
+  opt.locate_limit = 5;
+  opt.chunk_patterns = 64;
+  std::istringstream in(input);
+  std::ostringstream out;
+  run_batch_queries(idx, in, out, pool, opt);
+
+  const std::string bytes = out.str();
+  size_t off = 0;
+  for ([[maybe_unused]] const auto& p : patterns) {
+    uint64_t c;
+    uint32_t n;
+    std::memcpy(&c, bytes.data() + off, 8);
+    std::memcpy(&n, bytes.data() + off + 8, 4);
+    off += 12;
+    std::vector<uint64_t> pos(n);
+    std::memcpy(pos.data(), bytes.data() + off, n * 8);
+    off += n * 8;
+    assert(c == idx.count(p));
+    assert(pos == idx.locate(p, 5));
+  }
+  assert(off == bytes.size());
+  std::cout << "  ✓ Binary format passed\n";
+}
+
+static void test_shared_suffixes() {
+  std::cout << "[batch_query_tests] Test 4: Shared-suffix search\n";
+  FMIndex idx = FMIndex::build_from_text(make_text(), BuildParams());
+  auto patterns = make_patterns();
+  for (const char* p : {"", "lta\n", "elta\n", "delta\n", " delta\n", "xdelta\n", "ta"}) patterns.push_back(p);
+
+  SharedSearchStats st;
+  const auto intervals = search_shared_suffixes(idx, patterns, &st);
+  assert(intervals.size() == patterns.size());
+  for (size_t i = 0; i < patterns.size(); ++i) assert(intervals[i] == idx.interval(patterns[i]));
+  assert(st.rank_calls < st.naive_rank_calls);
+
+  // Nothing shared: exactly one backward search per pattern.
+  SharedSearchStats none;
+  search_shared_suffixes(idx, {"ab", "cd", "zz"}, &none);
+  assert(none.rank_calls == none.naive_rank_calls && none.rank_calls == 2 * (2 + 2 + 1));
+  std::cout << "  ✓ Shared-suffix search passed\n";
+}
+
+int main() {
+  std::cout << "=== Running batch_query_tests ===\n";
+  test_tsv_order();
+  test_tsv_locate();
+  test_binary();
+  test_shared_suffixes();
+  std::cout << "=== All batch_query_tests passed! ===\n";
+  return 0;
+}
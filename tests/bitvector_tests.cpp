@@ -9,6 +9,8 @@
  *   4) Random bitstrings (seeded, compare against naïve reference).
  *   5) Edge cases (rank at 0, rank at size, rank beyond size).
  *   6) Single-bit changes.
+ *   7) select1 on sparse, dense and random bitvectors.
+ *   8) select0 likewise.
  */
 
 #include "../src/core/bitvector.hpp"
@@ -186,6 +188,46 @@ static void test_build_from_words() {
   std::cout << "  PASS\n";
 }
 
+static void test_select1(size_t n, unsigned seed, unsigned one_in) {
+  std::cout << "[TEST] select1 (n=" << n << ", density=1/" << one_in << ")\n";
+  std::mt19937 gen(seed);
+  std::vector<uint8_t> bits(n);
+  for (auto& b : bits) b = gen() % one_in == 0;
+
+  BitVector bv;
+  bv.build(bits);
+  size_t k = 0;
+  for (size_t i = 0; i < n; ++i) {
+    if (!bits[i]) continue;
+    ++k;
+    assert(bv.select1(k) == i);
+  }
+  assert(k == bv.ones());
+  assert(bv.select1(0) == n);
+  assert(bv.select1(k + 1) == n);
+  std::cout << "  PASS\n";
+}
+
+static void test_select0(size_t n, unsigned seed, unsigned zero_in) {
+  std::cout << "[TEST] select0 (n=" << n << ", zero density=1/" << zero_in << ")\n";
+  std::mt19937 gen(seed);
+  std::vector<uint8_t> bits(n);
+  for (auto& b : bits) b = gen() % zero_in != 0;
+
+  BitVector bv;
+  bv.build(bits);
+  size_t k = 0;
+  for (size_t i = 0; i < n; ++i) {
+    if (bits[i]) continue;
+    ++k;
+    assert(bv.select0(k) == i);
+  }
+  assert(k == n - bv.ones());
+  assert(bv.select0(0) == n);
+  assert(bv.select0(k + 1) == n);
+  std::cout << "  PASS\n";
+}
+
 // ──────────────────────────────────────────────────────────────
 // Main test runner
 // ──────────────────────────────────────────────────────────────
@@ -208,6 +250,14 @@ int main() {
   test_random(10000, 7777);
   test_edge_cases();
   test_build_from_words();
+  test_select1(100000, 5, 1);
+  test_select1(100000, 6, 2);
+  test_select1(300000, 7, 97);
+  test_select1(50000, 8, 5000);
+  test_select0(100000, 9, 1);
+  test_select0(100000, 10, 2);
+  test_select0(300000, 11, 97);
+  test_select0(50000, 12, 5000);
 
   std::cout << "========================================\n";
   std::cout << "All BitVector tests PASSED!\n";
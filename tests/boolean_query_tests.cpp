@@ -0,0 +1,133 @@
+/**
+ * boolean_query_tests.cpp — Tests for document-level AND/OR/NOT queries.
+ *
+ * Tests:
+ *   1) Parsing: precedence, implicit AND, quoting, round trip, errors.
+ *   2) Random queries against a per-document scan.
+ *   3) Planner: rarest term seeds the AND, negations never list, empty
+ *      intermediates short-circuit.
+ */
+
+#include "../src/api/boolean_query.hpp"
+#include <iostream>
+#include <cassert>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace cs;
+
+static bool naive_match(const BoolQuery& q, const std::string& doc) {
+  switch (q.op) {
+    case BoolQuery::Op::TERM:
+      return doc.find(q.pattern) != std::string::npos;
+    case BoolQuery::Op::NOT:
+      return !naive_match(q.children[0], doc);
+    case BoolQuery::Op::AND:
+      for (const auto& c : q.children) if (!naive_match(c, doc)) return false;
+      return true;
+    case BoolQuery::Op::OR:
+      for (const auto& c : q.children) if (naive_match(c, doc)) return true;
+      return false;
+  }
+  return false;
+}
+
+[[maybe_unused]] static std::vector<uint32_t> naive_search(const std::vector<std::string>& docs, const BoolQuery& q) {
+  std::vector<uint32_t> out;
+  for (size_t d = 0; d < docs.size(); ++d) {
+    if (naive_match(q, docs[d])) out.push_back(static_cast<uint32_t>(d));
+  }
+  return out;
+}
+
+static FMIndex build(const std::vector<std::string>& docs) {
+  std::vector<std::string_view> views(docs.begin(), docs.end());
+  return FMIndex::build_from_documents(views, BuildParams());
+}
+
+static void test_parse() {
+  std::cout << "[boolean_query_tests] Test 1: Parsing\n";
+  BoolQuery q = BoolQuery::parse("a b OR NOT c AND (\"d e\" OR \"x\\\"y\")");
+  assert(q.op == BoolQuery::Op::OR && q.children.size() == 2);
+  assert(q.children[0].op == BoolQuery::Op::AND);
+  assert(q.children[1].op == BoolQuery::Op::AND);
+  assert(q.children[1].children[0].op == BoolQuery::Op::NOT);
+  assert(q.children[1].children[1].children[1].pattern == "x\"y");
+  assert(q.to_string() == "((\"a\" AND \"b\") OR (NOT \"c\" AND (\"d e\" OR \"x\\\"y\")))");
+  assert(BoolQuery::parse(q.to_string()).to_string() == q.to_string());
+  assert(BoolQuery::parse("\"OR\" ORx").to_string() == "(\"OR\" AND \"ORx\")");
+
+  for (const char* bad : {"", "a AND", "(a", "a)", "\"a", "OR a", "NOT", "\"\""}) {
+    [[maybe_unused]] bool threw = false;
+    try {
+      BoolQuery::parse(bad);
+    } catch (const std::invalid_argument&) {
+      threw = true;
+    }
+    assert(threw);
+  }
+  std::cout << "  ✓ Parsing passed\n";
+}
+
+static void test_random_queries() {
+  std::cout << "[boolean_query_tests] Test 2: Random queries vs scan\n";
+  const std::vector<std::string> words = {"ant", "bee", "cat", "dog", "eel", "fox", "gnu", "zzz"};
+  std::mt19937 rng(5);
+  std::vector<std::string> docs(80);
+  for (auto& d : docs) {
+    for (size_t w = rng() % 6; w > 0; --w) d += words[rng() % 7] + " ";
+  }
+  FMIndex idx = build(docs);
+
+  std::function<BoolQuery(int)> gen = [&](int depth) -> BoolQuery {
+    const unsigned r = rng() % 10;
+    if (depth == 0 || r < 4) return BoolQuery::term(words[rng() % words.size()]);
+    if (r < 6) return BoolQuery::negate(gen(depth - 1));
+    std::vector<BoolQuery> ops;
+    for (size_t k = 2 + rng() % 2; k > 0; --k) ops.push_back(gen(depth - 1));
+    return r < 8 ? BoolQuery::all_of(std::move(ops)) : BoolQuery::any_of(std::move(ops));
+  };
+  for (int i = 0; i < 300; ++i) {
+    const BoolQuery q = gen(3);
+    assert(search_documents(idx, q) == naive_search(docs, q));
+  }
+  // A plain-text index is one document.
+  FMIndex plain = FMIndex::build_from_text("ant bee", BuildParams());
+  assert(search_documents(plain, BoolQuery::parse("ant NOT cat")) == std::vector<uint32_t>{0});
+  assert(search_documents(plain, BoolQuery::parse("ant cat")).empty());
+  std::cout << "  ✓ Random queries passed\n";
+}
+
+static void test_planner() {
+  std::cout << "[boolean_query_tests] Test 3: Planner\n";
+  std::vector<std::string> docs(500, "common words here ");
+  for (size_t d = 250; d < 350; ++d) docs[d] += "banned ";
+  docs[7] += "rare";
+  docs[300] += "rare";
+  FMIndex idx = build(docs);
+
+  BoolQueryStats st;
+  auto hits = search_documents(idx, BoolQuery::parse("common here rare NOT banned"), &st);
+  assert(hits == std::vector<uint32_t>{7});
+  assert(st.lists == 1);           // Only "rare" is listed, never "banned"
+  assert(st.probes <= 2 * 3);      // Two candidates, three filters
+  assert(st.counts == 4);
+
+  st = {};
+  hits = search_documents(idx, BoolQuery::parse("common absent (rare OR words)"), &st);
+  assert(hits.empty());
+  assert(st.short_circuit && st.probes == 0);
+  std::cout << "  ✓ Planner passed\n";
+}
+
+int main() {
+  std::cout << "=== Running boolean_query_tests ===\n";
+  test_parse();
+  test_random_queries();
+  test_planner();
+  std::cout << "=== All boolean_query_tests passed! ===\n";
+  return 0;
+}
@@ -0,0 +1,120 @@
+/**
+ * class_pattern_tests.cpp — Tests for wildcard and character-class search.
+ *
+ * Tests:
+ *   1) Parsing: literals, '?', ranges, negation, escapes, malformed input.
+ *   2) count/locate against a brute-force scan of the text.
+ *   3) Filtered wavelet descents report exactly the allowed symbols.
+ */
+
+#include "../src/api/class_pattern.hpp"
+#include "test_util.hpp"
+#include <iostream>
+#include <cassert>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace cs;
+
+static std::vector<uint64_t> naive_locate(const std::string& text, const ClassPattern& p) {
+  std::vector<uint64_t> out;
+  for (size_t i = 0; i + p.size() <= text.size(); ++i) {
+    size_t k = 0;
+    while (k < p.size() && p.at(k).contains(static_cast<uint8_t>(text[i + k]))) ++k;
+    if (k == p.size()) out.push_back(i);
+  }
+  return out;
+}
+
+static void test_parse() {
+  std::cout << "[class_pattern_tests] Test 1: Parsing\n";
+  const ClassPattern p = ClassPattern::parse("A?[GT][^a-y]\\?[]x]");
+  assert(p.size() == 6 && !p.is_literal());
+  assert(p.at(0).size() == 1 && p.at(0).contains('A'));
+  assert(p.at(1).size() == 256);
+  assert(p.at(2).size() == 2 && p.at(2).contains('G') && p.at(2).contains('T') && !p.at(2).contains('A'));
+  assert(p.at(3).size() == 256 - 25 && p.at(3).contains('z') && !p.at(3).contains('m'));
+  assert(p.at(4).size() == 1 && p.at(4).contains('?'));
+  assert(p.at(5).size() == 2 && p.at(5).contains(']') && p.at(5).contains('x'));
+  assert(ClassPattern::parse("[!0-9]").at(0) == ClassPattern::parse("[^0-9]").at(0));
+  assert(ClassPattern::parse("ACGT").is_literal());
+
+  CharClass cc;
+  cc.add(70);
+  assert(cc.any_in(64, 128) && cc.any_in(70, 71) && !cc.any_in(0, 70) && !cc.any_in(71, 256));
+
+  for (const char* bad : {"AC[GT", "[z-a]", "x\\"}) {
+    [[maybe_unused]] bool threw = false;
+    try {
+      ClassPattern::parse(bad);
+    } catch (const std::invalid_argument&) {
+      threw = true;
+    }
+    assert(threw);
+  }
+  std::cout << "  ✓ Parsing passed\n";
+}
+
+static void test_against_scan() {
+  std::cout << "[class_pattern_tests] Test 2: count/locate vs brute force\n";
+  const std::string text = random_text(5000, std::string("ACGTN") + '\0', 1);
+  FMIndex idx = FMIndex::build_from_text(text, BuildParams());
+  std::mt19937 rng(2);
+  const char* pieces[] = {"?", "[GT]", "[^A]", "[A-C]", "[N\\]]", "[!ACGT]"};
+  for (int t = 0; t < 300; ++t) {
+    // A text substring with a few positions replaced by classes.
+    const size_t len = 1 + rng() % 9, at = rng() % (text.size() - len);
+    std::string pat;
+    for (size_t k = 0; k < len; ++k) {
+      const char c = text[at + k];
+      if (rng() % 3 == 0) pat += pieces[rng() % 6];
+      else if (c == '?' || c == '[' || c == '\\') pat += std::string("\\") + c;
+      else pat += c;
+    }
+    const ClassPattern p = ClassPattern::parse(pat);
+    const auto want = naive_locate(text, p);
+    ClassSearchStats st;
+    uint64_t rows = 0;
+    for (const SAInterval& iv : class_intervals(idx, p, &st)) rows += iv.size();
+    assert(rows == want.size() && count_class(idx, p) == want.size());
+    assert(locate_class(idx, p) == want);
+    assert(st.extends + st.descents > 0);
+  }
+  const ClassPattern any = ClassPattern::parse("??");
+  assert(count_class(idx, any) == text.size() - 1);
+  assert(locate_class(idx, ClassPattern::parse("?????"), 10).size() == 10);
+  assert(count_class(idx, ClassPattern::parse("[xyz]")) == 0);
+  assert(count_class(idx, ClassPattern::parse("")) == idx.size());
+  std::cout << "  ✓ count/locate passed\n";
+}
+
+static void test_filtered_descent() {
+  std::cout << "[class_pattern_tests] Test 3: Filtered extensions\n";
+  const std::string text = random_text(3000, "abcdefgh", 3);
+  FMIndex idx = FMIndex::build_from_text(text, BuildParams());
+  const SAInterval iv = idx.interval("c");
+  std::vector<std::pair<uint8_t, SAInterval>> all, some;
+  idx.for_each_left_extension(iv, [&](uint8_t c, const SAInterval& e) { all.emplace_back(c, e); });
+  CharClass cc;
+  cc.add_range('b', 'e');
+  idx.for_each_left_extension(iv, [&](unsigned lo, unsigned hi) { return cc.any_in(lo, hi); },
+                              [&](uint8_t c, const SAInterval& e) { some.emplace_back(c, e); });
+  std::vector<std::pair<uint8_t, SAInterval>> want;
+  for (const auto& x : all) if (cc.contains(x.first)) want.push_back(x);
+  assert(some == want && want.size() == 4);
+  for ([[maybe_unused]] const auto& [c, e] : some) {
+    assert(e == idx.interval(std::string(1, static_cast<char>(c)) + "c"));
+  }
+  std::cout << "  ✓ Filtered extensions passed\n";
+}
+
+int main() {
+  std::cout << "=== Running class_pattern_tests ===\n";
+  test_parse();
+  test_against_scan();
+  test_filtered_descent();
+  std::cout << "=== All class_pattern_tests passed! ===\n";
+  return 0;
+}
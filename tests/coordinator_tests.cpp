@@ -0,0 +1,322 @@
+/**
+ * coordinator_tests.cpp — Tests for shard persistence and the Coordinator.
+ *
+ * Tests:
+ *   1) ShardedIndex save/load roundtrip through the manifest.
+ *   2) Coordinator over local shard servers matches a single FMIndex
+ *      (one server hosts two shards in different slots).
+ *   3) Unresponsive and unreachable shards yield partial results in time.
+ *   4) Connects that never complete and sends that never drain stay
+ *      within the deadline.
+ *   5) Case-folded shards: tail overlaps are folded like the shards fold.
+ */
+
+#include "../src/server/coordinator.hpp"
+#include "../src/server/server.hpp"
+#include "test_util.hpp"
+#include <iostream>
+#include <cassert>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace cs;
+
+static std::string tmp_path(const std::string& name) {
+  return "/tmp/cs_coord_test_" + std::to_string(::getpid()) + "_" + name;
+}
+
+static std::string make_text() { return random_text(6000, "acgt", 3); }
+
+static std::vector<std::string> make_patterns(const std::string& text, size_t max_len) {
+  std::mt19937 rng(5);
+  std::vector<std::string> patterns = {"", "acgtacgtacgtacgtacgtacgt"};
+  for (int i = 0; i < 150; ++i) {
+    const size_t len = 1 + rng() % max_len;
+    patterns.push_back(text.substr(rng() % (text.size() - len), len));
+  }
+  return patterns;
+}
+
+// Servers bound to Unix sockets, each running on its own thread.
+struct LocalWorkers {
+  std::vector<std::unique_ptr<QueryServer>> servers;
+  std::vector<std::thread> loops;
+
+  std::string start(std::vector<const FMIndex*> slots, const std::string& name) {
+    ServerConfig cfg;
+    cfg.threads = 2;
+    servers.push_back(std::make_unique<QueryServer>(std::move(slots), cfg));
+    const std::string path = tmp_path(name);
+    servers.back()->listen_unix(path);
+    loops.emplace_back([s = servers.back().get()] { s->run(); });
+    return "unix:" + path;
+  }
+
+  ~LocalWorkers() {
+    for (auto& s : servers) s->stop();
+    for (auto& l : loops) l.join();
+  }
+};
+
+static void test_save_load() {
+  std::cout << "[coordinator_tests] Test 1: ShardedIndex save/load\n";
+  const std::string text = make_text();
+  ThreadPool pool(3);
+  ShardParams p;
+  p.num_shards = 3;
+  p.max_pattern_len = 10;
+  ShardedIndex si = ShardedIndex::build(text, p, pool);
+  const std::string dir = tmp_path("shards");
+  si.save(dir);
+
+  ShardedIndex back = ShardedIndex::load(dir, pool);
+  assert(back.num_shards() == 3 && back.size() == text.size());
+  assert(back.max_pattern_len() == 10);
+  for (const auto& pat : make_patterns(text, 10)) {
+    if (pat.empty() || pat.size() > 10) continue;
+    assert(back.count(pat, pool) == si.count(pat, pool));
+    assert(back.locate(pat, pool) == si.locate(pat, pool));
+  }
+  const ShardManifest m = ShardManifest::read(dir + "/shards.manifest");
+  assert(m.shards.size() == 3 && m.shards[1].start == si.shard_start(1));
+  assert(m.shards[2].tail_len == 0 && m.shards[0].tail_len == 9);
+  std::filesystem::remove_all(dir);
+  std::cout << "  ✓ save/load passed\n";
+}
+
+static void test_matches_single_index() {
+  std::cout << "[coordinator_tests] Test 2: Coordinator matches single index\n";
+  const std::string text = make_text();
+  FMIndex ref = FMIndex::build_from_text(text, BuildParams());
+  ThreadPool pool(2);
+  ShardParams p;
+  p.num_shards = 3;
+  p.max_pattern_len = 24;
+  ShardedIndex si = ShardedIndex::build(text, p, pool);
+
+  LocalWorkers workers;
+  const std::string a = workers.start({&si.shard(0)}, "a.sock");
+  const std::string b = workers.start({&si.shard(1), &si.shard(2)}, "b.sock");
+  auto eps = Coordinator::endpoints(si.manifest(), {a, b, b});
+  eps[2].slot = 1;
+  CoordinatorConfig cfg;
+  cfg.max_pattern_len = si.max_pattern_len();
+  Coordinator coord(eps, cfg);
+
+  const auto patterns = make_patterns(text, 24);
+  for (int round = 0; round < 2; ++round) {  // Second round reuses connections
+    auto counts = coord.count(patterns);
+    assert(!counts.partial());
+    auto locs = coord.locate(patterns, 5);
+    assert(!locs.partial());
+    for (size_t k = 0; k < patterns.size(); ++k) {
+      if (patterns[k].empty()) {
+        assert(counts.counts[k] == text.size());
+        continue;
+      }
+      assert(counts.counts[k] == ref.count(patterns[k]));
+      assert(locs.replies[k].total == counts.counts[k]);
+      // Shards return their smallest positions and tail hits sort last, so
+      // every limited reply is still full and the merge is exact.
+      assert(locs.replies[k].positions == ref.locate_smallest(patterns[k], 5));
+      for ([[maybe_unused]] uint64_t pos : locs.replies[k].positions) {
+        assert(text.compare(pos, patterns[k].size(), patterns[k]) == 0);
+      }
+    }
+  }
+
+  [[maybe_unused]] bool threw = false;
+  try {
+    coord.count({std::string(25, 'a')});
+  } catch (const std::invalid_argument&) {
+    threw = true;
+  }
+  assert(threw);
+  std::cout << "  ✓ Coordinator matches single index passed\n";
+}
+
+static void test_partial_results() {
+  std::cout << "[coordinator_tests] Test 3: Partial results on timeout\n";
+  const std::string text = make_text();
+  ThreadPool pool(2);
+  ShardParams p;
+  p.num_shards = 3;
+  p.max_pattern_len = 8;
+  ShardedIndex si = ShardedIndex::build(text, p, pool);
+
+  // Shard 1 "hangs": the socket accepts connections but never answers.
+  const std::string hung_path = tmp_path("hung.sock");
+  ::unlink(hung_path.c_str());
+  const int hung = socket(AF_UNIX, SOCK_STREAM, 0);
+  sockaddr_un addr{};
+  addr.sun_family = AF_UNIX;
+  std::strcpy(addr.sun_path, hung_path.c_str());
+  [[maybe_unused]] int rc = bind(hung, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+  assert(rc == 0);
+  rc = listen(hung, 8);
+  assert(rc == 0);
+
+  LocalWorkers workers;
+  const std::string a = workers.start({&si.shard(0)}, "p0.sock");
+  auto eps = Coordinator::endpoints(si.manifest(),
+                                    {a, "unix:" + hung_path, "unix:" + tmp_path("nobody.sock")});
+  CoordinatorConfig cfg;
+  cfg.timeout_ms = 150;
+  Coordinator coord(eps, cfg);
+
+  const std::vector<std::string> patterns = {"acg", "tt"};
+  const auto t0 = std::chrono::steady_clock::now();
+  auto counts = coord.count(patterns);
+  [[maybe_unused]] const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - t0).count();
+  assert(counts.partial());
+  assert((counts.missing == std::vector<size_t>{1, 2}));
+  assert(ms < 1000);
+
+  // Only shard 0 answered: its owned range is [0, shard_start(1)).
+  const uint64_t owned_end = si.shard_start(1);
+  for (size_t k = 0; k < patterns.size(); ++k) {
+    uint64_t expect = 0;
+    for (uint64_t pos : si.locate(patterns[k], pool)) expect += pos < owned_end;
+    assert(counts.counts[k] == expect);
+  }
+
+  auto locs = coord.locate(patterns, 3);
+  assert((locs.missing == std::vector<size_t>{1, 2}));
+  for (const auto& rep : locs.replies) {
+    for ([[maybe_unused]] uint64_t pos : rep.positions) assert(pos < owned_end);
+  }
+
+  ::close(hung);
+  ::unlink(hung_path.c_str());
+  std::cout << "  ✓ Partial results passed\n";
+}
+
+static void test_deadline_covers_connect_and_send() {
+  std::cout << "[coordinator_tests] Test 4: Deadline covers connect and send\n";
+  // A TCP listener that never accepts: once its backlog is full the kernel
+  // drops further SYNs, so a connect stays pending.
+  const int full = socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in in{};
+  in.sin_family = AF_INET;
+  in.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  [[maybe_unused]] int rc = bind(full, reinterpret_cast<sockaddr*>(&in), sizeof(in));
+  assert(rc == 0);
+  rc = listen(full, 0);
+  assert(rc == 0);
+  socklen_t in_len = sizeof(in);
+  getsockname(full, reinterpret_cast<sockaddr*>(&in), &in_len);
+  std::vector<int> fillers;
+  for (int i = 0; i < 8; ++i) {
+    const int f = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    connect(f, reinterpret_cast<sockaddr*>(&in), sizeof(in));
+    fillers.push_back(f);
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+  // A Unix listener that never reads: a large batch fills the socket buffer.
+  const std::string path = tmp_path("noread.sock");
+  ::unlink(path.c_str());
+  const int noread = socket(AF_UNIX, SOCK_STREAM, 0);
+  sockaddr_un un{};
+  un.sun_family = AF_UNIX;
+  std::strcpy(un.sun_path, path.c_str());
+  rc = bind(noread, reinterpret_cast<sockaddr*>(&un), sizeof(un));
+  assert(rc == 0);
+  rc = listen(noread, 8);
+  assert(rc == 0);
+
+  const std::string tcp = "127.0.0.1:" + std::to_string(ntohs(in.sin_port));
+  for (const std::string& address : {tcp, "unix:" + path}) {
+    CoordinatorConfig cfg;
+    cfg.timeout_ms = 200;
+    Coordinator coord({ShardEndpoint{address, 0, 0, 1000, 0}}, cfg);
+    const std::vector<std::string> patterns(64, std::string(256 << 10, 'a'));  // 16 MiB
+    const auto t0 = std::chrono::steady_clock::now();
+    const auto counts = coord.count(patterns);
+    [[maybe_unused]] const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - t0).count();
+    assert((counts.missing == std::vector<size_t>{0}));
+    assert(ms < 600);
+  }
+
+  for (int f : fillers) ::close(f);
+  ::close(full);
+  ::close(noread);
+  ::unlink(path.c_str());
+  std::cout << "  ✓ Deadline covers connect and send passed\n";
+}
+
+static void test_folded_shards() {
+  std::cout << "[coordinator_tests] Test 5: Folded shards\n";
+  const std::string text = random_text(6000, "acgtACGT", 11);
+  BuildParams bp;
+  bp.fold = ascii_case_fold();
+  FMIndex ref = FMIndex::build_from_text(text, bp);
+  ThreadPool pool(2);
+  ShardParams p;
+  p.num_shards = 3;
+  p.max_pattern_len = 8;
+  p.build = bp;
+  ShardedIndex si = ShardedIndex::build(text, p, pool);
+
+  LocalWorkers workers;
+  const std::string a = workers.start({&si.shard(0), &si.shard(1), &si.shard(2)}, "fold.sock");
+  auto eps = Coordinator::endpoints(si.manifest(), {a, a, a});
+  eps[1].slot = 1;
+  eps[2].slot = 2;
+  CoordinatorConfig cfg;
+  cfg.max_pattern_len = si.max_pattern_len();
+  Coordinator coord(eps, cfg);
+
+  // Patterns in the opposite case of the text at every shard cut, so each
+  // one matches inside the tail only after folding both sides.
+  std::vector<std::string> patterns = {"a", "ACg", "tTaA"};
+  for (size_t i = 1; i < si.num_shards(); ++i) {
+    const uint64_t cut = si.shard_start(i);
+    for (uint64_t back = 1; back < 4; ++back) {
+      std::string pat = text.substr(cut - back, 6);
+      for (auto& ch : pat) {
+        ch = static_cast<char>(std::isupper(static_cast<unsigned char>(ch)) ? std::tolower(ch)
+                                                                           : std::toupper(ch));
+      }
+      patterns.push_back(pat);
+    }
+  }
+  for (int round = 0; round < 2; ++round) {
+    auto counts = coord.count(patterns);
+    auto locs = coord.locate(patterns, 4);
+    assert(!counts.partial() && !locs.partial());
+    for (size_t k = 0; k < patterns.size(); ++k) {
+      assert(counts.counts[k] == ref.count(patterns[k]));
+      assert(counts.counts[k] == si.count(patterns[k], pool));
+      assert(locs.replies[k].total == counts.counts[k]);
+      assert(locs.replies[k].positions == ref.locate_smallest(patterns[k], 4));
+    }
+  }
+  std::cout << "  ✓ Folded shards passed\n";
+}
+
+int main() {
+  std::cout << "=== Running coordinator_tests ===\n";
+  test_save_load();
+  test_matches_single_index();
+  test_partial_results();
+  test_deadline_covers_connect_and_send();
+  test_folded_shards();
+  std::cout << "=== All coordinator_tests passed! ===\n";
+  return 0;
+}
@@ -0,0 +1,102 @@
+/**
+ * dna_tests.cpp — Tests for both-strand DNA search.
+ *
+ * Tests:
+ *   1) Reverse complement.
+ *   2) One search vs two plain searches, over several sequences.
+ *   3) Palindromes, save/load, rejected indexes.
+ */
+
+#include "../src/api/dna.hpp"
+#include "test_util.hpp"
+#include <iostream>
+#include <cassert>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace cs;
+
+// The two-search answer: hits of P, and of revcomp(P) marked MINUS.
+static std::vector<StrandHit> naive(const std::vector<std::string>& seqs, const std::string& p) {
+  std::vector<StrandHit> out;
+  const std::string rc = reverse_complement(p);
+  for (uint32_t s = 0; s < seqs.size(); ++s) {
+    for (size_t i = 0; i + p.size() <= seqs[s].size(); ++i) {
+      if (seqs[s].compare(i, p.size(), p) == 0) out.push_back({s, i, Strand::PLUS});
+      if (seqs[s].compare(i, rc.size(), rc) == 0) out.push_back({s, i, Strand::MINUS});
+    }
+  }
+  return out;
+}
+
+static void test_reverse_complement() {
+  std::cout << "[dna_tests] Test 1: Reverse complement\n";
+  assert(reverse_complement("AACGTN") == "NACGTT");
+  assert(reverse_complement("acgT") == "Acgt");
+  assert(reverse_complement("") == "");
+  const std::string s = random_text(500, "ACGT", 1);
+  assert(reverse_complement(reverse_complement(s)) == s);
+  std::cout << "  ✓ Reverse complement passed\n";
+}
+
+static void test_both_strands() {
+  std::cout << "[dna_tests] Test 2: One search vs two\n";
+  const std::vector<std::string> seqs = {random_text(3000, "ACGT", 2), random_text(50, "ACGT", 3),
+                                         random_text(2000, "ACGT", 4)};
+  const std::vector<std::string_view> views(seqs.begin(), seqs.end());
+  const FMIndex idx = build_both_strands(views, BuildParams());
+  const FMIndex plain = FMIndex::build_from_documents(views, BuildParams());
+  assert(strand_sequences(idx) == 3);
+
+  std::mt19937 rng(5);
+  for (int t = 0; t < 300; ++t) {
+    const std::string& s = seqs[rng() % 3];
+    std::string p = s.substr(rng() % (s.size() - 12), 1 + rng() % 12);
+    if (t % 2) p = reverse_complement(p);
+    const auto want = naive(seqs, p);
+    assert(idx.count(p) == plain.count(p) + plain.count(reverse_complement(p)));
+    assert(idx.count(p) == want.size());
+    assert(locate_both_strands(idx, p) == want);
+  }
+  assert(locate_both_strands(idx, "").empty());
+  assert(locate_both_strands(idx, "ACGT", 0).empty());
+  std::cout << "  ✓ One search vs two passed\n";
+}
+
+static void test_palindromes_and_persistence() {
+  std::cout << "[dna_tests] Test 3: Palindromes, save/load, rejected indexes\n";
+  const std::string seq = random_text(4000, "ACGT", 6) + "GAATTC";  // EcoRI site, its own reverse complement
+  const FMIndex idx = build_both_strands(seq, BuildParams());
+  const auto hits = locate_both_strands(idx, "GAATTC");
+  assert(hits == naive({seq}, "GAATTC") && hits.size() % 2 == 0);
+  assert(hits[hits.size() - 2] == (StrandHit{0, 4000, Strand::PLUS}) && hits.back().strand == Strand::MINUS);
+
+  const std::string path = "dna_tests.csidx";
+  idx.save(path);
+  const FMIndex back = FMIndex::load(path);
+  std::remove(path.c_str());
+  assert(locate_both_strands(back, "GAATTC") == hits);
+
+  for (const auto& bad : {FMIndex::build_from_text(seq, BuildParams()),
+                          FMIndex::build_from_documents(std::vector<std::string_view>{"ACGT", "AC"}, BuildParams())}) {
+    [[maybe_unused]] bool threw = false;
+    try {
+      locate_both_strands(bad, "AC");
+    } catch (const std::invalid_argument&) {
+      threw = true;
+    }
+    assert(threw);
+  }
+  std::cout << "  ✓ Palindromes and persistence passed\n";
+}
+
+int main() {
+  std::cout << "=== Running dna_tests ===\n";
+  test_reverse_complement();
+  test_both_strands();
+  test_palindromes_and_persistence();
+  std::cout << "=== All dna_tests passed! ===\n";
+  return 0;
+}
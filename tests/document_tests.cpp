@@ -0,0 +1,128 @@
+/**
+ * document_tests.cpp — Tests for multi-document collections.
+ *
+ * Tests:
+ *   1) locate_documents matches a per-document scan (empty docs included).
+ *   2) A document containing the separator is rejected.
+ *   3) Documents survive save/load.
+ *   4) list_documents / doc_frequency / top_k_documents against a scan.
+ */
+
+#include "../src/api/fm_index.hpp"
+#include <iostream>
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace cs;
+
+static std::vector<std::string> make_docs() {
+  return {"the cat sat", "", "on the mat", "the", "cat the cat", "", "at", ""};
+}
+
+static std::vector<DocHit> naive_hits(const std::vector<std::string>& docs, std::string_view p) {
+  std::vector<DocHit> hits;
+  for (size_t d = 0; d < docs.size(); ++d) {
+    for (size_t at = docs[d].find(p); at != std::string::npos; at = docs[d].find(p, at + 1)) {
+      hits.push_back({static_cast<uint32_t>(d), at});
+    }
+  }
+  return hits;
+}
+
+static FMIndex build(const std::vector<std::string>& docs) {
+  std::vector<std::string_view> views(docs.begin(), docs.end());
+  return FMIndex::build_from_documents(views, BuildParams());
+}
+
+static void test_locate_documents() {
+  std::cout << "[document_tests] Test 1: locate_documents\n";
+  const auto docs = make_docs();
+  FMIndex idx = build(docs);
+  assert(idx.num_documents() == docs.size());
+  for (size_t d = 0; d < docs.size(); ++d) {
+    assert(idx.document_length(d) == docs[d].size());
+    assert(idx.extract(idx.document_start(d), idx.document_length(d)) == docs[d]);
+  }
+  for ([[maybe_unused]] const char* p : {"the", "cat", "at", "t", "mat", "dog", "the cat"}) {
+    assert(idx.locate_documents(p) == naive_hits(docs, p));
+  }
+  // A plain-text index is a single document.
+  FMIndex plain = FMIndex::build_from_text("abcabc", BuildParams());
+  assert(plain.num_documents() == 1);
+  assert((plain.to_document(4) == DocHit{0, 4}));
+  std::cout << "  ✓ locate_documents passed\n";
+}
+
+static void test_separator_rejected() {
+  std::cout << "[document_tests] Test 2: Separator inside a document\n";
+  [[maybe_unused]] bool threw = false;
+  try {
+    build({"fine", std::string("bad\x1e") + "doc"});
+  } catch (const std::invalid_argument&) {
+    threw = true;
+  }
+  assert(threw);
+  std::cout << "  ✓ Separator rejected\n";
+}
+
+static void test_save_load() {
+  std::cout << "[document_tests] Test 3: save/load\n";
+  const auto docs = make_docs();
+  FMIndex idx = build(docs);
+  const std::string path = "document_tests.csidx";
+  idx.save(path);
+  FMIndex back = FMIndex::load(path);
+  std::remove(path.c_str());
+  assert(back.num_documents() == docs.size());
+  for (size_t d = 0; d < docs.size(); ++d) assert(back.document_start(d) == idx.document_start(d));
+  assert(back.locate_documents("cat") == naive_hits(docs, "cat"));
+  assert(back.doc_frequency("the") == idx.doc_frequency("the"));
+  std::cout << "  ✓ save/load passed\n";
+}
+
+static void test_document_listing() {
+  std::cout << "[document_tests] Test 4: Document listing and frequencies\n";
+  std::vector<std::string> docs;
+  for (int d = 0; d < 60; ++d) {
+    std::string doc;
+    for (int w = 0; w < 1 + d % 9; ++w) doc += (w + d) % 4 == 0 ? "apple " : (w % 3 ? "pear " : "fig ");
+    docs.push_back(doc);
+  }
+  FMIndex idx = build(docs);
+
+  for (const char* p : {"apple", "pear", "fig", "e", "ap", "kiwi"}) {
+    std::vector<DocFreq> expect;
+    for (const auto& h : naive_hits(docs, p)) {
+      if (expect.empty() || expect.back().doc != h.doc) expect.push_back({h.doc, 0});
+      ++expect.back().freq;
+    }
+    assert(idx.doc_frequency(p) == expect);
+
+    std::vector<uint32_t> ids;
+    for (const auto& e : expect) ids.push_back(e.doc);
+    assert(idx.list_documents(p) == ids);
+    if (ids.size() > 5) ids.resize(5);
+    assert(idx.list_documents(p, 5) == ids);
+
+    std::stable_sort(expect.begin(), expect.end(),
+                     [](const DocFreq& a, const DocFreq& b) { return a.freq > b.freq; });
+    if (expect.size() > 4) expect.resize(4);
+    assert(idx.top_k_documents(p, 4) == expect);
+  }
+  std::cout << "  ✓ Document listing passed\n";
+}
+
+int main() {
+  std::cout << "=== Running document_tests ===\n";
+  test_locate_documents();
+  test_separator_rejected();
+  test_save_load();
+  test_document_listing();
+  std::cout << "=== All document_tests passed! ===\n";
+  return 0;
+}
@@ -0,0 +1,172 @@
+/**
+ * extract_sink_tests.cpp — Tests for FMIndex::extract_to and its sinks.
+ *
+ * Tests:
+ *   1) extract_to agrees with extract (plain and packed, across chunks).
+ *   2) Batches: position order and placements; StreamSink.
+ *   3) FdSink: gathered writes to a file, large pieces, write errors.
+ */
+
+#include "../src/api/fm_index.hpp"
+#include <iostream>
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace cs;
+
+// ACGT with N runs, so the packed index has exception runs to decode.
+static std::string make_dna(size_t n, unsigned seed) {
+  std::mt19937 rng(seed);
+  std::string t(n, 'A');
+  for (size_t i = 0; i < n; ++i) {
+    t[i] = rng() % 500 == 0 ? 'N' : "ACGT"[rng() % 4];
+  }
+  return t;
+}
+
+static FMIndex build(const std::string& text, bool packed) {
+  BuildParams p;
+  p.pack_dna = packed;
+  return FMIndex::build_from_text(text, p);
+}
+
+static void test_extract_to() {
+  std::cout << "[extract_sink_tests] Test 1: extract_to vs extract\n";
+  const std::string text = make_dna(3 * EXTRACT_CHUNK + 1234, 1);
+  for (bool packed : {false, true}) {
+    const FMIndex idx = build(text, packed);
+    std::vector<char> out(text.size());
+    const std::vector<std::pair<uint64_t, uint64_t>> cases = {
+      {0, text.size()}, {0, 0}, {5, 100}, {EXTRACT_CHUNK - 7, 2 * EXTRACT_CHUNK + 20},
+      {text.size() - 10, 500}, {text.size(), 5}, {text.size() + 3, 5}};
+    for (const auto& [pos, len] : cases) {
+      BufferSink sink(out.data(), out.size());
+      [[maybe_unused]] const uint64_t got = idx.extract_to(pos, len, sink);
+      const std::string want = idx.extract(pos, len);
+      assert(got == want.size() && sink.size() == got);
+      assert(std::string(out.data(), got) == want);
+    }
+    BufferSink small(out.data(), 10);
+    [[maybe_unused]] bool threw = false;
+    try {
+      idx.extract_to(0, 11, small);
+    } catch (const std::out_of_range&) {
+      threw = true;
+    }
+    assert(threw);
+  }
+  std::cout << "  ✓ extract_to passed\n";
+}
+
+static void test_batch() {
+  std::cout << "[extract_sink_tests] Test 2: Batched ranges\n";
+  const std::string text = make_dna(200000, 2);
+  std::mt19937 rng(3);
+  std::vector<ExtractRange> ranges(500);
+  for (auto& r : ranges) r = {rng() % (text.size() + 50), rng() % 300};
+  ranges.push_back({0, 0});
+  for (bool packed : {false, true}) {
+    const FMIndex idx = build(text, packed);
+    std::ostringstream os;
+    StreamSink sink(os);
+    const auto placed = idx.extract_to(ranges, sink);
+    sink.flush();
+    const std::string all = os.str();
+    assert(placed.size() == ranges.size());
+
+    uint64_t total = 0;
+    [[maybe_unused]] uint64_t last_pos = 0, last_offset = 0;
+    for (size_t i = 0; i < ranges.size(); ++i) {
+      const std::string want = idx.extract(ranges[i].pos, ranges[i].len);
+      assert(placed[i].len == want.size() && all.substr(placed[i].offset, placed[i].len) == want);
+      total += want.size();
+    }
+    assert(all.size() == total);
+    // Output follows text position.
+    std::vector<size_t> by_offset(ranges.size());
+    for (size_t i = 0; i < ranges.size(); ++i) by_offset[i] = i;
+    std::sort(by_offset.begin(), by_offset.end(), [&](size_t a, size_t b) {
+      return placed[a].offset != placed[b].offset ? placed[a].offset < placed[b].offset : ranges[a].pos < ranges[b].pos;
+    });
+    for (size_t i : by_offset) {
+      if (placed[i].len == 0) continue;
+      assert(ranges[i].pos >= last_pos && placed[i].offset >= last_offset);
+      last_pos = ranges[i].pos;
+      last_offset = placed[i].offset;
+    }
+  }
+  std::cout << "  ✓ Batched ranges passed\n";
+}
+
+[[maybe_unused]] static std::string read_file(const char* path) {
+  std::FILE* f = std::fopen(path, "rb");
+  assert(f);
+  std::string s;
+  char buf[4096];
+  for (size_t got; (got = std::fread(buf, 1, sizeof(buf), f)) > 0;) s.append(buf, got);
+  std::fclose(f);
+  return s;
+}
+
+static void test_fd_sink() {
+  std::cout << "[extract_sink_tests] Test 3: FdSink\n";
+  const std::string text = make_dna(300000, 4);
+  const char* path = "extract_sink_tests.out";
+  std::mt19937 rng(5);
+  std::vector<ExtractRange> ranges(2000);
+  for (auto& r : ranges) r = {rng() % text.size(), 1 + rng() % 100};
+
+  for (bool packed : {false, true}) {
+    const FMIndex idx = build(text, packed);
+    std::string want;
+    std::FILE* f = std::fopen(path, "wb");
+    assert(f);
+    {
+      FdSink sink(fileno(f), 4096);
+      const auto placed = idx.extract_to(ranges, sink);
+      // A piece larger than the staging buffer, then the whole text.
+      idx.extract_to(1000, 3 * EXTRACT_CHUNK, sink);
+      idx.extract_to(0, text.size(), sink);
+      sink.flush();
+      std::vector<std::string> parts(ranges.size());
+      for (size_t i = 0; i < ranges.size(); ++i) parts[i] = idx.extract(ranges[i].pos, ranges[i].len);
+      std::vector<size_t> order(ranges.size());
+      for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+      std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return placed[a].offset < placed[b].offset; });
+      for (size_t i : order) want += parts[i];
+      want += text.substr(1000, 3 * EXTRACT_CHUNK) + text;
+      assert(sink.bytes_written() == want.size());
+      // Gathered: far fewer syscalls than pieces.
+      assert(sink.syscalls() < ranges.size() / 10);
+    }
+    std::fclose(f);
+    assert(read_file(path) == want);
+  }
+  std::remove(path);
+
+  FdSink bad(-1);
+  bad.write("abc", 3);
+  [[maybe_unused]] bool threw = false;
+  try {
+    bad.flush();
+  } catch (const std::runtime_error&) {
+    threw = true;
+  }
+  assert(threw);
+  std::cout << "  ✓ FdSink passed\n";
+}
+
+int main() {
+  std::cout << "=== Running extract_sink_tests ===\n";
+  test_extract_to();
+  test_batch();
+  test_fd_sink();
+  std::cout << "=== All extract_sink_tests passed! ===\n";
+  return 0;
+}
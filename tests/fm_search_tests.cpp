@@ -8,6 +8,8 @@
  *   4) Multiple matches.
  *   5) Overlapping matches.
  *   6) Random text with known patterns.
+ *   7) SA intervals: incremental extend_left and locate(interval).
+ *   8) extract_forward / extract_backward from the index alone.
  */
 
 #include "../src/api/fm_index.hpp"
@@ -176,11 +178,11 @@ static void test_full_alphabet() {
   std::cout << "[TEST] Full byte alphabet\n";
   
   std::string text;
-  // Use bytes 1-255 (skip 0 to reserve for potential terminator).
+  // Use bytes 1-255 (skip 0 to reserve for potential terminator). No explicit
+  // '$' here: it would occur twice, and the index adds its own terminator.
   for (int i = 1; i < 256; ++i) {
     text += static_cast<char>(i);
   }
-  text += '$';  // Add terminator.
   
   BuildParams params;
   FMIndex idx = FMIndex::build_from_text(text, params);
@@ -277,6 +279,76 @@ static void test_single_char() {
   std::cout << "  PASS\n";
 }
 
+static void test_intervals() {
+  std::cout << "[TEST] SA intervals\n";
+
+  std::string text = "mississippi missing misfits";
+  FMIndex idx = FMIndex::build_from_text(text, BuildParams());
+
+  SAInterval full = idx.full_interval();
+  assert(full.size() == text.size() + 1 && full.len == 0);
+  assert(idx.locate(full).empty());
+
+  // Grow "ssi" one symbol at a time, then reuse the cached "si" interval.
+  SAInterval i = idx.extend_left(full, 'i');
+  SAInterval si = idx.extend_left(i, 's');
+  assert(si == idx.interval("si") && si.len == 2);
+  [[maybe_unused]] SAInterval ssi = idx.extend_left(si, 's');
+  assert(ssi.size() == naive_count(text, "ssi"));
+  assert(idx.locate(ssi) == naive_locate(text, "ssi"));
+  assert(idx.extend_left(si, "mi").size() == naive_count(text, "misi"));
+  assert(idx.extend_left(si, "is") == idx.interval("issi"));
+
+  // Empty intervals stay empty and keep counting length.
+  [[maybe_unused]] SAInterval none = idx.extend_left(si, 'z');
+  assert(none.empty() && none.size() == 0 && none.len == 3);
+  assert(idx.extend_left(none, "ab").len == 5 && idx.locate(none).empty());
+
+  for (const char* p : {"m", "mis", "ss", "ing", "its", "q"}) {
+    const SAInterval iv = idx.interval(p);
+    assert(iv.size() == idx.count(p));
+    assert(idx.locate(iv, 2) == idx.locate(p, 2));
+    // locate keeps the first rows; locate_smallest the smallest positions.
+    const auto all = naive_locate(text, p);
+    for (size_t k = 0; k <= all.size(); ++k) {
+      const auto first = idx.locate(iv, k);
+      assert(first.size() == k && std::includes(all.begin(), all.end(), first.begin(), first.end()));
+      assert(idx.locate_smallest(iv, k) == std::vector<uint64_t>(all.begin(), all.begin() + k));
+    }
+  }
+
+  std::cout << "  PASS\n";
+}
+
+static void test_extract_walks() {
+  std::cout << "[TEST] extract_forward / extract_backward\n";
+
+  std::string text;
+  for (int i = 0; i < 3000; ++i) text += static_cast<char>(i % 7 == 0 ? i * 31 % 256 : 'a' + i * i % 5);
+  text[100] = '\0';
+  for (const bool packed : {false, true}) {
+    BuildParams p;
+    p.ssa_stride = 16;
+    p.pack_dna = packed;
+    const FMIndex idx = FMIndex::build_from_text(text, p);
+    for (uint64_t row = 0; row <= text.size(); row += 7) {
+      assert(idx.sa_at(idx.psi(row)) == (idx.sa_at(row) + 1) % (text.size() + 1));
+    }
+    for (uint64_t pos : {0, 1, 15, 16, 17, 99, 100, 2990, 2999}) {
+      for (uint64_t len : {0, 1, 5, 40, 100}) {
+        const std::string want = text.substr(pos, len);
+        assert(idx.extract_forward(pos, len) == want);
+        assert(idx.extract_backward(pos, len) == want);
+      }
+    }
+    [[maybe_unused]] char buf[64];
+    assert(idx.extract_forward(2990, 64, buf) == 10 && std::string(buf, 10) == text.substr(2990));
+    assert(idx.extract_forward(text.size(), 5).empty() && idx.extract_backward(text.size(), 5).empty());
+  }
+
+  std::cout << "  PASS\n";
+}
+
 // ──────────────────────────────────────────────────────────────
 // Main test runner
 // ──────────────────────────────────────────────────────────────
@@ -295,6 +367,8 @@ int main() {
   test_long_text();
   test_repeated_pattern();
   test_single_char();
+  test_intervals();
+  test_extract_walks();
 
   std::cout << "========================================\n";
   std::cout << "All FM-Index search tests PASSED!\n";
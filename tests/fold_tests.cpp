@@ -0,0 +1,162 @@
+/**
+ * fold_tests.cpp — Tests for build-time alphabet folding.
+ *
+ * Tests:
+ *   1) Case-insensitive count/locate, exact-case locate, original extract.
+ *   2) Save/load, bidirectional search, and the pattern engines.
+ *   3) Fold tables, documents, sharded indexes.
+ *   4) Negated classes fold before they negate ([^a] also leaves out 'A').
+ */
+
+#include "../src/api/class_pattern.hpp"
+#include "../src/api/proximity.hpp"
+#include "../src/api/regex.hpp"
+#include "../src/api/sharded_index.hpp"
+#include "test_util.hpp"
+#include <iostream>
+#include <algorithm>
+#include <cassert>
+#include <cctype>
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace cs;
+
+static std::string lower(std::string s) {
+  for (auto& c : s) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+  return s;
+}
+
+[[maybe_unused]] static std::vector<uint64_t> naive_locate(const std::string& text, const std::string& p) {
+  std::vector<uint64_t> out;
+  for (size_t i = text.find(p); i != std::string::npos; i = text.find(p, i + 1)) out.push_back(i);
+  return out;
+}
+
+static BuildParams folding() {
+  BuildParams p;
+  p.fold = ascii_case_fold();
+  return p;
+}
+
+static void test_case_insensitive() {
+  std::cout << "[fold_tests] Test 1: Case-insensitive search\n";
+  const std::string text = random_text(4000, "abcABC .", 1);
+  const std::string low = lower(text);
+  FMIndex idx = FMIndex::build_from_text(text, folding());
+  FMIndex plain = FMIndex::build_from_text(low, BuildParams());
+  assert(idx.folded() && !plain.folded() && idx.size() == text.size());
+  assert(idx.extract(100, 50) == text.substr(100, 50));
+  assert(idx.fold("AbC.") == "abc." && plain.fold("AbC.") == "AbC.");
+
+  std::mt19937 rng(2);
+  for (int t = 0; t < 200; ++t) {
+    std::string p = text.substr(rng() % 3990, 1 + rng() % 8);
+    if (t % 2) p = lower(p);
+    assert(idx.interval(p) == plain.interval(lower(p)));
+    assert(idx.locate(p) == naive_locate(low, lower(p)));
+    assert(idx.locate_exact(p) == naive_locate(text, p));
+  }
+  assert(idx.locate_exact(text.substr(7, 3), 2).size() <= 2);
+  std::cout << "  ✓ Case-insensitive search passed\n";
+}
+
+static void test_persistence_and_engines() {
+  std::cout << "[fold_tests] Test 2: Save/load and pattern engines\n";
+  const std::string text = random_text(3000, "acgtACGT", 3);
+  const std::string low = lower(text);
+  BuildParams p = folding();
+  p.bidirectional = true;
+  FMIndex idx = FMIndex::build_from_text(text, p);
+
+  const std::string path = "fold_tests.csidx";
+  idx.save(path);
+  FMIndex back = FMIndex::load(path);
+  std::remove(path.c_str());
+  assert(back.folded() && back.fold_table() == idx.fold_table());
+  assert(back.count("ACGT") == idx.count("acgt") && back.extract(0, 20) == text.substr(0, 20));
+
+  const std::string read = text.substr(500, 40);
+  assert(idx.smems(read) == idx.smems(lower(read)));
+  assert(count_class(idx, ClassPattern::parse("A[CG]T")) == naive_locate(low, "act").size() + naive_locate(low, "agt").size());
+
+  ProximityOptions popt;
+  popt.max_gap = 5;
+  popt.limit = SIZE_MAX;
+  assert(find_near(idx, "ACG", "tT", popt) == find_near(idx, "acg", "TT", popt));
+  assert(!find_near(idx, "ACG", "tT", popt).empty());
+
+  RegexOptions ropt;
+  ropt.max_length = 8;
+  for (const auto plan : {RegexPlan::TRAVERSE, RegexPlan::VERIFY}) {
+    ropt.plan = plan;
+    assert(count_regex(idx, Regex::compile("GA[CT]+g"), ropt) == count_regex(idx, Regex::compile("ga[ct]+g"), ropt));
+  }
+  std::cout << "  ✓ Save/load and pattern engines passed\n";
+}
+
+static void test_tables_documents_shards() {
+  std::cout << "[fold_tests] Test 3: Tables, documents, shards\n";
+  [[maybe_unused]] const FoldTable id = identity_fold(), ascii = ascii_case_fold(), latin = latin1_case_fold();
+  assert(id['Q'] == 'Q' && ascii['Q'] == 'q' && ascii[0xC4] == 0xC4 && latin[0xC4] == 0xE4 && latin[0xD7] == 0xD7);
+
+  const std::vector<std::string_view> docs = {"Hello World", "hello there", "HELLO"};
+  FMIndex d = FMIndex::build_from_documents(docs, folding());
+  assert((d.list_documents("hello") == std::vector<uint32_t>{0, 1, 2}));
+  BuildParams bad = folding();
+  FoldTable t = identity_fold();
+  t['x'] = bad.doc_separator;
+  bad.fold = t;
+  [[maybe_unused]] bool threw = false;
+  try {
+    FMIndex::build_from_documents(docs, bad);
+  } catch (const std::invalid_argument&) {
+    threw = true;
+  }
+  assert(threw);
+
+  const std::string text = random_text(5000, "abAB", 4);
+  ShardParams sp;
+  sp.num_shards = 4;
+  sp.max_pattern_len = 8;
+  sp.build = folding();
+  ThreadPool pool(2);
+  ShardedIndex si = ShardedIndex::build(text, sp, pool);
+  for ([[maybe_unused]] const char* q : {"aB", "ABBA", "bbbbb"}) {
+    assert(si.count(q, pool) == naive_locate(lower(text), lower(q)).size());
+    assert(si.locate(q, pool) == naive_locate(lower(text), lower(q)));
+  }
+  std::cout << "  ✓ Tables, documents, shards passed\n";
+}
+
+static void test_negated_classes() {
+  std::cout << "[fold_tests] Test 4: Negated classes\n";
+  FMIndex idx = FMIndex::build_from_text("xa xA xb", folding());
+  assert(count_class(idx, ClassPattern::parse("x[^a]")) == 1);
+  assert(count_class(idx, ClassPattern::parse("x[!A]")) == 1);
+  assert(count_class(idx, ClassPattern::parse("x?")) == 3);
+
+  FMIndex mixed = FMIndex::build_from_text("xa xA x1 x- x\n", folding());
+  const std::pair<const char*, uint64_t> cases[] = {
+      {"x[^a]", 3}, {"x[^A]", 3}, {"x.", 4}, {"x\\W", 2}, {"x\\D", 4}, {"x\\S", 4}, {"x[^\\Wa]", 1}, {"x[\\Wa]", 4}};
+  RegexOptions ropt;
+  for (const auto plan : {RegexPlan::TRAVERSE, RegexPlan::VERIFY}) {
+    ropt.plan = plan;
+    assert(count_regex(idx, Regex::compile("x[^a]"), ropt) == 1);
+    for ([[maybe_unused]] const auto& [re, want] : cases) assert(count_regex(mixed, Regex::compile(re), ropt) == want);
+  }
+  std::cout << "  ✓ Negated classes passed\n";
+}
+
+int main() {
+  std::cout << "=== Running fold_tests ===\n";
+  test_case_insensitive();
+  test_persistence_and_engines();
+  test_tables_documents_shards();
+  test_negated_classes();
+  std::cout << "=== All fold_tests passed! ===\n";
+  return 0;
+}
@@ -0,0 +1,130 @@
+/**
+ * interval_cache_tests.cpp — Tests for the concurrent SA-interval cache.
+ *
+ * Tests:
+ *   1) Full, partial and negative hits agree with FMIndex::interval.
+ *   2) A tiny memory cap evicts but stays correct; shards shrink to fit it.
+ *   3) Concurrent readers and writers.
+ */
+
+#include "../src/api/interval_cache.hpp"
+#include <iostream>
+#include <cassert>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace cs;
+
+static std::string make_text(size_t n, unsigned seed) {
+  std::mt19937 rng(seed);
+  std::string t(n, 'a');
+  for (auto& c : t) c = "abcd"[rng() % 4];
+  return t;
+}
+
+static void test_hits() {
+  std::cout << "[interval_cache_tests] Test 1: Full/partial/negative hits\n";
+  const std::string text = make_text(20000, 1);
+  FMIndex idx = FMIndex::build_from_text(text, BuildParams());
+  IntervalCache cache(idx);
+
+  const std::string p = text.substr(100, 12);
+  assert(cache.interval(p) == idx.interval(p));
+  assert(cache.stats().misses == 1 && cache.stats().inserts >= 2);
+  assert(cache.interval(p) == idx.interval(p));
+  assert(cache.stats().hits == 1);
+
+  // A longer pattern ending in a cached 8-byte suffix resumes from it.
+  const std::string longer = text.substr(96, 16);
+  assert(cache.interval(longer) == idx.interval(longer));
+  assert(cache.stats().partial_hits == 1);
+
+  // Absent patterns are cached as empty.
+  assert(cache.count("abcdabcdabcdabcdabcdabcdddddddda") == 0);
+  assert(cache.count("abcdabcdabcdabcdabcdabcdddddddda") == 0);
+  assert(cache.stats().hits == 2);
+
+  // Longer than KEY_MAX: the capped suffix is cached, the rest resumed.
+  const std::string huge = text.substr(1000, IntervalCache::KEY_MAX + 20);
+  assert(cache.interval(huge) == idx.interval(huge));
+  assert(cache.interval(huge) == idx.interval(huge));
+  assert(cache.locate(huge) == idx.locate(huge));
+  assert(cache.count("") == idx.count(""));
+  std::cout << "  ✓ Hits passed\n";
+}
+
+static void test_eviction() {
+  std::cout << "[interval_cache_tests] Test 2: Memory cap and eviction\n";
+  const std::string text = make_text(20000, 2);
+  FMIndex idx = FMIndex::build_from_text(text, BuildParams());
+  IntervalCacheConfig cfg;
+  cfg.memory_bytes = 4096;
+  cfg.shards = 2;
+  IntervalCache cache(idx, cfg);
+  assert(cache.stats().memory_bytes <= 4096);
+
+  std::mt19937 rng(3);
+  for (int i = 0; i < 2000; ++i) {
+    const std::string p = text.substr(rng() % 19000, 1 + rng() % 20);
+    assert(cache.count(p) == idx.count(p));
+  }
+  [[maybe_unused]] const auto st = cache.stats();
+  assert(st.evictions > 0 && st.inserts - st.evictions <= st.capacity);
+  cache.clear();
+  assert(cache.count(text.substr(0, 9)) == idx.count(text.substr(0, 9)));
+
+  // Sixteen shards of one bucket each would not fit in 4 KiB.
+  cfg.shards = 16;
+  IntervalCache narrow(idx, cfg);
+  assert(narrow.stats().memory_bytes <= 4096 && narrow.stats().capacity >= IntervalCache::WAYS);
+  assert(narrow.count(text.substr(5, 7)) == idx.count(text.substr(5, 7)));
+  cfg.memory_bytes = 64;
+  [[maybe_unused]] bool threw = false;
+  try {
+    IntervalCache none(idx, cfg);
+  } catch (const std::invalid_argument&) {
+    threw = true;
+  }
+  assert(threw);
+  std::cout << "  ✓ Eviction passed\n";
+}
+
+static void test_concurrent() {
+  std::cout << "[interval_cache_tests] Test 3: Concurrent access\n";
+  const std::string text = make_text(50000, 4);
+  FMIndex idx = FMIndex::build_from_text(text, BuildParams());
+  IntervalCacheConfig cfg;
+  cfg.memory_bytes = 64 << 10;
+  IntervalCache cache(idx, cfg);
+
+  // Skewed mix: a small hot set plus a long tail.
+  std::vector<std::string> hot;
+  for (int i = 0; i < 50; ++i) hot.push_back(text.substr(i * 997 % 49000, 6 + i % 10));
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&, t] {
+      std::mt19937 rng(t);
+      for (int i = 0; i < 5000; ++i) {
+        const std::string p = rng() % 4 ? hot[rng() % hot.size()] : text.substr(rng() % 49000, 1 + rng() % 30);
+        if (cache.interval(p) != idx.interval(p)) std::abort();
+      }
+    });
+  }
+  for (auto& th : threads) th.join();
+  [[maybe_unused]] const auto st = cache.stats();
+  assert(st.hits + st.partial_hits + st.misses == 20000);
+  assert(st.hits > st.misses);
+  std::cout << "  ✓ Concurrent access passed\n";
+}
+
+int main() {
+  std::cout << "=== Running interval_cache_tests ===\n";
+  test_hits();
+  test_eviction();
+  test_concurrent();
+  std::cout << "=== All interval_cache_tests passed! ===\n";
+  return 0;
+}
@@ -0,0 +1,169 @@
+/**
+ * kmer_tests.cpp — Tests for symbol enumeration and k-mer spectra.
+ *
+ * Tests:
+ *   1) range_symbols and the for_each_*_extension helpers vs one symbol at a time.
+ *   2) enumerate_kmers vs a hash count, both orders, with min_count.
+ *   3) Edge cases: k beyond the text, k == 0, a single branch.
+ *   4) Capped blocks: same spectrum, no block over block_kmers, and a
+ *      throwing callback stops the walk.
+ */
+
+#include "../src/api/kmers.hpp"
+#include "test_util.hpp"
+#include <iostream>
+#include <algorithm>
+#include <cassert>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace cs;
+
+static void test_extensions() {
+  std::cout << "[kmer_tests] Test 1: Symbol enumeration\n";
+  const std::string text = random_text(3000, std::string("ACGTacgt") + '\0', 1);
+  FMIndex idx = FMIndex::build_from_text(text, bidi());
+
+  std::mt19937 rng(2);
+  for (int t = 0; t < 200; ++t) {
+    const std::string p = t % 10 == 0 ? std::string() : text.substr(rng() % 2990, 1 + rng() % 3);
+    const SAInterval iv = idx.interval(p);
+    std::vector<std::pair<uint8_t, SAInterval>> want, got;
+    for (int c = 0; c < 256; ++c) {
+      const SAInterval e = idx.extend_left(iv, static_cast<uint8_t>(c));
+      if (!e.empty()) want.emplace_back(static_cast<uint8_t>(c), e);
+    }
+    idx.for_each_left_extension(iv, [&](uint8_t c, const SAInterval& e) { got.emplace_back(c, e); });
+    assert(got == want);
+
+    BiInterval bi = idx.bi_full_interval();
+    for (char c : p) bi = idx.extend_right(bi, static_cast<uint8_t>(c));
+    std::vector<std::pair<uint8_t, BiInterval>> want_r, got_r;
+    for (int c = 0; c < 256; ++c) {
+      const BiInterval e = idx.extend_right(bi, static_cast<uint8_t>(c));
+      if (!e.empty()) want_r.emplace_back(static_cast<uint8_t>(c), e);
+    }
+    idx.for_each_right_extension(bi, [&](uint8_t c, const BiInterval& e) { got_r.emplace_back(c, e); });
+    assert(got_r == want_r);
+  }
+  std::cout << "  ✓ Symbol enumeration passed\n";
+}
+
+using Spectrum = std::vector<std::pair<std::string, uint64_t>>;
+
+static Spectrum collect(const FMIndex& idx, size_t k, uint64_t min_count, ThreadPool& pool, KmerStats* st,
+                        const KmerOptions& opt = {}) {
+  Spectrum out;
+  *st = enumerate_kmers(idx, k, min_count, [&](const KmerBlock& b) {
+    assert(b.k == k && b.kmers.size() == b.size() * k);
+    for (size_t i = 0; i < b.size(); ++i) out.emplace_back(std::string(b.kmer(i)), b.counts[i]);
+  }, pool, opt);
+  return out;
+}
+
+static void test_spectrum() {
+  std::cout << "[kmer_tests] Test 2: K-mer spectra\n";
+  const std::string text = random_text(5000, std::string("ACGT") + '\0', 3) + "ACGTACGTACGT";
+  FMIndex fwd = FMIndex::build_from_text(text, BuildParams());
+  FMIndex both = FMIndex::build_from_text(text, bidi());
+  ThreadPool pool(3);
+
+  for (size_t k : {1, 3, 6, 9}) {
+    for (uint64_t min_count : {1, 4}) {
+      std::unordered_map<std::string, uint64_t> hashed;
+      for (size_t i = 0; i + k <= text.size(); ++i) ++hashed[text.substr(i, k)];
+      Spectrum want;
+      for (const auto& [s, c] : hashed) if (c >= min_count) want.emplace_back(s, c);
+      std::sort(want.begin(), want.end());
+
+      KmerStats st;
+      const Spectrum lex = collect(both, k, min_count, pool, &st);
+      assert(st.lexicographic && lex == want && st.kmers == want.size());
+
+      auto colex = [](const auto& a, const auto& b) {
+        return std::string(a.first.rbegin(), a.first.rend()) < std::string(b.first.rbegin(), b.first.rend());
+      };
+      std::sort(want.begin(), want.end(), colex);
+      const Spectrum rev = collect(fwd, k, min_count, pool, &st);
+      assert(!st.lexicographic && rev == want);
+      uint64_t total = 0;
+      for (const auto& e : want) total += e.second;
+      assert(st.occurrences == total);
+    }
+  }
+  std::cout << "  ✓ K-mer spectra passed\n";
+}
+
+static void test_edges() {
+  std::cout << "[kmer_tests] Test 3: Edge cases\n";
+  const std::string text = "abracadabra";
+  FMIndex idx = FMIndex::build_from_text(text, bidi());
+  ThreadPool pool(2);
+  KmerStats st;
+  assert(collect(idx, 12, 1, pool, &st).empty() && st.blocks == 0);
+  assert(collect(idx, 11, 1, pool, &st) == (Spectrum{{text, 1}}));
+
+  KmerOptions one;
+  one.min_branches = 1;
+  one.window = 1;
+  const Spectrum abra = collect(idx, 4, 2, pool, &st, one);
+  assert(abra == (Spectrum{{"abra", 2}}) && st.blocks == 1);
+  assert(collect(idx, 2, 0, pool, &st).size() == 7);  // ab ac ad br ca da ra
+
+  [[maybe_unused]] bool threw = false;
+  try {
+    enumerate_kmers(idx, 0, 1, [](const KmerBlock&) {}, pool);
+  } catch (const std::invalid_argument&) {
+    threw = true;
+  }
+  assert(threw);
+  std::cout << "  ✓ Edge cases passed\n";
+}
+
+static void test_block_cap() {
+  std::cout << "[kmer_tests] Test 4: Capped blocks\n";
+  const std::string text = random_text(20000, "ACGT", 7);
+  FMIndex idx = FMIndex::build_from_text(text, bidi());
+  ThreadPool pool(3);
+  KmerStats ref_st, st;
+  const Spectrum ref = collect(idx, 8, 1, pool, &ref_st);
+
+  KmerOptions small;
+  small.min_branches = 2;  // Few branches, each far larger than a block
+  small.window = 2;
+  small.block_kmers = 37;
+  size_t largest = 0;
+  Spectrum got;
+  st = enumerate_kmers(idx, 8, 1, [&](const KmerBlock& b) {
+    largest = std::max(largest, b.size());
+    for (size_t i = 0; i < b.size(); ++i) got.emplace_back(std::string(b.kmer(i)), b.counts[i]);
+  }, pool, small);
+  assert(got == ref && st.kmers == ref_st.kmers && st.nodes == ref_st.nodes);
+  assert(largest == 37 && st.blocks >= ref.size() / 37);
+
+  size_t seen = 0;
+  [[maybe_unused]] bool threw = false;
+  try {
+    enumerate_kmers(idx, 8, 1, [&](const KmerBlock&) {
+      if (++seen == 3) throw std::runtime_error("stop");
+    }, pool, small);
+  } catch (const std::runtime_error&) {
+    threw = true;
+  }
+  assert(threw && seen == 3);
+  std::cout << "  ✓ Capped blocks passed\n";
+}
+
+int main() {
+  std::cout << "=== Running kmer_tests ===\n";
+  test_extensions();
+  test_spectrum();
+  test_edges();
+  test_block_cap();
+  std::cout << "=== All kmer_tests passed! ===\n";
+  return 0;
+}
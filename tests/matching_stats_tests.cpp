@@ -0,0 +1,120 @@
+/**
+ * matching_stats_tests.cpp — Tests for the LCP array and matching statistics.
+ *
+ * Tests:
+ *   1) LcpArray values and prev/next smaller against a plain array.
+ *   2) matching_statistics against brute force (including '\0' bytes).
+ *   3) longest_common_substring, save/load, index without LCP rejected.
+ */
+
+#include "../src/api/fm_index.hpp"
+#include "../src/core/sais.hpp"
+#include "test_util.hpp"
+#include <iostream>
+#include <cassert>
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace cs;
+
+static BuildParams with_lcp() {
+  BuildParams p;
+  p.lcp = true;
+  return p;
+}
+
+[[maybe_unused]] static std::vector<uint32_t> naive_ms(const std::string& text, const std::string& q) {
+  std::vector<uint32_t> ms(q.size());
+  for (size_t i = 0; i < q.size(); ++i) {
+    size_t l = 0;
+    while (i + l < q.size() && text.find(q.substr(i, l + 1)) != std::string::npos) ++l;
+    ms[i] = static_cast<uint32_t>(l);
+  }
+  return ms;
+}
+
+static void test_lcp_array() {
+  std::cout << "[matching_stats_tests] Test 1: LCP array\n";
+  // A long repeat pushes values past the one-byte range.
+  const std::string unit = random_text(400, "ab", 1);
+  const std::string text = random_text(2000, "ab", 2) + unit + random_text(300, "ab", 3) + unit;
+  std::vector<uint32_t> sa = build_sa_naive(text);
+  sa.insert(sa.begin(), static_cast<uint32_t>(text.size()));
+  LcpArray lcp;
+  lcp.build(text, sa);
+  assert(lcp.size() == sa.size() && !lcp.overflow().empty());
+
+  std::vector<uint32_t> plain(sa.size(), 0);
+  for (size_t i = 1; i < sa.size(); ++i) {
+    size_t h = 0;
+    while (sa[i - 1] + h < text.size() && sa[i] + h < text.size() && text[sa[i - 1] + h] == text[sa[i] + h]) ++h;
+    plain[i] = static_cast<uint32_t>(h);
+    assert(lcp[i] == h);
+  }
+  std::mt19937 rng(4);
+  for (int t = 0; t < 3000; ++t) {
+    const size_t i = rng() % plain.size();
+    const uint32_t d = t % 3 ? rng() % 12 : rng() % 500;
+    [[maybe_unused]] size_t prev = LcpArray::npos, next = plain.size();
+    for (size_t k = 0; k <= i; ++k) if (plain[k] < d) prev = k;
+    for (size_t k = plain.size(); k-- > i;) if (plain[k] < d) next = k;
+    assert(lcp.prev_smaller(i, d) == prev && lcp.next_smaller(i, d) == next);
+  }
+  std::cout << "  ✓ LCP array passed\n";
+}
+
+static void test_matching_statistics() {
+  std::cout << "[matching_stats_tests] Test 2: Matching statistics vs brute force\n";
+  const std::string alphabet = std::string("ACGT") + '\0';
+  const std::string text = random_text(4000, alphabet, 5);
+  FMIndex idx = FMIndex::build_from_text(text, with_lcp());
+  std::mt19937 rng(6);
+  for (int t = 0; t < 200; ++t) {
+    std::string q = t % 4 == 3 ? random_text(1 + rng() % 80, alphabet + "N", rng())
+                               : text.substr(rng() % 3900, 1 + rng() % 100);
+    for (size_t k = rng() % 5; k > 0; --k) q[rng() % q.size()] = "ACGTN"[rng() % 5];
+    assert(idx.matching_statistics(q) == naive_ms(text, q));
+  }
+  assert(idx.matching_statistics("").empty());
+  std::cout << "  ✓ Matching statistics passed\n";
+}
+
+static void test_lcs_and_persistence() {
+  std::cout << "[matching_stats_tests] Test 3: Longest common substring, save/load\n";
+  const std::string text = "the quick brown fox jumps over the lazy dog; the quick red fox naps";
+  FMIndex idx = FMIndex::build_from_text(text, with_lcp());
+
+  [[maybe_unused]] const CommonSubstring lcs = idx.longest_common_substring("a very quick red fox indeed");
+  assert(lcs.length == 15 && lcs.query_pos == 6);                    // " quick red fox "
+  assert(idx.locate(lcs.iv) == std::vector<uint64_t>{48});
+  assert(idx.longest_common_substring("###").length == 0);
+  assert(idx.longest_common_substring("#x#").length == 1);           // "x" in "fox"
+
+  const std::string path = "matching_stats_tests.csidx";
+  idx.save(path);
+  FMIndex back = FMIndex::load(path);
+  std::remove(path.c_str());
+  assert(back.has_lcp() && back.longest_common_substring("lazy cat") == idx.longest_common_substring("lazy cat"));
+
+  FMIndex plain = FMIndex::build_from_text(text, BuildParams());
+  [[maybe_unused]] bool threw = false;
+  try {
+    plain.matching_statistics("fox");
+  } catch (const std::logic_error&) {
+    threw = true;
+  }
+  assert(threw && !plain.has_lcp());
+  std::cout << "  ✓ Longest common substring passed\n";
+}
+
+int main() {
+  std::cout << "=== Running matching_stats_tests ===\n";
+  test_lcp_array();
+  test_matching_statistics();
+  test_lcs_and_persistence();
+  std::cout << "=== All matching_stats_tests passed! ===\n";
+  return 0;
+}
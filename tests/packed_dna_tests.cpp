@@ -0,0 +1,145 @@
+/**
+ * packed_dna_tests.cpp — Tests for 2-bit DNA storage and the packed FM-index.
+ *
+ * Tests:
+ *   1) PackedDna access and extract vs the byte string (exceptions included).
+ *   2) DnaOcc access and occ vs brute force.
+ *   3) FMIndex with pack_dna agrees with the byte layout; save/load; folds.
+ */
+
+#include "../src/api/fm_index.hpp"
+#include <iostream>
+#include <cassert>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace cs;
+
+// ACGT with runs of N, a few lowercase bases and stray bytes.
+static std::string make_dna(size_t n, unsigned seed) {
+  std::mt19937 rng(seed);
+  std::string t(n, 'A');
+  for (size_t i = 0; i < n; ++i) {
+    const unsigned r = rng() % 1000;
+    t[i] = r < 3 ? 'a' + rng() % 3 : r < 5 ? "N-\0R"[rng() % 4] : "ACGT"[rng() % 4];
+    if (r == 999) for (size_t k = 0; k < 40 && i < n; ++k) t[i++] = 'N';
+  }
+  return t;
+}
+
+static void test_packed_text() {
+  std::cout << "[packed_dna_tests] Test 1: PackedDna vs bytes\n";
+  for (size_t n : {0, 1, 31, 32, 33, 127, 128, 129, 5000}) {
+    const std::string s = make_dna(n, static_cast<unsigned>(n));
+    PackedDna p;
+    p.build(s);
+    assert(p.size() == n && p.str() == s);
+    for (size_t i = 0; i < n; ++i) assert(p[i] == s[i]);
+    std::mt19937 rng(1);
+    for (int t = 0; n && t < 300; ++t) {
+      [[maybe_unused]] const size_t pos = rng() % n, len = rng() % 100;
+      assert(p.extract(pos, len) == s.substr(pos, len));
+    }
+    assert(p.extract(n, 5).empty());
+  }
+  PackedDna p;
+  p.build(std::string(4096, 'G'));
+  assert(p.exception_runs() == 0 && p.size_in_bytes() < 4096 / 3);
+  p.build(std::string(1000, 'N') + "ACGT" + std::string(1000, 'N'));
+  assert(p.exception_runs() == 2 && p.extract(998, 8) == "NNACGTNN");
+  std::cout << "  ✓ PackedDna passed\n";
+}
+
+static void test_occ() {
+  std::cout << "[packed_dna_tests] Test 2: DnaOcc vs brute force\n";
+  for (size_t n : {1, 128, 300, 4000}) {
+    const std::string s = make_dna(n, static_cast<unsigned>(n) + 7);
+    DnaOcc o;
+    o.build(s);
+    uint64_t counts[4] = {};
+    for (size_t i = 0; i <= n; ++i) {
+      for (unsigned c = 0; c < 4; ++c) assert(o.occ(c, i) == counts[c]);
+      if (i == n) break;
+      assert(o[i] == s[i]);
+      const int code = dna_code(static_cast<uint8_t>(s[i]));
+      if (code >= 0) ++counts[code];
+    }
+  }
+  std::cout << "  ✓ DnaOcc passed\n";
+}
+
+static void test_index() {
+  std::cout << "[packed_dna_tests] Test 3: FMIndex with pack_dna\n";
+  const std::string text = make_dna(6000, 3);
+  BuildParams bp;
+  bp.bidirectional = true;
+  bp.ssa_stride = 8;
+  const FMIndex plain = FMIndex::build_from_text(text, bp);
+  bp.pack_dna = true;
+  const FMIndex packed = FMIndex::build_from_text(text, bp);
+  assert(packed.packed_dna() && !plain.packed_dna());
+  assert(packed.text_and_bwt_bytes() * 2 < plain.text_and_bwt_bytes());
+
+  std::mt19937 rng(4);
+  for (int t = 0; t < 300; ++t) {
+    std::string q = text.substr(rng() % 5980, 1 + rng() % 15);
+    if (t % 5 == 0) q[rng() % q.size()] = "ACGTN"[rng() % 5];
+    assert(packed.interval(q) == plain.interval(q));
+    assert(packed.locate(q) == plain.locate(q));
+    assert(packed.smems(q, 3) == plain.smems(q, 3));
+  }
+  for (int t = 0; t < 200; ++t) {
+    [[maybe_unused]] const uint64_t pos = rng() % 6000, len = rng() % 80;
+    assert(packed.extract(pos, len) == text.substr(pos, len));
+  }
+  for (uint64_t row = 0; row <= text.size(); row += 97) assert(packed.psi(row) == plain.psi(row));
+
+  const std::string path = "packed_dna_tests.csidx";
+  packed.save(path);
+  const FMIndex back = FMIndex::load(path);
+  std::remove(path.c_str());
+  assert(back.packed_dna() && back.extract(0, text.size()) == text);
+  assert(back.locate("ACGTN") == plain.locate("ACGTN") && back.count("GATTACA") == plain.count("GATTACA"));
+
+  // Folded: the packed text keeps the original case.
+  bp.fold = ascii_case_fold();
+  bp.bidirectional = false;
+  const FMIndex folded = FMIndex::build_from_text(text, bp);
+  const FMIndex folded_plain = FMIndex::build_from_text(text, BuildParams{.fold = ascii_case_fold()});
+  assert(folded.extract(0, text.size()) == text);
+  assert(folded.count("acgt") == folded_plain.count("acgt"));
+  for (int t = 0; t < 100; ++t) {
+    const std::string q = text.substr(rng() % 5980, 1 + rng() % 15);
+    assert(folded.locate(q) == folded_plain.locate(q));
+  }
+  // Folded a/c/g/t are coded as bases, not exceptions, so the index shrinks.
+  assert(folded.size_in_bytes() < folded_plain.size_in_bytes());
+  assert(packed.size_in_bytes() < plain.size_in_bytes());
+
+  // Folds that merge two bases, or fold another byte onto an uncoded base, are rejected.
+  FoldTable merge = identity_fold(), clash = ascii_case_fold();
+  merge['C'] = 'A';
+  clash['x'] = 'A';
+  for (const FoldTable& f : {merge, clash}) {
+    bp.fold = f;
+    [[maybe_unused]] bool threw = false;
+    try {
+      FMIndex::build_from_text(text, bp);
+    } catch (const std::invalid_argument&) {
+      threw = true;
+    }
+    assert(threw);
+  }
+  std::cout << "  ✓ FMIndex with pack_dna passed\n";
+}
+
+int main() {
+  std::cout << "=== Running packed_dna_tests ===\n";
+  test_packed_text();
+  test_occ();
+  test_index();
+  std::cout << "=== All packed_dna_tests passed! ===\n";
+  return 0;
+}
@@ -0,0 +1,125 @@
+/**
+ * proximity_tests.cpp — Tests for bounded-gap proximity search.
+ *
+ * Tests:
+ *   1) Every plan against a brute-force pairing of occurrences.
+ *   2) AUTO picks a scan for a rare side and the join for two frequent ones.
+ *   3) Limits, absent patterns, bad gaps, gaps beyond the text.
+ */
+
+#include "../src/api/proximity.hpp"
+#include "test_util.hpp"
+#include <iostream>
+#include <cassert>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace cs;
+
+static std::vector<ProximityMatch> naive_near(const std::string& text, const std::string& p1, const std::string& p2,
+                                              uint64_t min_gap, uint64_t max_gap) {
+  std::vector<ProximityMatch> out;
+  for (size_t i = text.find(p1); i != std::string::npos; i = text.find(p1, i + 1))
+    for (size_t j = text.find(p2, i + p1.size()); j != std::string::npos; j = text.find(p2, j + 1)) {
+      const uint64_t gap = j - i - p1.size();
+      if (gap > max_gap) break;
+      if (gap >= min_gap) out.push_back({i, j});
+    }
+  return out;
+}
+
+static void test_plans() {
+  std::cout << "[proximity_tests] Test 1: Plans vs brute force\n";
+  const std::string text = random_text(6000, "abcd", 1);
+  FMIndex idx = FMIndex::build_from_text(text, BuildParams());
+  std::mt19937 rng(2);
+  for (int t = 0; t < 120; ++t) {
+    const std::string p1 = text.substr(rng() % 5900, 1 + rng() % 5);
+    const std::string p2 = text.substr(rng() % 5900, 1 + rng() % 5);
+    ProximityOptions opt;
+    opt.max_gap = rng() % 40;
+    opt.min_gap = rng() % (opt.max_gap + 1);
+    opt.limit = SIZE_MAX;
+    const auto want = naive_near(text, p1, p2, opt.min_gap, opt.max_gap);
+    for (const auto plan : {ProximityPlan::AUTO, ProximityPlan::SCAN_AFTER_FIRST, ProximityPlan::SCAN_BEFORE_SECOND,
+                            ProximityPlan::JOIN}) {
+      opt.plan = plan;
+      ProximityStats st;
+      assert(find_near(idx, p1, p2, opt, &st) == want);
+      assert(st.first_count == idx.count(p1) && st.second_count == idx.count(p2));
+      assert(plan == ProximityPlan::AUTO || st.plan == plan);
+    }
+  }
+  std::cout << "  ✓ Plans passed\n";
+}
+
+static void test_auto() {
+  std::cout << "[proximity_tests] Test 2: Plan choice\n";
+  std::string text = random_text(20000, "abcd", 3);
+  text.replace(5000, 6, "RARExx");
+  text.replace(5010, 3, "abc");
+  FMIndex idx = FMIndex::build_from_text(text, BuildParams());
+  ProximityOptions opt;
+  opt.max_gap = 10;
+  ProximityStats st;
+  auto got = find_near(idx, "RARE", "abc", opt, &st);
+  assert(st.plan == ProximityPlan::SCAN_AFTER_FIRST && st.located == 1 && st.scanned_bytes <= 10 + 3);
+  assert(got == naive_near(text, "RARE", "abc", 0, 10) && !got.empty());
+  got = find_near(idx, "abc", "RARE", opt, &st);
+  assert(st.plan == ProximityPlan::SCAN_BEFORE_SECOND && st.located == 1);
+  assert(got == naive_near(text, "abc", "RARE", 0, 10));
+  // Two mid-frequency words, wide gap: their windows cover the text.
+  opt.max_gap = 1000;
+  opt.limit = SIZE_MAX;
+  got = find_near(idx, "abca", "dcbd", opt, &st);
+  assert(st.plan == ProximityPlan::JOIN && st.scanned_bytes == 0);
+  assert(got == naive_near(text, "abca", "dcbd", 0, 1000));
+  std::cout << "  ✓ Plan choice passed\n";
+}
+
+static void test_edges() {
+  std::cout << "[proximity_tests] Test 3: Limits and edge cases\n";
+  const std::string text = "ab ab ab xy";
+  FMIndex idx = FMIndex::build_from_text(text, BuildParams());
+  ProximityOptions opt;
+  opt.max_gap = 20;
+  assert(find_near(idx, "ab", "ab", opt).size() == 3);
+  opt.limit = 2;
+  assert((find_near(idx, "ab", "ab", opt) == std::vector<ProximityMatch>{{0, 3}, {0, 6}}));
+  assert(find_near(idx, "ab", "zz", opt).empty() && find_near(idx, "", "ab", opt).empty());
+  opt.min_gap = 1;
+  opt.max_gap = 1;
+  opt.limit = 10;
+  assert((find_near(idx, "ab", "xy", opt) == std::vector<ProximityMatch>{{6, 9}}));
+  opt.min_gap = 2;
+  [[maybe_unused]] bool threw = false;
+  try {
+    find_near(idx, "ab", "xy", opt);
+  } catch (const std::invalid_argument&) {
+    threw = true;
+  }
+  assert(threw);
+  // Unbounded gaps must not wrap window ends or plan costs.
+  opt.min_gap = 0;
+  opt.max_gap = UINT64_MAX;
+  for (const auto plan : {ProximityPlan::AUTO, ProximityPlan::SCAN_AFTER_FIRST, ProximityPlan::SCAN_BEFORE_SECOND,
+                          ProximityPlan::JOIN}) {
+    opt.plan = plan;
+    assert(find_near(idx, "ab", "xy", opt) == naive_near(text, "ab", "xy", 0, UINT64_MAX));
+    assert(find_near(idx, "ab", "ab", opt).size() == 3);
+  }
+  opt.min_gap = UINT64_MAX;
+  assert(find_near(idx, "ab", "xy", opt).empty());
+  std::cout << "  ✓ Limits and edge cases passed\n";
+}
+
+int main() {
+  std::cout << "=== Running proximity_tests ===\n";
+  test_plans();
+  test_auto();
+  test_edges();
+  std::cout << "=== All proximity_tests passed! ===\n";
+  return 0;
+}
@@ -0,0 +1,154 @@
+/**
+ * regex_tests.cpp — Tests for regular-expression search.
+ *
+ * Tests:
+ *   1) Parsing, required literals, and full matches vs std::regex.
+ *   2) Both plans against a brute-force scan of every substring.
+ *   3) Literal pruning, plan choice, limits, unbounded max_length, errors.
+ */
+
+#include "../src/api/regex.hpp"
+#include "test_util.hpp"
+#include <iostream>
+#include <cassert>
+#include <random>
+#include <regex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace cs;
+
+static std::vector<RegexMatch> naive_find(const std::string& text, const Regex& re, size_t max_length) {
+  std::vector<RegexMatch> out;
+  for (size_t i = 0; i < text.size(); ++i)
+    for (size_t len = 1; len <= max_length && i + len <= text.size(); ++len)
+      if (re.matches(std::string_view(text).substr(i, len))) out.push_back({i, static_cast<uint32_t>(len)});
+  return out;
+}
+
+static const char* const PATTERNS[] = {
+  "ab", "a.c", "[ab]+c", "(ab|ba)d", "a[^b]?d", "c{2,3}", "(a|b)*cd", "d\\d", "\\w{3}", "[a-c]b{1,}",
+  "x?y?a", "(abc)+", "a(b|c)(d|a)", "\\.", "[\\]a]b", "((a|b)c|d)+",
+};
+
+static void test_compile() {
+  std::cout << "[regex_tests] Test 1: Parsing and literals\n";
+  assert(Regex::compile("ERROR [0-9]+ timeout").required_literal() == " timeout");
+  assert(Regex::compile("ab+cd").required_literal() == "bcd");
+  assert(Regex::compile("(GET|GET)/x").required_literal() == "GET/x");
+  assert(Regex::compile("a(bc){2}d").required_literal() == "abcbcd");
+  assert(Regex::compile("a|b").required_literal().empty());
+  assert(Regex::compile("[0-9]*").required_literal().empty());
+
+  std::mt19937 rng(1);
+  for (const char* p : PATTERNS) {
+    const Regex re = Regex::compile(p);
+    const std::regex ref(p);
+    for (int t = 0; t < 300; ++t) {
+      const std::string s = random_text(rng() % 7, "abcd1.x]", rng());
+      assert(re.matches(s) == std::regex_match(s, ref));
+    }
+  }
+  assert(Regex::compile("a.b").matches("axb") && !Regex::compile("a.b").matches("a\nb"));
+  assert(Regex::compile("\\x41\\t").matches("A\t"));
+
+  for (const char* bad : {"(ab", "ab)", "*a", "a{3,1}", "[ab", "^a", "a{2000}", "a\\"}) {
+    [[maybe_unused]] bool threw = false;
+    try {
+      Regex::compile(bad);
+    } catch (const std::invalid_argument&) {
+      threw = true;
+    }
+    assert(threw);
+  }
+  std::cout << "  ✓ Parsing and literals passed\n";
+}
+
+static void test_plans() {
+  std::cout << "[regex_tests] Test 2: Plans vs brute force\n";
+  const std::string text = random_text(1000, "abcd1.x", 2);
+  FMIndex idx = FMIndex::build_from_text(text, BuildParams());
+  for (const char* p : PATTERNS) {
+    const Regex re = Regex::compile(p);
+    RegexOptions opt;
+    opt.max_length = 10;
+    opt.limit = SIZE_MAX;
+    const auto want = naive_find(text, re, opt.max_length);
+    for (const auto plan : {RegexPlan::AUTO, RegexPlan::TRAVERSE, RegexPlan::VERIFY}) {
+      if (plan == RegexPlan::VERIFY && re.required_literal().empty()) continue;
+      opt.plan = plan;
+      RegexStats st;
+      assert(find_regex(idx, re, opt, &st) == want);
+      assert(count_regex(idx, re, opt) == want.size());
+      assert(plan == RegexPlan::AUTO || st.plan == plan);
+    }
+    uint64_t rows = 0;
+    for (const SAInterval& iv : regex_intervals(idx, re, opt)) {
+      assert(iv.len >= 1 && iv.len <= opt.max_length);
+      rows += iv.size();
+    }
+    assert(rows == want.size());
+  }
+  std::cout << "  ✓ Plans passed\n";
+}
+
+static void test_pruning() {
+  std::cout << "[regex_tests] Test 3: Pruning, plan choice, limits\n";
+  std::string text = random_text(20000, "abcd", 3);
+  text.replace(7000, 14, "ERROR 4711 end");
+  FMIndex idx = FMIndex::build_from_text(text, BuildParams());
+
+  RegexStats st;
+  assert(count_regex(idx, Regex::compile("[a-d]+ZZZ[a-d]"), {}, &st) == 0);
+  assert(st.literal_count == 0 && st.nodes == 0);
+
+  // Ends in a class: the traversal would branch on every [a-z] string.
+  const Regex re = Regex::compile("ERROR [0-9]+ [a-z]+");
+  RegexOptions opt;
+  opt.max_length = 24;
+  auto got = find_regex(idx, re, opt, &st);
+  assert(st.plan == RegexPlan::VERIFY && st.literal_count == 1);
+  assert(!got.empty() && got.front() == (RegexMatch{7000, 12}));
+  opt.plan = RegexPlan::TRAVERSE;
+  assert(find_regex(idx, re, opt, &st) == got && st.nodes > 0 && st.scanned_bytes == 0);
+
+  // No required literal: always a traversal.
+  assert(count_regex(idx, Regex::compile("d(a|b)c"), {}, &st) == idx.count("dac") + idx.count("dbc"));
+  assert(st.plan == RegexPlan::TRAVERSE);
+  opt = {};
+  opt.limit = 5;
+  assert(find_regex(idx, Regex::compile("ab"), opt).size() == 5);
+  opt.max_length = 3;
+  assert(count_regex(idx, Regex::compile("a+"), opt) == idx.count("a") + idx.count("aa") + idx.count("aaa"));
+
+  // max_length beyond the text must not wrap the verify window or the plan estimate.
+  opt = {};
+  opt.limit = SIZE_MAX;
+  opt.max_length = SIZE_MAX;
+  const Regex tail = Regex::compile("4711 e[n-z]*");
+  for (const auto plan : {RegexPlan::AUTO, RegexPlan::VERIFY, RegexPlan::TRAVERSE}) {
+    opt.plan = plan;
+    assert((find_regex(idx, tail, opt) == std::vector<RegexMatch>{{7006, 6}, {7006, 7}}));
+    assert(count_regex(idx, tail, opt) == 2);
+  }
+
+  [[maybe_unused]] bool threw = false;
+  opt.plan = RegexPlan::VERIFY;
+  try {
+    count_regex(idx, Regex::compile("a|b"), opt);
+  } catch (const std::invalid_argument&) {
+    threw = true;
+  }
+  assert(threw);
+  std::cout << "  ✓ Pruning, plan choice, limits passed\n";
+}
+
+int main() {
+  std::cout << "=== Running regex_tests ===\n";
+  test_compile();
+  test_plans();
+  test_pruning();
+  std::cout << "=== All regex_tests passed! ===\n";
+  return 0;
+}
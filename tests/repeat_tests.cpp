@@ -0,0 +1,153 @@
+/**
+ * repeat_tests.cpp — Tests for maximal and supermaximal repeats.
+ *
+ * Tests:
+ *   1) Left extensions on a BiInterval vs extend_left.
+ *   2) Maximal / supermaximal repeats vs brute force, with thresholds.
+ *   3) Positions, batching across threads, throwing callback, unidirectional index rejected.
+ */
+
+#include "../src/api/repeats.hpp"
+#include "test_util.hpp"
+#include <iostream>
+#include <algorithm>
+#include <cassert>
+#include <map>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace cs;
+
+// Every repeat as (string, count), from its left/right context sets; -1 is
+// the start or end of the text.
+[[maybe_unused]] static std::map<std::string, uint64_t> naive_repeats(const std::string& t, uint64_t min_len,
+                                                                      uint64_t min_count, bool supermaximal) {
+  std::map<std::string, std::vector<size_t>> occ;
+  for (size_t i = 0; i < t.size(); ++i)
+    for (size_t l = 1; i + l <= t.size(); ++l) occ[t.substr(i, l)].push_back(i);
+  std::map<std::string, uint64_t> maximal;
+  for (const auto& [s, pos] : occ) {
+    if (pos.size() < 2) continue;
+    std::set<int> left, right;
+    for (size_t p : pos) {
+      left.insert(p == 0 ? -1 : static_cast<unsigned char>(t[p - 1]));
+      right.insert(p + s.size() == t.size() ? -1 : static_cast<unsigned char>(t[p + s.size()]));
+    }
+    if (left.size() >= 2 && right.size() >= 2) maximal[s] = pos.size();
+  }
+  std::map<std::string, uint64_t> out;
+  for (const auto& [s, c] : maximal) {
+    if (s.size() < min_len || c < min_count) continue;
+    bool inside = false;
+    for (const auto& e : maximal) inside |= e.first.size() > s.size() && e.first.find(s) != std::string::npos;
+    if (!supermaximal || !inside) out[s] = c;
+  }
+  return out;
+}
+
+[[maybe_unused]] static std::map<std::string, uint64_t> found(const FMIndex& idx, const std::string& text,
+                                                              const RepeatOptions& opt, ThreadPool& pool,
+                                                              RepeatStats* st = nullptr) {
+  std::map<std::string, uint64_t> out;
+  const RepeatStats s = find_maximal_repeats(idx, opt, [&](std::span<const MaximalRepeat> batch) {
+    for (const auto& r : batch) {
+      const std::string label = text.substr(idx.locate(r.iv, 1)[0], r.length());
+      assert(!out.count(label));
+      out[label] = r.count();
+    }
+  }, pool);
+  if (st) *st = s;
+  return out;
+}
+
+static void test_left_extensions() {
+  std::cout << "[repeat_tests] Test 1: Bidirectional left extensions\n";
+  const std::string text = random_text(2000, std::string("ACGT") + '\0', 1);
+  FMIndex idx = FMIndex::build_from_text(text, bidi());
+  std::mt19937 rng(2);
+  for (int t = 0; t < 200; ++t) {
+    BiInterval bi = idx.bi_full_interval();
+    for (char c : text.substr(rng() % 1990, rng() % 4)) bi = idx.extend_right(bi, static_cast<uint8_t>(c));
+    std::vector<std::pair<uint8_t, BiInterval>> want, got;
+    for (int c = 0; c < 256; ++c) {
+      const BiInterval e = idx.extend_left(bi, static_cast<uint8_t>(c));
+      if (!e.empty()) want.emplace_back(static_cast<uint8_t>(c), e);
+    }
+    idx.for_each_left_extension(bi, [&](uint8_t c, const BiInterval& e) { got.emplace_back(c, e); });
+    assert(got == want);
+  }
+  std::cout << "  ✓ Bidirectional left extensions passed\n";
+}
+
+static void test_brute_force() {
+  std::cout << "[repeat_tests] Test 2: Repeats vs brute force\n";
+  ThreadPool pool(3);
+  for (unsigned seed = 3; seed < 7; ++seed) {
+    const std::string text = random_text(150, seed % 2 ? "ab" : std::string("abc") + '\0', seed) + "abcabc";
+    FMIndex idx = FMIndex::build_from_text(text, bidi());
+    for (bool super : {false, true}) {
+      for (auto [len, cnt] : {std::pair<uint64_t, uint64_t>{1, 2}, {4, 2}, {2, 5}}) {
+        RepeatOptions opt;
+        opt.min_length = len;
+        opt.min_count = cnt;
+        opt.supermaximal = super;
+        opt.batch = 7;
+        assert(found(idx, text, opt, pool) == naive_repeats(text, len, cnt, super));
+      }
+    }
+  }
+  std::cout << "  ✓ Repeats vs brute force passed\n";
+}
+
+static void test_positions() {
+  std::cout << "[repeat_tests] Test 3: Positions, batches, unidirectional\n";
+  const std::string text = "GET /a 200\nGET /b 404\nGET /a 200\nPOST /a 200\n";
+  FMIndex idx = FMIndex::build_from_text(text, bidi());
+  ThreadPool pool(2);
+  RepeatOptions opt;
+  opt.min_length = 8;
+  opt.locate_limit = 10;
+  opt.min_branches = 1;
+  std::vector<MaximalRepeat> all;
+  RepeatStats st;
+  st = find_maximal_repeats(idx, opt, [&](std::span<const MaximalRepeat> b) { all.insert(all.end(), b.begin(), b.end()); },
+                            pool);
+  assert(st.repeats == all.size() && st.batches >= 1 && st.nodes > 0);
+  bool saw = false;
+  for (const auto& r : all) {
+    assert(r.positions == idx.locate(r.iv, 10));
+    saw |= text.substr(r.positions[0], r.length()) == "GET /a 200\n" && r.positions == std::vector<uint64_t>{0, 22};
+  }
+  assert(saw);
+
+  opt.batch = 1;
+  [[maybe_unused]] bool threw = false;
+  try {
+    find_maximal_repeats(idx, opt, [](std::span<const MaximalRepeat>) { throw std::runtime_error("stop"); }, pool);
+  } catch (const std::runtime_error&) {
+    threw = true;
+  }
+  assert(threw);
+
+  FMIndex one_way = FMIndex::build_from_text(text, BuildParams());
+  threw = false;
+  try {
+    find_maximal_repeats(one_way, opt, [](std::span<const MaximalRepeat>) {}, pool);
+  } catch (const std::logic_error&) {
+    threw = true;
+  }
+  assert(threw);
+  std::cout << "  ✓ Positions, batches, unidirectional passed\n";
+}
+
+int main() {
+  std::cout << "=== Running repeat_tests ===\n";
+  test_left_extensions();
+  test_brute_force();
+  test_positions();
+  std::cout << "=== All repeat_tests passed! ===\n";
+  return 0;
+}
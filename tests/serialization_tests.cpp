@@ -3,6 +3,7 @@
  */
 
 #include "../src/serialization/serialization.hpp"
+#include "../src/api/fm_index.hpp"
 #include <iostream>
 #include <vector>
 #include <cassert>
@@ -343,6 +344,32 @@ static void test_full_index() {
   std::cout << "  ✓ Full index roundtrip passed\n";
 }
 
+// ──────────────────────────────────────────────────────────────
+// Test 9: FMIndex save/load
+// ──────────────────────────────────────────────────────────────
+
+static void test_fm_index_save_load() {
+  std::cout << "[serialization_tests] Test 9: FMIndex save/load\n";
+
+  std::string text;
+  for (int i = 0; i < 300; ++i) text += "mississippi river " + std::to_string(i % 7) + " ";
+  BuildParams params;
+  params.ssa_stride = 8;
+  FMIndex built = FMIndex::build_from_text(text, params);
+  built.save(TEST_INDEX_PATH);
+
+  FMIndex loaded = FMIndex::load(TEST_INDEX_PATH);
+  assert(loaded.size() == built.size() && "Text length mismatch");
+  for ([[maybe_unused]] const char* p : {"ssi", "river 3", "i", "mississippi", "zzz", "6 mis"}) {
+    assert(loaded.count(p) == built.count(p) && "count mismatch after load");
+    assert(loaded.locate(p) == built.locate(p) && "locate mismatch after load");
+  }
+  assert(loaded.extract(100, 20) == text.substr(100, 20) && "extract mismatch after load");
+
+  cleanup_test_file();
+  std::cout << "  ✓ FMIndex save/load passed\n";
+}
+
 // ──────────────────────────────────────────────────────────────
 // Main test driver
 // ──────────────────────────────────────────────────────────────
@@ -358,6 +385,7 @@ int main() {
   test_wavelet_roundtrip();
   test_veb_layout_roundtrip();
   test_full_index();
+  test_fm_index_save_load();
 
   std::cout << "=== All serialization_tests passed! ===\n";
   return 0;
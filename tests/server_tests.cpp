@@ -0,0 +1,364 @@
+/**
+ * server_tests.cpp — Tests for the batch protocol and QueryServer.
+ *
+ * Tests:
+ *   1) execute_frame against a local FMIndex (count/locate/extract/errors,
+ *      responses over FRAME_MAX_PAYLOAD).
+ *   2) Pipelined batches over a Unix-domain socket.
+ *   3) TCP listener on an ephemeral port, bad index slot.
+ *   4) Backpressure: a client that pipelines without reading still gets
+ *      every reply once it drains them.
+ *   5) A request frame larger than max_buffered is still answered.
+ *   6) QueryClient::recv bounds the whole frame, not each read.
+ */
+
+#include "../src/server/server.hpp"
+#include "../src/server/client.hpp"
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace cs;
+
+static const std::string TEXT =
+    "the quick brown fox jumps over the lazy dog; the dog sleeps, the fox runs";
+
+static std::string unix_path() {
+  return "/tmp/cs_server_test_" + std::to_string(::getpid()) + ".sock";
+}
+
+// ──────────────────────────────────────────────────────────────
+// Test 1: execute_frame without sockets
+// ──────────────────────────────────────────────────────────────
+
+static void test_execute_frame() {
+  std::cout << "[server_tests] Test 1: execute_frame\n";
+  FMIndex idx = FMIndex::build_from_text(TEXT, BuildParams());
+
+  std::string req;
+  size_t at = begin_frame(req);
+  WireWriter w(req);
+  w.bytes("the");
+  w.bytes("fox");
+  w.bytes("cat");
+  FrameHeader hdr;
+  hdr.op = OP_COUNT;
+  hdr.count = 3;
+  hdr.request_id = 7;
+  finish_frame(req, at, hdr);
+  std::memcpy(&hdr, req.data(), sizeof(FrameHeader));  // Picks up payload size
+
+  std::string out;
+  execute_frame(hdr, req.data() + sizeof(FrameHeader), idx, out);
+  WireResponse r;
+  std::memcpy(&r.header, out.data(), sizeof(FrameHeader));
+  r.payload = out.substr(sizeof(FrameHeader));
+  assert(r.header.request_id == 7);
+  auto counts = QueryClient::decode_counts(r);
+  assert(counts.size() == 3);
+  assert(counts[0] == idx.count("the") && counts[1] == 2 && counts[2] == 0);
+
+  // Same response through an interval cache, cold and warm.
+  IntervalCache cache(idx);
+  for (int round = 0; round < 2; ++round) {
+    std::string cached;
+    execute_frame(hdr, req.data() + sizeof(FrameHeader), idx, cached, &cache);
+    assert(cached == out);
+  }
+  assert(cache.stats().hits == 3);
+
+  // Truncated payload → STATUS_BAD_REQUEST, not an exception.
+  hdr.count = 4;
+  out.clear();
+  execute_frame(hdr, req.data() + sizeof(FrameHeader), idx, out);
+  FrameHeader bad;
+  std::memcpy(&bad, out.data(), sizeof(FrameHeader));
+  assert(bad.status == STATUS_BAD_REQUEST && bad.count == 0);
+
+  // Each range is legal, but a million whole-text extracts exceed the cap.
+  std::string big;
+  at = begin_frame(big);
+  WireWriter bw(big);
+  for (int i = 0; i < 1000000; ++i) {
+    bw.u64(0);
+    bw.u64(TEXT.size());
+  }
+  FrameHeader many;
+  many.op = OP_EXTRACT;
+  many.count = 1000000;
+  finish_frame(big, at, many);
+  std::memcpy(&many, big.data(), sizeof(FrameHeader));
+  out.clear();
+  execute_frame(many, big.data() + sizeof(FrameHeader), idx, out);
+  std::memcpy(&bad, out.data(), sizeof(FrameHeader));
+  assert(bad.status == STATUS_BAD_REQUEST && out.size() < 4096);
+
+  std::cout << "  ✓ execute_frame passed\n";
+}
+
+// ──────────────────────────────────────────────────────────────
+// Test 2: Pipelined batches over a Unix-domain socket
+// ──────────────────────────────────────────────────────────────
+
+static void test_unix_pipelined() {
+  std::cout << "[server_tests] Test 2: Pipelined unix socket batches\n";
+  FMIndex idx = FMIndex::build_from_text(TEXT, BuildParams());
+  ServerConfig cfg;
+  cfg.threads = 4;
+  cfg.inline_items = 1;  // Force multi-pattern batches onto the worker pool
+  QueryServer server({&idx}, cfg);
+  const std::string path = unix_path();
+  server.listen_unix(path);
+  std::thread loop([&] { server.run(); });
+
+  {
+    QueryClient client = QueryClient::connect_unix(path);
+    const std::vector<std::string> patterns = {"the", "fox", "dog", "o", "zebra", " the "};
+
+    // Send many frames before reading any reply.
+    std::vector<uint64_t> ids;
+    for (int i = 0; i < 200; ++i) {
+      ids.push_back(i % 2 ? client.send_count(patterns) : client.send_count({patterns[i % 6]}));
+    }
+    std::vector<bool> seen(ids.size(), false);
+    for (size_t got = 0; got < ids.size(); ++got) {
+      WireResponse r;
+      [[maybe_unused]] const bool ok = client.recv(r, 5000);
+      assert(ok);
+      const size_t i = r.header.request_id - ids.front();
+      assert(i < ids.size() && !seen[i]);
+      seen[i] = true;
+      auto counts = QueryClient::decode_counts(r);
+      if (i % 2) {
+        assert(counts.size() == patterns.size());
+        for (size_t k = 0; k < patterns.size(); ++k) assert(counts[k] == idx.count(patterns[k]));
+      } else {
+        assert(counts.size() == 1 && counts[0] == idx.count(patterns[i % 6]));
+      }
+    }
+
+    auto locs = client.locate({"fox", "the", "zebra"}, 2);
+    assert(locs.size() == 3);
+    assert(locs[0].total == 2 && locs[0].positions == idx.locate("fox"));
+    assert(locs[1].total == idx.count("the") && locs[1].positions.size() == 2);
+    assert(locs[2].total == 0 && locs[2].positions.empty());
+
+    // LOCATE_SMALLEST keeps the smallest positions rather than the first rows.
+    const auto smallest = QueryClient::decode_locates(
+        client.wait_for(client.send_locate({"the", "o"}, 3, 0, true)));
+    assert(smallest[0].positions == idx.locate_smallest("the", 3));
+    assert(smallest[1].positions == idx.locate_smallest("o", 3));
+    assert(smallest[1].positions == (std::vector<uint64_t>{12, 17, 26}));
+
+    auto snippets = client.extract({{4, 5}, {0, 3}, {TEXT.size() - 4, 100}});
+    assert(snippets[0] == "quick" && snippets[1] == "the" && snippets[2] == "runs");
+
+    client.send_info();
+    WireResponse info;
+    [[maybe_unused]] const bool ok = client.recv(info, 5000);
+    assert(ok);
+    [[maybe_unused]] const IndexInfo ii = QueryClient::decode_info(info);
+    assert(ii.size == TEXT.size() && ii.fold == identity_fold());
+  }
+
+  server.stop();
+  loop.join();
+  std::cout << "  ✓ Pipelined unix socket batches passed\n";
+}
+
+// ──────────────────────────────────────────────────────────────
+// Test 3: TCP listener, index slots, half-close
+// ──────────────────────────────────────────────────────────────
+
+static void test_tcp_slots() {
+  std::cout << "[server_tests] Test 3: TCP listener and index slots\n";
+  FMIndex a = FMIndex::build_from_text("abracadabra", BuildParams());
+  FMIndex b = FMIndex::build_from_text("mississippi", BuildParams());
+  QueryServer server({&a, &b});
+  const uint16_t port = server.listen_tcp("127.0.0.1", 0);
+  assert(port != 0);
+  std::thread loop([&] { server.run(); });
+
+  {
+    QueryClient client = QueryClient::connect_tcp("127.0.0.1", port);
+    assert(client.count({"abra", "ssi"}, 0) == (std::vector<uint64_t>{2, 0}));
+    assert(client.count({"abra", "ssi"}, 1) == (std::vector<uint64_t>{0, 2}));
+
+    [[maybe_unused]] bool threw = false;
+    try {
+      client.count({"x"}, 9);
+    } catch (const std::runtime_error&) {
+      threw = true;
+    }
+    assert(threw && "bad slot should surface as an error");
+
+    // Replies to frames sent before a half-close are still delivered.
+    const uint64_t id = client.send_count({"ss", "i"}, 1);
+    ::shutdown(client.fd(), SHUT_WR);
+    WireResponse r = client.wait_for(id);
+    assert(QueryClient::decode_counts(r) == (std::vector<uint64_t>{2, 4}));
+  }
+
+  server.stop();
+  loop.join();
+  std::cout << "  ✓ TCP listener and index slots passed\n";
+}
+
+// ──────────────────────────────────────────────────────────────
+// Test 4: Backpressure with tiny inflight/output budgets
+// ──────────────────────────────────────────────────────────────
+
+static void test_backpressure() {
+  std::cout << "[server_tests] Test 4: Backpressure\n";
+  std::string text;
+  while (text.size() < (64u << 10)) text += TEXT;
+  FMIndex idx = FMIndex::build_from_text(text, BuildParams());
+  ServerConfig cfg;
+  cfg.threads = 2;
+  cfg.max_inflight = 2;
+  cfg.max_buffered = 4096;  // Far below one reply, so reads pause after each
+  QueryServer server({&idx}, cfg);
+  const std::string path = unix_path();
+  server.listen_unix(path);
+  std::thread loop([&] { server.run(); });
+
+  {
+    QueryClient client = QueryClient::connect_unix(path);
+    // ~19 MiB of replies queued behind a peer that is not reading yet.
+    std::vector<uint64_t> ids;
+    for (int i = 0; i < 300; ++i) {
+      ids.push_back(i % 3 ? client.send_extract({{0, text.size()}})
+                          : client.send_locate({"the"}, 1000));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    for (size_t got = 0; got < ids.size(); ++got) {
+      WireResponse r;
+      [[maybe_unused]] const bool ok = client.recv(r, 5000);
+      assert(ok);
+      const size_t i = r.header.request_id - ids.front();
+      assert(i < ids.size());
+      if (i % 3) {
+        assert(QueryClient::decode_extracts(r)[0] == text);
+      } else {
+        auto locs = QueryClient::decode_locates(r);
+        assert(locs[0].total == idx.count("the") && locs[0].positions.size() == 1000);
+      }
+    }
+  }
+
+  server.stop();
+  loop.join();
+  std::cout << "  ✓ Backpressure passed\n";
+}
+
+// ──────────────────────────────────────────────────────────────
+// Test 5: Request frame larger than the read-ahead budget
+// ──────────────────────────────────────────────────────────────
+
+static void test_oversized_frame() {
+  std::cout << "[server_tests] Test 5: Oversized request frame\n";
+  FMIndex idx = FMIndex::build_from_text(TEXT, BuildParams());
+  ServerConfig cfg;
+  cfg.threads = 1;
+  cfg.max_buffered = 64u << 10;
+  QueryServer server({&idx}, cfg);
+  const std::string path = unix_path();
+  server.listen_unix(path);
+  std::thread loop([&] { server.run(); });
+
+  {
+    QueryClient client = QueryClient::connect_unix(path);
+    // ~200 KB of patterns in one COUNT frame, over three times max_buffered.
+    std::vector<std::string> patterns(2000, std::string(96, 'x'));
+    patterns.back() = "fox";
+    [[maybe_unused]] const uint64_t id = client.send_count(patterns);
+    WireResponse r;
+    [[maybe_unused]] bool ok = client.recv(r, 3000);
+    assert(ok);
+    assert(r.header.request_id == id);
+    auto counts = QueryClient::decode_counts(r);
+    assert(counts.size() == patterns.size());
+    assert(counts.front() == 0 && counts.back() == 2);
+
+    // The connection keeps working for small frames afterwards.
+    [[maybe_unused]] const uint64_t small = client.send_count({"the"});
+    ok = client.recv(r, 3000);
+    assert(ok);
+    assert(r.header.request_id == small);
+    assert(QueryClient::decode_counts(r)[0] == idx.count("the"));
+  }
+
+  server.stop();
+  loop.join();
+  std::cout << "  ✓ Oversized request frame passed\n";
+}
+
+// ──────────────────────────────────────────────────────────────
+// Test 6: recv timeout covers a frame that trickles in
+// ──────────────────────────────────────────────────────────────
+
+static void test_recv_deadline() {
+  std::cout << "[server_tests] Test 6: recv deadline\n";
+  const std::string path = unix_path();
+  ::unlink(path.c_str());
+  const int lfd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  sockaddr_un addr{};
+  addr.sun_family = AF_UNIX;
+  std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+  [[maybe_unused]] int rc = ::bind(lfd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+  assert(rc == 0);
+  rc = ::listen(lfd, 1);
+  assert(rc == 0);
+
+  // A peer that sends one byte of a reply header every 20 ms.
+  std::thread peer([&] {
+    const int fd = ::accept(lfd, nullptr, nullptr);
+    std::string frame;
+    const size_t at = begin_frame(frame);
+    finish_frame(frame, at, FrameHeader{});
+    for (char b : frame) {
+      if (::send(fd, &b, 1, MSG_NOSIGNAL) != 1) break;
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    ::close(fd);
+  });
+
+  {
+    QueryClient client = QueryClient::connect_unix(path);
+    WireResponse r;
+    const auto t0 = std::chrono::steady_clock::now();
+    [[maybe_unused]] const bool ok = client.recv(r, 100);
+    assert(!ok);
+    const auto took = std::chrono::steady_clock::now() - t0;
+    assert(took < std::chrono::milliseconds(300));  // The whole frame takes ~640 ms
+  }
+  peer.join();
+  ::close(lfd);
+  ::unlink(path.c_str());
+  std::cout << "  ✓ recv deadline passed\n";
+}
+
+int main() {
+  std::cout << "========================================\n";
+  std::cout << "Query Server Tests\n";
+  std::cout << "========================================\n";
+
+  test_execute_frame();
+  test_unix_pipelined();
+  test_tcp_slots();
+  test_backpressure();
+  test_oversized_frame();
+  test_recv_deadline();
+
+  std::cout << "========================================\n";
+  std::cout << "All server tests PASSED!\n";
+  std::cout << "========================================\n";
+  return 0;
+}
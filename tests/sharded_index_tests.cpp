@@ -0,0 +1,123 @@
+/**
+ * sharded_index_tests.cpp — Tests for ShardedIndex scatter-gather queries.
+ *
+ * Tests:
+ *   1) count/locate/extract match a single FMIndex for several shard counts,
+ *      including patterns that straddle shard cuts.
+ *   2) Explicit boundaries, newline-snapped cuts, and count_batch.
+ *   3) Patterns longer than max_pattern_len are rejected.
+ */
+
+#include "../src/api/sharded_index.hpp"
+#include "test_util.hpp"
+#include <iostream>
+#include <cassert>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace cs;
+
+static void test_matches_single_index() {
+  std::cout << "[sharded_index_tests] Test 1: Matches single index\n";
+  const std::string text = random_text(5000, "acgt", 7);
+  FMIndex ref = FMIndex::build_from_text(text, BuildParams());
+  ThreadPool pool(4);
+
+  std::mt19937 rng(11);
+  for (size_t shards : {1, 2, 3, 7, 16}) {
+    ShardParams p;
+    p.num_shards = shards;
+    p.max_pattern_len = 12;
+    ShardedIndex si = ShardedIndex::build(text, p, pool);
+    assert(si.num_shards() == shards);
+    assert(si.size() == text.size());
+
+    for (int q = 0; q < 200; ++q) {
+      // Half the patterns are taken right across a shard cut.
+      const size_t len = 1 + rng() % 12;
+      size_t at = rng() % (text.size() - len);
+      if (q % 2 && shards > 1) {
+        const uint64_t cut = si.shard_start(1 + rng() % (shards - 1));
+        at = cut - std::min<uint64_t>(cut, rng() % len);
+      }
+      const std::string pat = text.substr(at, len);
+      assert(si.count(pat, pool) == ref.count(pat));
+      assert(si.locate(pat, pool) == ref.locate(pat));
+      assert(si.locate(pat, pool, 3) == ref.locate_smallest(pat, 3));
+    }
+    assert(si.extract(0, text.size()) == text);
+    assert(si.extract(1234, 900) == text.substr(1234, 900));
+  }
+  std::cout << "  ✓ Matches single index passed\n";
+}
+
+static void test_boundaries_and_batch() {
+  std::cout << "[sharded_index_tests] Test 2: Boundaries and batch\n";
+  std::string text;
+  for (int i = 0; i < 300; ++i) text += "record " + std::to_string(i) + " payload\n";
+  FMIndex ref = FMIndex::build_from_text(text, BuildParams());
+  ThreadPool pool(3);
+
+  ShardParams snapped;
+  snapped.num_shards = 5;
+  snapped.boundary_char = '\n';
+  snapped.max_pattern_len = 16;
+  ShardedIndex a = ShardedIndex::build(text, snapped, pool);
+  for (size_t i = 1; i < a.num_shards(); ++i) assert(text[a.shard_start(i) - 1] == '\n');
+
+  ShardParams explicit_cuts;
+  explicit_cuts.boundaries = {0, 10, 11, 4000};
+  explicit_cuts.max_pattern_len = 16;
+  ShardedIndex b = ShardedIndex::build(text, explicit_cuts, pool);
+  assert(b.num_shards() == 4);
+  assert(b.shard_owned(1) == 1);
+
+  const std::vector<std::string> patterns = {"record", "payload\nrecord 2", "\n", "zzz", "", "7"};
+  auto ca = a.count_batch(patterns, pool);
+  auto cb = b.count_batch(patterns, pool);
+  for (size_t k = 0; k < patterns.size(); ++k) {
+    if (!patterns[k].empty()) assert(ca[k] == ref.count(patterns[k]));
+    assert(cb[k] == ca[k]);
+    if (!patterns[k].empty()) assert(b.locate(patterns[k], pool) == ref.locate(patterns[k]));
+  }
+  assert(ca[4] == text.size());
+
+  [[maybe_unused]] bool threw = false;
+  try {
+    explicit_cuts.boundaries = {0, 50, 40};
+    ShardedIndex::build(text, explicit_cuts, pool);
+  } catch (const std::invalid_argument&) {
+    threw = true;
+  }
+  assert(threw);
+  std::cout << "  ✓ Boundaries and batch passed\n";
+}
+
+static void test_pattern_too_long() {
+  std::cout << "[sharded_index_tests] Test 3: Pattern too long\n";
+  ThreadPool pool(2);
+  ShardParams p;
+  p.num_shards = 2;
+  p.max_pattern_len = 4;
+  ShardedIndex si = ShardedIndex::build("abcabcabcabc", p, pool);
+  assert(si.count("abca", pool) == 3);
+  [[maybe_unused]] bool threw = false;
+  try {
+    si.count("abcab", pool);
+  } catch (const std::invalid_argument&) {
+    threw = true;
+  }
+  assert(threw);
+  std::cout << "  ✓ Pattern too long passed\n";
+}
+
+int main() {
+  std::cout << "=== Running sharded_index_tests ===\n";
+  test_matches_single_index();
+  test_boundaries_and_batch();
+  test_pattern_too_long();
+  std::cout << "=== All sharded_index_tests passed! ===\n";
+  return 0;
+}
@@ -0,0 +1,136 @@
+/**
+ * smem_tests.cpp — Tests for bidirectional search and SMEM finding.
+ *
+ * Tests:
+ *   1) extend_left/extend_right agree with both one-way indexes.
+ *   2) smems against a brute-force definition (including '\0' bytes).
+ *   3) Batched SMEMs, save/load, unidirectional index rejected.
+ */
+
+#include "../src/api/batch_query.hpp"
+#include "test_util.hpp"
+#include <iostream>
+#include <cassert>
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace cs;
+
+// Reads: text substrings with a few substitutions, plus random junk.
+static std::vector<std::string> make_reads(const std::string& text, const std::string& alphabet,
+                                           size_t count, unsigned seed) {
+  std::mt19937 rng(seed);
+  std::vector<std::string> reads;
+  for (size_t i = 0; i < count; ++i) {
+    const size_t len = 5 + rng() % 60;
+    std::string r = i % 5 == 4 ? random_text(len, alphabet + "xy", rng()) : text.substr(rng() % (text.size() - len), len);
+    for (size_t k = rng() % 4; k > 0; --k) r[rng() % r.size()] = alphabet[rng() % alphabet.size()];
+    reads.push_back(r);
+  }
+  return reads;
+}
+
+// SMEMs are [b, e(b)) where e(b) is the end of the longest match at b and
+// e(b) grows past e(b-1).
+static std::vector<std::pair<uint32_t, uint32_t>> naive_smems(const std::string& text, const std::string& q,
+                                                              size_t min_len) {
+  std::vector<std::pair<uint32_t, uint32_t>> out;
+  size_t prev_end = 0;
+  for (size_t b = 0; b < q.size(); ++b) {
+    size_t e = b;
+    while (e < q.size() && text.find(q.substr(b, e + 1 - b)) != std::string::npos) ++e;
+    if (e > b && (b == 0 || e > prev_end) && e - b >= min_len) out.emplace_back(b, e);
+    prev_end = e;
+  }
+  return out;
+}
+
+static void test_bidirectional() {
+  std::cout << "[smem_tests] Test 1: Bidirectional extension\n";
+  const std::string text = random_text(3000, std::string("ACGT") + '\0', 1);
+  FMIndex idx = FMIndex::build_from_text(text, bidi());
+  FMIndex rev = FMIndex::build_from_text(std::string(text.rbegin(), text.rend()), BuildParams());
+  assert(idx.bidirectional() && !rev.bidirectional());
+
+  std::mt19937 rng(2);
+  for (int t = 0; t < 300; ++t) {
+    // Grow a pattern from the middle outwards in a random order.
+    std::string p = text.substr(rng() % 2980, 12);
+    if (t % 7 == 0) p[rng() % 12] = 'N';
+    const size_t mid = rng() % 12;
+    BiInterval bi = idx.extend_right(idx.bi_full_interval(), static_cast<uint8_t>(p[mid]));
+    size_t lo = mid, hi = mid + 1;
+    while (lo > 0 || hi < p.size()) {
+      if (lo > 0 && (hi == p.size() || rng() % 2)) bi = idx.extend_left(bi, static_cast<uint8_t>(p[--lo]));
+      else bi = idx.extend_right(bi, static_cast<uint8_t>(p[hi++]));
+      const std::string sub = p.substr(lo, hi - lo);
+      assert(idx.to_interval(bi) == idx.interval(sub));
+      [[maybe_unused]] const SAInterval r = rev.interval(std::string(sub.rbegin(), sub.rend()));
+      assert(bi.len == sub.size() && (bi.empty() ? r.empty() : bi.rev == r.sp));
+    }
+  }
+  std::cout << "  ✓ Bidirectional extension passed\n";
+}
+
+static void test_smems() {
+  std::cout << "[smem_tests] Test 2: SMEMs vs brute force\n";
+  const std::string alphabet = std::string("ACGT") + '\0';
+  const std::string text = random_text(4000, alphabet, 3);
+  FMIndex idx = FMIndex::build_from_text(text, bidi());
+  for (size_t min_len : {1, 8}) {
+    for (const auto& q : make_reads(text, alphabet, 200, 4)) {
+      const auto got = idx.smems(q, min_len);
+      const auto want = naive_smems(text, q, min_len);
+      assert(got.size() == want.size());
+      for (size_t i = 0; i < got.size(); ++i) {
+        assert(got[i].begin == want[i].first && got[i].end == want[i].second);
+        assert(got[i].iv == idx.interval(q.substr(got[i].begin, got[i].length())));
+      }
+    }
+  }
+  assert(idx.smems("").empty());
+  std::cout << "  ✓ SMEMs passed\n";
+}
+
+static void test_batch_and_persistence() {
+  std::cout << "[smem_tests] Test 3: Batch, save/load, unidirectional\n";
+  const std::string text = random_text(3000, "ACGT", 5);
+  FMIndex idx = FMIndex::build_from_text(text, bidi());
+  const auto reads = make_reads(text, "ACGT", 700, 6);
+
+  ThreadPool pool(3);
+  const SmemBatch batch = find_smems_batch(idx, reads, 4, pool);
+  assert(batch.offsets.size() == reads.size() + 1 && batch.offsets.back() == batch.hits.size());
+  for (size_t r = 0; r < reads.size(); ++r) {
+    const std::vector<Smem> one(batch.hits.begin() + batch.offsets[r], batch.hits.begin() + batch.offsets[r + 1]);
+    assert(one == idx.smems(reads[r], 4));
+  }
+
+  const std::string path = "smem_tests.csidx";
+  idx.save(path);
+  FMIndex back = FMIndex::load(path);
+  std::remove(path.c_str());
+  assert(back.bidirectional() && back.smems(reads[0]) == idx.smems(reads[0]));
+
+  FMIndex one_way = FMIndex::build_from_text(text, BuildParams());
+  [[maybe_unused]] bool threw = false;
+  try {
+    one_way.smems(reads[0]);
+  } catch (const std::logic_error&) {
+    threw = true;
+  }
+  assert(threw);
+  std::cout << "  ✓ Batch and persistence passed\n";
+}
+
+int main() {
+  std::cout << "=== Running smem_tests ===\n";
+  test_bidirectional();
+  test_smems();
+  test_batch_and_persistence();
+  std::cout << "=== All smem_tests passed! ===\n";
+  return 0;
+}
@@ -0,0 +1,151 @@
+/**
+ * suffix_tree_tests.cpp — Tests for PLCP storage and the compressed suffix tree.
+ *
+ * Tests:
+ *   1) PLCP and byte LCP agree; PLCP save/load; sa_at and psi.
+ *   2) Node operations against labels searched from scratch (both encodings).
+ *   3) Leaves, the root, and an index without LCP.
+ *   4) A case-folded index: labels and child() use folded symbols.
+ */
+
+#include "../src/api/suffix_tree.hpp"
+#include "test_util.hpp"
+#include <iostream>
+#include <cassert>
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace cs;
+
+static BuildParams with_lcp(LcpEncoding enc) {
+  BuildParams p;
+  p.lcp = true;
+  p.lcp_encoding = enc;
+  p.ssa_stride = 8;
+  return p;
+}
+
+static void test_plcp() {
+  std::cout << "[suffix_tree_tests] Test 1: PLCP encoding\n";
+  const std::string unit = random_text(300, "ab", 1);
+  const std::string text = random_text(1500, std::string("ab") + '\0', 2) + unit + "b" + unit;
+  FMIndex bytes = FMIndex::build_from_text(text, with_lcp(LcpEncoding::BYTES));
+  FMIndex plcp = FMIndex::build_from_text(text, with_lcp(LcpEncoding::PLCP));
+  assert(plcp.lcp_array().encoding() == LcpEncoding::PLCP);
+  assert(plcp.lcp_array().size_in_bytes() < bytes.lcp_array().size_in_bytes());
+
+  const std::string path = "suffix_tree_tests.csidx";
+  plcp.save(path);
+  FMIndex back = FMIndex::load(path);
+  std::remove(path.c_str());
+  assert(back.lcp_array().encoding() == LcpEncoding::PLCP);
+
+  const uint64_t rows = bytes.full_interval().ep;
+  for (uint64_t r = 0; r < rows; ++r) {
+    assert(plcp.lcp(r) == bytes.lcp(r) && back.lcp(r) == bytes.lcp(r));
+    // psi is the inverse of LF: SA[psi(r)] = SA[r] + 1 (mod n + 1).
+    assert(bytes.sa_at(bytes.psi(r)) == (bytes.sa_at(r) + 1) % (text.size() + 1));
+  }
+  const std::string q = text.substr(1700, 80) + "xx" + text.substr(100, 40);
+  assert(plcp.matching_statistics(q) == bytes.matching_statistics(q));
+  std::cout << "  ✓ PLCP encoding passed\n";
+}
+
+static void check_tree(const FMIndex& idx, const std::string& text, unsigned seed) {
+  SuffixTree st(idx);
+  auto label = [&](const SAInterval& v) { return text.substr(idx.sa_at(v.sp), v.len); };
+  auto locus = [&](const std::string& s) { return st.node(idx.interval(s)); };
+  std::mt19937 rng(seed);
+  for (int t = 0; t < 300; ++t) {
+    const SAInterval v = locus(text.substr(rng() % (text.size() - 10), 1 + rng() % 8));
+    const std::string lv = label(v);
+    // The locus is where the label's rows branch (or a leaf).
+    assert(st.is_leaf(v) || st.children(v).size() >= 2);
+    assert(lv.size() == v.len && locus(lv) == v);
+
+    [[maybe_unused]] const SAInterval p = st.parent(v);
+    assert(p.len < v.len && p.sp <= v.sp && v.ep <= p.ep && locus(lv.substr(0, p.len)) == p);
+    assert(st.is_root(p) || st.children(p).size() >= 2);
+
+    [[maybe_unused]] uint64_t covered = v.sp;
+    for (const SAInterval& ch : st.children(v)) {
+      assert(ch.sp == covered && st.parent(ch) == v);
+      covered = ch.ep;
+    }
+    assert(st.is_leaf(v) || covered == v.ep);
+    for (uint8_t c : {'a', 'b', 'c', 'x'}) {
+      [[maybe_unused]] const SAInterval want = locus(lv + static_cast<char>(c));
+      assert(st.child(v, c) == (want.empty() ? SAInterval{0, 0, v.len + 1} : want));
+    }
+    assert(st.suffix_link(v) == locus(lv.substr(1)));
+  }
+}
+
+static void test_operations() {
+  std::cout << "[suffix_tree_tests] Test 2: Node operations\n";
+  const std::string text = random_text(3000, "abc", 3) + "abcabcabcabc";
+  check_tree(FMIndex::build_from_text(text, with_lcp(LcpEncoding::BYTES)), text, 4);
+  check_tree(FMIndex::build_from_text(text, with_lcp(LcpEncoding::PLCP)), text, 5);
+  std::cout << "  ✓ Node operations passed\n";
+}
+
+static void test_edges() {
+  std::cout << "[suffix_tree_tests] Test 3: Root, leaves, no LCP\n";
+  const std::string text = "mississippi";
+  FMIndex idx = FMIndex::build_from_text(text, with_lcp(LcpEncoding::BYTES));
+  SuffixTree st(idx);
+  const SAInterval root = st.root();
+  assert(st.is_root(root) && st.parent(root) == root && st.suffix_link(root) == root);
+
+  // Root children: the empty suffix, then i, m, p, s.
+  const auto kids = st.children(root);
+  assert(kids.size() == 5 && st.is_leaf(kids[0]) && kids[0].len == 0);
+  assert(st.child(root, 'm') == st.node(idx.interval("mississippi")) && st.child(root, 'm').len == 11);
+  assert(st.child(root, 'z').empty());
+
+  const SAInterval issi = st.node(idx.interval("issi"));
+  assert(issi.len == 4 && issi.size() == 2 && st.label_at(issi, 3) == 'i');
+  [[maybe_unused]] const SAInterval leaf = st.child(issi, 'p');
+  assert(st.is_leaf(leaf) && leaf.len == 7 && idx.locate(leaf) == std::vector<uint64_t>{4});
+  assert(st.suffix_link(leaf) == st.node(idx.interval("ssippi")));
+
+  FMIndex plain = FMIndex::build_from_text(text, BuildParams());
+  [[maybe_unused]] bool threw = false;
+  try {
+    SuffixTree bad(plain);
+  } catch (const std::logic_error&) {
+    threw = true;
+  }
+  assert(threw);
+  std::cout << "  ✓ Root, leaves, no LCP passed\n";
+}
+
+static void test_folded() {
+  std::cout << "[suffix_tree_tests] Test 4: Folded index\n";
+  BuildParams p = with_lcp(LcpEncoding::BYTES);
+  p.fold = ascii_case_fold();
+  const std::string text = random_text(3000, "abcABC", 6);
+  FMIndex idx = FMIndex::build_from_text(text, p);
+  check_tree(idx, idx.fold(text), 7);
+
+  FMIndex band = FMIndex::build_from_text("Banana band BANDANA", p);
+  SuffixTree st(band);
+  [[maybe_unused]] const SAInterval b = st.child(st.root(), 'b');
+  assert(b.size() == band.count("b") && b.size() == 3 && st.child(st.root(), 'B') == b);
+  assert(st.child(st.root(), 'n').size() == 5 && st.child(st.root(), 'a').size() == band.count("a"));
+  assert(st.label_at(st.node(band.interval("BAND")), 0) == 'b');
+  std::cout << "  ✓ Folded index passed\n";
+}
+
+int main() {
+  std::cout << "=== Running suffix_tree_tests ===\n";
+  test_plcp();
+  test_operations();
+  test_edges();
+  test_folded();
+  std::cout << "=== All suffix_tree_tests passed! ===\n";
+  return 0;
+}
@@ -0,0 +1,24 @@
+#pragma once
+/**
+ * test_util.hpp — Helpers shared by the test programs.
+ */
+
+#include "../src/api/fm_index.hpp"
+#include <cstddef>
+#include <random>
+#include <string>
+
+/// n bytes drawn uniformly from alphabet; the same seed gives the same text.
+inline std::string random_text(size_t n, const std::string& alphabet, unsigned seed) {
+  std::mt19937 rng(seed);
+  std::string t(n, ' ');
+  for (auto& c : t) c = alphabet[rng() % alphabet.size()];
+  return t;
+}
+
+/// Build parameters with the reverse index, for bidirectional searches.
+inline cs::BuildParams bidi() {
+  cs::BuildParams p;
+  p.bidirectional = true;
+  return p;
+}
@@ -0,0 +1,146 @@
+/**
+ * utf8_index_tests.cpp — Tests for the code-point FM-index.
+ *
+ * Tests:
+ *   1) Decoding: well-formed and malformed sequences, round trip.
+ *   2) count/locate vs brute force over character-aligned matches.
+ *   3) Extract, byte offsets, no misaligned hits the byte index would give.
+ */
+
+#include "../src/api/utf8_index.hpp"
+#include <iostream>
+#include <cassert>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace cs;
+
+// Random text over ASCII, Greek, CJK and emoji characters.
+static std::string make_text(size_t chars, unsigned seed) {
+  const std::vector<uint32_t> pool = {'a', 'b', ' ', 0x3B1, 0x3B2, 0x3B3, 0x4E2D, 0x6587, 0x1F600, 0xE9};
+  std::mt19937 rng(seed);
+  std::string t;
+  for (size_t i = 0; i < chars; ++i) append_utf8(t, pool[rng() % pool.size()]);
+  return t;
+}
+
+static std::vector<uint32_t> decode_all(std::string_view s) {
+  std::vector<uint32_t> out;
+  for (size_t i = 0; i < s.size();) out.push_back(decode_utf8(s, i));
+  return out;
+}
+
+// Character positions where the decoded pattern occurs in the decoded text.
+static std::vector<uint64_t> naive_locate(const std::string& text, const std::string& p) {
+  const auto t = decode_all(text), q = decode_all(p);
+  std::vector<uint64_t> out;
+  for (size_t i = 0; q.size() && i + q.size() <= t.size(); ++i)
+    if (std::equal(q.begin(), q.end(), t.begin() + i)) out.push_back(i);
+  return out;
+}
+
+static void test_decode() {
+  std::cout << "[utf8_index_tests] Test 1: Decoding\n";
+  assert(decode_all("a\xC3\xA9\xE4\xB8\xAD\xF0\x9F\x98\x80") == (std::vector<uint32_t>{'a', 0xE9, 0x4E2D, 0x1F600}));
+  // Stray continuation, overlong '/', surrogate, truncated, above U+10FFFF.
+  assert(decode_all("\x80") == std::vector<uint32_t>{INVALID_BASE + 0x80});
+  assert(decode_all("\xC0\xAF").size() == 2 && decode_all("\xC0\xAF")[0] == INVALID_BASE + 0xC0);
+  assert(decode_all("\xED\xA0\x80").size() == 3);
+  assert(decode_all("\xE4\xB8").size() == 2);
+  assert(decode_all("\xF4\x90\x80\x80").size() == 4);
+  std::mt19937 rng(1);
+  for (int t = 0; t < 200; ++t) {
+    std::string s(1 + rng() % 20, ' ');
+    for (auto& c : s) c = static_cast<char>(rng() % 3 ? rng() : "\xC3\xA9\xE4\xB8\xAD"[rng() % 5]);
+    std::string back;
+    for (uint32_t cp : decode_all(s)) append_utf8(back, cp);
+    assert(back == s);
+  }
+  std::cout << "  ✓ Decoding passed\n";
+}
+
+static void test_search() {
+  std::cout << "[utf8_index_tests] Test 2: count/locate vs brute force\n";
+  const std::string text = make_text(4000, 2) + "\xFF\xC3(" + make_text(100, 3);
+  Utf8IndexParams p;
+  p.sample_stride = 5;
+  const Utf8Index u = Utf8Index::build(text, p);
+  assert(u.size() == decode_all(text).size() && u.bytes() == text.size() && u.alphabet() == 13);
+
+  std::mt19937 rng(4);
+  const auto cps = decode_all(text);
+  for (int t = 0; t < 300; ++t) {
+    const size_t at = rng() % (cps.size() - 10), len = 1 + rng() % 6;
+    std::string q;
+    for (size_t k = 0; k < len; ++k) append_utf8(q, cps[at + k]);
+    if (t % 10 == 0) append_utf8(q, 0x263A);  // Not in the text
+    const auto want = naive_locate(text, q);
+    assert(u.count(q) == want.size());
+    assert(u.locate(q) == want);
+    assert(u.interval(q).len == decode_all(q).size());
+  }
+  assert(u.count("\xFF\xC3(") == 1 && u.count("\xC3(") == 1);
+  assert(u.count("") == u.size() && u.locate("").empty());
+  assert(u.id(0x263A) == 0 && u.code_point(u.id(0x4E2D)) == 0x4E2D);
+  std::cout << "  ✓ count/locate passed\n";
+}
+
+static void test_extract_and_alignment() {
+  std::cout << "[utf8_index_tests] Test 3: Extract, byte offsets, alignment\n";
+  const std::string text = make_text(3000, 5) + "\xE4\xB8";
+  Utf8IndexParams p;
+  p.sample_stride = 7;
+  const Utf8Index u = Utf8Index::build(text, p);
+  assert(u.extract(0, u.size()) == text);
+  assert(u.extract(1, UINT64_MAX) == u.extract(1, u.size()));
+
+  std::vector<uint64_t> offsets;
+  for (size_t i = 0; i < text.size();) {
+    offsets.push_back(i);
+    decode_utf8(text, i);
+  }
+  offsets.push_back(text.size());
+  for (uint64_t k = 0; k <= u.size(); ++k) assert(u.byte_offset(k) == offsets[k]);
+  for (uint64_t b = 0; b < text.size(); ++b) {
+    [[maybe_unused]] const uint64_t k = u.char_at_byte(b);
+    assert(offsets[k] <= b && b < offsets[k + 1]);
+  }
+  std::mt19937 rng(6);
+  for (int t = 0; t < 200; ++t) {
+    const uint64_t pos = rng() % u.size(), len = rng() % 12;
+    [[maybe_unused]] const uint64_t end = std::min<uint64_t>(pos + len, u.size());
+    assert(u.extract(pos, len) == text.substr(offsets[pos], offsets[end] - offsets[pos]));
+  }
+
+  // "\xB8\xAD" is the tail of 中 (E4 B8 AD) and "\xAD\xE6" spans two
+  // characters: a byte index matches both, the code-point index neither.
+  const std::string tail = "\xB8\xAD", cross = "\xAD\xE6";
+  assert(text.find(tail) != std::string::npos && text.find(cross) != std::string::npos);
+  assert(u.count(tail) == 0 && u.count(cross) == 0);
+  const std::string zhong = "\xE4\xB8\xAD";
+  for ([[maybe_unused]] uint64_t b : u.locate_bytes(zhong)) assert(text.compare(b, 3, zhong) == 0);
+  assert(u.locate_bytes(zhong).size() == naive_locate(text, zhong).size());
+
+  p.byte_offsets = false;
+  const Utf8Index bare = Utf8Index::build(text, p);
+  assert(bare.size_in_bytes() < u.size_in_bytes());
+  [[maybe_unused]] bool threw = false;
+  try {
+    bare.byte_offset(0);
+  } catch (const std::logic_error&) {
+    threw = true;
+  }
+  assert(threw);
+  assert(Utf8Index::build("").size() == 0 && Utf8Index::build("").count("a") == 0);
+  std::cout << "  ✓ Extract and alignment passed\n";
+}
+
+int main() {
+  std::cout << "=== Running utf8_index_tests ===\n";
+  test_decode();
+  test_search();
+  test_extract_and_alignment();
+  std::cout << "=== All utf8_index_tests passed! ===\n";
+  return 0;
+}
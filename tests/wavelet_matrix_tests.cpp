@@ -0,0 +1,101 @@
+/**
+ * wavelet_matrix_tests.cpp — Tests for the integer-alphabet wavelet matrix.
+ *
+ * Tests:
+ *   1) access/rank against the plain array (several alphabet widths).
+ *   2) range_distinct and top_k against per-range histograms.
+ *   3) Rebuild from serialized level words.
+ */
+
+#include "../src/core/wavelet_matrix.hpp"
+#include <iostream>
+#include <algorithm>
+#include <cassert>
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace cs;
+
+static std::vector<uint32_t> random_values(size_t n, uint32_t sigma, unsigned seed) {
+  std::mt19937 rng(seed);
+  std::vector<uint32_t> v(n);
+  for (auto& x : v) x = rng() % sigma;
+  return v;
+}
+
+static void test_access_rank() {
+  std::cout << "[wavelet_matrix_tests] Test 1: access/rank\n";
+  for (uint32_t sigma : {1u, 2u, 5u, 300u, 70000u}) {
+    const auto v = random_values(3000, sigma, sigma);
+    WaveletMatrix wm;
+    wm.build(v);
+    assert(wm.size() == v.size());
+    std::map<uint32_t, size_t> seen;
+    for (size_t i = 0; i < v.size(); ++i) {
+      assert(wm.access(i) == v[i]);
+      if (i % 7 == 0) assert(wm.rank(v[i], i) == seen[v[i]]);
+      ++seen[v[i]];
+    }
+    for ([[maybe_unused]] const auto& [x, c] : seen) assert(wm.rank(x, v.size()) == c);
+    assert(wm.rank(sigma + 1000000, v.size()) == 0);
+  }
+  std::cout << "  ✓ access/rank passed\n";
+}
+
+static void test_distinct_topk() {
+  std::cout << "[wavelet_matrix_tests] Test 2: range_distinct/top_k\n";
+  const auto v = random_values(5000, 40, 9);
+  WaveletMatrix wm;
+  wm.build(v);
+  std::mt19937 rng(1);
+  for (int q = 0; q < 200; ++q) {
+    size_t sp = rng() % v.size(), ep = rng() % (v.size() + 1);
+    if (sp > ep) std::swap(sp, ep);
+    std::map<uint32_t, size_t> hist;
+    for (size_t i = sp; i < ep; ++i) ++hist[v[i]];
+
+    std::vector<std::pair<uint32_t, size_t>> got, expect(hist.begin(), hist.end());
+    wm.range_distinct(sp, ep, [&](uint32_t x, size_t c) {
+      got.emplace_back(x, c);
+      return true;
+    });
+    assert(got == expect);
+
+    std::stable_sort(expect.begin(), expect.end(),
+                     [](const auto& a, const auto& b) { return a.second > b.second; });
+    const size_t k = 1 + rng() % 10;
+    if (expect.size() > k) expect.resize(k);
+    assert(wm.top_k(sp, ep, k) == expect);
+  }
+  // Early stop.
+  size_t calls = 0;
+  wm.range_distinct(0, v.size(), [&](uint32_t, size_t) { return ++calls < 3; });
+  assert(calls == 3);
+  std::cout << "  ✓ range_distinct/top_k passed\n";
+}
+
+static void test_level_words() {
+  std::cout << "[wavelet_matrix_tests] Test 3: Rebuild from level words\n";
+  const auto v = random_values(1000, 1000, 4);
+  WaveletMatrix wm;
+  wm.build(v);
+  std::vector<uint64_t> words;
+  for (uint32_t l = 0; l < wm.width(); ++l) {
+    const auto& bits = wm.level(l).bits();
+    words.insert(words.end(), bits.begin(), bits.begin() + (v.size() + 63) / 64);
+  }
+  WaveletMatrix back;
+  back.build_from_level_words(words.data(), v.size(), wm.width());
+  for (size_t i = 0; i < v.size(); ++i) assert(back.access(i) == v[i]);
+  std::cout << "  ✓ Rebuild passed\n";
+}
+
+int main() {
+  std::cout << "=== Running wavelet_matrix_tests ===\n";
+  test_access_rank();
+  test_distinct_topk();
+  test_level_words();
+  std::cout << "=== All wavelet_matrix_tests passed! ===\n";
+  return 0;
+}
@@ -8,6 +8,8 @@
  *   4) All same character.
  *   5) Random bytes (verify rank matches naïve).
  *   6) Access reconstruction (verify access(i) == bwt[i]).
+ *   7) range_rank against naive counts.
+ *   8) select inverts rank.
  */
 
 #include "../src/core/wavelet.hpp"
@@ -208,6 +210,47 @@ static void test_boundary() {
   std::cout << "  PASS\n";
 }
 
+static void test_range_rank() {
+  std::cout << "[TEST] range_rank\n";
+  std::mt19937 rng(7);
+  std::vector<uint8_t> text(3000);
+  for (auto& c : text) c = static_cast<uint8_t>(rng() % 6 == 0 ? rng() : rng() % 4);
+  WaveletTree wt;
+  wt.build(text);
+
+  for (int q = 0; q < 500; ++q) {
+    size_t sp = rng() % (text.size() + 1), ep = rng() % (text.size() + 1);
+    if (sp > ep) std::swap(sp, ep);
+    const uint8_t c = static_cast<uint8_t>(q % 3 ? rng() % 5 : rng());
+    size_t before = 0, inside = 0, less = 0;
+    for (size_t i = 0; i < ep; ++i) {
+      if (i < sp) before += text[i] == c;
+      else inside += text[i] == c, less += text[i] < c;
+    }
+    [[maybe_unused]] const RangeRank r = wt.range_rank(c, sp, ep);
+    assert(r.before == before && r.inside == inside && r.less == less);
+  }
+  std::cout << "  PASS\n";
+}
+
+static void test_select() {
+  std::cout << "[TEST] select\n";
+  std::mt19937 rng(8);
+  std::vector<uint8_t> text(20000);
+  for (auto& c : text) c = static_cast<uint8_t>(rng() % 5 == 0 ? rng() : rng() % 4);
+  WaveletTree wt;
+  wt.build(text);
+
+  std::vector<size_t> seen(256, 0);
+  for (size_t i = 0; i < text.size(); ++i) {
+    ++seen[text[i]];
+    assert(wt.select(text[i], seen[text[i]]) == i);
+  }
+  for (unsigned c = 0; c < 256; ++c) assert(wt.select(static_cast<uint8_t>(c), seen[c] + 1) == text.size());
+  assert(wt.select(0, 0) == text.size());
+  std::cout << "  PASS\n";
+}
+
 // ──────────────────────────────────────────────────────────────
 // Main test runner
 // ──────────────────────────────────────────────────────────────
@@ -226,6 +269,8 @@ int main() {
   test_random(5000, 999);
   test_alphabet_coverage();
   test_boundary();
+  test_range_rank();
+  test_select();
 
   std::cout << "========================================\n";
   std::cout << "All WaveletTree tests PASSED!\n";
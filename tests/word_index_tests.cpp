@@ -0,0 +1,135 @@
+/**
+ * word_index_tests.cpp — Tests for the word-level FM-index.
+ *
+ * Tests:
+ *   1) Tokenizer, dictionary and WaveletMatrix::access_rank.
+ *   2) count/locate/extract against a brute-force token scan.
+ *   3) Folding, byte offsets, unknown words, empty input.
+ */
+
+#include "../src/api/word_index.hpp"
+#include <iostream>
+#include <cassert>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace cs;
+
+static const char* const WORDS[] = {"the", "cat", "sat", "on", "a", "mat", "dog", "ran", "The", "café"};
+
+static std::string random_prose(size_t words, unsigned seed) {
+  std::mt19937 rng(seed);
+  std::string t;
+  for (size_t i = 0; i < words; ++i) {
+    t += WORDS[rng() % 10];
+    t += rng() % 9 == 0 ? ", " : rng() % 13 == 0 ? ".\n" : " ";
+  }
+  return t;
+}
+
+static std::vector<std::string> tokens_of(const std::string& text, const TokenizerParams& p = {}) {
+  std::vector<std::string> out;
+  tokenize(text, p, [&](std::string_view t, size_t) { out.emplace_back(t); });
+  return out;
+}
+
+static std::vector<uint64_t> naive_locate(const std::vector<std::string>& T, const std::vector<std::string>& q) {
+  std::vector<uint64_t> out;
+  for (size_t i = 0; i + q.size() <= T.size(); ++i)
+    if (std::equal(q.begin(), q.end(), T.begin() + i)) out.push_back(i);
+  return out;
+}
+
+static void test_tokens() {
+  std::cout << "[word_index_tests] Test 1: Tokenizer and dictionary\n";
+  assert((tokens_of("Hi, there!  x_1\tcafé") == std::vector<std::string>{"Hi", ",", "there", "!", "x_1", "café"}));
+  TokenizerParams np;
+  np.punctuation = false;
+  assert((tokens_of("a, b.", np) == std::vector<std::string>{"a", "b"}));
+
+  WordIndex w = WordIndex::build("b a c a b a");
+  assert(w.size() == 6 && w.vocabulary() == 3);
+  assert(w.id("a") == 1 && w.id("b") == 2 && w.id("c") == 3 && w.id("d") == 0 && w.token(2) == "b");
+  assert((w.ids("a d c") == std::vector<uint32_t>{1, 0, 3}));
+
+  std::vector<uint32_t> vals;
+  std::mt19937 rng(1);
+  for (int i = 0; i < 3000; ++i) vals.push_back(rng() % 300);
+  WaveletMatrix wm;
+  wm.build(vals);
+  for (size_t i = 0; i < vals.size(); i += 7) {
+    [[maybe_unused]] size_t r = 0;
+    assert(wm.access_rank(i, r) == vals[i] && r == wm.rank(vals[i], i));
+  }
+  std::cout << "  ✓ Tokenizer and dictionary passed\n";
+}
+
+static void test_search() {
+  std::cout << "[word_index_tests] Test 2: count/locate/extract vs brute force\n";
+  const std::string text = random_prose(3000, 2);
+  const auto T = tokens_of(text);
+  WordIndexParams p;
+  p.sample_stride = 8;
+  WordIndex w = WordIndex::build(text, p);
+  assert(w.size() == T.size());
+
+  std::mt19937 rng(3);
+  for (int t = 0; t < 300; ++t) {
+    const size_t len = 1 + rng() % 4, at = rng() % (T.size() - len);
+    std::vector<std::string> q(T.begin() + at, T.begin() + at + len);
+    if (t % 5 == 0) q[rng() % len] = WORDS[rng() % 10];
+    std::string phrase;
+    for (const auto& s : q) phrase += s + " ";
+    const auto want = naive_locate(T, q);
+    assert(w.count(phrase) == want.size());
+    assert(w.locate(phrase) == want);
+  }
+  for (uint64_t at : {0ul, 1ul, 7ul, 8ul, 500ul, T.size() - 3}) {
+    const auto ids = w.extract_ids(at, 3);
+    assert(ids.size() == 3);
+    for (size_t k = 0; k < 3; ++k) assert(w.token(ids[k]) == T[at + k]);
+  }
+  assert(w.extract(T.size() - 2, 10) == T[T.size() - 2] + " " + T.back());
+  assert(w.extract(T.size(), 1).empty());
+  assert(w.extract_ids(1, UINT64_MAX).size() == T.size() - 1);
+  assert(w.count("") == w.size() && w.locate("").empty());
+  std::cout << "  ✓ count/locate/extract passed\n";
+}
+
+static void test_options() {
+  std::cout << "[word_index_tests] Test 3: Folding, offsets, edge cases\n";
+  const std::string text = "The cat.  the CAT sat";
+  WordIndexParams p;
+  p.tokenizer.fold = ascii_case_fold();
+  WordIndex w = WordIndex::build(text, p);
+  assert(w.vocabulary() == 4 && w.count("THE Cat") == 2 && w.count("cat sat") == 1);
+  assert((w.locate("the cat") == std::vector<uint64_t>{0, 3}));
+  assert(w.byte_offset(0) == 0 && w.byte_offset(2) == 7 && w.byte_offset(3) == 10 && w.byte_offset(5) == 18);
+  assert(w.count("cat dog") == 0 && w.locate("dog").empty());
+  assert(w.size_in_bytes() > 0);
+
+  p.byte_offsets = false;
+  WordIndex no = WordIndex::build(text, p);
+  [[maybe_unused]] bool threw = false;
+  try {
+    no.byte_offset(0);
+  } catch (const std::logic_error&) {
+    threw = true;
+  }
+  assert(threw);
+
+  WordIndex empty = WordIndex::build("  \n ");
+  assert(empty.size() == 0 && empty.count("a") == 0 && empty.extract(0, 3).empty());
+  std::cout << "  ✓ Folding, offsets, edge cases passed\n";
+}
+
+int main() {
+  std::cout << "=== Running word_index_tests ===\n";
+  test_tokens();
+  test_search();
+  test_options();
+  std::cout << "=== All word_index_tests passed! ===\n";
+  return 0;
+}
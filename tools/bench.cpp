@@ -1,13 +1,54 @@
 #include <iostream>
+#include <fstream>
+#include <cstdio>
 #include <random>
+#include <regex>
+#include <unordered_map>
 #include "../src/api/fm_index.hpp"
+#include "../src/api/batch_query.hpp"
+#include "../src/api/dna.hpp"
+#include "../src/api/kmers.hpp"
+#include "../src/api/proximity.hpp"
+#include "../src/api/regex.hpp"
+#include "../src/api/word_index.hpp"
+#include "../src/api/repeats.hpp"
 #include "../src/util/io.hpp"
 #include "../src/util/timer.hpp"
 
+// Query log: one pattern per line, or words (up to 32 bytes) drawn at random
+// text positions, so frequent words dominate and inflections share suffixes.
+static std::vector<std::string> load_log(const std::string& text, const char* path, size_t n){
+  std::vector<std::string> log;
+  if (path){
+    std::ifstream in(path, std::ios::binary);
+    if (!in) throw std::runtime_error(std::string("cannot open: ") + path);
+    std::string line;
+    while (std::getline(in, line)){
+      if (!line.empty() && line.back() == '\r') line.pop_back();
+      log.push_back(line);
+    }
+    return log;
+  }
+  auto is_word = [](char c){ return std::isalnum(static_cast<unsigned char>(c)) != 0; };
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<size_t> P(0, text.empty() ? 0 : text.size() - 1);
+  for (size_t tries = 0; log.size() < n && tries < 20 * n; ++tries){
+    size_t b = P(rng);
+    if (!is_word(text[b])) continue;
+    for (size_t k = 0; k < 32 && b > 0 && is_word(text[b - 1]); ++k) --b;
+    size_t e = b;
+    while (e < text.size() && e - b < 32 && is_word(text[e])) ++e;
+    log.push_back(text.substr(b, e - b));
+  }
+  return log;
+}
+
 int main(int argc, char** argv){
-  if (argc < 2){ std::cerr << "usage: cs_bench <input.txt>\n"; return 1; }
+  if (argc < 2){ std::cerr << "usage: cs_bench <input.txt> [query_log.txt]\n"; return 1; }
   auto text = cs::slurp(argv[1]);
-  auto idx = cs::FMIndex::build_from_text(text, {});
+  cs::BuildParams params;
+  params.bidirectional = true;  // For the SMEM section
+  auto idx = cs::FMIndex::build_from_text(text, params);
   std::mt19937 rng(42);
   std::uniform_int_distribution<size_t> L(3, 12), P(0, text.size() ? text.size()-20 : 0);
   size_t iters = 2000, total = 0;
@@ -21,5 +62,234 @@ int main(int argc, char** argv){
     }
   }
   std::cerr << "agg=" << total << "\n";
+
+  // Batch search: one backward search per pattern vs the shared-suffix trie.
+  const auto log = load_log(text, argc > 2 ? argv[2] : nullptr, 200000);
+  const size_t chunk = 4096;
+  uint64_t agg_single = 0, agg_shared = 0;
+  cs::SharedSearchStats st;
+  cs::Timer t1;
+  for (const auto& p : log) agg_single += idx.interval(p).size();
+  const double single_ms = t1.elapsed_ms();
+  cs::Timer t2;
+  for (size_t at = 0; at < log.size(); at += chunk){
+    std::vector<std::string> batch(log.begin() + at, log.begin() + std::min(log.size(), at + chunk));
+    for (const auto& iv : cs::search_shared_suffixes(idx, batch, &st)) agg_shared += iv.size();
+  }
+  const double shared_ms = t2.elapsed_ms();
+  if (agg_single != agg_shared){ std::cerr << "mismatch\n"; return 1; }
+  std::cerr << "batch of " << log.size() << " patterns (chunks of " << chunk << "):\n"
+            << "  single: " << single_ms << " ms, " << st.naive_rank_calls << " rank calls\n"
+            << "  shared: " << shared_ms << " ms, " << st.rank_calls << " rank calls ("
+            << (shared_ms > 0 ? single_ms / shared_ms : 0) << "x)\n";
+
+  // SMEM seeding: 100-byte reads from the text with 2% substitutions.
+  if (text.size() > 200){
+    std::vector<std::string> reads(20000);
+    std::uniform_int_distribution<size_t> R(0, text.size() - 100);
+    for (auto& r : reads){
+      r = text.substr(R(rng), 100);
+      for (auto& c : r) if (rng() % 50 == 0) c = text[R(rng)];
+    }
+    cs::ThreadPool pool(0);
+    cs::Timer t3;
+    const auto seeds = cs::find_smems_batch(idx, reads, 19, pool);
+    const double smem_ms = t3.elapsed_ms();
+    std::cerr << "smems: " << reads.size() << " reads x 100 bytes, " << seeds.hits.size() << " seeds (min 19) in "
+              << smem_ms << " ms (" << (smem_ms > 0 ? reads.size() / smem_ms * 1000.0 : 0) << " reads/s, "
+              << pool.size() << " threads)\n";
+  }
+
+  // K-mer spectrum: suffix-tree walk vs hashing every window of the text.
+  // Hashing touches every window; the walk only nodes that reach min_count.
+  cs::ThreadPool kpool(0);
+  for (const size_t k : {12, 24}) {
+    cs::Timer th;
+    std::unordered_map<std::string_view, uint64_t> hashed;
+    for (size_t i = 0; i + k <= text.size(); ++i) ++hashed[std::string_view(text).substr(i, k)];
+    const double hash_ms = th.elapsed_ms();
+    for (const uint64_t min_count : {1, 2}) {
+      uint64_t want = 0;
+      for (const auto& kv : hashed) want += kv.second >= min_count;
+      cs::Timer tw;
+      const auto st = cs::enumerate_kmers(idx, k, min_count, [](const cs::KmerBlock&) {}, kpool);
+      const double walk_ms = tw.elapsed_ms();
+      if (st.kmers != want){ std::cerr << "kmer mismatch\n"; return 1; }
+      std::cerr << "kmers k=" << k << " min " << min_count << ": " << st.kmers << ", hash " << hash_ms
+                << " ms, walk " << walk_ms << " ms (" << st.nodes << " nodes, " << kpool.size() << " threads)\n";
+    }
+  }
+
+  // Maximal repeats of at least 20 bytes, streamed.
+  {
+    cs::RepeatOptions ropt;
+    ropt.min_length = 20;
+    uint64_t longest = 0;
+    cs::Timer tr;
+    const auto st = cs::find_maximal_repeats(idx, ropt, [&](std::span<const cs::MaximalRepeat> b) {
+      for (const auto& r : b) longest = std::max(longest, r.length());
+    }, kpool);
+    std::cerr << "repeats >= 20: " << st.repeats << " (longest " << longest << ") in " << tr.elapsed_ms()
+              << " ms (" << st.nodes << " nodes, " << kpool.size() << " threads)\n";
+  }
+
+  // Proximity: word pairs from the log within 64 bytes, each plan forced vs AUTO.
+  if (log.size() >= 400) {
+    const char* names[] = {"auto", "scan after", "scan before", "join"};
+    for (int plan = 0; plan < 4; ++plan) {
+      cs::ProximityOptions popt;
+      popt.max_gap = 64;
+      popt.limit = SIZE_MAX;
+      popt.plan = static_cast<cs::ProximityPlan>(plan);
+      uint64_t matches = 0;
+      cs::Timer tp;
+      for (size_t i = 0; i + 1 < 400; i += 2) matches += cs::find_near(idx, log[i], log[i + 1], popt).size();
+      std::cerr << "near (200 pairs, gap <= 64) " << names[plan] << ": " << matches << " matches in "
+                << tp.elapsed_ms() << " ms\n";
+    }
+  }
+
+  // Regex: each plan vs std::regex over the whole text.
+  for (const char* pattern : {"return [a-z_]+\\(", "[A-Z][a-z]+Error", "0x[0-9a-f]{4,}", "(if|for|while) \\("}) {
+    const cs::Regex re = cs::Regex::compile(pattern);
+    std::cerr << "regex " << pattern << ":";
+    for (const auto plan : {cs::RegexPlan::TRAVERSE, cs::RegexPlan::VERIFY}) {
+      if (plan == cs::RegexPlan::VERIFY && re.required_literal().empty()) continue;
+      cs::RegexOptions ropt;
+      ropt.plan = plan;
+      ropt.max_length = 64;
+      cs::RegexStats rst;
+      cs::Timer tx;
+      const uint64_t n = cs::count_regex(idx, re, ropt, &rst);
+      std::cerr << (plan == cs::RegexPlan::VERIFY ? " verify " : " traverse ") << n << " in " << tx.elapsed_ms()
+                << " ms (" << rst.nodes << " nodes, " << rst.scanned_bytes << " bytes);";
+    }
+    const std::regex ref(pattern);
+    cs::Timer ts;
+    const auto hits = std::distance(std::sregex_iterator(text.begin(), text.end(), ref), std::sregex_iterator());
+    std::cerr << " std::regex scan " << hits << " leftmost in " << ts.elapsed_ms() << " ms\n";
+  }
+
+  // Word-level index: 3-token phrases cut from the text, by token and by byte.
+  {
+    cs::Timer tb;
+    const auto words = cs::WordIndex::build(text);
+    const double build_ms = tb.elapsed_ms();
+    std::vector<std::pair<std::string, std::string>> phrases;  // (as text, tokens)
+    std::uniform_int_distribution<uint64_t> W(0, words.size() > 4 ? words.size() - 4 : 0);
+    for (int i = 0; i < 20000 && words.size() > 4; ++i) {
+      const uint64_t at = W(rng), b = words.byte_offset(at), e = words.byte_offset(at + 3);
+      std::string raw = text.substr(b, e - b);
+      while (!raw.empty() && std::isspace(static_cast<unsigned char>(raw.back()))) raw.pop_back();
+      phrases.emplace_back(raw, words.extract(at, 3));
+    }
+    uint64_t by_word = 0, by_byte = 0;
+    cs::Timer tw;
+    for (const auto& ph : phrases) by_word += words.count(ph.second);
+    const double word_ms = tw.elapsed_ms();
+    cs::Timer tc;
+    for (const auto& ph : phrases) by_byte += idx.count(ph.first);
+    const double byte_ms = tc.elapsed_ms();
+    std::cerr << "words: " << words.size() << " tokens, " << words.vocabulary() << " distinct, "
+              << words.size_in_bytes() << " bytes (built in " << build_ms << " ms); " << phrases.size()
+              << " phrases: by token " << word_ms << " ms (" << by_word << " hits), by byte " << byte_ms
+              << " ms (" << by_byte << " hits)\n";
+  }
+
+  // Both strands: 20-byte reads, two searches on the text vs one on text + revcomp.
+  if (text.size() > 40) {
+    const auto strands = cs::build_both_strands(text, cs::BuildParams());
+    std::vector<std::string> reads(50000);
+    std::uniform_int_distribution<size_t> R(0, text.size() - 20);
+    for (size_t i = 0; i < reads.size(); ++i) {
+      reads[i] = text.substr(R(rng), 20);
+      if (i % 2) reads[i] = cs::reverse_complement(reads[i]);
+    }
+    uint64_t two = 0, one = 0;
+    cs::Timer ta;
+    for (const auto& r : reads) two += idx.count(r) + idx.count(cs::reverse_complement(r));
+    const double two_ms = ta.elapsed_ms();
+    cs::Timer tb;
+    for (const auto& r : reads) one += strands.count(r);
+    const double one_ms = tb.elapsed_ms();
+    std::cerr << "strands: " << reads.size() << " reads x 20: two searches " << two_ms << " ms (" << two
+              << " hits), one on both strands " << one_ms << " ms (" << one << " hits)\n";
+  }
+
+  // Extraction from the index alone: psi forward vs LF backward, 256-byte windows.
+  {
+    std::uniform_int_distribution<uint64_t> X(0, text.size() > 256 ? text.size() - 256 : 0);
+    std::vector<uint64_t> at(5000);
+    for (auto& a : at) a = X(rng);
+    uint64_t fwd = 0, bwd = 0;
+    cs::Timer tf;
+    for (uint64_t a : at) fwd += idx.extract_forward(a, 256).size();
+    const double fwd_ms = tf.elapsed_ms();
+    cs::Timer tb;
+    for (uint64_t a : at) bwd += idx.extract_backward(a, 256).size();
+    std::cerr << "extract " << at.size() << " x 256: forward (psi) " << fwd_ms << " ms, backward (LF) "
+              << tb.elapsed_ms() << " ms (" << fwd + bwd << " bytes)\n";
+  }
+
+  // 2-bit packing: counts and 1 KB extracts, byte layout vs packed.
+  {
+    cs::BuildParams pp;
+    pp.pack_dna = true;
+    const auto packed = cs::FMIndex::build_from_text(text, pp);
+    const auto plain = cs::FMIndex::build_from_text(text, cs::BuildParams());
+    std::vector<std::string> qs(50000);
+    std::uniform_int_distribution<size_t> Q(0, text.size() > 20 ? text.size() - 20 : 0);
+    for (auto& q : qs) q = text.substr(Q(rng), 20);
+    for (const auto* which : {&plain, &packed}) {
+      uint64_t hits = 0, bytes = 0;
+      cs::Timer tc;
+      for (const auto& q : qs) hits += which->count(q);
+      const double count_ms = tc.elapsed_ms();
+      cs::Timer te;
+      for (size_t i = 0; i < qs.size(); ++i) bytes += which->extract(Q(rng), 1024).size();
+      std::cerr << (which == &packed ? "packed" : "bytes ") << ": text+bwt " << which->text_and_bwt_bytes()
+                << " bytes, index " << which->size_in_bytes() << " bytes; "
+                << qs.size() << " counts " << count_ms << " ms (" << hits << " hits); "
+                << qs.size() << " extracts " << te.elapsed_ms() << " ms (" << bytes << " bytes)\n";
+    }
+
+    // Streaming: the whole text 20 times as strings vs into a buffer, then
+    // 50,000 64-byte snippets as strings fwritten to /dev/null vs one batch.
+    std::FILE* null = std::fopen("/dev/null", "wb");
+    std::vector<char> out(text.size());
+    std::vector<cs::ExtractRange> ranges(50000);
+    for (auto& r : ranges) r = {Q(rng), 64};
+    for (const auto* which : {&plain, &packed}) {
+      uint64_t bytes = 0;
+      cs::Timer ts;
+      for (int i = 0; i < 20; ++i) bytes += which->extract(0, text.size()).size();
+      const double string_ms = ts.elapsed_ms();
+      cs::Timer tb;
+      for (int i = 0; i < 20; ++i) {
+        cs::BufferSink sink(out.data(), out.size());
+        bytes += which->extract_to(0, text.size(), sink);
+      }
+      const double buffer_ms = tb.elapsed_ms();
+      cs::Timer tn;
+      for (const auto& r : ranges) {
+        const std::string s = which->extract(r.pos, r.len);
+        if (null) std::fwrite(s.data(), 1, s.size(), null);
+        bytes += s.size();
+      }
+      const double snippets_ms = tn.elapsed_ms();
+      cs::Timer tf;
+      uint64_t calls = 0;
+      if (null) {
+        cs::FdSink sink(fileno(null));
+        which->extract_to(ranges, sink);
+        sink.flush();
+        calls = sink.syscalls();
+      }
+      std::cerr << (which == &packed ? "packed" : "bytes ") << ": 20 x whole text: string " << string_ms
+                << " ms, buffer sink " << buffer_ms << " ms; " << ranges.size() << " x 64: strings " << snippets_ms
+                << " ms, fd sink " << tf.elapsed_ms() << " ms (" << calls << " writev, " << bytes << " bytes)\n";
+    }
+    if (null) std::fclose(null);
+  }
   return 0;
 }
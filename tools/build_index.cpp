@@ -1,4 +1,5 @@
 #include "../src/api/fm_index.hpp"
+#include "../src/api/sharded_index.hpp"
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -7,11 +8,15 @@
 void print_usage() {
     std::cout << "Usage: build_index <input_text_file> [options]\n\n";
     std::cout << "Options:\n";
-    std::cout << "  --no-terminator    Don't add $ terminator (use if file already has one)\n";
-    std::cout << "  --stats            Show detailed statistics\n\n";
+    std::cout << "  --stats            Show detailed statistics\n";
+    std::cout << "  --output FILE      Save the index to FILE (.csidx) and exit\n";
+    std::cout << "  --shards N         With --output: write N shards + manifest into directory FILE\n";
+    std::cout << "  --max-pattern L    Longest pattern matched across shard cuts (default 256)\n\n";
     std::cout << "Example:\n";
     std::cout << "  build_index mybook.txt\n";
-    std::cout << "  build_index genome.txt --no-terminator --stats\n";
+    std::cout << "  build_index genome.txt --stats\n";
+    std::cout << "  build_index mybook.txt --output mybook.csidx\n";
+    std::cout << "  build_index corpus.txt --shards 4 --output corpus_shards\n";
 }
 
 std::string read_file(const std::string& path) {
@@ -32,16 +37,22 @@ int main(int argc, char* argv[]) {
     }
 
     std::string input_file = argv[1];
-    bool add_terminator = true;
     bool show_stats = false;
+    std::string output_file;
+    size_t num_shards = 0;
+    size_t max_pattern = 256;
 
     // Parse options
     for (int i = 2; i < argc; ++i) {
         std::string arg = argv[i];
-        if (arg == "--no-terminator") {
-            add_terminator = false;
-        } else if (arg == "--stats") {
+        if (arg == "--stats") {
             show_stats = true;
+        } else if (arg == "--output" && i + 1 < argc) {
+            output_file = argv[++i];
+        } else if (arg == "--shards" && i + 1 < argc) {
+            num_shards = std::stoul(argv[++i]);
+        } else if (arg == "--max-pattern" && i + 1 < argc) {
+            max_pattern = std::stoul(argv[++i]);
         } else {
             std::cerr << "Unknown option: " << arg << "\n";
             return 1;
@@ -50,6 +61,7 @@ int main(int argc, char* argv[]) {
 
     try {
         std::cout << "Reading text from: " << input_file << "\n";
+        // The index adds its own virtual terminator; the text is indexed as is.
         std::string text = read_file(input_file);
         
         if (text.empty()) {
@@ -59,10 +71,25 @@ int main(int argc, char* argv[]) {
 
         std::cout << "Text size: " << text.size() << " bytes\n";
 
-        // Add terminator if needed
-        if (add_terminator && text.back() != '$' && text.back() != '\0') {
-            text += '$';
-            std::cout << "Added terminator '$'\n";
+        if (num_shards > 0) {
+            if (output_file.empty()) {
+                std::cerr << "Error: --shards requires --output DIR\n";
+                return 1;
+            }
+            std::cout << "\nBuilding " << num_shards << " shards...\n";
+            auto start = std::chrono::high_resolution_clock::now();
+            cs::ShardParams sp;
+            sp.num_shards = num_shards;
+            sp.max_pattern_len = max_pattern;
+            sp.build.ssa_stride = 32;
+            cs::ThreadPool pool;
+            cs::ShardedIndex sharded = cs::ShardedIndex::build(text, sp, pool);
+            sharded.save(output_file);
+            auto end = std::chrono::high_resolution_clock::now();
+            std::cout << "Built and saved " << sharded.num_shards() << " shards to " << output_file
+                      << "/ in " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()
+                      << " ms\n";
+            return 0;
         }
 
         // Build index
@@ -83,6 +110,12 @@ int main(int argc, char* argv[]) {
             std::cout << "Text length: " << text.size() << " bytes\n";
         }
 
+        if (!output_file.empty()) {
+            index.save(output_file);
+            std::cout << "Index saved to: " << output_file << "\n";
+            return 0;
+        }
+
         // Interactive query loop
         std::cout << "\n=== Ready for Queries ===\n";
         std::cout << "Enter patterns to search (or 'quit' to exit):\n\n";
@@ -102,7 +135,8 @@ int main(int argc, char* argv[]) {
 
             try {
                 auto query_start = std::chrono::high_resolution_clock::now();
-                size_t count = index.count(pattern);
+                const cs::SAInterval iv = index.interval(pattern);
+                size_t count = iv.size();
                 auto query_end = std::chrono::high_resolution_clock::now();
                 auto query_time = std::chrono::duration_cast<std::chrono::microseconds>(query_end - query_start);
 
@@ -111,7 +145,7 @@ int main(int argc, char* argv[]) {
 
                 if (count > 0 && count <= 10) {
                     std::cout << "  Finding positions...\n";
-                    auto positions = index.locate(pattern);
+                    auto positions = index.locate(iv);
                     std::cout << "  Positions: ";
                     for (size_t i = 0; i < positions.size(); ++i) {
                         if (i > 0) std::cout << ", ";
@@ -0,0 +1,137 @@
+/**
+ * coordinator.cpp — cs_coordinator: query a sharded index served by workers.
+ *
+ * Reads the shard manifest written by `build_index --shards N --output DIR`,
+ * pairs shard i with the i-th --worker address (each a cs_serverd serving
+ * DIR/shard-<i>.csidx), and answers patterns in batches. Output matches
+ * `cs_query --patterns` TSV; batches missing shards are reported on stderr
+ * and make the exit status 2.
+ */
+
+#include "../src/server/coordinator.hpp"
+#include "../src/util/timer.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static void print_usage() {
+  std::cout << "Usage: cs_coordinator --manifest FILE --worker ADDR [--worker ADDR ...] [options] [pattern ...]\n\n";
+  std::cout << "Options:\n";
+  std::cout << "  --worker ADDR      unix:PATH or HOST:PORT, one per shard in manifest order\n";
+  std::cout << "  --patterns FILE    Read patterns (one per line) from FILE, '-' for stdin\n";
+  std::cout << "  --locate N         Also print up to N positions per pattern\n";
+  std::cout << "  --batch N          Patterns per fan-out (default 1024)\n";
+  std::cout << "  --timeout MS       Per-batch shard deadline (default 1000)\n\n";
+  std::cout << "Example:\n";
+  std::cout << "  build_index corpus.txt --shards 2 --output shards\n";
+  std::cout << "  cs_serverd --unix /tmp/s0.sock shards/shard-0.csidx &\n";
+  std::cout << "  cs_serverd --unix /tmp/s1.sock shards/shard-1.csidx &\n";
+  std::cout << "  cs_coordinator --manifest shards/shards.manifest \\\n";
+  std::cout << "      --worker unix:/tmp/s0.sock --worker unix:/tmp/s1.sock --patterns queries.txt\n";
+}
+
+static void print_missing(size_t batch, const std::vector<size_t>& missing) {
+  std::cerr << "batch " << batch << ": partial result, missing shards";
+  for (size_t s : missing) std::cerr << " " << s;
+  std::cerr << "\n";
+}
+
+int main(int argc, char* argv[]) {
+  std::string manifest_path, patterns_path;
+  std::vector<std::string> workers, patterns;
+  size_t locate_limit = 0, batch_size = 1024;
+  int timeout_ms = 1000;
+
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--manifest" && i + 1 < argc) {
+      manifest_path = argv[++i];
+    } else if (arg == "--worker" && i + 1 < argc) {
+      workers.push_back(argv[++i]);
+    } else if (arg == "--patterns" && i + 1 < argc) {
+      patterns_path = argv[++i];
+    } else if (arg == "--locate" && i + 1 < argc) {
+      locate_limit = std::stoul(argv[++i]);
+    } else if (arg == "--batch" && i + 1 < argc) {
+      batch_size = std::max<size_t>(1, std::stoul(argv[++i]));
+    } else if (arg == "--timeout" && i + 1 < argc) {
+      timeout_ms = std::stoi(argv[++i]);
+    } else if (arg == "-h" || arg == "--help") {
+      print_usage();
+      return 0;
+    } else if (!arg.empty() && arg[0] == '-' && arg != "-") {
+      std::cerr << "Unknown option: " << arg << "\n";
+      return 1;
+    } else {
+      patterns.push_back(arg);
+    }
+  }
+  if (manifest_path.empty() || workers.empty() || (patterns.empty() && patterns_path.empty())) {
+    print_usage();
+    return 1;
+  }
+
+  try {
+    const cs::ShardManifest manifest = cs::ShardManifest::read(manifest_path);
+    cs::CoordinatorConfig cfg;
+    cfg.timeout_ms = timeout_ms;
+    cfg.max_pattern_len = manifest.max_pattern_len;
+    cs::Coordinator coord(cs::Coordinator::endpoints(manifest, workers), cfg);
+
+    std::ifstream file;
+    std::istream* in = nullptr;
+    if (patterns_path == "-") {
+      in = &std::cin;
+    } else if (!patterns_path.empty()) {
+      file.open(patterns_path);
+      if (!file) throw std::runtime_error("cannot open " + patterns_path);
+      in = &file;
+    }
+
+    cs::Timer t;
+    size_t batches = 0, total = 0, partial = 0;
+    std::vector<std::string> batch = std::move(patterns);
+    std::string line;
+    for (;;) {
+      while (in && batch.size() < batch_size && std::getline(*in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        batch.push_back(std::move(line));
+      }
+      if (batch.empty()) break;
+
+      std::vector<size_t> missing;
+      if (locate_limit == 0) {
+        auto r = coord.count(batch);
+        for (uint64_t c : r.counts) std::cout << c << "\n";
+        missing = std::move(r.missing);
+      } else {
+        auto r = coord.locate(batch, static_cast<uint32_t>(locate_limit));
+        for (const auto& rep : r.replies) {
+          std::cout << rep.total << "\t";
+          for (size_t k = 0; k < rep.positions.size(); ++k) std::cout << (k ? "," : "") << rep.positions[k];
+          std::cout << "\n";
+        }
+        missing = std::move(r.missing);
+      }
+      if (!missing.empty()) {
+        print_missing(batches, missing);
+        ++partial;
+      }
+      total += batch.size();
+      ++batches;
+      batch.clear();
+      if (!in) break;
+    }
+    std::cout.flush();
+    std::cerr << total << " patterns in " << batches << " batches across " << coord.num_shards()
+              << " shards, " << t.elapsed_ms() << " ms";
+    if (partial) std::cerr << " (" << partial << " partial)";
+    std::cerr << "\n";
+    return partial ? 2 : 0;
+  } catch (const std::exception& e) {
+    std::cerr << "Error: " << e.what() << "\n";
+    return 1;
+  }
+}
@@ -0,0 +1,93 @@
+/**
+ * cst_bench.cpp — cs_cst_bench: cost of compressed suffix tree operations.
+ *
+ * Builds the index twice, with byte-coded LCP and with PLCP, then times each
+ * SuffixTree operation over the same nodes (loci of random text substrings):
+ *   node, string_depth, parent, children, child, suffix_link
+ * and reports the LCP footprint in bits per row next to ns per operation.
+ */
+
+#include "../src/api/suffix_tree.hpp"
+#include "../src/util/io.hpp"
+#include "../src/util/timer.hpp"
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace cs;
+
+template <class Fn>
+static void time_op(const char* name, size_t ops, Fn&& fn) {
+  Timer t;
+  uint64_t agg = fn();
+  const double ms = t.elapsed_ms();
+  std::cout << "  " << std::left << std::setw(14) << name << std::right << std::setw(10) << std::fixed
+            << std::setprecision(1) << (ops ? ms * 1e6 / ops : 0) << " ns/op   (agg " << agg << ")\n";
+}
+
+static void run(const std::string& text, LcpEncoding enc, size_t samples) {
+  BuildParams p;
+  p.lcp = true;
+  p.lcp_encoding = enc;
+  Timer tb;
+  const FMIndex idx = FMIndex::build_from_text(text, p);
+  const double build_ms = tb.elapsed_ms();
+  const SuffixTree st(idx);
+  const double bits = 8.0 * idx.lcp_array().size_in_bytes() / idx.lcp_array().size();
+  std::cout << (enc == LcpEncoding::BYTES ? "BYTES" : "PLCP") << ": build " << std::fixed << std::setprecision(0)
+            << build_ms << " ms, LCP " << std::setprecision(2) << bits << " bits/row\n";
+
+  std::mt19937 rng(42);
+  std::vector<SAInterval> ivs(samples);
+  for (auto& iv : ivs) iv = idx.interval(text.substr(rng() % (text.size() - 8), 1 + rng() % 8));
+  std::vector<SAInterval> nodes(samples);
+
+  time_op("node", samples, [&] {
+    uint64_t agg = 0;
+    for (size_t i = 0; i < samples; ++i) agg += (nodes[i] = st.node(ivs[i])).len;
+    return agg;
+  });
+  time_op("string_depth", samples, [&] {
+    uint64_t agg = 0;
+    for (const auto& v : nodes) agg += st.string_depth(v);
+    return agg;
+  });
+  time_op("parent", samples, [&] {
+    uint64_t agg = 0;
+    for (const auto& v : nodes) agg += st.parent(v).len;
+    return agg;
+  });
+  time_op("children", samples, [&] {
+    uint64_t agg = 0;
+    for (const auto& v : nodes) agg += st.children(v).size();
+    return agg;
+  });
+  time_op("child", samples, [&] {
+    uint64_t agg = 0;
+    for (size_t i = 0; i < samples; ++i) agg += st.child(nodes[i], static_cast<uint8_t>(text[i % text.size()])).size();
+    return agg;
+  });
+  time_op("suffix_link", samples, [&] {
+    uint64_t agg = 0;
+    for (const auto& v : nodes) agg += st.suffix_link(v).len;
+    return agg;
+  });
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::cerr << "usage: cs_cst_bench <input.txt> [samples]\n";
+    return 1;
+  }
+  const std::string text = slurp(argv[1]);
+  if (text.size() < 16) {
+    std::cerr << "input too small\n";
+    return 1;
+  }
+  const size_t samples = argc > 2 ? std::stoul(argv[2]) : 20000;
+  run(text, LcpEncoding::BYTES, samples);
+  run(text, LcpEncoding::PLCP, samples);
+  return 0;
+}
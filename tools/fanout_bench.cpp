@@ -0,0 +1,131 @@
+/**
+ * fanout_bench.cpp — cs_fanout_bench: cost of coordinator scatter-gather.
+ *
+ * Builds a random text, shards it, and starts one QueryServer per shard on
+ * its own Unix socket (threads standing in for worker nodes). The same
+ * pattern batches are then answered three ways:
+ *   local     ShardedIndex::count_batch in-process (no sockets)
+ *   direct    one worker holding the whole text, one QueryClient round trip
+ *   fan-out   Coordinator over all shard workers
+ * and per-batch latency is reported for several batch sizes. The difference
+ * between fan-out and local is the network + merge overhead.
+ */
+
+#include "../src/api/sharded_index.hpp"
+#include "../src/server/coordinator.hpp"
+#include "../src/server/server.hpp"
+#include "../src/util/timer.hpp"
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+static void print_usage() {
+  std::cout << "Usage: cs_fanout_bench [options]\n\n";
+  std::cout << "Options:\n";
+  std::cout << "  --size MB          Text size (default 8)\n";
+  std::cout << "  --shards N         Shard workers (default 4)\n";
+  std::cout << "  --rounds R         Batches per measurement (default 200)\n";
+  std::cout << "  --threads N        Worker threads per shard server (default 1)\n";
+}
+
+int main(int argc, char* argv[]) {
+  size_t size_mb = 8, shards = 4, rounds = 200, threads = 1;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--size" && i + 1 < argc) {
+      size_mb = std::stoul(argv[++i]);
+    } else if (arg == "--shards" && i + 1 < argc) {
+      shards = std::stoul(argv[++i]);
+    } else if (arg == "--rounds" && i + 1 < argc) {
+      rounds = std::stoul(argv[++i]);
+    } else if (arg == "--threads" && i + 1 < argc) {
+      threads = std::stoul(argv[++i]);
+    } else {
+      print_usage();
+      return arg == "-h" || arg == "--help" ? 0 : 1;
+    }
+  }
+
+  std::mt19937 rng(42);
+  std::string text(size_mb << 20, 'a');
+  for (auto& ch : text) ch = "acgt"[rng() % 4];
+
+  cs::ThreadPool pool;
+  cs::ShardParams sp;
+  sp.num_shards = shards;
+  sp.max_pattern_len = 64;
+  cs::Timer t;
+  cs::ShardedIndex sharded = cs::ShardedIndex::build(text, sp, pool);
+  std::cerr << "built " << sharded.num_shards() << " shards in " << t.elapsed_ms() << " ms\n";
+  t.reset();
+  cs::FMIndex whole = cs::FMIndex::build_from_text(text, cs::BuildParams());
+  std::cerr << "built whole index in " << t.elapsed_ms() << " ms\n";
+
+  // One server per shard plus one for the whole text, each on its own thread.
+  cs::ServerConfig cfg;
+  cfg.threads = threads;
+  const std::string prefix = "/tmp/cs_fanout_" + std::to_string(::getpid()) + "_";
+  std::vector<std::unique_ptr<cs::QueryServer>> servers;
+  std::vector<std::thread> loops;
+  std::vector<std::string> paths;
+  for (size_t i = 0; i <= sharded.num_shards(); ++i) {
+    const cs::FMIndex* idx = i < sharded.num_shards() ? &sharded.shard(i) : &whole;
+    servers.push_back(std::make_unique<cs::QueryServer>(std::vector<const cs::FMIndex*>{idx}, cfg));
+    paths.push_back(prefix + std::to_string(i) + ".sock");
+    servers.back()->listen_unix(paths.back());
+    loops.emplace_back([s = servers.back().get()] { s->run(); });
+  }
+
+  std::vector<std::string> addresses;
+  for (size_t i = 0; i < sharded.num_shards(); ++i) addresses.push_back("unix:" + paths[i]);
+  cs::CoordinatorConfig ccfg;
+  ccfg.max_pattern_len = sharded.max_pattern_len();
+  cs::Coordinator coord(cs::Coordinator::endpoints(sharded.manifest(), addresses), ccfg);
+  cs::QueryClient direct = cs::QueryClient::connect_unix(paths.back());
+
+  std::cout << "\n=== Fan-out overhead (" << sharded.num_shards() << " shards, "
+            << size_mb << " MB, count) ===\n";
+  std::cout << std::setw(8) << "batch" << std::setw(14) << "local us" << std::setw(14) << "direct us"
+            << std::setw(14) << "fan-out us" << std::setw(14) << "overhead us" << "\n";
+
+  uint64_t checksum = 0;
+  for (size_t batch : {1, 16, 256, 4096}) {
+    std::vector<std::vector<std::string>> batches(rounds);
+    for (auto& b : batches) {
+      for (size_t k = 0; k < batch; ++k) b.push_back(text.substr(rng() % (text.size() - 16), 4 + rng() % 12));
+    }
+    // Warm up connections and tails.
+    coord.count(batches[0]);
+
+    t.reset();
+    for (const auto& b : batches) checksum += sharded.count_batch(b, pool)[0];
+    const double local = t.elapsed_us() / rounds;
+    t.reset();
+    for (const auto& b : batches) checksum += direct.count(b)[0];
+    const double one = t.elapsed_us() / rounds;
+    t.reset();
+    size_t partial = 0;
+    for (const auto& b : batches) {
+      auto r = coord.count(b);
+      checksum += r.counts[0];
+      partial += r.partial();
+    }
+    const double fan = t.elapsed_us() / rounds;
+
+    std::cout << std::setw(8) << batch << std::fixed << std::setprecision(1)
+              << std::setw(14) << local << std::setw(14) << one << std::setw(14) << fan
+              << std::setw(14) << fan - local;
+    if (partial) std::cout << "  (" << partial << " partial)";
+    std::cout << "\n";
+  }
+  std::cerr << "checksum=" << checksum << "\n";
+
+  for (auto& s : servers) s->stop();
+  for (auto& l : loops) l.join();
+  return 0;
+}
@@ -1,18 +1,91 @@
 #include <iostream>
+#include <fstream>
+#include <string>
 #include "../src/api/fm_index.hpp"
+#include "../src/api/batch_query.hpp"
 #include "../src/util/io.hpp"
+#include "../src/util/timer.hpp"
+
+static void print_usage(){
+  std::cerr << "usage: cs_query <input.txt|index.csidx> <pattern>\n"
+            << "       cs_query <input.txt|index.csidx> --patterns FILE|- [options]\n\n"
+            << "batch options:\n"
+            << "  --locate N       also report up to N positions per pattern\n"
+            << "  --format tsv|bin output format (default tsv, one record per line)\n"
+            << "  --threads N      worker threads (default: all cores)\n"
+            << "  --chunk N        patterns per work unit (default 4096)\n"
+            << "  --no-shared      search patterns one by one, not as a suffix trie\n";
+}
+
+static bool ends_with(const std::string& s, const std::string& suffix){
+  return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
 
 int main(int argc, char** argv){
   if (argc < 3){
-    std::cerr << "usage: cs_query <input.txt> <pattern>\n";
+    print_usage();
+    return 1;
+  }
+  const std::string source = argv[1];
+  std::string patterns_file;
+  std::string pattern;
+  cs::BatchQueryOptions opt;
+  size_t threads = 0;
+  for (int i = 2; i < argc; ++i){
+    const std::string arg = argv[i];
+    if (arg == "--patterns" && i + 1 < argc) patterns_file = argv[++i];
+    else if (arg == "--locate" && i + 1 < argc) opt.locate_limit = std::stoul(argv[++i]);
+    else if (arg == "--threads" && i + 1 < argc) threads = std::stoul(argv[++i]);
+    else if (arg == "--chunk" && i + 1 < argc) opt.chunk_patterns = std::stoul(argv[++i]);
+    else if (arg == "--no-shared") opt.shared_suffixes = false;
+    else if (arg == "--format" && i + 1 < argc){
+      const std::string f = argv[++i];
+      if (f == "tsv") opt.format = cs::BatchFormat::TSV;
+      else if (f == "bin") opt.format = cs::BatchFormat::BINARY;
+      else { std::cerr << "unknown format: " << f << "\n"; return 1; }
+    }
+    else if (pattern.empty() && patterns_file.empty()) pattern = arg;
+    else { print_usage(); return 1; }
+  }
+
+  try {
+    // A .csidx is loaded as-is; anything else is indexed on the fly.
+    auto idx = ends_with(source, ".csidx") ? cs::FMIndex::load(source)
+                                           : cs::FMIndex::build_from_text(cs::slurp(source), {});
+
+    if (patterns_file.empty()){
+      auto iv = idx.interval(pattern);
+      auto c = pattern.empty() ? idx.size() : iv.size();
+      auto pos = idx.locate(iv, 100);
+      std::cout << "count=" << c << "\npositions: ";
+      for (auto p: pos) std::cout << p << " ";
+      std::cout << "\n";
+      return 0;
+    }
+
+    std::ios::sync_with_stdio(false);
+    std::ifstream file;
+    if (patterns_file != "-"){
+      file.open(patterns_file, std::ios::binary);
+      if (!file) throw std::runtime_error("cannot open: " + patterns_file);
+    }
+    std::istream& in = patterns_file == "-" ? std::cin : file;
+
+    cs::ThreadPool pool(threads);
+    cs::Timer t;
+    const auto stats = cs::run_batch_queries(idx, in, std::cout, pool, opt);
+    const double ms = t.elapsed_ms();
+    std::cerr << "patterns=" << stats.patterns << " occurrences=" << stats.occurrences
+              << " time=" << ms << " ms (" << (ms > 0 ? stats.patterns / ms * 1000.0 : 0)
+              << " patterns/s, " << pool.size() << " threads)\n";
+    if (opt.shared_suffixes && stats.naive_rank_calls > 0){
+      std::cerr << "rank calls=" << stats.rank_calls << " of " << stats.naive_rank_calls << " ("
+                << 100.0 * (stats.naive_rank_calls - stats.rank_calls) / stats.naive_rank_calls
+                << "% saved by shared suffixes)\n";
+    }
+  } catch (const std::exception& e){
+    std::cerr << "error: " << e.what() << "\n";
     return 1;
   }
-  auto text = cs::slurp(argv[1]);
-  auto idx = cs::FMIndex::build_from_text(text, {});
-  auto c = idx.count(argv[2]);
-  auto pos = idx.locate(argv[2], 100);
-  std::cout << "count=" << c << "\npositions: ";
-  for (auto p: pos) std::cout << p << " ";
-  std::cout << "\n";
   return 0;
 }
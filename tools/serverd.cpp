@@ -0,0 +1,106 @@
+/**
+ * serverd.cpp — cs_serverd: serve count/locate/extract from .csidx files.
+ *
+ * Loads every index once, then answers batched requests (see
+ * src/server/protocol.hpp) until SIGINT/SIGTERM. Index slot i is the i-th
+ * file on the command line.
+ */
+
+#include "../src/api/fm_index.hpp"
+#include "../src/server/server.hpp"
+#include "../src/util/timer.hpp"
+#include <csignal>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+static cs::QueryServer* g_server = nullptr;
+
+static void on_signal(int) {
+  if (g_server) g_server->stop();
+}
+
+static void print_usage() {
+  std::cout << "Usage: cs_serverd [options] <index.csidx> [more.csidx ...]\n\n";
+  std::cout << "Options:\n";
+  std::cout << "  --unix PATH        Listen on a Unix-domain socket\n";
+  std::cout << "  --tcp HOST:PORT    Listen on TCP (IPv4; port 0 picks one)\n";
+  std::cout << "  --threads N        Worker threads (default: all cores)\n";
+  std::cout << "  --cache-mb N       Interval cache for hot patterns, in MB (default: off)\n\n";
+  std::cout << "Example:\n";
+  std::cout << "  cs_serverd --unix /tmp/cs.sock --tcp 127.0.0.1:7070 book.csidx\n";
+}
+
+int main(int argc, char* argv[]) {
+  std::vector<std::string> unix_paths, tcp_addrs, files;
+  cs::ServerConfig cfg;
+
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--unix" && i + 1 < argc) {
+      unix_paths.push_back(argv[++i]);
+    } else if (arg == "--tcp" && i + 1 < argc) {
+      tcp_addrs.push_back(argv[++i]);
+    } else if (arg == "--threads" && i + 1 < argc) {
+      cfg.threads = std::stoul(argv[++i]);
+    } else if (arg == "--cache-mb" && i + 1 < argc) {
+      cfg.cache_bytes = std::stoul(argv[++i]) << 20;
+    } else if (arg == "-h" || arg == "--help") {
+      print_usage();
+      return 0;
+    } else if (!arg.empty() && arg[0] == '-') {
+      std::cerr << "Unknown option: " << arg << "\n";
+      return 1;
+    } else {
+      files.push_back(arg);
+    }
+  }
+  if (files.empty() || (unix_paths.empty() && tcp_addrs.empty())) {
+    print_usage();
+    return 1;
+  }
+
+  try {
+    std::vector<std::unique_ptr<cs::FMIndex>> indexes;
+    std::vector<const cs::FMIndex*> slots;
+    for (const auto& f : files) {
+      cs::Timer t;
+      indexes.push_back(std::make_unique<cs::FMIndex>(cs::FMIndex::load(f)));
+      slots.push_back(indexes.back().get());
+      std::cerr << "[slot " << slots.size() - 1 << "] " << f << ": "
+                << indexes.back()->size() << " bytes, loaded in " << t.elapsed_ms() << " ms\n";
+    }
+
+    cs::QueryServer server(slots, cfg);
+    for (const auto& p : unix_paths) {
+      server.listen_unix(p);
+      std::cerr << "listening on unix:" << p << "\n";
+    }
+    for (const auto& a : tcp_addrs) {
+      const auto colon = a.rfind(':');
+      if (colon == std::string::npos) throw std::runtime_error("expected HOST:PORT, got " + a);
+      const uint16_t port = server.listen_tcp(a.substr(0, colon),
+                                              static_cast<uint16_t>(std::stoul(a.substr(colon + 1))));
+      std::cerr << "listening on tcp:" << a.substr(0, colon) << ":" << port << "\n";
+    }
+
+    g_server = &server;
+    std::signal(SIGINT, on_signal);
+    std::signal(SIGTERM, on_signal);
+    server.run();
+    g_server = nullptr;
+    for (size_t s = 0; s < slots.size(); ++s) {
+      if (const cs::IntervalCache* c = server.cache(s)) {
+        const auto st = c->stats();
+        std::cerr << "[slot " << s << "] cache: " << st.hits << " hits, " << st.partial_hits
+                  << " partial, " << st.misses << " misses, " << st.evictions << " evictions\n";
+      }
+    }
+    std::cerr << "shutting down\n";
+  } catch (const std::exception& e) {
+    std::cerr << "Error: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}